@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <functional>
+
+// Minimal benchmark harness, benchmarks register themselves and are run by name from main
+namespace Bench
+{
+	// Registers a benchmark under given name
+	struct Registration
+	{
+		Registration(const char* name, void(*run)());
+	};
+
+	// Prints the duration of a measured step and its cost per item
+	void report(const std::string& label, double ms, uint64_t nItems);
+
+	// Runs a step once, reports and returns its duration in milliseconds
+	template <typename Step>
+	double measure(const std::string& label, uint64_t nItems, Step&& step)
+	{
+		auto start = std::chrono::steady_clock::now();
+		step();
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		report(label, ms, nItems);
+		return ms;
+	}
+
+	// Keeps the compiler from optimizing away a value that is otherwise unused
+	void consume(uint64_t value);
+};
+
+// Defines and registers a benchmark
+#define BENCHMARK(name) \
+	static void name(); \
+	static Bench::Registration name##_registration(#name, name); \
+	static void name()
@@ -0,0 +1,92 @@
+#include "../bench.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <entt/entt.hpp>
+
+#include <ecs/components.h>
+#include <ecs/ecs_reflection.h>
+#include <ecs/reflection_formats.h>
+
+namespace {
+
+	constexpr uint32_t N_COMPONENTS = 100'000;
+
+	// Each entity owns a transform and a point light
+	constexpr uint32_t N_ENTITIES = N_COMPONENTS / 2;
+
+	void populate(entt::registry& registry, std::vector<entt::entity>& entities)
+	{
+		entities.resize(N_ENTITIES);
+		registry.create(entities.begin(), entities.end());
+		for (uint32_t i = 0; i < N_ENTITIES; i++) {
+			TransformComponent& transform = registry.emplace<TransformComponent>(entities[i]);
+			transform.position = glm::vec3(static_cast<float>(i), 0.0f, static_cast<float>(i % 100));
+
+			PointLightComponent& light = registry.emplace<PointLightComponent>(entities[i]);
+			light.intensity = static_cast<float>(i % 10);
+		}
+	}
+
+}
+
+BENCHMARK(ComponentReflection)
+{
+	ECSReflection::registerAll();
+
+	entt::registry source;
+	std::vector<entt::entity> entities;
+	populate(source, entities);
+
+	// Binary format
+	std::vector<uint8_t> binary;
+	Bench::measure("binary write", N_COMPONENTS, [&]() {
+		ECSReflection::BinaryWriter writer(binary);
+		for (entt::entity entity : entities) ECSReflection::serializeEntity(writer, source, entity);
+		});
+
+	entt::registry binaryTarget;
+	std::vector<entt::entity> binaryEntities(N_ENTITIES);
+	binaryTarget.create(binaryEntities.begin(), binaryEntities.end());
+	Bench::measure("binary read", N_COMPONENTS, [&]() {
+		ECSReflection::BinaryReader reader(binary.data(), binary.size());
+		for (entt::entity entity : binaryEntities) {
+			if (!reader.readComponent(binaryTarget, entity) || !reader.readComponent(binaryTarget, entity)) {
+				std::printf("  malformed binary data\n");
+				return;
+			}
+		}
+		});
+	Bench::consume(binaryTarget.view<PointLightComponent>().size());
+
+	// Json format
+	std::string text;
+	Bench::measure("json write", N_COMPONENTS, [&]() {
+		ECSReflection::JsonWriter writer(text);
+		for (entt::entity entity : entities) ECSReflection::serializeEntity(writer, source, entity);
+		writer.finish();
+		});
+
+	json document;
+	Bench::measure("json parse", N_COMPONENTS, [&]() {
+		document = json::parse(text);
+		});
+
+	entt::registry jsonTarget;
+	std::vector<entt::entity> jsonEntities(N_ENTITIES);
+	jsonTarget.create(jsonEntities.begin(), jsonEntities.end());
+	Bench::measure("json read", N_COMPONENTS, [&]() {
+		for (size_t i = 0; i < document.size(); i++) {
+			const json& component = document[i];
+			const ECSReflection::Component* type = ECSReflection::resolve(component["type"].get<entt::id_type>());
+			if (!type) continue;
+
+			ECSReflection::JsonReader reader(component["properties"]);
+			type->emplace(*type, jsonTarget, jsonEntities[i / 2], reader);
+		}
+		});
+	Bench::consume(jsonTarget.view<PointLightComponent>().size());
+
+	std::printf("  %-40s %10zu bytes binary, %zu bytes json\n", "output size", binary.size(), text.size());
+}
@@ -0,0 +1,73 @@
+#include "bench.h"
+
+#include <cstdio>
+#include <vector>
+#include <cstring>
+#include <atomic>
+
+//
+// Headless benchmarks of the parts of the core that don't need the graphics api
+//
+// nuro-bench [name filter]
+//
+
+namespace {
+
+	struct Benchmark
+	{
+		const char* name;
+		void(*run)();
+	};
+
+	// Constructed on first use, registrations run during static initialization
+	std::vector<Benchmark>& benchmarks()
+	{
+		static std::vector<Benchmark> registered;
+		return registered;
+	}
+
+	std::atomic<uint64_t> gSink = 0;
+
+}
+
+namespace Bench {
+
+	Registration::Registration(const char* name, void(*run)())
+	{
+		benchmarks().push_back({ name, run });
+	}
+
+	void report(const std::string& label, double ms, uint64_t nItems)
+	{
+		double nsPerItem = nItems ? ms * 1e6 / static_cast<double>(nItems) : 0.0;
+		std::printf("  %-40s %10.2f ms %12.2f ns/item\n", label.c_str(), ms, nsPerItem);
+	}
+
+	void consume(uint64_t value)
+	{
+		gSink.fetch_xor(value, std::memory_order_relaxed);
+	}
+
+}
+
+int main(int argc, char** argv)
+{
+	const char* filter = argc > 1 ? argv[1] : nullptr;
+
+	uint32_t nRun = 0;
+	for (const Benchmark& benchmark : benchmarks()) {
+		if (filter && !std::strstr(benchmark.name, filter)) continue;
+
+		std::printf("%s\n", benchmark.name);
+		benchmark.run();
+		std::printf("\n");
+		nRun++;
+	}
+
+	if (nRun == 0) {
+		std::fprintf(stderr, "no benchmark matches '%s'\n", filter ? filter : "");
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,57 @@
+#include "../bench.h"
+
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <rendering/lighting/light_cluster_grid.h>
+
+namespace {
+
+	// Random view space light volumes in front of the camera
+	std::vector<LightClusterGrid::LightBounds> randomLights(uint32_t count, float far, std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> lateral(-1.0f, 1.0f);
+		std::uniform_real_distribution<float> depth(0.5f, far);
+		std::uniform_real_distribution<float> radius(1.0f, 12.0f);
+
+		std::vector<LightClusterGrid::LightBounds> lights(count);
+		for (LightClusterGrid::LightBounds& light : lights) {
+			float z = depth(random);
+			light.center = glm::vec3(lateral(random) * z, lateral(random) * z * 0.5625f, -z);
+			light.radius = radius(random);
+		}
+		return lights;
+	}
+
+}
+
+BENCHMARK(LightClusterGridAssign)
+{
+	constexpr float near = 0.3f;
+	constexpr float far = 300.0f;
+	constexpr uint32_t N_FRAMES = 200;
+
+	glm::mat4 projection = glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, near, far);
+
+	LightClusterGrid grid;
+	Bench::measure("build cluster bounds", LightClusterGrid::N_CLUSTERS, [&]() {
+		grid.setProjection(projection, near, far);
+		});
+
+	std::mt19937 random(42);
+	for (uint32_t nLights : { 64u, 256u, 512u }) {
+		// Half point lights, half spotlights
+		std::vector<LightClusterGrid::LightBounds> pointLights = randomLights(nLights / 2, far, random);
+		std::vector<LightClusterGrid::LightBounds> spotlights = randomLights(nLights / 2, far, random);
+
+		std::string label = "assign " + std::to_string(nLights) + " lights (per frame)";
+		Bench::measure(label, N_FRAMES, [&]() {
+			for (uint32_t i = 0; i < N_FRAMES; i++) grid.assign(pointLights, spotlights);
+			});
+
+		Bench::consume(grid.getIndices().size());
+		std::printf("  %-40s %10u lights, %u indices\n", "max per cluster / total", grid.getMaxLightsPerCluster(), static_cast<uint32_t>(grid.getIndices().size()));
+	}
+}
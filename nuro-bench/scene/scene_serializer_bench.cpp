@@ -0,0 +1,75 @@
+#include "../bench.h"
+
+#include <cstdio>
+#include <vector>
+#include <string>
+#include <filesystem>
+
+#include <ecs/ecs.h>
+#include <scene/scene_serializer.h>
+
+namespace {
+
+	constexpr uint32_t N_ENTITIES = 1'000'000;
+
+	// Entities per group, each group is a root with its remaining entities as children
+	constexpr uint32_t GROUP_SIZE = 10;
+
+	// Fills an ecs with groups of entities, every child has a mesh renderer and every eighth entity a point light
+	void populate(ECS& ecs)
+	{
+		std::vector<Entity> entities = ecs.createEntities(N_ENTITIES);
+
+		std::vector<TransformComponent> transforms(N_ENTITIES);
+		std::vector<std::string> names(N_ENTITIES);
+		for (uint32_t i = 0; i < N_ENTITIES; i++) {
+			transforms[i].position = glm::vec3(static_cast<float>(i % 1000), static_cast<float>(i / 1000), 0.0f);
+			names[i] = "Entity " + std::to_string(i);
+		}
+
+		ecs.beginBatch();
+		ecs.insertTransforms(entities.begin(), entities.end(), transforms.begin(), names.begin());
+
+		for (uint32_t i = 0; i < N_ENTITIES; i++) {
+			if (i % GROUP_SIZE != 0) {
+				ecs.setParent(entities[i], entities[i - i % GROUP_SIZE]);
+				ecs.add<MeshRendererComponent>(entities[i]);
+			}
+			if (i % 8 == 0) ecs.add<PointLightComponent>(entities[i]);
+		}
+		ecs.endBatch();
+	}
+
+}
+
+BENCHMARK(SceneSerializer)
+{
+	FS::Path path = std::filesystem::temp_directory_path() / "nuro_bench_scene.nscn";
+	SceneAssetResolver assets;
+
+	ECS source;
+	Bench::measure("populate ecs", N_ENTITIES, [&]() { populate(source); });
+
+	double total = 0.0;
+
+	total += Bench::measure("write", N_ENTITIES, [&]() {
+		if (!SceneSerializer::write(path, source, assets)) std::printf("  writing scene failed\n");
+		});
+
+	SceneData data;
+	total += Bench::measure("read", N_ENTITIES, [&]() {
+		if (!SceneSerializer::read(path, data, assets)) std::printf("  reading scene failed\n");
+		});
+
+	ECS target;
+	std::vector<Entity> inserted;
+	total += Bench::measure("insert", N_ENTITIES, [&]() {
+		inserted = SceneSerializer::insert(target, data);
+		});
+
+	Bench::report("total", total, N_ENTITIES);
+	Bench::consume(inserted.size());
+
+	std::printf("  %-40s %10llu bytes\n", "scene file", static_cast<unsigned long long>(std::filesystem::file_size(path)));
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,162 @@
+#include "../bench.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <entt/entt.hpp>
+
+#include <ecs/ecs.h>
+#include <transform/transform.h>
+#include <transform/transform_pass.h>
+#include <rendering/transformation/transformation.h>
+
+//
+// Compares the transform pass over the split hot transform component with the transform component before
+// its identity and hierarchy were split out, both passes evaluate the same hierarchy with the same math
+//
+
+namespace {
+
+	constexpr uint32_t N_ENTITIES = 100'000;
+	constexpr uint32_t N_FRAMES = 50;
+
+	// Entities per group, each group is a root with its remaining entities as children
+	constexpr uint32_t GROUP_SIZE = 10;
+
+	// Transform component before identity and hierarchy were split out
+	struct LegacyTransformComponent {
+
+		uint32_t id = 0;
+		std::string name;
+		bool modified = true;
+		glm::vec3 position = glm::vec3(0.0f);
+		glm::quat rotation = glm::identity<glm::quat>();
+		glm::vec3 eulerAngles = glm::vec3(0.0f);
+		glm::vec3 scale = glm::vec3(1.0f);
+		Entity parent = entt::null;
+		std::vector<Entity> children;
+		uint32_t depth = 0;
+		glm::mat4 model = glm::mat4(1.0f);
+		glm::mat4 previousModel = glm::mat4(1.0f);
+		glm::mat4 normal = glm::mat4(1.0f);
+		glm::mat4 mvp = glm::mat4(1.0f);
+
+	};
+
+	// Transform pass as it was performed on the legacy component
+	class LegacyTransformPass
+	{
+	public:
+		explicit LegacyTransformPass(entt::registry& registry) : registry(registry)
+		{
+		}
+
+		void perform(const glm::mat4& viewProjection)
+		{
+			for (auto [entity, transform] : registry.view<LegacyTransformComponent>().each()) {
+				if (!transform.depth) evaluate(transform, nullptr, false);
+				transform.mvp = viewProjection * transform.model;
+			}
+		}
+
+	private:
+		entt::registry& registry;
+
+		void evaluate(LegacyTransformComponent& transform, LegacyTransformComponent* parent, bool propagateModified)
+		{
+			if (propagateModified) transform.modified = true;
+
+			if (transform.modified) {
+				glm::mat4 local = Transformation::model(transform.position, transform.rotation, transform.scale);
+				transform.model = parent ? parent->model * local : local;
+				transform.normal = Transformation::normal(transform.model);
+			}
+
+			for (Entity child : transform.children) {
+				evaluate(registry.get<LegacyTransformComponent>(child), &transform, transform.modified);
+			}
+
+			transform.modified = false;
+		}
+	};
+
+	glm::vec3 positionOf(uint32_t i)
+	{
+		return glm::vec3(static_cast<float>(i % 1000), static_cast<float>(i / 1000), 0.0f);
+	}
+
+	void populate(entt::registry& registry)
+	{
+		std::vector<Entity> entities(N_ENTITIES);
+		registry.create(entities.begin(), entities.end());
+		for (uint32_t i = 0; i < N_ENTITIES; i++) {
+			LegacyTransformComponent& transform = registry.emplace<LegacyTransformComponent>(entities[i]);
+			transform.id = i + 1;
+			transform.name = "Entity " + std::to_string(i);
+			transform.position = positionOf(i);
+
+			if (i % GROUP_SIZE == 0) continue;
+			Entity parent = entities[i - i % GROUP_SIZE];
+			transform.parent = parent;
+			transform.depth = 1;
+			registry.get<LegacyTransformComponent>(parent).children.push_back(entities[i]);
+		}
+	}
+
+	void populate(ECS& ecs)
+	{
+		std::vector<Entity> entities(N_ENTITIES);
+		for (uint32_t i = 0; i < N_ENTITIES; i++) {
+			auto [entity, transform] = i % GROUP_SIZE == 0 ? ecs.createEntity("Entity " + std::to_string(i)) : ecs.createEntity("Entity " + std::to_string(i), entities[i - i % GROUP_SIZE]);
+			transform.position = positionOf(i);
+			entities[i] = entity;
+		}
+	}
+
+	// Runs a pass for all frames, optionally modifying every transform before each frame, reports the bandwidth of the transform pool
+	template <typename Component, typename Modify, typename Pass>
+	void run(const std::string& label, Modify&& modify, Pass&& pass)
+	{
+		double ms = Bench::measure(label, static_cast<uint64_t>(N_ENTITIES) * N_FRAMES, [&]() {
+			for (uint32_t i = 0; i < N_FRAMES; i++) {
+				modify();
+				pass();
+			}
+			});
+
+		double bytes = static_cast<double>(sizeof(Component)) * N_ENTITIES * N_FRAMES;
+		std::printf("  %-40s %10.2f GB/s (%zu bytes per transform)\n", "", bytes / (ms * 1e6), sizeof(Component));
+	}
+
+}
+
+BENCHMARK(TransformPassBandwidth)
+{
+	glm::mat4 viewProjection = Transformation::projection(70.0f, 16.0f / 9.0f, 0.3f, 1000.0f);
+
+	// Legacy layout
+	entt::registry legacy;
+	populate(legacy);
+	LegacyTransformPass legacyPass(legacy);
+
+	// Current layout, the engine pass works on the main ecs
+	if (!entt::locator<ECS>::has_value()) entt::locator<ECS>::emplace();
+	ECS& ecs = ECS::main();
+	populate(ecs);
+	TransformPass pass;
+
+	auto noChange = []() {};
+	auto modifyLegacy = [&]() { for (auto [entity, transform] : legacy.view<LegacyTransformComponent>().each()) transform.modified = true; };
+	auto modifyCurrent = [&]() { for (auto [entity, transform] : ecs.view<TransformComponent>().each()) transform.modified = true; };
+
+	run<LegacyTransformComponent>("before, static", noChange, [&]() { legacyPass.perform(viewProjection); });
+	run<TransformComponent>("after, static", noChange, [&]() { pass.perform(viewProjection); });
+
+	run<LegacyTransformComponent>("before, all moving", modifyLegacy, [&]() { legacyPass.perform(viewProjection); });
+	run<TransformComponent>("after, all moving", modifyCurrent, [&]() { pass.perform(viewProjection); });
+
+	uint64_t checksum = 0;
+	for (auto [entity, transform] : ecs.view<TransformComponent>().each()) checksum += static_cast<uint64_t>(transform.mvp[3][0]);
+	for (auto [entity, transform] : legacy.view<LegacyTransformComponent>().each()) checksum += static_cast<uint64_t>(transform.mvp[3][0]);
+	Bench::consume(checksum);
+}
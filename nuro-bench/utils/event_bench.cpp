@@ -0,0 +1,134 @@
+#include "../bench.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+#include <utils/event.h>
+
+//
+// Compares events dispatching to inline stored callbacks in a slot map with the
+// events they replaced, shared pointers to std::function wrappers in a vector
+//
+
+namespace {
+
+	constexpr uint32_t N_DISPATCHES = 5'000'000;
+	constexpr uint32_t N_SUBSCRIBERS = 8;
+	constexpr uint32_t N_CHURN = 1'000'000;
+
+	template <typename... Args>
+	class LegacyCallback
+	{
+	public:
+		using FuncType = std::function<void(Args...)>;
+
+		LegacyCallback() = default;
+		LegacyCallback(FuncType func) : callback(std::move(func)) {};
+
+		void operator()(Args... args) const
+		{
+			if (callback) callback(std::forward<Args>(args)...);
+		}
+
+	private:
+		FuncType callback;
+	};
+
+	template <typename... Args>
+	class LegacyEvent {
+	public:
+		using FuncType = std::function<void(Args...)>;
+		using CallbackType = LegacyCallback<Args...>;
+		using CallbackPointer = std::shared_ptr<CallbackType>;
+
+		CallbackPointer subscribe(FuncType func) {
+			auto callbackPointer = std::make_shared<CallbackType>(std::move(func));
+			callbacks.emplace_back(callbackPointer);
+			return callbackPointer;
+		}
+
+		void unsubscribe(CallbackPointer callback) {
+			callbacks.erase(std::remove(callbacks.begin(), callbacks.end(), callback), callbacks.end());
+		}
+
+		void operator()(Args... args) const {
+			for (const auto& callback : callbacks) {
+				if (callback) {
+					(*callback)(std::forward<Args>(args)...);
+				}
+			}
+		}
+
+	private:
+		std::vector<CallbackPointer> callbacks;
+	};
+
+	// Dispatches to a few subscribers capturing a pointer and an index, the typical editor and ecs listener
+	template <typename E>
+	void dispatch(const std::string& label)
+	{
+		E event;
+		uint64_t sum = 0;
+		for (uint32_t i = 0; i < N_SUBSCRIBERS; i++) {
+			event.subscribe([&sum, i](const std::string& message, uint32_t value) { sum += message.size() + value + i; });
+		}
+
+		std::string message = "entity";
+		Bench::measure(label, N_DISPATCHES, [&]() {
+			for (uint32_t i = 0; i < N_DISPATCHES; i++) event(message, i);
+			});
+		Bench::consume(sum);
+	}
+
+	// Dispatches a string by value to subscribers only reading it, long enough to not fit the small string buffer
+	template <typename E>
+	void dispatchByValue(const std::string& label)
+	{
+		E event;
+		uint64_t sum = 0;
+		for (uint32_t i = 0; i < N_SUBSCRIBERS; i++) {
+			event.subscribe([&sum, i](const std::string& message) { sum += message.size() + i; });
+		}
+
+		std::string message = "entity with a long name";
+		Bench::measure(label, N_DISPATCHES, [&]() {
+			for (uint32_t i = 0; i < N_DISPATCHES; i++) event(message);
+			});
+		Bench::consume(sum);
+	}
+
+	// Subscribes and unsubscribes a listener next to a few permanent ones
+	template <typename E>
+	void churn(const std::string& label)
+	{
+		E event;
+		uint64_t sum = 0;
+		for (uint32_t i = 0; i < N_SUBSCRIBERS; i++) {
+			event.subscribe([&sum, i](const std::string&, uint32_t value) { sum += value + i; });
+		}
+
+		Bench::measure(label, N_CHURN, [&]() {
+			for (uint32_t i = 0; i < N_CHURN; i++) {
+				auto handle = event.subscribe([&sum, i](const std::string&, uint32_t value) { sum += value ^ i; });
+				event.unsubscribe(handle);
+			}
+			});
+		Bench::consume(sum);
+	}
+
+}
+
+BENCHMARK(EventDispatch)
+{
+	dispatch<LegacyEvent<const std::string&, uint32_t>>("before, dispatch to 8 subscribers");
+	dispatch<Event<const std::string&, uint32_t>>("after, dispatch to 8 subscribers");
+
+	dispatchByValue<LegacyEvent<std::string>>("before, dispatch string by value");
+	dispatchByValue<Event<std::string>>("after, dispatch string by value");
+
+	churn<LegacyEvent<const std::string&, uint32_t>>("before, subscribe and unsubscribe");
+	churn<Event<const std::string&, uint32_t>>("after, subscribe and unsubscribe");
+}
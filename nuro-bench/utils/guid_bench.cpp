@@ -0,0 +1,55 @@
+#include "../bench.h"
+
+#include <array>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <string_view>
+
+#include <utils/guid.h>
+
+namespace {
+
+	constexpr uint32_t N_GUIDS = 10'000'000;
+
+	// String form of a guid including its null terminator
+	using GUIDString = std::array<char, XG::GUID::STRING_LENGTH + 1>;
+
+}
+
+BENCHMARK(GuidCodec)
+{
+	std::vector<XG::GUID> guids(N_GUIDS);
+	Bench::measure("create", N_GUIDS, [&]() {
+		for (XG::GUID& guid : guids) guid = XG::createGUID();
+		});
+
+	// Encode into fixed buffers and into strings as asset metas do
+	std::vector<GUIDString> strings(N_GUIDS);
+	Bench::measure("encode into buffer", N_GUIDS, [&]() {
+		for (uint32_t i = 0; i < N_GUIDS; i++) guids[i].str(strings[i].data());
+		});
+
+	uint64_t length = 0;
+	Bench::measure("encode into string", N_GUIDS, [&]() {
+		for (const XG::GUID& guid : guids) length += guid.str().size();
+		});
+	Bench::consume(length);
+
+	// Decode and check the round trip
+	uint32_t nMismatches = 0;
+	Bench::measure("decode", N_GUIDS, [&]() {
+		for (uint32_t i = 0; i < N_GUIDS; i++) {
+			XG::GUID decoded(std::string_view(strings[i].data(), XG::GUID::STRING_LENGTH));
+			if (decoded != guids[i]) nMismatches++;
+		}
+		});
+	if (nMismatches) std::printf("  %u guids didn't survive the round trip\n", nMismatches);
+
+	uint64_t hash = 0;
+	std::hash<XG::GUID> hasher;
+	Bench::measure("hash", N_GUIDS, [&]() {
+		for (const XG::GUID& guid : guids) hash ^= hasher(guid);
+		});
+	Bench::consume(hash);
+}
@@ -0,0 +1,137 @@
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+
+#include <diagnostics/frame_capture.h>
+
+//
+// Headless analysis of frame captures written by the frame recorder
+//
+// nuro-capture stats <capture>
+// nuro-capture compare <baseline> <candidate> [threshold %]
+// nuro-capture convert <capture> <output>
+//
+
+namespace {
+
+	// Default relative increase of a percentile flagged as regression
+	constexpr float DEFAULT_THRESHOLD = 5.0f;
+
+	// Increases below this absolute value are considered noise
+	constexpr float NOISE_FLOOR = 0.01f;
+
+	void printUsage()
+	{
+		std::printf("usage:\n");
+		std::printf("  nuro-capture stats <capture>\n");
+		std::printf("  nuro-capture compare <baseline> <candidate> [threshold %%, default %.0f]\n", DEFAULT_THRESHOLD);
+		std::printf("  nuro-capture convert <capture> <output (.csv or binary)>\n");
+	}
+
+	bool loadCapture(const char* path, FrameCapture& capture)
+	{
+		if (!capture.load(path)) {
+			std::fprintf(stderr, "couldn't read capture '%s'\n", path);
+			return false;
+		}
+		return true;
+	}
+
+	// Returns relative change from baseline to candidate in percent
+	float change(float baseline, float candidate)
+	{
+		if (std::abs(baseline) < 1e-6f) return candidate > NOISE_FLOOR ? 100.0f : 0.0f;
+		return (candidate - baseline) / std::abs(baseline) * 100.0f;
+	}
+
+	// Returns if candidate regressed from baseline, all recorded metrics are better when lower
+	bool regressed(float baseline, float candidate, float threshold)
+	{
+		return candidate - baseline > NOISE_FLOOR && change(baseline, candidate) > threshold;
+	}
+
+	int32_t stats(const char* path)
+	{
+		FrameCapture capture;
+		if (!loadCapture(path, capture)) return 2;
+
+		std::printf("%u frames\n\n", capture.nFrames());
+		std::printf("%-32s %10s %10s %10s %10s %10s\n", "metric", "mean", "p50", "p90", "p99", "max");
+		for (uint32_t i = 0; i < capture.nColumns(); i++) {
+			std::printf("%-32s %10.3f %10.3f %10.3f %10.3f %10.3f\n",
+				capture.getColumns()[i].c_str(),
+				capture.mean(i),
+				capture.percentile(i, 50.0f),
+				capture.percentile(i, 90.0f),
+				capture.percentile(i, 99.0f),
+				capture.percentile(i, 100.0f));
+		}
+
+		return 0;
+	}
+
+	int32_t compare(const char* baselinePath, const char* candidatePath, float threshold)
+	{
+		FrameCapture baseline;
+		FrameCapture candidate;
+		if (!loadCapture(baselinePath, baseline) || !loadCapture(candidatePath, candidate)) return 2;
+
+		std::printf("%u baseline frames, %u candidate frames, threshold %.1f%%\n\n", baseline.nFrames(), candidate.nFrames(), threshold);
+		std::printf("%-32s %10s %10s %8s %10s %10s %8s\n", "metric", "base p50", "cand p50", "p50 %", "base p99", "cand p99", "p99 %");
+
+		uint32_t nRegressions = 0;
+		for (uint32_t i = 0; i < baseline.nColumns(); i++) {
+			const std::string& name = baseline.getColumns()[i];
+			int32_t j = candidate.findColumn(name);
+			if (j < 0) continue;
+
+			float baseP50 = baseline.percentile(i, 50.0f);
+			float candP50 = candidate.percentile(j, 50.0f);
+			float baseP99 = baseline.percentile(i, 99.0f);
+			float candP99 = candidate.percentile(j, 99.0f);
+
+			bool regression = regressed(baseP50, candP50, threshold) || regressed(baseP99, candP99, threshold);
+			if (regression) nRegressions++;
+
+			std::printf("%-32s %10.3f %10.3f %+7.1f%% %10.3f %10.3f %+7.1f%%%s\n",
+				name.c_str(),
+				baseP50, candP50, change(baseP50, candP50),
+				baseP99, candP99, change(baseP99, candP99),
+				regression ? "  REGRESSION" : "");
+		}
+
+		std::printf("\n%u regression(s)\n", nRegressions);
+		return nRegressions > 0 ? 1 : 0;
+	}
+
+	int32_t convert(const char* inputPath, const std::string& outputPath)
+	{
+		FrameCapture capture;
+		if (!loadCapture(inputPath, capture)) return 2;
+
+		bool csv = outputPath.size() >= 4 && outputPath.compare(outputPath.size() - 4, 4, ".csv") == 0;
+		bool written = csv ? capture.saveCsv(outputPath) : capture.saveBinary(outputPath);
+		if (!written) {
+			std::fprintf(stderr, "couldn't write capture '%s'\n", outputPath.c_str());
+			return 2;
+		}
+
+		return 0;
+	}
+
+}
+
+// Exits with 1 if a comparison found regressions, 2 on errors
+int main(int argc, char** argv)
+{
+	std::string command = argc > 1 ? argv[1] : "";
+
+	if (command == "stats" && argc == 3) return stats(argv[2]);
+	if (command == "compare" && (argc == 4 || argc == 5)) return compare(argv[2], argv[3], argc == 5 ? std::strtof(argv[4], nullptr) : DEFAULT_THRESHOLD);
+	if (command == "convert" && argc == 4) return convert(argv[2], argv[3]);
+
+	printUsage();
+	return 2;
+}
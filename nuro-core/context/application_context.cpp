@@ -14,8 +14,12 @@ extern "C"
 #include <input/input.h>
 #include <input/cursor.h>
 #include <utils/console.h>
+#include <transform/transform.h>
+#include <diagnostics/profiler.h>
 #include <diagnostics/diagnostics.h>
+#include <diagnostics/gl_gpu_timer_backend.h>
 #include <rendering/primitives/global_quad.h>
+#include <rendering/batching/gl_frame_allocator_backend.h>
 
 namespace ApplicationContext {
 
@@ -36,6 +40,35 @@ namespace ApplicationContext {
 	// Global resource manager
 	ResourceManager gResourceManager;
 
+	// Global allocator for dynamic per frame gpu data
+	FrameAllocator gFrameAllocator(std::make_unique<GLFrameAllocatorBackend>());
+
+	// Global gpu profiler measuring passes
+	GPUProfiler gGPUProfiler(std::make_unique<GLGPUTimerBackend>());
+
+	// Size of each frame region of the global frame allocator
+	constexpr uint32_t gFrameRegionSize = 8 * 1024 * 1024;
+
+	// Global cache of all lights, gathered once per frame
+	LightCache gLightCache;
+
+	// Global recorder of per frame metrics
+	FrameRecorder gFrameRecorder;
+
+	// Passes timed by the global frame recorder
+	const std::vector<std::string> gRecordedPasses = {
+		"render",
+		"shadow_pass",
+		"cascaded_shadow_pass",
+		"pre_pass",
+		"ssao",
+		"forward_pass",
+		"forward_depth",
+		"post_processing",
+		"ui_pass",
+		"scene_view"
+	};
+
 	// Default glfw error callback
 	static void _glfwErrorCallback(int32_t error, const char* description)
 	{
@@ -67,6 +100,24 @@ namespace ApplicationContext {
 		}
 	}
 
+	// Enables parallel shader compilation if supported, programs linked without querying their status are then built concurrently
+	void _enableParallelShaderCompile()
+	{
+		using MaxShaderCompilerThreadsFn = void(*)(GLuint);
+
+		const char* function = nullptr;
+		if (glfwExtensionSupported("GL_KHR_parallel_shader_compile")) function = "glMaxShaderCompilerThreadsKHR";
+		else if (glfwExtensionSupported("GL_ARB_parallel_shader_compile")) function = "glMaxShaderCompilerThreadsARB";
+		if (!function) return;
+
+		auto maxShaderCompilerThreads = reinterpret_cast<MaxShaderCompilerThreadsFn>(glfwGetProcAddress(function));
+		if (!maxShaderCompilerThreads) return;
+
+		// Maximum value leaves the amount of threads up to the driver
+		maxShaderCompilerThreads(0xFFFFFFFF);
+		Console::out::info("Application Context", "Parallel shader compilation enabled");
+	}
+
 	// Loads graphics backend
 	void _loadBackend()
 	{
@@ -80,6 +131,9 @@ namespace ApplicationContext {
 		// Debug graphics api version
 		const char* version = (const char*)glGetString(GL_VERSION);
 		Console::out::info("Application Context", "Initialized, OpenGL version: " + std::string(version));
+
+		// Let the driver compile shaders on as many threads as it likes
+		_enableParallelShaderCompile();
 	}
 
 	void create(Configuration configuration)
@@ -181,11 +235,36 @@ namespace ApplicationContext {
 		// Create essential primitives
 		GlobalQuad::create();
 
+		// Create frame allocator
+		gFrameAllocator.create(gFrameRegionSize);
+
+		// Create light cache
+		gLightCache.create();
+
+		// Measure passes on the gpu too
+		Profiler::setGPUProfiler(&gGPUProfiler);
+
+		// Create frame recorder
+		gFrameRecorder.create(FrameRecorder::DEFAULT_CAPACITY, gRecordedPasses);
+
 		Console::out::done("Application Context", "Created application context");
 	}
 
 	void destroy()
 	{
+		// Destroy frame recorder
+		gFrameRecorder.destroy();
+
+		// Destroy light cache
+		gLightCache.destroy();
+
+		// Destroy frame allocator
+		gFrameAllocator.destroy();
+
+		// Destroy gpu profiler
+		Profiler::setGPUProfiler(nullptr);
+		gGPUProfiler.destroy();
+
 		// Destroy audio context
 		gAudioContext.destroy();
 
@@ -215,6 +294,18 @@ namespace ApplicationContext {
 		// Update diagnostics
 		Diagnostics::step();
 
+		// Keep transforms of last frame for motion vectors
+		Transform::step();
+
+		// Advance to next frame region of frame allocator
+		gFrameAllocator.beginFrame();
+
+		// Read back gpu times of past frames
+		gGPUProfiler.beginFrame();
+
+		// Record metrics of completed frame
+		gFrameRecorder.record();
+
 		// Update input system
 		Input::update();
 
@@ -224,6 +315,9 @@ namespace ApplicationContext {
 
 	void endFrame()
 	{
+		// Fence all frame allocations of this frame
+		gFrameAllocator.endFrame();
+
 		// Swap gWindow buffers
 		glfwSwapBuffers(gWindow);
 	}
@@ -405,4 +499,19 @@ namespace ApplicationContext {
 		return gResourceManager;
 	}
 
+	FrameAllocator& frameAllocator()
+	{
+		return gFrameAllocator;
+	}
+
+	LightCache& lightCache()
+	{
+		return gLightCache;
+	}
+
+	FrameRecorder& frameRecorder()
+	{
+		return gFrameRecorder;
+	}
+
 }
\ No newline at end of file
@@ -5,8 +5,11 @@
 
 #include <backend/api.h>
 #include <audio/audio_context.h>
+#include <memory/frame_allocator.h>
 #include <memory/resource_manager.h>
+#include <diagnostics/frame_recorder.h>
 #include <physics/core/physics_context.h>
+#include <rendering/lighting/light_cache.h>
 
 struct GLFWwindow;
 struct GLFWmonitor;
@@ -92,4 +95,13 @@ namespace ApplicationContext
 	// Returns the resource manager
 	ResourceManager& resourceManager();
 
+	// Returns the allocator for dynamic per frame gpu data
+	FrameAllocator& frameAllocator();
+
+	// Returns the per frame cache of all lights
+	LightCache& lightCache();
+
+	// Returns the recorder of per frame metrics
+	FrameRecorder& frameRecorder();
+
 };
\ No newline at end of file
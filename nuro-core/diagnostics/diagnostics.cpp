@@ -1,5 +1,7 @@
 #include "diagnostics.h"
 
+#include <algorithm>
+
 #include <time/time.h>
 
 namespace Diagnostics {
@@ -10,25 +12,48 @@ namespace Diagnostics {
 	float gAverageFpsFrameCount = 0.0f; // Frame counter for average fps calculation
 	float gAverageFpsElapsedTime = 0.0f; // Elapsed time since beginning of last fps period
 
-	uint32_t gCurrentDrawCalls = 0;
-	uint32_t gCurrentVertices = 0;
-	uint32_t gCurrentPolygons = 0;
+	FrameDrawStats gCurrentDrawStats;
+	FrameDrawStats gLastDrawStats;
+	std::vector<uint32_t> gPassStack; // Indices of currently running passes within current draw stats, innermost last
+
+	DrawStats gDrawStatsHistory[DRAW_STATS_HISTORY]; // Ring of total draw stats of past frames
+	uint32_t gDrawStatsHistoryHead = 0; // Index of last completed frame within history
 
 	uint32_t gNCPUEntities = 0;
 	uint32_t gNGPUEntities = 0;
 
+	uint32_t gCurrentShadowCasters = 0;
+	uint32_t gCurrentShadowCastersCulled = 0;
+	float gShadowSkipRate = 0.0f;
+	uint32_t gShadowRenderCount = 0; // Shadow map renders of current fps period
+	uint32_t gShadowSkipCount = 0; // Skipped shadow map renders of current fps period
+
+	DrawStats* _passStats()
+	{
+		if (gPassStack.empty()) return nullptr;
+		return &gCurrentDrawStats.passes[gPassStack.back()].stats;
+	}
+
 	void step()
 	{
 		float delta = Time::unscaledDeltaf();
 
+		// Archive draw stats of completed frame
+		std::swap(gLastDrawStats, gCurrentDrawStats);
+		gDrawStatsHistoryHead = (gDrawStatsHistoryHead + 1) % DRAW_STATS_HISTORY;
+		gDrawStatsHistory[gDrawStatsHistoryHead] = gLastDrawStats.total;
+
 		// Reset frame based diagnostics
-		gCurrentDrawCalls = 0;
-		gCurrentVertices = 0;
-		gCurrentPolygons = 0;
+		gCurrentDrawStats.total = DrawStats();
+		gCurrentDrawStats.passes.clear();
+		gPassStack.clear();
 
 		gNCPUEntities = 0;
 		gNGPUEntities = 0;
 
+		gCurrentShadowCasters = 0;
+		gCurrentShadowCastersCulled = 0;
+
 		// Calculate current fps
 		gFps = 1.0 / delta;
 
@@ -40,6 +65,11 @@ namespace Diagnostics {
 			gAverageFps = gAverageFpsFrameCount / gAverageFpsElapsedTime;
 			gAverageFpsElapsedTime = 0.0f;
 			gAverageFpsFrameCount = 0;
+
+			// Calculate shadow skip rate of fps period
+			gShadowSkipRate = gShadowRenderCount > 0 ? static_cast<float>(gShadowSkipCount) / gShadowRenderCount : 0.0f;
+			gShadowRenderCount = 0;
+			gShadowSkipCount = 0;
 		}
 	}
 
@@ -53,19 +83,56 @@ namespace Diagnostics {
 		return gAverageFps;
 	}
 
+	void beginPass(const std::string& identifier)
+	{
+		// Passes running multiple times per frame accumulate into the same entry
+		uint32_t index = 0;
+		std::vector<PassDrawStats>& passes = gCurrentDrawStats.passes;
+		while (index < passes.size() && passes[index].identifier != identifier) index++;
+		if (index == passes.size()) passes.push_back({ identifier, DrawStats() });
+
+		gPassStack.push_back(index);
+	}
+
+	void endPass()
+	{
+		if (!gPassStack.empty()) gPassStack.pop_back();
+	}
+
+	const FrameDrawStats& getCurrentDrawStats()
+	{
+		return gCurrentDrawStats;
+	}
+
+	const FrameDrawStats& getLastDrawStats()
+	{
+		return gLastDrawStats;
+	}
+
+	const DrawStats& getDrawStatsHistory(const uint32_t framesAgo)
+	{
+		uint32_t offset = std::min(framesAgo, DRAW_STATS_HISTORY - 1);
+		return gDrawStatsHistory[(gDrawStatsHistoryHead + DRAW_STATS_HISTORY - offset) % DRAW_STATS_HISTORY];
+	}
+
 	const uint32_t getCurrentDrawCalls()
 	{
-		return gCurrentDrawCalls;
+		return gCurrentDrawStats.total.drawCalls;
 	}
 
 	const uint32_t getCurrentVertices()
 	{
-		return gCurrentVertices;
+		return gCurrentDrawStats.total.vertices;
 	}
 
 	const uint32_t getCurrentPolygons()
 	{
-		return gCurrentPolygons;
+		return gCurrentDrawStats.total.polygons;
+	}
+
+	const uint32_t getCurrentInstancedDrawsSaved()
+	{
+		return gCurrentDrawStats.total.instancedDrawsSaved;
 	}
 
 	const uint32_t getNEntitiesCPU()
@@ -78,19 +145,60 @@ namespace Diagnostics {
 		return gNGPUEntities;
 	}
 
-	const void addCurrentDrawCalls(const uint32_t increment)
+	const uint32_t getCurrentShadowCasters()
 	{
-		gCurrentDrawCalls += increment;
+		return gCurrentShadowCasters;
 	}
 
-	const void addCurrentVertices(const uint32_t increment)
+	const uint32_t getCurrentShadowCastersCulled()
 	{
-		gCurrentVertices += increment;
+		return gCurrentShadowCastersCulled;
 	}
 
-	const void addCurrentPolygons(const uint32_t increment)
+	const float getShadowSkipRate()
 	{
-		gCurrentPolygons += increment;
+		return gShadowSkipRate;
+	}
+
+	const void addDrawCall(const uint32_t vertices, const uint32_t polygons, const uint32_t instances)
+	{
+		for (DrawStats* stats : { &gCurrentDrawStats.total, _passStats() }) {
+			if (!stats) continue;
+			stats->drawCalls++;
+			stats->vertices += vertices;
+			stats->polygons += polygons;
+			stats->instances += instances;
+		}
+	}
+
+	const void addShaderBind()
+	{
+		gCurrentDrawStats.total.shaderBinds++;
+		if (DrawStats* stats = _passStats()) stats->shaderBinds++;
+	}
+
+	const void addMaterialBind()
+	{
+		gCurrentDrawStats.total.materialBinds++;
+		if (DrawStats* stats = _passStats()) stats->materialBinds++;
+	}
+
+	const void addVaoBind()
+	{
+		gCurrentDrawStats.total.vaoBinds++;
+		if (DrawStats* stats = _passStats()) stats->vaoBinds++;
+	}
+
+	const void addUploadedBytes(const uint64_t bytes)
+	{
+		gCurrentDrawStats.total.uploadedBytes += bytes;
+		if (DrawStats* stats = _passStats()) stats->uploadedBytes += bytes;
+	}
+
+	const void addCurrentInstancedDrawsSaved(const uint32_t increment)
+	{
+		gCurrentDrawStats.total.instancedDrawsSaved += increment;
+		if (DrawStats* stats = _passStats()) stats->instancedDrawsSaved += increment;
 	}
 
 	const void addNEntitiesCPU(const uint32_t increment)
@@ -103,4 +211,20 @@ namespace Diagnostics {
 		gNGPUEntities += increment;
 	}
 
+	const void addCurrentShadowCasters(const uint32_t increment)
+	{
+		gCurrentShadowCasters += increment;
+	}
+
+	const void addCurrentShadowCastersCulled(const uint32_t increment)
+	{
+		gCurrentShadowCastersCulled += increment;
+	}
+
+	const void addShadowRender(const bool skipped)
+	{
+		gShadowRenderCount++;
+		if (skipped) gShadowSkipCount++;
+	}
+
 }
\ No newline at end of file
@@ -1,25 +1,75 @@
 #pragma once
 
+#include <string>
+#include <vector>
 #include <cstdint>
 
 namespace Diagnostics
 {
 
+	// Amount of frames draw stats are kept for
+	constexpr uint32_t DRAW_STATS_HISTORY = 240;
+
+	// Draw submissions and state changes of a pass or frame
+	struct DrawStats
+	{
+		uint32_t drawCalls = 0; // Draw calls issued
+		uint32_t vertices = 0; // Indices (or vertices of non indexed draws) processed by all instances
+		uint32_t polygons = 0; // Triangles rendered by all instances
+		uint32_t instances = 0; // Instances drawn
+		uint32_t instancedDrawsSaved = 0; // Draws saved by merging identical draws into instances
+		uint32_t shaderBinds = 0; // Shader programs bound
+		uint32_t materialBinds = 0; // Materials bound
+		uint32_t vaoBinds = 0; // Vertex arrays bound
+		uint64_t uploadedBytes = 0; // Bytes uploaded to gpu buffers
+	};
+
+	// Draw stats of a single pass, draws of nested passes only count towards the innermost pass
+	struct PassDrawStats
+	{
+		std::string identifier;
+		DrawStats stats;
+	};
+
+	// Draw stats of a frame
+	struct FrameDrawStats
+	{
+		DrawStats total; // Stats of all draws, including draws outside of any pass
+		std::vector<PassDrawStats> passes; // Stats of each pass in order of their first start
+	};
+
 	void step(); // Prepares diagnostics for next frame
 
 	const float getFps(); // Current fps
 	const float getAverageFps(); // Average fps of last fps period
 
+	void beginPass(const std::string& identifier); // Attributes upcoming draw stats to given pass until it ends
+	void endPass(); // Ends current pass, upcoming draw stats are attributed to the enclosing pass again
+
+	const FrameDrawStats& getCurrentDrawStats(); // Draw stats of this frame so far
+	const FrameDrawStats& getLastDrawStats(); // Draw stats of last completed frame
+	const DrawStats& getDrawStatsHistory(const uint32_t framesAgo); // Total draw stats of a past frame, 0 is last completed frame
+
 	const uint32_t getCurrentDrawCalls(); // Draw calls issued this frame
 	const uint32_t getCurrentVertices(); // Vertices rendered this frame
 	const uint32_t getCurrentPolygons(); // Polygons rendered this frame
+	const uint32_t getCurrentInstancedDrawsSaved(); // Draws saved this frame by merging identical draws into instances
 	const uint32_t getNEntitiesCPU(); // Entities handled on the cpu this frame
 	const uint32_t getNEntitiesGPU(); // Entities handled on the gpu this frame
+	const uint32_t getCurrentShadowCasters(); // Shadow casters drawn this frame
+	const uint32_t getCurrentShadowCastersCulled(); // Shadow casters culled by light frustums this frame
+	const float getShadowSkipRate(); // Share of shadow map renders skipped during last fps period
 
-	const void addCurrentDrawCalls(const uint32_t increment);
-	const void addCurrentVertices(const uint32_t increment);
-	const void addCurrentPolygons(const uint32_t increment);
+	const void addDrawCall(const uint32_t vertices, const uint32_t polygons, const uint32_t instances); // Reports a draw call, counts are for all instances
+	const void addShaderBind();
+	const void addMaterialBind();
+	const void addVaoBind();
+	const void addUploadedBytes(const uint64_t bytes);
+	const void addCurrentInstancedDrawsSaved(const uint32_t increment);
 	const void addNEntitiesCPU(const uint32_t increment);
 	const void addNEntitiesGPU(const uint32_t increment);
+	const void addCurrentShadowCasters(const uint32_t increment);
+	const void addCurrentShadowCastersCulled(const uint32_t increment);
+	const void addShadowRender(const bool skipped); // Reports a shadow map render, skipped if shadow map was still valid
 
 };
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include "frame_capture.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+FrameCapture::FrameCapture() : columns(),
+values()
+{
+}
+
+FrameCapture::FrameCapture(std::vector<std::string> columns) : columns(std::move(columns)),
+values()
+{
+}
+
+void FrameCapture::clear()
+{
+	values.clear();
+}
+
+void FrameCapture::addFrame(const float* frameValues)
+{
+	values.insert(values.end(), frameValues, frameValues + columns.size());
+}
+
+uint32_t FrameCapture::nColumns() const
+{
+	return static_cast<uint32_t>(columns.size());
+}
+
+uint32_t FrameCapture::nFrames() const
+{
+	return columns.empty() ? 0 : static_cast<uint32_t>(values.size() / columns.size());
+}
+
+const std::vector<std::string>& FrameCapture::getColumns() const
+{
+	return columns;
+}
+
+int32_t FrameCapture::findColumn(const std::string& name) const
+{
+	auto it = std::find(columns.begin(), columns.end(), name);
+	return it != columns.end() ? static_cast<int32_t>(it - columns.begin()) : -1;
+}
+
+float FrameCapture::value(uint32_t frame, uint32_t column) const
+{
+	return values[static_cast<size_t>(frame) * columns.size() + column];
+}
+
+float FrameCapture::percentile(uint32_t column, float percent) const
+{
+	uint32_t n = nFrames();
+	if (n == 0) return 0.0f;
+
+	std::vector<float> sorted(n);
+	for (uint32_t i = 0; i < n; i++) {
+		sorted[i] = value(i, column);
+	}
+
+	// Nearest rank
+	float clamped = std::clamp(percent, 0.0f, 100.0f);
+	uint32_t rank = static_cast<uint32_t>(std::ceil(clamped / 100.0f * n));
+	uint32_t index = rank > 0 ? rank - 1 : 0;
+
+	std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+	return sorted[index];
+}
+
+float FrameCapture::mean(uint32_t column) const
+{
+	uint32_t n = nFrames();
+	if (n == 0) return 0.0f;
+
+	double sum = 0.0;
+	for (uint32_t i = 0; i < n; i++) {
+		sum += value(i, column);
+	}
+	return static_cast<float>(sum / n);
+}
+
+bool FrameCapture::saveBinary(const std::filesystem::path& path) const
+{
+	std::ofstream stream(path, std::ios::binary);
+	if (!stream) return false;
+
+	// Header
+	uint32_t nColumns = this->nColumns();
+	uint32_t nFrames = this->nFrames();
+	stream.write(MAGIC, sizeof(MAGIC));
+	stream.write(reinterpret_cast<const char*>(&VERSION), sizeof(VERSION));
+	stream.write(reinterpret_cast<const char*>(&nColumns), sizeof(nColumns));
+	stream.write(reinterpret_cast<const char*>(&nFrames), sizeof(nFrames));
+
+	// Column names, length prefixed
+	for (const std::string& column : columns) {
+		uint16_t length = static_cast<uint16_t>(std::min<size_t>(column.size(), UINT16_MAX));
+		stream.write(reinterpret_cast<const char*>(&length), sizeof(length));
+		stream.write(column.data(), length);
+	}
+
+	// Values of all frames
+	stream.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(static_cast<size_t>(nFrames) * nColumns * sizeof(float)));
+
+	return static_cast<bool>(stream);
+}
+
+bool FrameCapture::saveCsv(const std::filesystem::path& path) const
+{
+	std::ofstream stream(path);
+	if (!stream) return false;
+
+	// Header row
+	for (size_t i = 0; i < columns.size(); i++) {
+		if (i > 0) stream << ',';
+		stream << columns[i];
+	}
+	stream << '\n';
+
+	// Row per frame
+	char buffer[32];
+	uint32_t nFrames = this->nFrames();
+	for (uint32_t frame = 0; frame < nFrames; frame++) {
+		for (uint32_t column = 0; column < columns.size(); column++) {
+			if (column > 0) stream << ',';
+			std::snprintf(buffer, sizeof(buffer), "%.6g", value(frame, column));
+			stream << buffer;
+		}
+		stream << '\n';
+	}
+
+	return static_cast<bool>(stream);
+}
+
+bool FrameCapture::load(const std::filesystem::path& path)
+{
+	std::ifstream stream(path, std::ios::binary);
+	if (!stream) return false;
+
+	columns.clear();
+	values.clear();
+
+	// Detect format
+	char magic[sizeof(MAGIC)] = {};
+	stream.read(magic, sizeof(magic));
+	if (stream && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0) return loadBinary(stream);
+
+	stream.clear();
+	stream.seekg(0);
+	return loadCsv(stream);
+}
+
+bool FrameCapture::loadBinary(std::istream& stream)
+{
+	uint32_t version = 0;
+	uint32_t nColumns = 0;
+	uint32_t nFrames = 0;
+	stream.read(reinterpret_cast<char*>(&version), sizeof(version));
+	stream.read(reinterpret_cast<char*>(&nColumns), sizeof(nColumns));
+	stream.read(reinterpret_cast<char*>(&nFrames), sizeof(nFrames));
+	if (!stream || version != VERSION) return false;
+
+	// Column names
+	columns.resize(nColumns);
+	for (std::string& column : columns) {
+		uint16_t length = 0;
+		stream.read(reinterpret_cast<char*>(&length), sizeof(length));
+		column.resize(length);
+		stream.read(column.data(), length);
+	}
+
+	// Values of all frames
+	values.resize(static_cast<size_t>(nFrames) * nColumns);
+	stream.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(float)));
+
+	if (!stream) {
+		columns.clear();
+		values.clear();
+		return false;
+	}
+	return true;
+}
+
+bool FrameCapture::loadCsv(std::istream& stream)
+{
+	// Header row
+	std::string line;
+	if (!std::getline(stream, line)) return false;
+	if (!line.empty() && line.back() == '\r') line.pop_back();
+
+	std::stringstream header(line);
+	std::string column;
+	while (std::getline(header, column, ',')) {
+		columns.push_back(column);
+	}
+	if (columns.empty()) return false;
+
+	// Rows, incomplete rows are dropped
+	std::vector<float> row(columns.size());
+	while (std::getline(stream, line)) {
+		const char* cursor = line.c_str();
+		size_t nValues = 0;
+		while (nValues < row.size() && *cursor != '\0' && *cursor != '\r') {
+			char* end = nullptr;
+			float value = std::strtof(cursor, &end);
+			if (end == cursor) break;
+
+			row[nValues++] = value;
+			cursor = *end == ',' ? end + 1 : end;
+		}
+		if (nValues == row.size()) addFrame(row.data());
+	}
+
+	return true;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+
+// Per frame metrics stored in named columns, written to and read from capture files
+// Only depends on the standard library so offline tools can read captures without the engine
+class FrameCapture
+{
+public:
+	// Magic number at the beginning of binary captures
+	static constexpr char MAGIC[4] = { 'N', 'C', 'A', 'P' };
+
+	// Version of binary captures written
+	static constexpr uint32_t VERSION = 1;
+
+	FrameCapture();
+	explicit FrameCapture(std::vector<std::string> columns);
+
+	// Removes all frames, keeps columns
+	void clear();
+
+	// Appends a frame, expects a value for each column
+	void addFrame(const float* frameValues);
+
+	// Returns the amount of columns
+	uint32_t nColumns() const;
+
+	// Returns the amount of frames
+	uint32_t nFrames() const;
+
+	// Returns the names of all columns
+	const std::vector<std::string>& getColumns() const;
+
+	// Returns the index of a column, -1 if there is none with given name
+	int32_t findColumn(const std::string& name) const;
+
+	// Returns the value of a column in a frame
+	float value(uint32_t frame, uint32_t column) const;
+
+	// Returns the value of a column at a percentile (0 - 100) using the nearest rank, 0 if capture is empty
+	float percentile(uint32_t column, float percent) const;
+
+	// Returns the mean value of a column, 0 if capture is empty
+	float mean(uint32_t column) const;
+
+	// Writes capture as compact binary file
+	bool saveBinary(const std::filesystem::path& path) const;
+
+	// Writes capture as csv file with a header row of column names
+	bool saveCsv(const std::filesystem::path& path) const;
+
+	// Reads a binary or csv capture, format is detected by its header
+	bool load(const std::filesystem::path& path);
+
+private:
+	// Reads a binary capture from an opened file
+	bool loadBinary(std::istream& stream);
+
+	// Reads a csv capture from an opened file
+	bool loadCsv(std::istream& stream);
+
+	// Names of all columns
+	std::vector<std::string> columns;
+
+	// Values of all frames, row major
+	std::vector<float> values;
+};
@@ -0,0 +1,224 @@
+#include "frame_recorder.h"
+
+#include <cstdlib>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <time/time.h>
+#include <utils/console.h>
+#include <diagnostics/profiler.h>
+#include <diagnostics/diagnostics.h>
+#include <context/application_context.h>
+
+namespace {
+
+	// Returns the physical memory used by the process in bytes, 0 if unknown
+	// Reads the kept open statm file on linux without allocating
+	uint64_t processMemory(int32_t statmFd)
+	{
+#if defined(_WIN32)
+		PROCESS_MEMORY_COUNTERS counters;
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return counters.WorkingSetSize;
+		return 0;
+#elif defined(__linux__)
+		if (statmFd < 0) return 0;
+
+		char buffer[128];
+		ssize_t length = pread(statmFd, buffer, sizeof(buffer) - 1, 0);
+		if (length <= 0) return 0;
+		buffer[length] = '\0';
+
+		// Resident pages are the second value of statm
+		char* end = nullptr;
+		std::strtoull(buffer, &end, 10);
+		uint64_t resident = std::strtoull(end, nullptr, 10);
+
+		static const uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+		return resident * pageSize;
+#else
+		return 0;
+#endif
+	}
+
+}
+
+FrameRecorder::FrameRecorder() : columns(),
+passes(),
+ring(),
+head(0),
+_nFrames(0),
+_capacity(0),
+enabled(true),
+memoryCountdown(0),
+processMb(0.0f),
+statmFd(-1)
+{
+}
+
+void FrameRecorder::create(uint32_t capacity, const std::vector<std::string>& _passes)
+{
+	passes = _passes;
+
+	// Fixed columns
+	columns = { "frame_ms" };
+
+	// Timings of each tracked pass
+	for (const std::string& pass : passes) {
+		columns.push_back(pass + "_cpu_ms");
+		columns.push_back(pass + "_gpu_ms");
+	}
+
+	// Draw stats, resources and memory
+	columns.insert(columns.end(), {
+		"draw_calls",
+		"vertices",
+		"polygons",
+		"instances",
+		"shader_binds",
+		"material_binds",
+		"vao_binds",
+		"uploaded_kb",
+		"queued_pipes",
+		"resources",
+		"retired_resources",
+		"process_mb",
+		"frame_allocator_kb"
+	});
+
+	_capacity = capacity;
+	ring.assign(static_cast<size_t>(capacity) * columns.size(), 0.0f);
+	head = 0;
+	_nFrames = 0;
+
+	// Process memory is sampled on the first recorded frame
+	memoryCountdown = 0;
+	processMb = 0.0f;
+#if defined(__linux__)
+	if (statmFd < 0) statmFd = open("/proc/self/statm", O_RDONLY | O_CLOEXEC);
+#endif
+}
+
+void FrameRecorder::destroy()
+{
+	columns.clear();
+	passes.clear();
+	ring.clear();
+	ring.shrink_to_fit();
+	head = 0;
+	_nFrames = 0;
+	_capacity = 0;
+
+#if defined(__linux__)
+	if (statmFd >= 0) close(statmFd);
+#endif
+	statmFd = -1;
+}
+
+void FrameRecorder::record()
+{
+	if (!enabled || _capacity == 0) return;
+
+	// Write metrics directly into the oldest row
+	float* row = ring.data() + static_cast<size_t>(head) * columns.size();
+	uint32_t column = 0;
+
+	row[column++] = static_cast<float>(Time::unscaledDelta() * 1000.0);
+
+	for (const std::string& pass : passes) {
+		row[column++] = static_cast<float>(Profiler::getMs(pass));
+		row[column++] = static_cast<float>(Profiler::getGpuMs(pass));
+	}
+
+	const Diagnostics::DrawStats& stats = Diagnostics::getLastDrawStats().total;
+	row[column++] = static_cast<float>(stats.drawCalls);
+	row[column++] = static_cast<float>(stats.vertices);
+	row[column++] = static_cast<float>(stats.polygons);
+	row[column++] = static_cast<float>(stats.instances);
+	row[column++] = static_cast<float>(stats.shaderBinds);
+	row[column++] = static_cast<float>(stats.materialBinds);
+	row[column++] = static_cast<float>(stats.vaoBinds);
+	row[column++] = static_cast<float>(stats.uploadedBytes / 1024.0);
+
+	ResourceManager& resources = ApplicationContext::resourceManager();
+	row[column++] = static_cast<float>(resources.nQueuedPipes());
+	row[column++] = static_cast<float>(resources.nResources());
+	row[column++] = static_cast<float>(resources.nRetired());
+
+	// Sampling memory is a syscall, repeat the last sample in between
+	if (memoryCountdown == 0) {
+		processMb = static_cast<float>(processMemory(statmFd) / (1024.0 * 1024.0));
+		memoryCountdown = MEMORY_SAMPLE_INTERVAL;
+	}
+	memoryCountdown--;
+	row[column++] = processMb;
+	row[column++] = static_cast<float>(ApplicationContext::frameAllocator().regionSize() * static_cast<double>(FrameAllocator::N_REGIONS) / 1024.0);
+
+	head = (head + 1) % _capacity;
+	if (_nFrames < _capacity) _nFrames++;
+}
+
+void FrameRecorder::clear()
+{
+	head = 0;
+	_nFrames = 0;
+}
+
+void FrameRecorder::setEnabled(bool _enabled)
+{
+	enabled = _enabled;
+}
+
+bool FrameRecorder::getEnabled() const
+{
+	return enabled;
+}
+
+const std::vector<std::string>& FrameRecorder::getColumns() const
+{
+	return columns;
+}
+
+uint32_t FrameRecorder::nFrames() const
+{
+	return _nFrames;
+}
+
+uint32_t FrameRecorder::capacity() const
+{
+	return _capacity;
+}
+
+FrameCapture FrameRecorder::capture() const
+{
+	FrameCapture capture(columns);
+
+	// Oldest frame is at head once the ring wrapped
+	uint32_t first = _nFrames < _capacity ? 0 : head;
+	for (uint32_t i = 0; i < _nFrames; i++) {
+		uint32_t index = (first + i) % _capacity;
+		capture.addFrame(ring.data() + static_cast<size_t>(index) * columns.size());
+	}
+
+	return capture;
+}
+
+bool FrameRecorder::dump(const std::filesystem::path& path) const
+{
+	FrameCapture frames = capture();
+	bool written = path.extension() == ".csv" ? frames.saveCsv(path) : frames.saveBinary(path);
+
+	if (!written) {
+		Console::out::warning("Frame Recorder", "Couldn't write capture to '" + path.string() + "'");
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+
+#include <diagnostics/frame_capture.h>
+
+// Records metrics of every frame into a fixed size ring for soak tests and offline analysis
+// Metrics are frame time, cpu and gpu time of tracked passes, draw stats, resource queue depth and memory usage
+class FrameRecorder
+{
+public:
+	// Default amount of frames kept
+	static constexpr uint32_t DEFAULT_CAPACITY = 3600;
+
+	// Frames between samples of the process memory
+	static constexpr uint32_t MEMORY_SAMPLE_INTERVAL = 30;
+
+	FrameRecorder();
+
+	// Creates ring for given amount of frames, tracks timings of given passes
+	void create(uint32_t capacity, const std::vector<std::string>& passes);
+
+	// Destroys ring and all recorded frames
+	void destroy();
+
+	// Records metrics of the last completed frame, overwrites the oldest frame once the ring is full
+	void record();
+
+	// Removes all recorded frames
+	void clear();
+
+	// Sets if frames are recorded
+	void setEnabled(bool enabled);
+
+	// Returns if frames are recorded
+	bool getEnabled() const;
+
+	// Returns the names of all recorded metrics
+	const std::vector<std::string>& getColumns() const;
+
+	// Returns the amount of frames recorded
+	uint32_t nFrames() const;
+
+	// Returns the amount of frames the ring can hold
+	uint32_t capacity() const;
+
+	// Returns all recorded frames from oldest to latest
+	FrameCapture capture() const;
+
+	// Writes all recorded frames to a capture file, csv if path has a .csv extension, binary otherwise
+	bool dump(const std::filesystem::path& path) const;
+
+private:
+	// Names of all recorded metrics
+	std::vector<std::string> columns;
+
+	// Identifiers of passes timed
+	std::vector<std::string> passes;
+
+	// Recorded values, a row of all columns per frame
+	std::vector<float> ring;
+
+	// Row the next frame is recorded into
+	uint32_t head;
+
+	// Amount of frames recorded
+	uint32_t _nFrames;
+
+	// Amount of frames the ring can hold
+	uint32_t _capacity;
+
+	// If frames are recorded
+	bool enabled;
+
+	// Frames until process memory is sampled again
+	uint32_t memoryCountdown;
+
+	// Process memory in megabytes sampled last
+	float processMb;
+
+	// Kept open process statistics file memory is read from, -1 if not available (linux only)
+	int32_t statmFd;
+};
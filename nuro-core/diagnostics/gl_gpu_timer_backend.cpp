@@ -0,0 +1,34 @@
+#include "gl_gpu_timer_backend.h"
+
+#include <glad/glad.h>
+
+uint32_t GLGPUTimerBackend::createQuery()
+{
+	uint32_t query = 0;
+	glCreateQueries(GL_TIMESTAMP, 1, &query);
+	return query;
+}
+
+void GLGPUTimerBackend::destroyQuery(uint32_t query)
+{
+	glDeleteQueries(1, &query);
+}
+
+void GLGPUTimerBackend::timestamp(uint32_t query)
+{
+	glQueryCounter(query, GL_TIMESTAMP);
+}
+
+bool GLGPUTimerBackend::available(uint32_t query)
+{
+	GLint available = GL_FALSE;
+	glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+	return available == GL_TRUE;
+}
+
+uint64_t GLGPUTimerBackend::result(uint32_t query)
+{
+	GLuint64 time = 0;
+	glGetQueryObjectui64v(query, GL_QUERY_RESULT, &time);
+	return time;
+}
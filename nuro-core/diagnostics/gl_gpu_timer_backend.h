@@ -0,0 +1,14 @@
+#pragma once
+
+#include <diagnostics/gpu_profiler.h>
+
+// Gpu timer backend using timestamp query objects
+class GLGPUTimerBackend : public GPUTimerBackend
+{
+public:
+	uint32_t createQuery() override;
+	void destroyQuery(uint32_t query) override;
+	void timestamp(uint32_t query) override;
+	bool available(uint32_t query) override;
+	uint64_t result(uint32_t query) override;
+};
@@ -0,0 +1,120 @@
+#include "gpu_profiler.h"
+
+#include <utils/console.h>
+
+GPUProfiler::GPUProfiler(std::unique_ptr<GPUTimerBackend> backend) : backend(std::move(backend)),
+frames(),
+frame(0),
+freeQueries(),
+_nQueries(0),
+_nDropped(0),
+times()
+{
+}
+
+GPUProfiler::~GPUProfiler()
+{
+	destroy();
+}
+
+void GPUProfiler::destroy()
+{
+	// Recycle queries of all pending zones without reading them back
+	for (std::vector<Zone>& zones : frames) {
+		for (const Zone& zone : zones) {
+			if (zone.startQuery) freeQueries.push_back(zone.startQuery);
+			if (zone.stopQuery) freeQueries.push_back(zone.stopQuery);
+		}
+		zones.clear();
+	}
+
+	for (uint32_t query : freeQueries) {
+		backend->destroyQuery(query);
+	}
+	freeQueries.clear();
+	_nQueries = 0;
+}
+
+void GPUProfiler::beginFrame()
+{
+	// Advance to next frame slot, its zones were recorded N_FRAMES - 1 frames ago
+	frame = (frame + 1) % N_FRAMES;
+	readBack(frames[frame]);
+}
+
+void GPUProfiler::start(const std::string& identifier)
+{
+	Zone& zone = frames[frame].emplace_back();
+	zone.identifier = identifier;
+	zone.startQuery = acquireQuery();
+	backend->timestamp(zone.startQuery);
+}
+
+void GPUProfiler::stop(const std::string& identifier)
+{
+	// Find latest open zone of identifier
+	std::vector<Zone>& zones = frames[frame];
+	for (auto it = zones.rbegin(); it != zones.rend(); ++it) {
+		if (it->stopQuery || it->identifier != identifier) continue;
+
+		it->stopQuery = acquireQuery();
+		backend->timestamp(it->stopQuery);
+		return;
+	}
+
+	Console::out::warning("GPU Profiler", "Tried to stop zone '" + identifier + "' which wasn't started this frame");
+}
+
+double GPUProfiler::getMs(const std::string& identifier) const
+{
+	return getUs(identifier) * 0.001;
+}
+
+double GPUProfiler::getUs(const std::string& identifier) const
+{
+	auto it = times.find(identifier);
+	return it != times.end() ? it->second : 0.0;
+}
+
+uint64_t GPUProfiler::nDropped() const
+{
+	return _nDropped;
+}
+
+uint32_t GPUProfiler::nQueries() const
+{
+	return _nQueries;
+}
+
+uint32_t GPUProfiler::acquireQuery()
+{
+	if (!freeQueries.empty()) {
+		uint32_t query = freeQueries.back();
+		freeQueries.pop_back();
+		return query;
+	}
+
+	_nQueries++;
+	return backend->createQuery();
+}
+
+void GPUProfiler::readBack(std::vector<Zone>& zones)
+{
+	for (const Zone& zone : zones) {
+		// Stop timestamp is recorded after start, if it's available so is start
+		// Zones recorded multiple times per frame keep their latest time, like cpu profiles do
+		if (zone.stopQuery && backend->available(zone.stopQuery)) {
+			uint64_t startTime = backend->result(zone.startQuery);
+			uint64_t stopTime = backend->result(zone.stopQuery);
+			times[zone.identifier] = stopTime > startTime ? (stopTime - startTime) * 0.001 : 0.0;
+		}
+		// Never block, keep previous time of zone instead
+		else {
+			_nDropped++;
+		}
+
+		freeQueries.push_back(zone.startQuery);
+		if (zone.stopQuery) freeQueries.push_back(zone.stopQuery);
+	}
+	zones.clear();
+}
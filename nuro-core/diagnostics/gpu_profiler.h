@@ -0,0 +1,101 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+
+// Backend providing gpu timestamp queries to a gpu profiler
+class GPUTimerBackend
+{
+public:
+	virtual ~GPUTimerBackend() = default;
+
+	// Creates a timestamp query and returns its handle
+	virtual uint32_t createQuery() = 0;
+
+	// Destroys a timestamp query
+	virtual void destroyQuery(uint32_t query) = 0;
+
+	// Records the gpu time once all previously issued commands are done into the query
+	virtual void timestamp(uint32_t query) = 0;
+
+	// Returns if the result of a query is available without blocking
+	virtual bool available(uint32_t query) = 0;
+
+	// Returns the recorded gpu time of a query in nanoseconds, check available() first
+	virtual uint64_t result(uint32_t query) = 0;
+};
+
+// Measures gpu time of named zones using timestamp queries
+// Results of a frame are read back once its frame slot is reused, by then they're usually available without stalling
+class GPUProfiler
+{
+public:
+	// Number of frame slots, results are read back this many frames after they were recorded
+	static constexpr uint32_t N_FRAMES = 4;
+
+	explicit GPUProfiler(std::unique_ptr<GPUTimerBackend> backend);
+	~GPUProfiler();
+
+	// Destroys all queries, queries are created lazily
+	void destroy();
+
+	// Advances to the next frame slot and reads back the results recorded in it
+	void beginFrame();
+
+	// Starts a zone by recording a timestamp
+	void start(const std::string& identifier);
+
+	// Stops a zone started this frame by recording a timestamp
+	void stop(const std::string& identifier);
+
+	// Returns last read back gpu time of a zone in milliseconds, 0 if none
+	double getMs(const std::string& identifier) const;
+
+	// Returns last read back gpu time of a zone in microseconds, 0 if none
+	double getUs(const std::string& identifier) const;
+
+	// Returns the amount of zones dropped because their results weren't available in time
+	uint64_t nDropped() const;
+
+	// Returns the amount of queries allocated
+	uint32_t nQueries() const;
+
+private:
+	// Zone recorded within a frame
+	struct Zone
+	{
+		std::string identifier;
+		uint32_t startQuery = 0;
+		uint32_t stopQuery = 0;
+	};
+
+	// Returns an unused query, creates one if none is left
+	uint32_t acquireQuery();
+
+	// Reads back the zones of a frame slot and recycles their queries
+	void readBack(std::vector<Zone>& zones);
+
+	// Backend of profiler
+	std::unique_ptr<GPUTimerBackend> backend;
+
+	// Zones recorded per frame slot
+	std::vector<Zone> frames[N_FRAMES];
+
+	// Index of current frame slot
+	uint32_t frame;
+
+	// Queries ready for reuse
+	std::vector<uint32_t> freeQueries;
+
+	// Amount of queries allocated
+	uint32_t _nQueries;
+
+	// Amount of zones dropped
+	uint64_t _nDropped;
+
+	// Last read back time of each zone in microseconds
+	std::unordered_map<std::string, double> times;
+};
@@ -1,11 +1,16 @@
 #include "profiler.h"
 
+#include <diagnostics/diagnostics.h>
+#include <diagnostics/gpu_profiler.h>
+
 namespace Profiler
 {
 
 	std::unordered_map<std::string, std::chrono::steady_clock::time_point> gProfiles = std::unordered_map<std::string, std::chrono::steady_clock::time_point>();
 	std::unordered_map<std::string, double> gTimes = std::unordered_map<std::string, double>();
 
+	GPUProfiler* gGPUProfiler = nullptr;
+
 	bool _validateProfile(const std::string& identifier)
 	{
 		return gProfiles.find(identifier) == gProfiles.end() ? false : true;
@@ -55,4 +60,30 @@ namespace Profiler
 		return gTimes[identifier] * 1000;
 	}
 
-}
+	void setGPUProfiler(GPUProfiler* profiler)
+	{
+		gGPUProfiler = profiler;
+	}
+
+	void startPass(const std::string& identifier)
+	{
+		if (gGPUProfiler) gGPUProfiler->start(identifier);
+		Diagnostics::beginPass(identifier);
+		start(identifier);
+	}
+
+	double stopPass(const std::string& identifier)
+	{
+		double time = stop(identifier);
+		Diagnostics::endPass();
+		if (gGPUProfiler) gGPUProfiler->stop(identifier);
+		return time;
+	}
+
+	double getGpuMs(const std::string& identifier)
+	{
+		if (!gGPUProfiler) return 0.0;
+		return gGPUProfiler->getMs(identifier);
+	}
+
+}
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <chrono>
 #include <unordered_map>
 
+class GPUProfiler;
+
 namespace Profiler
 {
 
@@ -22,4 +24,16 @@ namespace Profiler
 	// Returns last cached time for given identifier in nanoseconds
 	double getNs(const std::string& identifier);
 
+	// Sets the gpu profiler measuring passes, nullptr to measure passes on the cpu only
+	void setGPUProfiler(GPUProfiler* profiler);
+
+	// Creates new profile for given pass and starts profiling it on the cpu and gpu, draw stats are attributed to the pass until it stops
+	void startPass(const std::string& identifier);
+
+	// Stops profiling for given pass on the cpu and gpu and returns cpu time
+	double stopPass(const std::string& identifier);
+
+	// Returns last read back gpu time for given pass in milliseconds
+	double getGpuMs(const std::string& identifier);
+
 };
\ No newline at end of file
@@ -19,16 +19,6 @@ using Entity = entt::entity;
 
 struct TransformComponent {
 
-	//
-	// GENERAL
-	//
-
-	// Unique id of entity
-	uint32_t id = 0;
-
-	// Name of entity
-	std::string name;
-
 	// Set if transform was modified and needs to be evaluated (initially set)
 	bool modified = true;
 
@@ -55,9 +45,6 @@ struct TransformComponent {
 	// Optional parent
 	Entity parent = entt::null;
 
-	// List of children
-	std::vector<Entity> children;
-
 	// Depth in hierarchy
 	uint32_t depth = 0;
 
@@ -68,6 +55,9 @@ struct TransformComponent {
 	// Transforms current model matrix in world space
 	glm::mat4 model = glm::mat4(1.0f);
 
+	// Transforms model matrix in world space at the end of last frame
+	glm::mat4 previousModel = glm::mat4(1.0f);
+
 	// Transforms current normal matrix in world space
 	glm::mat4 normal = glm::mat4(1.0f);
 
@@ -76,6 +66,23 @@ struct TransformComponent {
 
 };
 
+struct IdentityComponent {
+
+	// Unique id of entity
+	uint32_t id = 0;
+
+	// Name of entity
+	std::string name;
+
+};
+
+struct HierarchyComponent {
+
+	// List of children
+	std::vector<Entity> children;
+
+};
+
 struct MeshRendererComponent {
 	// Set if mesh renderer is enabled
 	bool enabled = true;
@@ -165,9 +172,6 @@ struct VelocityBlurComponent {
 	// Intensity of the velocity impact
 	float intensity = 1.0f;
 
-	// Cached model matrix from last frame
-	glm::mat4 lastModel = glm::mat4(1.0f);
-
 };
 
 struct BoxColliderComponent {
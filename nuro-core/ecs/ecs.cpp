@@ -8,7 +8,7 @@
 #include <audio/audio_context.h>
 #include <transform/transform.h>
 
-ECS::ECS() : registry(), idCounter(0), renderQueue()
+ECS::ECS() : registry(), idCounter(0), renderQueue(), batchDepth(0), renderQueueDirty(false), onReparent(), onBatchEnd()
 {
 	// Setup ecs component reflection
 	ECSReflection::registerAll();
@@ -27,6 +27,17 @@ const RenderQueue& ECS::getRenderQueue()
 	return renderQueue;
 }
 
+void ECS::prepareShaders()
+{
+	// Entities sharing a material are consecutive in the queue, prepare each material once
+	const IMaterial* previous = nullptr;
+	for (auto& [entity, transform, renderer] : renderQueue) {
+		if (!renderer.material || renderer.material == previous) continue;
+		previous = renderer.material;
+		renderer.material->prepareShader();
+	}
+}
+
 std::optional<Camera> ECS::getActiveCamera() {
 	auto group = registry.group<TransformComponent>(entt::get<CameraComponent>);
 	for (auto entity : group) {
@@ -40,14 +51,12 @@ std::optional<Camera> ECS::getActiveCamera() {
 
 std::tuple<Entity, TransformComponent&> ECS::createEntity(std::string name)
 {
-	// Create new entity and emplace transform component
+	// Create new entity and emplace its cold components first, transform listeners see complete entities
 	Entity entity = registry.create();
+	add<IdentityComponent>(entity, IdentityComponent{ getId(), std::move(name) });
+	add<HierarchyComponent>(entity);
 	TransformComponent& transform = add<TransformComponent>(entity);
 
-	// Set transform data
-	transform.id = getId();
-	transform.name = name;
-
 	// Return entity and transform component
 	return std::tuple<Entity, TransformComponent&>(entity, transform);
 }
@@ -63,9 +72,6 @@ std::tuple<Entity, TransformComponent&> ECS::createEntity(std::string name, Enti
 	// Create new entity
 	auto [entity, transform] = createEntity(name);
 
-	// Fetch parent
-	TransformComponent& parentTransform = get<TransformComponent>(parent);
-
 	// Set parent
 	setParent(entity, parent);
 
@@ -95,12 +101,14 @@ void ECS::setParent(Entity entity, Entity parent)
 	TransformComponent& parentTransform = get<TransformComponent>(parent);
 
 	// Add entity to parents children
-	parentTransform.children.push_back(entity);
+	get<HierarchyComponent>(parent).children.push_back(entity);
 
 	// Update transform
 	transform.parent = parent;
 	transform.depth = parentTransform.depth + 1;
 	transform.modified = true;
+
+	onReparent(entity);
 }
 
 void ECS::removeParent(Entity entity)
@@ -112,7 +120,7 @@ void ECS::removeParent(Entity entity)
 
 	// Remove entity from children of parent
 	// Inefficient, add e.g. binary search here later
-	auto& children = Transform::fetchParent(transform).children;
+	auto& children = get<HierarchyComponent>(transform.parent).children;
 	auto it = std::find(children.begin(), children.end(), entity);
 	if (it != children.end()) {
 		std::swap(*it, children.back());
@@ -123,6 +131,92 @@ void ECS::removeParent(Entity entity)
 	transform.parent = entt::null;
 	transform.depth = 0;
 	transform.modified = true;
+
+	onReparent(entity);
+}
+
+std::vector<Entity> ECS::createEntities(size_t count)
+{
+	std::vector<Entity> entities(count);
+	registry.create(entities.begin(), entities.end());
+	return entities;
+}
+
+void ECS::destroyEntities(std::vector<Entity>::const_iterator first, std::vector<Entity>::const_iterator last)
+{
+	beginBatch();
+
+	for (auto it = first; it != last; ++it) {
+		Entity entity = *it;
+		if (!has<TransformComponent>(entity)) continue;
+		TransformComponent& transform = get<TransformComponent>(entity);
+
+		// Destroying moves remaining transforms within their storage, the render queue references them
+		renderQueueDirty = true;
+
+		// Detach from parent, children destroyed in reverse creation order are found at the back
+		if (Transform::hasParent(transform) && verify(transform.parent)) {
+			auto& children = get<HierarchyComponent>(transform.parent).children;
+			auto child = std::find(children.rbegin(), children.rend(), entity);
+			if (child != children.rend()) {
+				std::swap(*child, children.back());
+				children.pop_back();
+			}
+		}
+
+		// Orphan remaining children
+		std::vector<Entity>& children = get<HierarchyComponent>(entity).children;
+		for (Entity child : children) {
+			if (!has<TransformComponent>(child)) continue;
+			TransformComponent& childTransform = get<TransformComponent>(child);
+			childTransform.parent = entt::null;
+			childTransform.depth = 0;
+			childTransform.modified = true;
+			onReparent(child);
+		}
+		children.clear();
+	}
+
+	registry.destroy(first, last);
+
+	endBatch();
+}
+
+void ECS::beginBatch()
+{
+	batchDepth++;
+}
+
+void ECS::endBatch()
+{
+	if (batchDepth == 0) return;
+	batchDepth--;
+
+	if (batchDepth > 0) return;
+
+	// Apply deferred render queue update
+	if (renderQueueDirty) {
+		renderQueueDirty = false;
+		rebuildRenderQueue(entt::null);
+	}
+
+	// Let listeners apply their deferred work
+	onBatchEnd();
+}
+
+bool ECS::batching() const
+{
+	return batchDepth > 0;
+}
+
+Event<>& ECS::batchEndEvent()
+{
+	return onBatchEnd;
+}
+
+Event<Entity>& ECS::reparentEvent()
+{
+	return onReparent;
 }
 
 ECS& ECS::main()
@@ -139,70 +233,58 @@ uint32_t ECS::getId() {
 }
 
 void ECS::insertMeshRenderer(Entity target) {
+	// Rebuild once the current batch ends
+	if (batchDepth > 0) {
+		renderQueueDirty = true;
+		return;
+	}
 
-	//
-	// NON-OPTIMAL BOILERPLATE CODE!
-	// Right now, this code is just regenerating the render queue using all mesh renderer components
-	// This is sub-optimal, it should just be inserted into the render queue at the right place
-	//
-
-	// Fill target queue
-	std::vector<Entity> targetQueue;
-
-	view<MeshRendererComponent>().each([&](auto entity, const auto&) {
-		targetQueue.push_back(entity);
-		});
-
-	// Sort targets by shader and material
-	std::sort(targetQueue.begin(), targetQueue.end(), [&](auto lhsEntity, auto rhsEntity) {
-		MeshRendererComponent& lhs = get<MeshRendererComponent>(lhsEntity);
-		auto lhsShaderId = lhs.material ? lhs.material->getShaderId() : -1;
-		auto lhsMaterialId = lhs.material ? lhs.material->getId() : -1;
-
-		MeshRendererComponent& rhs = get<MeshRendererComponent>(rhsEntity);
-		auto rhsShaderId = rhs.material ? rhs.material->getShaderId() : -1;
-		auto rhsMaterialId = rhs.material ? rhs.material->getId() : -1;
-
-		return std::tie(lhsShaderId, lhsMaterialId) < std::tie(rhsShaderId, rhsMaterialId);
-		});
-
-	// Fill render queue
-	renderQueue.clear();
+	rebuildRenderQueue(entt::null);
+}
 
-	for (auto entity : targetQueue) {
-		renderQueue.emplace_back(entity, get<TransformComponent>(entity), get<MeshRendererComponent>(entity));
+void ECS::purgeMeshRenderer(Entity target) {
+	// Rebuild once the current batch ends, the target is removed by then
+	if (batchDepth > 0) {
+		renderQueueDirty = true;
+		return;
 	}
 
+	rebuildRenderQueue(target);
 }
 
-void ECS::purgeMeshRenderer(Entity target) {
+void ECS::rebuildRenderQueue(Entity skip) {
 
 	//
 	// NON-OPTIMAL BOILERPLATE CODE!
-	// Right now, this code is just regenerating the render queue using all mesh renderer components but skips the provided target entity
-	// This is sub-optimal, it should just be removed from the render queue
+	// Right now, this code is just regenerating the render queue using all mesh renderer components but skips the provided entity
+	// This is sub-optimal, entities should just be inserted into or removed from the render queue at the right place
 	//
 
 	// Fill target queue
 	std::vector<Entity> targetQueue;
 
 	view<MeshRendererComponent>().each([&](auto entity, const auto&) {
-		if (entity != target) {
+		if (entity != skip) {
 			targetQueue.push_back(entity);
 		}
 		});
 
-	// Sort targets by shader and material
+	// Sort targets by shader, material and mesh (identical mesh and material pairs end up consecutive for instancing)
+	// Shader keys don't depend on the render state, views with different render states share the order
 	std::sort(targetQueue.begin(), targetQueue.end(), [&](auto lhsEntity, auto rhsEntity) {
 		MeshRendererComponent& lhs = get<MeshRendererComponent>(lhsEntity);
-		auto lhsShaderId = lhs.material ? lhs.material->getShaderId() : -1;
+		auto lhsShaderKey = lhs.material ? lhs.material->getShaderKey() : UINT64_MAX;
 		auto lhsMaterialId = lhs.material ? lhs.material->getId() : -1;
+		auto lhsMaterial = reinterpret_cast<uintptr_t>(lhs.material);
+		auto lhsMesh = reinterpret_cast<uintptr_t>(lhs.mesh);
 
 		MeshRendererComponent& rhs = get<MeshRendererComponent>(rhsEntity);
-		auto rhsShaderId = rhs.material ? rhs.material->getShaderId() : -1;
+		auto rhsShaderKey = rhs.material ? rhs.material->getShaderKey() : UINT64_MAX;
 		auto rhsMaterialId = rhs.material ? rhs.material->getId() : -1;
+		auto rhsMaterial = reinterpret_cast<uintptr_t>(rhs.material);
+		auto rhsMesh = reinterpret_cast<uintptr_t>(rhs.mesh);
 
-		return std::tie(lhsShaderId, lhsMaterialId) < std::tie(rhsShaderId, rhsMaterialId);
+		return std::tie(lhsShaderKey, lhsMaterialId, lhsMaterial, lhsMesh) < std::tie(rhsShaderKey, rhsMaterialId, rhsMaterial, rhsMesh);
 		});
 
 	// Fill render queue
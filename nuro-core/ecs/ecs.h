@@ -1,12 +1,15 @@
 #pragma once
 
 #include <tuple>
+#include <vector>
+#include <iterator>
 #include <memory>
 #include <sstream>
 #include <cstdint>
 #include <optional>
 #include <entt/entt.hpp>
 
+#include <utils/event.h>
 #include <utils/console.h>
 #include <ecs/components.h>
 #include <ecs/ecs_reflection.h>
@@ -25,6 +28,10 @@ public:
 	// Returns the render queue
 	const RenderQueue& getRenderQueue();
 
+	// Builds the shaders all queued materials are shaded with in the current render state if needed
+	// Call once per view before the render queue is batched (context thread), the queue order doesn't depend on the render state
+	void prepareShaders();
+
 	// Returns the camera currently rendering
 	std::optional<Camera> getActiveCamera();
 
@@ -40,6 +47,44 @@ public:
 	// Removes the parent of an entity if it has one
 	void removeParent(Entity entity);
 
+	// Creates the given amount of entities in bulk, their components must be added using insertTransforms()
+	std::vector<Entity> createEntities(size_t count);
+
+	// Adds transform, identity and hierarchy components to a range of entities created in bulk
+	// Moves the transforms and names into the registry and assigns unique ids
+	template<typename EntityIt, typename TransformIt, typename NameIt>
+	void insertTransforms(EntityIt first, EntityIt last, TransformIt transforms, NameIt names) {
+		std::vector<IdentityComponent> identities;
+		identities.reserve(static_cast<size_t>(std::distance(first, last)));
+		NameIt name = names;
+		for (EntityIt it = first; it != last; ++it, ++name) {
+			identities.push_back({ getId(), std::move(*name) });
+		}
+
+		// Transforms are inserted last, their construction listeners see complete entities
+		beginBatch();
+		insert<IdentityComponent>(first, last, identities.begin());
+		insertCopies(first, last, HierarchyComponent());
+		insert<TransformComponent>(first, last, transforms);
+		endBatch();
+	}
+
+	// Destroys a range of entities at once, detaches them from parents outside the range and orphans their remaining children
+	void destroyEntities(std::vector<Entity>::const_iterator first, std::vector<Entity>::const_iterator last);
+
+	// Defers render queue updates until the batch ends, use when adding or removing many components at once (nestable)
+	void beginBatch();
+	void endBatch();
+
+	// Returns if a batch is currently open, construction listeners may defer their work until the batch ends
+	bool batching() const;
+
+	// Returns the event invoked once the outermost batch ended
+	Event<>& batchEndEvent();
+
+	// Returns the event invoked whenever the parent of an entity changed (also when it was orphaned)
+	Event<Entity>& reparentEvent();
+
 public:
 	// Returns a reference to the registry; use with caution, prefer wrapper methods!
 	Registry& reg() {
@@ -87,6 +132,22 @@ public:
 		registry.remove<T>(entity);
 	}
 
+	// Adds a copy of the given component to a range of entities at once (check canAdd() first!)
+	template<typename T, typename EntityIt>
+	void insertCopies(EntityIt first, EntityIt last, const T& component) {
+		beginBatch();
+		registry.insert<T>(first, last, component);
+		endBatch();
+	}
+
+	// Adds components of given type to a range of entities at once, moving them from the given components (check canAdd() first!)
+	template<typename T, typename EntityIt, typename ComponentIt>
+	void insert(EntityIt first, EntityIt last, ComponentIt components) {
+		beginBatch();
+		registry.insert<T>(first, last, std::make_move_iterator(components));
+		endBatch();
+	}
+
 public:
 	// Locates the main ECS service
 	static ECS& main();
@@ -96,9 +157,24 @@ private:
 	uint32_t idCounter;
 	RenderQueue renderQueue;
 
+	// Depth of nested batches
+	uint32_t batchDepth;
+
+	// Set if the render queue needs to be rebuilt once the current batch ends
+	bool renderQueueDirty;
+
+	// Invoked whenever the parent of an entity changed
+	Event<Entity> onReparent;
+
+	// Invoked once the outermost batch ended
+	Event<> onBatchEnd;
+
 	// Returns a unique id
 	uint32_t getId();
 
+	// Rebuilds the render queue from all mesh renderer components, skipping the given entity
+	void rebuildRenderQueue(Entity skip);
+
 	// Inserts the target entity and its mesh renderer component to the render queue
 	void insertMeshRenderer(Entity target);
 
@@ -1,144 +1,231 @@
 #include "ecs_reflection.h"
 
-#include <string>
-#include <functional>
-
-#include <glm/glm.hpp>
+#include <type_traits>
+#include <unordered_map>
 
 #include <ecs/ecs.h>
 #include <utils/console.h>
 #include <ecs/components.h>
+#include <ecs/reflection_formats.h>
+
+namespace ECSReflection {
+
+	//
+	// CODECS
+	// One codec per member type, enums are encoded by their underlying value
+	//
 
-#define START_CAST() \
-	auto anyval = member.get(instance); \
-	if (!anyval) continue;
-
-#define NEXT_CAST(type) \
-    else if (memberType == entt::resolve<type>()) { \
-        auto value = anyval.cast<type>(); \
-        properties[key] = value; \
-    }
-
-using namespace entt::literals;
-
-struct Example {
-	float x;
-	float y;
-};
-
-namespace nlohmann {
-	template <>
-	struct adl_serializer<glm::vec3> {
-		static void to_json(ordered_json& j, const glm::vec3& v) {
-			j = json{
-				{"x", v.x},
-				{"y", v.y},
-				{"z", v.z}
-			};
+	template <typename T>
+	struct Codec {
+		static void write(Writer& writer, std::string_view key, const void* value) {
+			if constexpr (std::is_enum_v<T>) writer.write(key, static_cast<int32_t>(*static_cast<const T*>(value)));
+			else writer.write(key, *static_cast<const T*>(value));
 		}
 
-		static void from_json(const ordered_json& j, glm::vec3& v) {
-			v.x = j.at("x").get<float>();
-			v.y = j.at("y").get<float>();
-			v.z = j.at("z").get<float>();
+		static bool read(Reader& reader, std::string_view key, void* value) {
+			if constexpr (std::is_enum_v<T>) {
+				int32_t raw = static_cast<int32_t>(*static_cast<T*>(value));
+				if (!reader.read(key, raw)) return false;
+				*static_cast<T*>(value) = static_cast<T>(raw);
+				return true;
+			}
+			else {
+				return reader.read(key, *static_cast<T*>(value));
+			}
 		}
 	};
 
-	template <>
-	struct adl_serializer<glm::quat> {
-		static void to_json(ordered_json& j, const glm::quat& q) {
-			j = json{
-				{"x", q.x},
-				{"y", q.y},
-				{"z", q.z},
-				{"w", q.w}
-			};
+	//
+	// REGISTRATION
+	//
+
+	std::vector<Component> gComponents;
+	std::unordered_map<entt::id_type, size_t> gComponentIndices;
+	std::unordered_map<entt::id_type, size_t> gTypeIndices;
+
+	// Registers a component type and builds its member table
+	template <typename T>
+	class ComponentBuilder {
+	public:
+		explicit ComponentBuilder(std::string_view name) : index(gComponents.size())
+		{
+			Component component;
+			component.id = entt::hashed_string(name.data(), name.size()).value();
+			component.typeHash = entt::type_hash<T>::value();
+			component.name = name;
+			component.find = &find;
+			component.emplace = &emplace;
+
+			gComponentIndices[component.id] = index;
+			gTypeIndices[component.typeHash] = index;
+			gComponents.push_back(std::move(component));
 		}
 
-		static void from_json(const ordered_json& j, glm::quat& q) {
-			q.x = j.at("x").get<float>();
-			q.y = j.at("y").get<float>();
-			q.z = j.at("z").get<float>();
-			q.w = j.at("w").get<float>();
+		// Adds a data member, its offset is measured once on a default instance
+		template <auto MemberPointer>
+		ComponentBuilder& member(std::string_view name) {
+			using MemberType = std::remove_cvref_t<decltype(std::declval<T&>().*MemberPointer)>;
+
+			const T probe{};
+			const char* base = reinterpret_cast<const char*>(&probe);
+			const char* address = reinterpret_cast<const char*>(&(probe.*MemberPointer));
+
+			uint32_t size = std::is_trivially_copyable_v<MemberType> ? static_cast<uint32_t>(sizeof(MemberType)) : 0;
+
+			gComponents[index].members.push_back({ name, static_cast<uint32_t>(address - base), size, &Codec<MemberType>::write, &Codec<MemberType>::read });
+			return *this;
+		}
+
+	private:
+		size_t index;
+
+		static const void* find(entt::registry& registry, entt::entity entity) {
+			return registry.try_get<T>(entity);
+		}
+
+		static bool emplace(const Component& type, entt::registry& registry, entt::entity entity, Reader& reader) {
+			// Decode into a temporary first so construction listeners see the decoded values
+			T component{};
+			if (!deserializeMembers(reader, type, &component)) return false;
+
+			registry.emplace_or_replace<T>(entity, std::move(component));
+			return true;
 		}
 	};
-}
 
-namespace ECSReflection {
+	void registerAll() {
+		// Only register once
+		if (!gComponents.empty()) return;
+
+		// Asset references, hierarchy links and backend handles aren't reflected, the scene serializer resolves them
+		// Scene files store the reflected members of each component column wise in table order
+
+		ComponentBuilder<IdentityComponent>("Identity")
+			.member<&IdentityComponent::id>("id")
+			.member<&IdentityComponent::name>("name");
+
+		ComponentBuilder<TransformComponent>("Transform")
+			.member<&TransformComponent::position>("position")
+			.member<&TransformComponent::rotation>("rotation")
+			.member<&TransformComponent::eulerAngles>("eulerAngles")
+			.member<&TransformComponent::scale>("scale");
+
+		ComponentBuilder<MeshRendererComponent>("MeshRenderer")
+			.member<&MeshRendererComponent::enabled>("enabled");
+
+		ComponentBuilder<CameraComponent>("Camera")
+			.member<&CameraComponent::enabled>("enabled")
+			.member<&CameraComponent::fov>("fov")
+			.member<&CameraComponent::near>("near")
+			.member<&CameraComponent::far>("far");
+
+		ComponentBuilder<DirectionalLightComponent>("DirectionalLight")
+			.member<&DirectionalLightComponent::enabled>("enabled")
+			.member<&DirectionalLightComponent::intensity>("intensity")
+			.member<&DirectionalLightComponent::color>("color");
+
+		ComponentBuilder<PointLightComponent>("PointLight")
+			.member<&PointLightComponent::enabled>("enabled")
+			.member<&PointLightComponent::intensity>("intensity")
+			.member<&PointLightComponent::color>("color")
+			.member<&PointLightComponent::range>("range")
+			.member<&PointLightComponent::falloff>("falloff");
+
+		ComponentBuilder<SpotlightComponent>("Spotlight")
+			.member<&SpotlightComponent::enabled>("enabled")
+			.member<&SpotlightComponent::intensity>("intensity")
+			.member<&SpotlightComponent::color>("color")
+			.member<&SpotlightComponent::range>("range")
+			.member<&SpotlightComponent::falloff>("falloff")
+			.member<&SpotlightComponent::innerAngle>("innerAngle")
+			.member<&SpotlightComponent::outerAngle>("outerAngle");
+
+		ComponentBuilder<VelocityBlurComponent>("VelocityBlur")
+			.member<&VelocityBlurComponent::enabled>("enabled")
+			.member<&VelocityBlurComponent::intensity>("intensity");
+
+		ComponentBuilder<BoxColliderComponent>("BoxCollider")
+			.member<&BoxColliderComponent::center>("center")
+			.member<&BoxColliderComponent::size>("size");
+
+		ComponentBuilder<SphereColliderComponent>("SphereCollider")
+			.member<&SphereColliderComponent::center>("center")
+			.member<&SphereColliderComponent::radius>("radius");
+
+		ComponentBuilder<RigidbodyComponent>("Rigidbody")
+			.member<&RigidbodyComponent::interpolation>("interpolation")
+			.member<&RigidbodyComponent::collisionDetection>("collisionDetection")
+			.member<&RigidbodyComponent::mass>("mass")
+			.member<&RigidbodyComponent::resistance>("resistance")
+			.member<&RigidbodyComponent::angularResistance>("angularResistance")
+			.member<&RigidbodyComponent::gravity>("gravity")
+			.member<&RigidbodyComponent::kinematic>("kinematic");
+
+		ComponentBuilder<AudioListenerComponent>("AudioListener")
+			.member<&AudioListenerComponent::enabled>("enabled")
+			.member<&AudioListenerComponent::dopplerFactor>("dopplerFactor");
+
+		ComponentBuilder<AudioSourceComponent>("AudioSource")
+			.member<&AudioSourceComponent::volume>("volume")
+			.member<&AudioSourceComponent::pitch>("pitch")
+			.member<&AudioSourceComponent::looping>("looping")
+			.member<&AudioSourceComponent::playOnAwake>("playOnAwake")
+			.member<&AudioSourceComponent::isSpatial>("isSpatial")
+			.member<&AudioSourceComponent::range>("range")
+			.member<&AudioSourceComponent::falloff>("falloff")
+			.member<&AudioSourceComponent::coneInnerAngle>("coneInnerAngle")
+			.member<&AudioSourceComponent::coneOuterAngle>("coneOuterAngle")
+			.member<&AudioSourceComponent::coneOuterVolume>("coneOuterVolume");
+	}
 
-	template <typename T>
-	entt::meta_any emplace(entt::entity entity) {
-		T& component = ECS::main().reg().emplace_or_replace<T>(entity);
-		return std::ref(component);
+	const std::vector<Component>& components()
+	{
+		return gComponents;
 	}
 
-	void registerAll() {
-		entt::meta<TransformComponent>()
-			.type("Transform"_hs)
-			.func<&emplace<TransformComponent>>("emplace"_hs)
-			.data<&TransformComponent::id>("id"_hs)
-			.data<&TransformComponent::name>("name"_hs)
-			.data<&TransformComponent::position>("position"_hs)
-			.data<&TransformComponent::rotation>("rotation"_hs)
-			.data<&TransformComponent::scale>("scale"_hs);
-
-		entt::meta<MeshRendererComponent>()
-			.type("MeshRenderer"_hs)
-			.func<&emplace<MeshRendererComponent>>("emplace"_hs)
-			.data<&MeshRendererComponent::enabled>("enabled"_hs);
-
-		entt::meta<PointLightComponent>()
-			.type("PointLight"_hs)
-			.func<&emplace<PointLightComponent>>("emplace"_hs)
-			.data<&PointLightComponent::enabled>("enabled"_hs)
-			.data<&PointLightComponent::intensity>("intensity"_hs)
-			.data<&PointLightComponent::color>("color"_hs)
-			.data<&PointLightComponent::range>("range"_hs)
-			.data<&PointLightComponent::falloff>("falloff"_hs);
+	const Component* resolve(entt::id_type id)
+	{
+		auto it = gComponentIndices.find(id);
+		return it != gComponentIndices.end() ? &gComponents[it->second] : nullptr;
 	}
 
-	json serializeComponent(entt::meta_any instance) {
-		// Fetch type
-		entt::meta_type type = instance.type();
-		if (!type)
-			return json();
-
-		// Create json buffers
-		json component{};
-		json properties{};
-
-		// Serialize each data member
-		for (auto [id, member] : type.data()) {
-			std::string key = std::to_string(id);
-			auto memberType = member.type();
-			if (!memberType)
-				continue;
-			
-			try {
-				START_CAST()
-					NEXT_CAST(int)
-					NEXT_CAST(float)
-					NEXT_CAST(double)
-					NEXT_CAST(bool)
-					NEXT_CAST(std::string)
-					NEXT_CAST(glm::vec3)
-					NEXT_CAST(glm::quat)
-			}
-			catch (const std::exception& e) {
-				Console::out::warning("ECS Reflection", "Error while serializing ECS component " + std::string(type.info().name()) + ": ", e.what());
-				return json();
-			}
-			catch (...) {
-				Console::out::warning("ECS Reflection", "Error while serializing ECS component " + std::string(type.info().name()));
-				return json();
-			}
+	const Component* resolveType(entt::id_type typeHash)
+	{
+		auto it = gTypeIndices.find(typeHash);
+		return it != gTypeIndices.end() ? &gComponents[it->second] : nullptr;
+	}
+
+	//
+	// SERIALIZATION
+	//
+
+	void serializeComponent(Writer& writer, const Component& type, const void* instance)
+	{
+		const char* base = static_cast<const char*>(instance);
+
+		writer.beginComponent(type.id, type.name);
+		for (const Member& member : type.members) {
+			member.write(writer, member.name, base + member.offset);
 		}
+		writer.endComponent();
+	}
 
-		// Set type and properties
-		component["type"] = type.id();
-		component["properties"] = properties;
+	bool deserializeMembers(Reader& reader, const Component& type, void* instance)
+	{
+		char* base = static_cast<char*>(instance);
+
+		for (const Member& member : type.members) {
+			if (!member.read(reader, member.name, base + member.offset)) return false;
+		}
+		return true;
+	}
 
-		return component;
+	void serializeEntity(Writer& writer, entt::registry& registry, entt::entity entity)
+	{
+		for (const Component& type : gComponents) {
+			const void* instance = type.find(registry, entity);
+			if (instance) serializeComponent(writer, type, instance);
+		}
 	}
 
 	bool deserializeComponent(entt::entity entity, const json& source)
@@ -148,37 +235,21 @@ namespace ECSReflection {
 			return false;
 
 		// Resolve component type
-		auto xtype = source["type"];
+		const json& xtype = source["type"];
 		if (!xtype.is_number_unsigned())
 			return false;
-		auto typehash = xtype.get<entt::id_type>();
-		entt::meta_type type = entt::resolve(typehash);
+		const Component* type = resolve(xtype.get<entt::id_type>());
 		if (!type)
 			return false;
 
-		// Fetch emplace function
-		entt::meta_any caller = type.construct();
-		entt::meta_func emplace = type.func("emplace"_hs);
-		if (!emplace)
-			return false;
-
-		// Instantiate component
-		entt::meta_any instance = emplace.invoke(caller, entity);
-		entt::meta_type instanceType = instance.type();
-		if (!instanceType)
+		// Read properties and emplace component
+		JsonReader reader(source["properties"]);
+		if (!type->emplace(*type, ECS::main().reg(), entity, reader)) {
+			Console::out::warning("ECS Reflection", "Couldn't deserialize malformed " + std::string(type->name) + " component");
 			return false;
-
-		// Set each data member of component
-		for (auto [id, member] : instanceType.data()) {
-			auto memberType = member.type();
-			if (!memberType)
-				continue;
-
-			// Set values of each member
-			// ...
 		}
 
 		return true;
 	}
 
-}
\ No newline at end of file
+}
@@ -1,19 +1,120 @@
 #pragma once
 
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+#include <glm/glm.hpp>
 #include <entt/entt.hpp>
 #include <nlohmann/json.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 using json = nlohmann::ordered_json;
 
 namespace ECSReflection {
 
-	// Registers all types and their associated reflection metadata
+	// Receives the reflected members of components, implemented by each serialization format
+	class Writer {
+	public:
+		virtual ~Writer() = default;
+
+		// Begins and ends a component of the given type
+		virtual void beginComponent(entt::id_type type, std::string_view name) = 0;
+		virtual void endComponent() = 0;
+
+		virtual void write(std::string_view key, bool value) = 0;
+		virtual void write(std::string_view key, int32_t value) = 0;
+		virtual void write(std::string_view key, uint32_t value) = 0;
+		virtual void write(std::string_view key, float value) = 0;
+		virtual void write(std::string_view key, const glm::vec3& value) = 0;
+		virtual void write(std::string_view key, const glm::quat& value) = 0;
+		virtual void write(std::string_view key, const std::string& value) = 0;
+	};
+
+	// Provides the reflected members of components, implemented by each serialization format
+	// Reads return false if a value is malformed, missing values may keep their defaults depending on the format
+	class Reader {
+	public:
+		virtual ~Reader() = default;
+
+		virtual bool read(std::string_view key, bool& value) = 0;
+		virtual bool read(std::string_view key, int32_t& value) = 0;
+		virtual bool read(std::string_view key, uint32_t& value) = 0;
+		virtual bool read(std::string_view key, float& value) = 0;
+		virtual bool read(std::string_view key, glm::vec3& value) = 0;
+		virtual bool read(std::string_view key, glm::quat& value) = 0;
+		virtual bool read(std::string_view key, std::string& value) = 0;
+	};
+
+	// Reflected data member of a component
+	struct Member {
+
+		// Name of the member
+		std::string_view name;
+
+		// Byte offset of the member within its component
+		uint32_t offset;
+
+		// Byte size of the member if it can be copied bytewise, zero otherwise
+		uint32_t size;
+
+		// Codec of the members type
+		void (*write)(Writer& writer, std::string_view key, const void* value);
+		bool (*read)(Reader& reader, std::string_view key, void* value);
+
+	};
+
+	// Reflected component type
+	struct Component {
+
+		// Hashed name of the component type
+		entt::id_type id;
+
+		// Hash of the c++ type of the component
+		entt::id_type typeHash;
+
+		// Name of the component type
+		std::string_view name;
+
+		// Serialized data members in serialization order
+		std::vector<Member> members;
+
+		// Returns the component of an entity or nullptr if the entity doesn't own one
+		const void* (*find)(entt::registry& registry, entt::entity entity);
+
+		// Reads a component of this type and emplaces or replaces it on an entity, returns success
+		bool (*emplace)(const Component& type, entt::registry& registry, entt::entity entity, Reader& reader);
+
+	};
+
+	// Registers all component types and builds their member tables (only once)
 	void registerAll();
 
-	// Serializes an ecs component instance to json
-	json serializeComponent(entt::meta_any instance);
+	// Returns all registered component types
+	const std::vector<Component>& components();
+
+	// Returns the registered component type with the given id or nullptr if there is none
+	const Component* resolve(entt::id_type id);
+
+	// Returns the registered component type with the given c++ type hash or nullptr if there is none
+	const Component* resolveType(entt::id_type typeHash);
+
+	// Returns the registered component type of a c++ type or nullptr if there is none
+	template <typename T>
+	const Component* resolve() {
+		return resolveType(entt::type_hash<T>::value());
+	}
+
+	// Writes all reflected members of a component instance
+	void serializeComponent(Writer& writer, const Component& type, const void* instance);
+
+	// Reads all reflected members into a component instance, returns success
+	bool deserializeMembers(Reader& reader, const Component& type, void* instance);
+
+	// Writes all reflected components owned by an entity
+	void serializeEntity(Writer& writer, entt::registry& registry, entt::entity entity);
 
 	// Deserializes a json component emplacing it onto the given entity
 	bool deserializeComponent(entt::entity entity, const json& source);
 
-}
\ No newline at end of file
+}
@@ -69,14 +69,16 @@ public:
 
 	// Returns id of entity
 	inline uint32_t id() const {
-		if (!_transform) return 0;
-		return _transform->id;
+		const IdentityComponent* identity = fetchIdentity();
+		if (!identity) return 0;
+		return identity->id;
 	}
 
 	// Returns name of entity
 	inline std::string name() const {
-		if (!_transform) return "Invalid Entity";
-		return _transform->name;
+		const IdentityComponent* identity = fetchIdentity();
+		if (!identity) return "Invalid Entity";
+		return identity->name;
 	}
 
 	// Returns if entity is valid in registry
@@ -148,6 +150,12 @@ private:
 	TransformComponent* _transform;
 
 private:
+	// Returns the identity of the entity or nullptr if it has none
+	const IdentityComponent* fetchIdentity() const {
+		if (!_transform || !verify()) return nullptr;
+		return ECS::main().reg().try_get<IdentityComponent>(_handle);
+	}
+
 	template<typename T>
 	void componentOperationFailed(std::string operation, std::string reason) {
 		Console::out::warning("Entity Container", "Couldn't " + operation + " some component because entity '" + name() + "' " + reason + "");
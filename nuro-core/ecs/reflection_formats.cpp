@@ -0,0 +1,401 @@
+#include "reflection_formats.h"
+
+#include <cmath>
+#include <charconv>
+#include <cstring>
+
+namespace ECSReflection {
+
+	//
+	// BINARY WRITER
+	//
+
+	BinaryWriter::BinaryWriter(std::vector<uint8_t>& output) : output(output),
+	sizeOffset(0)
+	{
+	}
+
+	void BinaryWriter::beginComponent(entt::id_type type, std::string_view name)
+	{
+		uint32_t id = type;
+		bytes(&id, sizeof(id));
+
+		// Payload size is patched once the component ends
+		sizeOffset = output.size();
+		uint32_t size = 0;
+		bytes(&size, sizeof(size));
+	}
+
+	void BinaryWriter::endComponent()
+	{
+		uint32_t size = static_cast<uint32_t>(output.size() - sizeOffset - sizeof(uint32_t));
+		std::memcpy(output.data() + sizeOffset, &size, sizeof(size));
+	}
+
+	void BinaryWriter::write(std::string_view key, bool value)
+	{
+		uint8_t byte = value ? 1 : 0;
+		bytes(&byte, sizeof(byte));
+	}
+
+	void BinaryWriter::write(std::string_view key, int32_t value)
+	{
+		bytes(&value, sizeof(value));
+	}
+
+	void BinaryWriter::write(std::string_view key, uint32_t value)
+	{
+		bytes(&value, sizeof(value));
+	}
+
+	void BinaryWriter::write(std::string_view key, float value)
+	{
+		bytes(&value, sizeof(value));
+	}
+
+	void BinaryWriter::write(std::string_view key, const glm::vec3& value)
+	{
+		float components[3] = { value.x, value.y, value.z };
+		bytes(components, sizeof(components));
+	}
+
+	void BinaryWriter::write(std::string_view key, const glm::quat& value)
+	{
+		float components[4] = { value.x, value.y, value.z, value.w };
+		bytes(components, sizeof(components));
+	}
+
+	void BinaryWriter::write(std::string_view key, const std::string& value)
+	{
+		uint32_t length = static_cast<uint32_t>(value.size());
+		bytes(&length, sizeof(length));
+		bytes(value.data(), value.size());
+	}
+
+	void BinaryWriter::bytes(const void* data, size_t size)
+	{
+		const uint8_t* source = static_cast<const uint8_t*>(data);
+		output.insert(output.end(), source, source + size);
+	}
+
+	//
+	// BINARY READER
+	//
+
+	BinaryReader::BinaryReader(const uint8_t* data, size_t size) : data(data),
+	size(size),
+	cursor(0)
+	{
+	}
+
+	bool BinaryReader::readComponent(entt::registry& registry, entt::entity entity)
+	{
+		uint32_t id = 0;
+		uint32_t payloadSize = 0;
+		if (!bytes(&id, sizeof(id)) || !bytes(&payloadSize, sizeof(payloadSize))) return false;
+		if (payloadSize > size - cursor) return false;
+
+		// Skip unknown component types
+		size_t end = cursor + payloadSize;
+		const Component* type = resolve(id);
+		if (!type) {
+			cursor = end;
+			return true;
+		}
+
+		// Payload must be consumed exactly
+		if (!type->emplace(*type, registry, entity, *this)) return false;
+		return cursor == end;
+	}
+
+	bool BinaryReader::done() const
+	{
+		return cursor >= size;
+	}
+
+	bool BinaryReader::read(std::string_view key, bool& value)
+	{
+		uint8_t byte = 0;
+		if (!bytes(&byte, sizeof(byte))) return false;
+		value = byte != 0;
+		return true;
+	}
+
+	bool BinaryReader::read(std::string_view key, int32_t& value)
+	{
+		return bytes(&value, sizeof(value));
+	}
+
+	bool BinaryReader::read(std::string_view key, uint32_t& value)
+	{
+		return bytes(&value, sizeof(value));
+	}
+
+	bool BinaryReader::read(std::string_view key, float& value)
+	{
+		return bytes(&value, sizeof(value));
+	}
+
+	bool BinaryReader::read(std::string_view key, glm::vec3& value)
+	{
+		float components[3];
+		if (!bytes(components, sizeof(components))) return false;
+		value = glm::vec3(components[0], components[1], components[2]);
+		return true;
+	}
+
+	bool BinaryReader::read(std::string_view key, glm::quat& value)
+	{
+		float components[4];
+		if (!bytes(components, sizeof(components))) return false;
+		value = glm::quat(components[3], components[0], components[1], components[2]);
+		return true;
+	}
+
+	bool BinaryReader::read(std::string_view key, std::string& value)
+	{
+		uint32_t length = 0;
+		if (!bytes(&length, sizeof(length)) || length > size - cursor) return false;
+		value.assign(reinterpret_cast<const char*>(data + cursor), length);
+		cursor += length;
+		return true;
+	}
+
+	bool BinaryReader::bytes(void* destination, size_t count)
+	{
+		if (count > size - cursor) return false;
+		std::memcpy(destination, data + cursor, count);
+		cursor += count;
+		return true;
+	}
+
+	//
+	// JSON WRITER
+	//
+
+	JsonWriter::JsonWriter(std::string& output) : output(output),
+	firstComponent(true),
+	firstMember(true)
+	{
+		output += '[';
+	}
+
+	void JsonWriter::finish()
+	{
+		output += ']';
+	}
+
+	void JsonWriter::beginComponent(entt::id_type type, std::string_view name)
+	{
+		if (!firstComponent) output += ',';
+		firstComponent = false;
+		firstMember = true;
+
+		output += "{\"type\":";
+		number(static_cast<int64_t>(type));
+		output += ",\"name\":";
+		string(name);
+		output += ",\"properties\":{";
+	}
+
+	void JsonWriter::endComponent()
+	{
+		output += "}}";
+	}
+
+	void JsonWriter::write(std::string_view key, bool value)
+	{
+		this->key(key);
+		output += value ? "true" : "false";
+	}
+
+	void JsonWriter::write(std::string_view key, int32_t value)
+	{
+		this->key(key);
+		number(static_cast<int64_t>(value));
+	}
+
+	void JsonWriter::write(std::string_view key, uint32_t value)
+	{
+		this->key(key);
+		number(static_cast<int64_t>(value));
+	}
+
+	void JsonWriter::write(std::string_view key, float value)
+	{
+		this->key(key);
+		number(value);
+	}
+
+	void JsonWriter::write(std::string_view key, const glm::vec3& value)
+	{
+		this->key(key);
+		output += "{\"x\":";
+		number(value.x);
+		output += ",\"y\":";
+		number(value.y);
+		output += ",\"z\":";
+		number(value.z);
+		output += '}';
+	}
+
+	void JsonWriter::write(std::string_view key, const glm::quat& value)
+	{
+		this->key(key);
+		output += "{\"x\":";
+		number(value.x);
+		output += ",\"y\":";
+		number(value.y);
+		output += ",\"z\":";
+		number(value.z);
+		output += ",\"w\":";
+		number(value.w);
+		output += '}';
+	}
+
+	void JsonWriter::write(std::string_view key, const std::string& value)
+	{
+		this->key(key);
+		string(value);
+	}
+
+	void JsonWriter::key(std::string_view key)
+	{
+		if (!firstMember) output += ',';
+		firstMember = false;
+
+		// Member names never need escaping
+		output += '"';
+		output += key;
+		output += "\":";
+	}
+
+	void JsonWriter::number(float value)
+	{
+		// Json has no representation for non finite values
+		if (!std::isfinite(value)) value = 0.0f;
+
+		// Shortest representation that reads back to the same value
+		char buffer[32];
+		auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+		output.append(buffer, result.ptr);
+	}
+
+	void JsonWriter::number(int64_t value)
+	{
+		char buffer[24];
+		auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+		output.append(buffer, result.ptr);
+	}
+
+	void JsonWriter::string(std::string_view value)
+	{
+		static const char* hex = "0123456789abcdef";
+
+		output += '"';
+		for (char c : value) {
+			switch (c) {
+			case '"': output += "\\\""; break;
+			case '\\': output += "\\\\"; break;
+			case '\n': output += "\\n"; break;
+			case '\r': output += "\\r"; break;
+			case '\t': output += "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20) {
+					output += "\\u00";
+					output += hex[(c >> 4) & 0xF];
+					output += hex[c & 0xF];
+				}
+				else {
+					output += c;
+				}
+				break;
+			}
+		}
+		output += '"';
+	}
+
+	//
+	// JSON READER
+	//
+
+	JsonReader::JsonReader(const json& properties) : properties(properties)
+	{
+	}
+
+	bool JsonReader::read(std::string_view key, bool& value)
+	{
+		const json* member = find(key);
+		if (!member) return true;
+		if (!member->is_boolean()) return false;
+		value = member->get<bool>();
+		return true;
+	}
+
+	bool JsonReader::read(std::string_view key, int32_t& value)
+	{
+		const json* member = find(key);
+		if (!member) return true;
+		if (!member->is_number_integer()) return false;
+		value = member->get<int32_t>();
+		return true;
+	}
+
+	bool JsonReader::read(std::string_view key, uint32_t& value)
+	{
+		const json* member = find(key);
+		if (!member) return true;
+		if (!member->is_number_unsigned()) return false;
+		value = member->get<uint32_t>();
+		return true;
+	}
+
+	bool JsonReader::read(std::string_view key, float& value)
+	{
+		const json* member = find(key);
+		if (!member) return true;
+		if (!member->is_number()) return false;
+		value = member->get<float>();
+		return true;
+	}
+
+	bool JsonReader::read(std::string_view key, glm::vec3& value)
+	{
+		const json* member = find(key);
+		if (!member) return true;
+		if (!member->is_object()) return false;
+		value.x = member->value("x", value.x);
+		value.y = member->value("y", value.y);
+		value.z = member->value("z", value.z);
+		return true;
+	}
+
+	bool JsonReader::read(std::string_view key, glm::quat& value)
+	{
+		const json* member = find(key);
+		if (!member) return true;
+		if (!member->is_object()) return false;
+		value.x = member->value("x", value.x);
+		value.y = member->value("y", value.y);
+		value.z = member->value("z", value.z);
+		value.w = member->value("w", value.w);
+		return true;
+	}
+
+	bool JsonReader::read(std::string_view key, std::string& value)
+	{
+		const json* member = find(key);
+		if (!member) return true;
+		if (!member->is_string()) return false;
+		value = member->get<std::string>();
+		return true;
+	}
+
+	const json* JsonReader::find(std::string_view key) const
+	{
+		if (!properties.is_object()) return nullptr;
+		auto it = properties.find(std::string(key));
+		return it != properties.end() ? &*it : nullptr;
+	}
+
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <ecs/ecs_reflection.h>
+
+namespace ECSReflection {
+
+	// Writes components into a compact binary buffer
+	// Each component is its type id and payload size followed by its members in table order
+	class BinaryWriter : public Writer {
+	public:
+		explicit BinaryWriter(std::vector<uint8_t>& output);
+
+		void beginComponent(entt::id_type type, std::string_view name) override;
+		void endComponent() override;
+
+		void write(std::string_view key, bool value) override;
+		void write(std::string_view key, int32_t value) override;
+		void write(std::string_view key, uint32_t value) override;
+		void write(std::string_view key, float value) override;
+		void write(std::string_view key, const glm::vec3& value) override;
+		void write(std::string_view key, const glm::quat& value) override;
+		void write(std::string_view key, const std::string& value) override;
+
+	private:
+		std::vector<uint8_t>& output;
+
+		// Offset of the payload size of the current component
+		size_t sizeOffset;
+
+		void bytes(const void* data, size_t size);
+	};
+
+	// Reads components written by a binary writer
+	class BinaryReader : public Reader {
+	public:
+		BinaryReader(const uint8_t* data, size_t size);
+
+		// Reads the next component and emplaces it onto an entity, unknown component types are skipped
+		// Returns false if the data is malformed
+		bool readComponent(entt::registry& registry, entt::entity entity);
+
+		// Returns if all data was read
+		bool done() const;
+
+		bool read(std::string_view key, bool& value) override;
+		bool read(std::string_view key, int32_t& value) override;
+		bool read(std::string_view key, uint32_t& value) override;
+		bool read(std::string_view key, float& value) override;
+		bool read(std::string_view key, glm::vec3& value) override;
+		bool read(std::string_view key, glm::quat& value) override;
+		bool read(std::string_view key, std::string& value) override;
+
+	private:
+		const uint8_t* data;
+		size_t size;
+		size_t cursor;
+
+		bool bytes(void* destination, size_t count);
+	};
+
+	// Writes components as a json array of objects directly into a string, without building a json document
+	class JsonWriter : public Writer {
+	public:
+		explicit JsonWriter(std::string& output);
+
+		// Closes the array, call once after all components were written
+		void finish();
+
+		void beginComponent(entt::id_type type, std::string_view name) override;
+		void endComponent() override;
+
+		void write(std::string_view key, bool value) override;
+		void write(std::string_view key, int32_t value) override;
+		void write(std::string_view key, uint32_t value) override;
+		void write(std::string_view key, float value) override;
+		void write(std::string_view key, const glm::vec3& value) override;
+		void write(std::string_view key, const glm::quat& value) override;
+		void write(std::string_view key, const std::string& value) override;
+
+	private:
+		std::string& output;
+
+		bool firstComponent;
+		bool firstMember;
+
+		void key(std::string_view key);
+		void number(float value);
+		void number(int64_t value);
+		void string(std::string_view value);
+	};
+
+	// Reads the properties object of a json component, missing members keep their defaults
+	class JsonReader : public Reader {
+	public:
+		explicit JsonReader(const json& properties);
+
+		bool read(std::string_view key, bool& value) override;
+		bool read(std::string_view key, int32_t& value) override;
+		bool read(std::string_view key, uint32_t& value) override;
+		bool read(std::string_view key, float& value) override;
+		bool read(std::string_view key, glm::vec3& value) override;
+		bool read(std::string_view key, glm::quat& value) override;
+		bool read(std::string_view key, std::string& value) override;
+
+	private:
+		const json& properties;
+
+		// Returns the value of a member or nullptr if it's missing
+		const json* find(std::string_view key) const;
+	};
+
+}
@@ -0,0 +1,179 @@
+#include "frame_allocator.h"
+
+#include <cstring>
+#include <algorithm>
+
+#include <utils/console.h>
+#include <diagnostics/diagnostics.h>
+
+FrameAllocator::FrameAllocator(std::unique_ptr<FrameAllocatorBackend> backend) : backend(std::move(backend)),
+buffer(0),
+mapping(nullptr),
+_regionSize(0),
+region(0),
+head(0),
+frame(0),
+fences(),
+retiredBuffers()
+{
+}
+
+FrameAllocator::~FrameAllocator()
+{
+	destroy();
+}
+
+void FrameAllocator::create(uint32_t regionSize)
+{
+	// Make sure allocator wasn't created already
+	if (buffer) return;
+
+	regionSize = alignRegion(regionSize);
+
+	buffer = backend->createBuffer(regionSize * N_REGIONS, mapping);
+	_regionSize = regionSize;
+	region = 0;
+	head = 0;
+}
+
+void FrameAllocator::destroy()
+{
+	// Wait for and release all fences
+	for (uint64_t& fence : fences) {
+		if (!fence) continue;
+		backend->waitFence(fence);
+		backend->releaseFence(fence);
+		fence = 0;
+	}
+
+	// Destroy retired buffers
+	for (RetiredBuffer& retired : retiredBuffers) {
+		backend->destroyBuffer(retired.buffer);
+	}
+	retiredBuffers.clear();
+
+	// Destroy current buffer
+	if (buffer) backend->destroyBuffer(buffer);
+	buffer = 0;
+	mapping = nullptr;
+	_regionSize = 0;
+	head = 0;
+}
+
+void FrameAllocator::beginFrame()
+{
+	frame++;
+
+	// Advance to next frame region
+	region = (region + 1) % N_REGIONS;
+	head = 0;
+
+	// Wait until the gpu is done reading the regions previous contents
+	uint64_t& fence = fences[region];
+	if (fence) {
+		backend->waitFence(fence);
+		backend->releaseFence(fence);
+		fence = 0;
+	}
+
+	// Destroy retired buffers which can't be in use anymore
+	auto expired = [&](const RetiredBuffer& retired) {
+		if (frame - retired.frame < N_REGIONS) return false;
+		backend->destroyBuffer(retired.buffer);
+		return true;
+		};
+	retiredBuffers.erase(std::remove_if(retiredBuffers.begin(), retiredBuffers.end(), expired), retiredBuffers.end());
+}
+
+void FrameAllocator::endFrame()
+{
+	// Nothing allocated this frame
+	if (head == 0) return;
+
+	fences[region] = backend->insertFence();
+}
+
+FrameAllocator::Allocation FrameAllocator::allocate(uint32_t size, uint32_t alignment)
+{
+	// Nothing to allocate
+	if (size == 0 || !buffer) return Allocation();
+
+	// Align offset within region
+	alignment = std::max(alignment, 1u);
+	uint32_t offset = (head + alignment - 1) / alignment * alignment;
+
+	// Grow if region is exhausted
+	if (offset + size > _regionSize) {
+		grow(std::max(_regionSize * 2, size + alignment));
+		offset = 0;
+	}
+
+	head = offset + size;
+
+	// Chunk is written by the cpu and read by the gpu, count it as uploaded
+	Diagnostics::addUploadedBytes(size);
+
+	// Return chunk of current region
+	uint32_t bufferOffset = region * _regionSize + offset;
+
+	Allocation allocation;
+	allocation.data = mapping + bufferOffset;
+	allocation.buffer = buffer;
+	allocation.offset = bufferOffset;
+	allocation.size = size;
+	return allocation;
+}
+
+FrameAllocator::Allocation FrameAllocator::write(const void* data, uint32_t size, uint32_t alignment)
+{
+	Allocation allocation = allocate(size, alignment);
+	if (allocation.valid()) std::memcpy(allocation.data, data, size);
+	return allocation;
+}
+
+uint32_t FrameAllocator::backendId() const
+{
+	return buffer;
+}
+
+uint32_t FrameAllocator::regionSize() const
+{
+	return _regionSize;
+}
+
+uint32_t FrameAllocator::currentRegion() const
+{
+	return region;
+}
+
+uint32_t FrameAllocator::used() const
+{
+	return head;
+}
+
+uint32_t FrameAllocator::alignRegion(uint32_t regionSize)
+{
+	return (std::max(regionSize, 1u) + REGION_ALIGNMENT - 1) / REGION_ALIGNMENT * REGION_ALIGNMENT;
+}
+
+void FrameAllocator::grow(uint32_t regionSize)
+{
+	regionSize = alignRegion(regionSize);
+
+	Console::out::warning("Frame Allocator", "Frame region exhausted, growing regions to " + std::to_string(regionSize) + " bytes");
+
+	// Allocations of this frame may still reference the old buffer, keep it alive for now
+	retiredBuffers.push_back({ buffer, frame });
+
+	// Fences guard the old buffer only
+	for (uint64_t& fence : fences) {
+		if (!fence) continue;
+		backend->releaseFence(fence);
+		fence = 0;
+	}
+
+	// Create bigger buffer
+	buffer = backend->createBuffer(regionSize * N_REGIONS, mapping);
+	_regionSize = regionSize;
+	head = 0;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <memory>
+
+// Backend providing persistently mapped buffers and fences to a frame allocator
+class FrameAllocatorBackend
+{
+public:
+	virtual ~FrameAllocatorBackend() = default;
+
+	// Creates a persistently mapped buffer of given size, returns its id and its mapped memory through mapping
+	virtual uint32_t createBuffer(uint32_t size, uint8_t*& mapping) = 0;
+
+	// Unmaps and destroys a buffer
+	virtual void destroyBuffer(uint32_t buffer) = 0;
+
+	// Inserts a fence after all commands issued so far and returns its handle
+	virtual uint64_t insertFence() = 0;
+
+	// Blocks until the given fence is signaled
+	virtual void waitFence(uint64_t fence) = 0;
+
+	// Releases a fence
+	virtual void releaseFence(uint64_t fence) = 0;
+};
+
+// Bump allocates dynamic per frame data from a persistently mapped buffer split into fenced frame regions
+class FrameAllocator
+{
+public:
+	// Number of frame regions, the cpu can write a frame while the gpu still reads the previous ones
+	static constexpr uint32_t N_REGIONS = 3;
+
+	// Region sizes are rounded to this, chunks aligned within a region stay aligned within the buffer for alignments up to it
+	static constexpr uint32_t REGION_ALIGNMENT = 256;
+
+	// Chunk of the current frame region
+	struct Allocation
+	{
+		// Mapped memory of chunk
+		uint8_t* data = nullptr;
+
+		// Backend id of the buffer the chunk belongs to
+		uint32_t buffer = 0;
+
+		// Offset of chunk within buffer in bytes
+		uint32_t offset = 0;
+
+		// Size of chunk in bytes
+		uint32_t size = 0;
+
+		// Returns if allocation is backed by memory
+		bool valid() const { return data != nullptr; }
+	};
+
+	explicit FrameAllocator(std::unique_ptr<FrameAllocatorBackend> backend);
+	~FrameAllocator();
+
+	// Creates the backing buffer with the given size per frame region
+	void create(uint32_t regionSize);
+
+	// Destroys the backing buffer and releases all fences
+	void destroy();
+
+	// Advances to the next frame region, waits until the gpu is done reading it
+	void beginFrame();
+
+	// Fences the current frame region, call after all commands reading the frames allocations were issued
+	void endFrame();
+
+	// Allocates an aligned chunk within the current frame region, grows the buffer if the region is exhausted
+	Allocation allocate(uint32_t size, uint32_t alignment);
+
+	// Allocates an aligned chunk and copies the given data into it
+	Allocation write(const void* data, uint32_t size, uint32_t alignment);
+
+	// Returns the backend id of the current buffer
+	uint32_t backendId() const;
+
+	// Returns the size of a single frame region in bytes
+	uint32_t regionSize() const;
+
+	// Returns the index of the current frame region
+	uint32_t currentRegion() const;
+
+	// Returns the amount of bytes allocated within the current frame region
+	uint32_t used() const;
+
+private:
+	// Buffer replaced by a bigger one, kept alive until allocations made from it can't be referenced anymore
+	struct RetiredBuffer
+	{
+		uint32_t buffer;
+		uint64_t frame;
+	};
+
+	// Rounds a region size up to REGION_ALIGNMENT
+	static uint32_t alignRegion(uint32_t regionSize);
+
+	// Recreates the buffer with a bigger region size
+	void grow(uint32_t regionSize);
+
+	// Backend of allocator
+	std::unique_ptr<FrameAllocatorBackend> backend;
+
+	// Current buffer and its mapped memory
+	uint32_t buffer;
+	uint8_t* mapping;
+
+	// Size of each frame region in bytes
+	uint32_t _regionSize;
+
+	// Index of current frame region
+	uint32_t region;
+
+	// Bump offset within current frame region
+	uint32_t head;
+
+	// Frame counter
+	uint64_t frame;
+
+	// Fence guarding each frame region, 0 if none
+	uint64_t fences[N_REGIONS];
+
+	// Buffers pending destruction
+	std::vector<RetiredBuffer> retiredBuffers;
+};
@@ -0,0 +1,112 @@
+#include "range_allocator.h"
+
+RangeAllocator::RangeAllocator(uint32_t capacity) : _capacity(0),
+_used(0),
+freeRanges(),
+allocations()
+{
+	grow(capacity);
+}
+
+uint32_t RangeAllocator::allocate(uint32_t size)
+{
+	// Nothing to allocate
+	if (size == 0) return INVALID_OFFSET;
+
+	// Find first free range big enough
+	for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it) {
+		auto [offset, rangeSize] = *it;
+		if (rangeSize < size) continue;
+
+		// Shrink or consume free range
+		freeRanges.erase(it);
+		if (rangeSize > size) freeRanges.emplace(offset + size, rangeSize - size);
+
+		// Register allocation
+		allocations.emplace(offset, size);
+		_used += size;
+
+		return offset;
+	}
+
+	// No fitting free range
+	return INVALID_OFFSET;
+}
+
+void RangeAllocator::free(uint32_t offset)
+{
+	// Make sure allocation is existing
+	auto it = allocations.find(offset);
+	if (it == allocations.end()) return;
+
+	// Release allocation
+	uint32_t size = it->second;
+	allocations.erase(it);
+	_used -= size;
+
+	insertFreeRange(offset, size);
+}
+
+void RangeAllocator::grow(uint32_t capacity)
+{
+	// Address space can't shrink
+	if (capacity <= _capacity) return;
+
+	insertFreeRange(_capacity, capacity - _capacity);
+	_capacity = capacity;
+}
+
+void RangeAllocator::reset()
+{
+	freeRanges.clear();
+	allocations.clear();
+	_used = 0;
+
+	if (_capacity > 0) freeRanges.emplace(0, _capacity);
+}
+
+uint32_t RangeAllocator::capacity() const
+{
+	return _capacity;
+}
+
+uint32_t RangeAllocator::used() const
+{
+	return _used;
+}
+
+uint32_t RangeAllocator::nAllocations() const
+{
+	return static_cast<uint32_t>(allocations.size());
+}
+
+uint32_t RangeAllocator::largestFreeRange() const
+{
+	uint32_t largest = 0;
+	for (const auto& [offset, size] : freeRanges) {
+		if (size > largest) largest = size;
+	}
+	return largest;
+}
+
+void RangeAllocator::insertFreeRange(uint32_t offset, uint32_t size)
+{
+	auto next = freeRanges.lower_bound(offset);
+
+	// Merge with following free range
+	if (next != freeRanges.end() && offset + size == next->first) {
+		size += next->second;
+		next = freeRanges.erase(next);
+	}
+
+	// Merge with preceding free range
+	if (next != freeRanges.begin()) {
+		auto previous = std::prev(next);
+		if (previous->first + previous->second == offset) {
+			previous->second += size;
+			return;
+		}
+	}
+
+	freeRanges.emplace(offset, size);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <map>
+#include <cstdint>
+#include <unordered_map>
+
+// Sub-allocates ranges of elements from a linear address space (no backend dependencies)
+class RangeAllocator
+{
+public:
+	// Offset returned if an allocation couldn't be served
+	static constexpr uint32_t INVALID_OFFSET = UINT32_MAX;
+
+	explicit RangeAllocator(uint32_t capacity = 0);
+
+	// Allocates a range of given size, returns its offset or INVALID_OFFSET if there is no fitting free range
+	uint32_t allocate(uint32_t size);
+
+	// Frees the range allocated at the given offset
+	void free(uint32_t offset);
+
+	// Extends the capacity of the address space, existing allocations stay untouched
+	void grow(uint32_t capacity);
+
+	// Releases all allocations
+	void reset();
+
+	// Returns the total capacity of the address space
+	uint32_t capacity() const;
+
+	// Returns the amount of allocated elements
+	uint32_t used() const;
+
+	// Returns the amount of live allocations
+	uint32_t nAllocations() const;
+
+	// Returns the size of the largest contiguous free range
+	uint32_t largestFreeRange() const;
+
+private:
+	// Inserts a free range and merges it with its adjacent free ranges
+	void insertFreeRange(uint32_t offset, uint32_t size);
+
+	// Total capacity of the address space
+	uint32_t _capacity;
+
+	// Amount of allocated elements
+	uint32_t _used;
+
+	// Free ranges sorted by offset (offset -> size)
+	std::map<uint32_t, uint32_t> freeRanges;
+
+	// Live allocations (offset -> size)
+	std::unordered_map<uint32_t, uint32_t> allocations;
+};
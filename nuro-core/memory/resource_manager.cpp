@@ -1,7 +1,13 @@
 #include "resource_manager.h"
 
-ResourceManager::ResourceManager() : idCounter(0),
-resources(),
+#include <algorithm>
+
+ResourceManager::ResourceManager() : slots(),
+freeSlots(),
+pools(),
+nAllocated(0),
+mtxSlots(),
+retired(),
 asyncPipes(),
 asyncPipesSize(0),
 processorRunning(false),
@@ -25,6 +31,24 @@ ResourceManager::~ResourceManager()
 
 void ResourceManager::updateContext()
 {
+	// Destroy released resources no one else references anymore, their backend data is freed on this thread
+	// Resources may be released from any thread, take the queue under the lock and destroy outside of it
+	std::vector<ResourceRef<Resource>> candidates;
+	{
+		std::lock_guard lock(mtxSlots);
+		candidates.swap(retired);
+	}
+
+	if (!candidates.empty()) {
+		// Keep resources that are still referenced retired
+		auto unreferenced = std::partition(candidates.begin(), candidates.end(), [](const ResourceRef<Resource>& resource) { return resource.use_count() > 1; });
+		if (unreferenced != candidates.begin()) {
+			std::lock_guard lock(mtxSlots);
+			retired.insert(retired.end(), std::make_move_iterator(candidates.begin()), std::make_move_iterator(unreferenced));
+		}
+		candidates.clear();
+	}
+
 	// Make sure task is waiting to get executed on context thread
 	if (!contextNext) return;
 
@@ -102,12 +126,52 @@ bool ResourceManager::execAsDependency(ResourcePipe&& pipe)
 
 void ResourceManager::release(ResourceID id)
 {
-	ResourceRef<Resource> resource = getResource(id);
-	if (!resource) 
+	std::lock_guard lock(mtxSlots);
+
+	const Slot* resolved = resolve(id);
+	if (!resolved)
 		return;
 
+	uint32_t index = (id & INDEX_MASK) - 1;
+	Slot& slot = slots[index];
+	ResourcePool& pool = pools[slot.pool];
+
+	// Retire resource, it's destroyed by the first context update after it isn't used anymore
+	ResourceRef<Resource> resource = std::move(pool.resources[slot.dense]);
 	resource->_resourceState = ResourceState::EMPTY;
-	resources.erase(id);
+	retired.push_back(std::move(resource));
+
+	// Swap remove resource from its pool
+	uint32_t last = static_cast<uint32_t>(pool.resources.size() - 1);
+	if (slot.dense != last) {
+		pool.resources[slot.dense] = std::move(pool.resources[last]);
+		pool.slots[slot.dense] = pool.slots[last];
+		slots[pool.slots[slot.dense]].dense = slot.dense;
+	}
+	pool.resources.pop_back();
+	pool.slots.pop_back();
+
+	// Invalidate all ids of slot and make it reusable
+	slot.resource = nullptr;
+	slot.generation = (slot.generation + 1) & GENERATION_MASK;
+	freeSlots.push_back(index);
+	nAllocated--;
+}
+
+uint32_t ResourceManager::allocateSlot()
+{
+	if (!freeSlots.empty()) {
+		uint32_t index = freeSlots.back();
+		freeSlots.pop_back();
+		return index;
+	}
+
+	if (slots.size() >= MAX_RESOURCES) {
+		Console::out::error("Resource Manager", "Fatal: Exceeded the maximum of " + std::to_string(MAX_RESOURCES) + " resources");
+	}
+
+	slots.emplace_back();
+	return static_cast<uint32_t>(slots.size() - 1);
 }
 
 void ResourceManager::asyncPipeProcessor() {
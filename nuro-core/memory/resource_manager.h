@@ -5,8 +5,10 @@
 #include <thread>
 #include <atomic>
 #include <memory>
+#include <vector>
 #include <utility>
-#include <unordered_map>
+#include <algorithm>
+#include <typeinfo>
 #include <condition_variable>
 
 #include <utils/console.h>
@@ -17,8 +19,36 @@
 template <typename T>
 using ResourceRef = std::shared_ptr<T>;
 
+// Resources of a single type, listed densely for linear iteration
+struct ResourcePool {
+
+	// Readable name of the resource type
+	std::string typeName;
+
+	// Owning references of all resources of this type
+	std::vector<ResourceRef<Resource>> resources;
+
+	// Slot of each resource
+	std::vector<uint32_t> slots;
+
+};
+
 class ResourceManager
 {
+public:
+	//
+	// RESOURCE IDS
+	// A resource id is a generation checked handle: the slot index (+1, zero is never valid) in its low bits, the slot generation in its high bits
+	// Ids of released resources stay invalid until the generation of their slot wraps around
+	//
+
+	static constexpr uint32_t INDEX_BITS = 20;
+	static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+	static constexpr uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
+	// Maximum amount of simultaneously allocated resources
+	static constexpr uint32_t MAX_RESOURCES = INDEX_MASK - 1;
+
 public:
 	ResourceManager();
 	~ResourceManager();
@@ -32,29 +62,44 @@ public:
 	// Executes a resource pipe synchronously, only possible until the first pipe was queued for asynchronous execution
 	bool execAsDependency(ResourcePipe&& pipe);
 
-	// Creates a new resource (lifetime managed by resource manager)
+	// Creates a new resource (lifetime managed by resource manager, create from the context thread only)
 	template <typename T, typename... Args>
 	std::pair<ResourceID, ResourceRef<T>> create(const std::string& name, Args&&... args) {
 		static_assert(std::is_base_of<Resource, T>::value, "Only classes that derive from Resource are valid for allocation");
 
-		// Create and return resource
-		ResourceID id = ++idCounter;
-		const auto& result = resources.emplace(id, std::make_shared<T>(std::forward<Args>(args)...));
-		auto& resource = result.first->second;
-		resource->_resourceId = id;
+		ResourceRef<T> resource = std::make_shared<T>(std::forward<Args>(args)...);
 		resource->_resourceName = name;
-		return std::make_pair(id, std::static_pointer_cast<T>(resource));
+
+		std::lock_guard lock(mtxSlots);
+
+		// Fetch pool of resource type
+		uint32_t poolIndex = typeIndex<T>();
+		if (poolIndex >= pools.size()) pools.resize(poolIndex + 1);
+		ResourcePool& pool = pools[poolIndex];
+		if (pool.typeName.empty()) pool.typeName = typeName<T>();
+
+		// Allocate slot and list resource in its pool
+		uint32_t index = allocateSlot();
+		Slot& slot = slots[index];
+		slot.resource = resource.get();
+		slot.pool = poolIndex;
+		slot.dense = static_cast<uint32_t>(pool.resources.size());
+		pool.resources.push_back(resource);
+		pool.slots.push_back(index);
+		nAllocated++;
+
+		ResourceID id = makeId(index, slot.generation);
+		resource->_resourceId = id;
+		return std::make_pair(id, std::move(resource));
 	}
 
 	// Retrieves an optional resource handle for a resource base by resource id, nullptr if none
 	ResourceRef<Resource> getResource(ResourceID id) {
-		// Find resource
-		auto it = resources.find(id);
-		if (it != resources.end())
-			return it->second;
+		std::lock_guard lock(mtxSlots);
 
-		// Resource not found
-		return nullptr;
+		const Slot* slot = resolve(id);
+		if (!slot) return nullptr;
+		return pools[slot->pool].resources[slot->dense];
 	}
 
 	// Retrieves an optional handle for a derived type T of resource by resource id, nullptr if none
@@ -62,16 +107,31 @@ public:
 	ResourceRef<T> getResourceAs(ResourceID id) {
 		static_assert(std::is_base_of<Resource, T>::value, "Only classes that derive from Resource are retrievable");
 
-		// Find resource
-		auto it = resources.find(id);
-		if (it != resources.end())
-			return std::static_pointer_cast<T>(it->second);
+		return std::static_pointer_cast<T>(getResource(id));
+	}
 
-		// Resource not found
-		return nullptr;
+	// Returns the resource of an id without taking a reference, nullptr if none
+	// Only valid on the context thread and until the resource is released, use for lookups on hot paths
+	Resource* peek(ResourceID id) const {
+		const Slot* slot = resolve(id);
+		return slot ? slot->resource : nullptr;
 	}
 
-	// Unregisters a resource, it will be released once its not used anymore
+	// Returns the resource of an id as derived type T without taking a reference, nullptr if none (see peek())
+	template <typename T>
+	T* peekAs(ResourceID id) const {
+		static_assert(std::is_base_of<Resource, T>::value, "Only classes that derive from Resource are retrievable");
+
+		return static_cast<T*>(peek(id));
+	}
+
+	// Returns if a resource id refers to an allocated resource
+	bool valid(ResourceID id) const {
+		return resolve(id) != nullptr;
+	}
+
+	// Unregisters a resource, its id becomes invalid immediately
+	// The resource is destroyed on the context thread once it's not used anymore
 	void release(ResourceID id);
 
 	// State of the async pipe processor
@@ -93,20 +153,91 @@ public:
 		return asyncPipesSize;
 	}
 
-	//
-	// TEMPORARY!
-	//
+	// Returns the amount of allocated resources
+	uint32_t nResources() const {
+		return nAllocated;
+	}
+
+	// Returns the amount of released resources awaiting destruction
+	uint32_t nRetired() const {
+		std::lock_guard lock(mtxSlots);
+		return static_cast<uint32_t>(retired.size());
+	}
 
-	const auto& readResources() {
-		return resources;
+	// Returns the resource pools of all types created so far, read from the context thread only
+	const std::vector<ResourcePool>& readPools() const {
+		return pools;
 	}
 
 private:
-	// Counter for unique resource ids throughout application lifetime
-	ResourceID idCounter;
+	struct Slot {
+		// Resource of slot, nullptr if free
+		Resource* resource = nullptr;
+
+		// Pool of resource and index within pool
+		uint32_t pool = 0;
+		uint32_t dense = 0;
+
+		// Incremented whenever the slot is released
+		uint32_t generation = 0;
+	};
+
+	// Resource slots, indexed by resource ids
+	std::vector<Slot> slots;
+
+	// Indices of free slots
+	std::vector<uint32_t> freeSlots;
+
+	// Resource pools, indexed by resource type
+	std::vector<ResourcePool> pools;
+
+	// Amount of allocated resources
+	uint32_t nAllocated;
+
+	// Guards slots and pools against lookups from the pipe processor while they're modified
+	mutable std::mutex mtxSlots;
+
+	// Released resources, destroyed on the context thread once their last outside reference is gone (guarded by mtxSlots)
+	std::vector<ResourceRef<Resource>> retired;
 
-	// Registry mapping a resource id to its resource reference
-	std::unordered_map<ResourceID, ResourceRef<Resource>> resources;
+	// Returns an unused slot index
+	uint32_t allocateSlot();
+
+	// Returns the slot of a resource id or nullptr if id is invalid
+	const Slot* resolve(ResourceID id) const {
+		uint32_t index = (id & INDEX_MASK) - 1;
+		if (index >= slots.size()) return nullptr;
+
+		const Slot& slot = slots[index];
+		if (!slot.resource || slot.generation != (id >> INDEX_BITS)) return nullptr;
+		return &slot;
+	}
+
+	// Builds a resource id from a slot index and generation
+	static ResourceID makeId(uint32_t index, uint32_t generation) {
+		return (generation << INDEX_BITS) | (index + 1);
+	}
+
+	// Returns a unique index per resource type
+	template <typename T>
+	static uint32_t typeIndex() {
+		static const uint32_t index = typeCounter++;
+		return index;
+	}
+
+	// Counter for unique resource type indices
+	static inline std::atomic<uint32_t> typeCounter = 0;
+
+	// Returns a readable name of a resource type
+	template <typename T>
+	static std::string typeName() {
+		// Strip msvc type prefixes or the length prefix of itanium mangled names
+		std::string name = typeid(T).name();
+		for (std::string prefix : { "class ", "struct " }) {
+			if (name.rfind(prefix, 0) == 0) return name.substr(prefix.size());
+		}
+		return name.substr(std::min(name.find_first_not_of("0123456789"), name.size()));
+	}
 
 	//
 	// RESOURCE PIPE PROCESSING
@@ -3,6 +3,8 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/component_wise.hpp>
 
+#include <algorithm>
+
 #include <utils/console.h>
 #include <transform/transform.h>
 #include <physics/rigidbody/rigidbody.h>
@@ -12,7 +14,8 @@ using namespace physx;
 
 PhysicsBridge::PhysicsBridge(PxPhysics*& physics, PxScene*& scene) : physics(physics), 
 scene(scene), 
-defaultMaterial(nullptr) 
+defaultMaterial(nullptr),
+pendingActors()
 {
 };
 
@@ -98,19 +101,33 @@ void PhysicsBridge::constructRigidbody(Registry& reg, Entity ent) {
 	Rigidbody::setAngularResistance(rigidbody, rigidbody.angularResistance);
 	Rigidbody::setGravity(rigidbody, rigidbody.gravity);
 	Rigidbody::setKinematic(rigidbody, rigidbody.kinematic);
+
+	// Add rigidbody actor to scene, actors of a batch are added at once when it ends
+	if (ECS::main().batching()) pendingActors.push_back(rbActor);
+	else scene->addActor(*rbActor);
 }
 
 void PhysicsBridge::destroyRigidbody(Registry& reg, Entity ent) {
 	// Get components
 	RigidbodyComponent& rigidbody = get<RigidbodyComponent>(reg, ent);
 
-	// Remove rigidbody from scene
-	scene->removeActor(*rigidbody.actor);
+	// Remove rigidbody from scene or from pending actors if it wasn't added yet
+	auto pending = std::find(pendingActors.begin(), pendingActors.end(), rigidbody.actor);
+	if (pending != pendingActors.end()) pendingActors.erase(pending);
+	else scene->removeActor(*rigidbody.actor);
 
 	// Release rigidbody
 	rigidbody.actor->release();
 }
 
+void PhysicsBridge::flushPendingActors()
+{
+	if (pendingActors.empty()) return;
+
+	scene->addActors(pendingActors.data(), static_cast<PxU32>(pendingActors.size()));
+	pendingActors.clear();
+}
+
 PxMaterial* PhysicsBridge::createMaterial(PxPhysics*& physics, float staticFriction, float dynamicFriction, float restitution)
 {
 	PxMaterial* material = physics->createMaterial(staticFriction, dynamicFriction, restitution);
@@ -144,8 +161,5 @@ PxRigidDynamic* PhysicsBridge::createDynamicRigidbody(PxPhysics*& physics, PxSce
 	float density = 1.0f;
 	PxRigidBodyExt::updateMassAndInertia(*rbActor, density);
 
-	// Add rigidbody actor to scene
-	scene->addActor(*rbActor);
-
 	return rbActor;
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vector>
 #include <entt/entt.hpp>
 #include <PxPhysicsAPI.h>
 
@@ -23,6 +24,9 @@ public:
 
 	void constructRigidbody(Registry& reg, Entity ent);
 	void destroyRigidbody(Registry& reg, Entity ent);
+
+	// Adds all rigidbody actors constructed during an ecs batch to the scene at once
+	void flushPendingActors();
 	 
 private:
 
@@ -43,6 +47,9 @@ private:
 	physx::PxScene*& scene;
 	physx::PxMaterial* defaultMaterial; // tmp
 
+	// Rigidbody actors constructed during an ecs batch, added to the scene once the batch ends
+	std::vector<physx::PxActor*> pendingActors;
+
 private:
 
 	//
@@ -16,6 +16,7 @@ dispatcher(nullptr),
 scene(nullptr),
 pvd(nullptr),
 bridge(physics, scene),
+batchEndSubscription(),
 timeStep(1.0f / 60.0f),
 gravity(PxVec3(0.0f, -9.81f, 0.0f)),
 accumulatedTime(0.0f)
@@ -65,10 +66,16 @@ void PhysicsContext::create()
 	ecs.reg().on_construct<RigidbodyComponent>().connect<&PhysicsBridge::constructRigidbody>(bridge);
 	ecs.reg().on_destroy<RigidbodyComponent>().connect<&PhysicsBridge::destroyRigidbody>(bridge);
 
+	// Rigidbodies constructed within an ecs batch are added to the scene together
+	batchEndSubscription = ecs.batchEndEvent().subscribe([this]() { bridge.flushPendingActors(); });
+
 }
 
 void PhysicsContext::destroy()
 {
+	ECS::main().batchEndEvent().unsubscribe(batchEndSubscription);
+	batchEndSubscription = EventHandle();
+
 	PX_RELEASE(scene);
 	PX_RELEASE(dispatcher);
 	PX_RELEASE(physics);
@@ -41,6 +41,9 @@ private:
 
 	PhysicsBridge bridge;
 
+	// Subscription to the ecs batch end event
+	EventHandle batchEndSubscription;
+
 	const physx::PxReal timeStep;
 	const physx::PxVec3 gravity;
 	double accumulatedTime;
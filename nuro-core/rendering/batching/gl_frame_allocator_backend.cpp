@@ -0,0 +1,45 @@
+#include "gl_frame_allocator_backend.h"
+
+#include <glad/glad.h>
+
+uint32_t GLFrameAllocatorBackend::createBuffer(uint32_t size, uint8_t*& mapping)
+{
+	// Create immutable buffer storage which stays mapped for its whole lifetime
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	uint32_t buffer = 0;
+	glCreateBuffers(1, &buffer);
+	glNamedBufferStorage(buffer, size, nullptr, flags);
+	mapping = static_cast<uint8_t*>(glMapNamedBufferRange(buffer, 0, size, flags));
+
+	return buffer;
+}
+
+void GLFrameAllocatorBackend::destroyBuffer(uint32_t buffer)
+{
+	glUnmapNamedBuffer(buffer);
+	glDeleteBuffers(1, &buffer);
+}
+
+uint64_t GLFrameAllocatorBackend::insertFence()
+{
+	return reinterpret_cast<uint64_t>(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+}
+
+void GLFrameAllocatorBackend::waitFence(uint64_t fence)
+{
+	GLsync sync = reinterpret_cast<GLsync>(fence);
+
+	// Flush on first wait so the fence is guaranteed to signal eventually
+	GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+	while (true) {
+		GLenum result = glClientWaitSync(sync, flags, 1000000);
+		if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED) return;
+		flags = 0;
+	}
+}
+
+void GLFrameAllocatorBackend::releaseFence(uint64_t fence)
+{
+	glDeleteSync(reinterpret_cast<GLsync>(fence));
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <memory/frame_allocator.h>
+
+// Frame allocator backend using immutable, persistently and coherently mapped buffers and fence sync objects
+class GLFrameAllocatorBackend : public FrameAllocatorBackend
+{
+public:
+	uint32_t createBuffer(uint32_t size, uint8_t*& mapping) override;
+	void destroyBuffer(uint32_t buffer) override;
+	uint64_t insertFence() override;
+	void waitFence(uint64_t fence) override;
+	void releaseFence(uint64_t fence) override;
+};
@@ -0,0 +1,107 @@
+#include "indirect_batch.h"
+
+#include <algorithm>
+#include <glad/glad.h>
+
+#include <rendering/model/mesh.h>
+#include <diagnostics/diagnostics.h>
+#include <context/application_context.h>
+#include <rendering/submission/draw_submission.h>
+
+IndirectBatch::IndirectBatch() : commands(),
+drawData(),
+groups(),
+commandAllocation(),
+drawDataAllocation(),
+storageAlignment(1)
+{
+}
+
+void IndirectBatch::create()
+{
+	// Query shader storage binding alignment
+	GLint alignment = 1;
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	storageAlignment = std::max(alignment, 1);
+}
+
+void IndirectBatch::destroy()
+{
+	clear();
+}
+
+void IndirectBatch::clear()
+{
+	commands.clear();
+	drawData.clear();
+	groups.clear();
+}
+
+void IndirectBatch::add(const IMaterial* material, const Mesh& mesh, const glm::mat4& model, const glm::mat4& mvp, const glm::mat4& normal)
+{
+	// Start new group if material changed
+	if (groups.empty() || groups.back().material != material) {
+		groups.push_back({ material, static_cast<uint32_t>(commands.size()), 0, 0, 0 });
+	}
+	Group& group = groups.back();
+	group.nInstances++;
+	group.nIndices += mesh.indiceCount();
+
+	// Per instance data is indexed by base instance + instance id
+	drawData.push_back({ model, mvp, normal });
+
+	// Previous command of group draws same mesh, add instance to it
+	if (group.nCommands > 0) {
+		Command& previous = commands.back();
+		if (previous.firstIndex == mesh.firstIndex() && previous.baseVertex == static_cast<int32_t>(mesh.baseVertex()) && previous.count == mesh.indiceCount()) {
+			previous.instanceCount++;
+			return;
+		}
+	}
+
+	// Add new command
+	Command command;
+	command.count = mesh.indiceCount();
+	command.instanceCount = 1;
+	command.firstIndex = mesh.firstIndex();
+	command.baseVertex = static_cast<int32_t>(mesh.baseVertex());
+	command.baseInstance = static_cast<uint32_t>(drawData.size() - 1);
+	commands.push_back(command);
+	group.nCommands++;
+}
+
+void IndirectBatch::upload()
+{
+	if (commands.empty()) return;
+
+	// Stream per instance data and commands through the frame allocator
+	FrameAllocator& allocator = ApplicationContext::frameAllocator();
+	drawDataAllocation = allocator.write(drawData.data(), static_cast<uint32_t>(drawData.size() * sizeof(DrawData)), storageAlignment);
+	commandAllocation = allocator.write(commands.data(), static_cast<uint32_t>(commands.size() * sizeof(Command)), sizeof(uint32_t));
+
+	// Each instance merged into a command saved a draw, counted once even if passes draw the batch several times
+	Diagnostics::addCurrentInstancedDrawsSaved(static_cast<uint32_t>(drawData.size() - commands.size()));
+}
+
+void IndirectBatch::draw(const Group& group) const
+{
+	if (group.nCommands == 0 || !commandAllocation.valid() || !drawDataAllocation.valid()) return;
+
+	// Bind command and per instance data ranges
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandAllocation.buffer);
+	glBindBufferRange(GL_SHADER_STORAGE_BUFFER, DRAW_DATA_BINDING, drawDataAllocation.buffer, drawDataAllocation.offset, drawDataAllocation.size);
+
+	// Submit all commands of group at once
+	const void* offset = reinterpret_cast<const void*>(static_cast<uintptr_t>(commandAllocation.offset) + static_cast<uintptr_t>(group.firstCommand) * sizeof(Command));
+	DrawSubmission::multiDrawElementsIndirect(offset, group.nCommands, group.nIndices, group.nInstances);
+}
+
+const std::vector<IndirectBatch::Group>& IndirectBatch::getGroups() const
+{
+	return groups;
+}
+
+uint32_t IndirectBatch::nCommands() const
+{
+	return static_cast<uint32_t>(commands.size());
+}
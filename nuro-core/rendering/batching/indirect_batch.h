@@ -0,0 +1,90 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include <memory/frame_allocator.h>
+
+class Mesh;
+class IMaterial;
+
+// Collects draws of arena allocated meshes and submits them with multi draw indirect calls
+class IndirectBatch
+{
+public:
+	// Shader storage binding point of the per draw data (see DrawBuffer block in batched shaders)
+	static constexpr uint32_t DRAW_DATA_BINDING = 0;
+
+	// Per draw data as read by batched shaders (std430 layout)
+	struct DrawData
+	{
+		glm::mat4 modelMatrix;
+		glm::mat4 mvpMatrix;
+		glm::mat4 normalMatrix;
+	};
+
+	// Indirect draw command layout as consumed by glMultiDrawElementsIndirect
+	struct Command
+	{
+		uint32_t count;
+		uint32_t instanceCount;
+		uint32_t firstIndex;
+		int32_t baseVertex;
+		uint32_t baseInstance;
+	};
+
+	// Consecutive commands sharing the same material
+	struct Group
+	{
+		const IMaterial* material;
+		uint32_t firstCommand;
+		uint32_t nCommands;
+
+		// Total amount of instances drawn by the groups commands
+		uint32_t nInstances;
+
+		// Total amount of indices drawn by the groups commands (all instances)
+		uint32_t nIndices;
+	};
+
+	IndirectBatch();
+
+	void create(); // Creates batch (queries backend limits)
+	void destroy(); // Destroys batch
+
+	// Clears all collected draws
+	void clear();
+
+	// Adds a draw of the given mesh, starts a new group if the material differs from the previous draw
+	// Consecutive draws of the same mesh and material are merged into a single instanced command
+	void add(const IMaterial* material, const Mesh& mesh, const glm::mat4& model, const glm::mat4& mvp, const glm::mat4& normal);
+
+	// Uploads all collected draws to the current frame region of the frame allocator, counts the draws saved by instancing
+	void upload();
+
+	// Submits all draws of a group (geometry arena of the meshes must be bound)
+	void draw(const Group& group) const;
+
+	// Returns all groups collected
+	const std::vector<Group>& getGroups() const;
+
+	// Returns the amount of commands collected
+	uint32_t nCommands() const;
+
+private:
+	// Collected draw commands
+	std::vector<Command> commands;
+
+	// Collected per instance data, indexed by the commands base instance and the instance id
+	std::vector<DrawData> drawData;
+
+	// Collected groups
+	std::vector<Group> groups;
+
+	FrameAllocator::Allocation commandAllocation; // Uploaded commands of current frame
+	FrameAllocator::Allocation drawDataAllocation; // Uploaded per instance data of current frame
+
+	// Required offset alignment of shader storage buffer bindings
+	uint32_t storageAlignment;
+};
@@ -0,0 +1,59 @@
+#include "frustum.h"
+
+#include <algorithm>
+
+Frustum::Frustum() : planes()
+{
+}
+
+Frustum::Frustum(const glm::mat4& viewProjection) : planes()
+{
+	// Rows of the (column major) view projection matrix
+	glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+	glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+	glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+	glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+	// Extract clip planes
+	planes[0] = row3 + row0;
+	planes[1] = row3 - row0;
+	planes[2] = row3 + row1;
+	planes[3] = row3 - row1;
+	planes[4] = row3 + row2;
+	planes[5] = row3 - row2;
+
+	// Normalize planes so distances are in world units
+	for (glm::vec4& plane : planes) {
+		float length = glm::length(glm::vec3(plane));
+		if (length > 0.0f) plane /= length;
+	}
+}
+
+bool Frustum::intersectsSphere(const glm::vec3& center, float radius) const
+{
+	for (const glm::vec4& plane : planes) {
+		if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+	}
+	return true;
+}
+
+bool Frustum::intersectsAABB(const glm::vec3& min, const glm::vec3& max) const
+{
+	for (const glm::vec4& plane : planes) {
+		// Test box corner furthest along the planes normal
+		glm::vec3 positive(plane.x >= 0.0f ? max.x : min.x, plane.y >= 0.0f ? max.y : min.y, plane.z >= 0.0f ? max.z : min.z);
+		if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.0f) return false;
+	}
+	return true;
+}
+
+void Frustum::transformSphere(const glm::mat4& model, const glm::vec3& localCenter, float localRadius, glm::vec3& center, float& radius)
+{
+	center = glm::vec3(model * glm::vec4(localCenter, 1.0f));
+
+	// Scale radius by the largest axis scale of the model matrix
+	float scaleX = glm::length(glm::vec3(model[0]));
+	float scaleY = glm::length(glm::vec3(model[1]));
+	float scaleZ = glm::length(glm::vec3(model[2]));
+	radius = localRadius * std::max(scaleX, std::max(scaleY, scaleZ));
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// View frustum given by the six clip planes of a view projection matrix
+class Frustum
+{
+public:
+	Frustum();
+
+	// Creates a frustum from the clip planes of the given view projection matrix
+	explicit Frustum(const glm::mat4& viewProjection);
+
+	// Returns if a sphere is at least partially inside the frustum
+	bool intersectsSphere(const glm::vec3& center, float radius) const;
+
+	// Returns if an axis aligned box is at least partially inside the frustum
+	bool intersectsAABB(const glm::vec3& min, const glm::vec3& max) const;
+
+	// Returns the world space bounding sphere center and radius of a local bounding sphere transformed by a model matrix
+	static void transformSphere(const glm::mat4& model, const glm::vec3& localCenter, float localRadius, glm::vec3& center, float& radius);
+
+private:
+	// Normalized planes (xyz = normal pointing inside, w = distance): left, right, bottom, top, near, far
+	glm::vec4 planes[6];
+};
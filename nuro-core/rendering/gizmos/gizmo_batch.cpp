@@ -0,0 +1,228 @@
+#include "gizmo_batch.h"
+
+#include <cmath>
+#include <algorithm>
+#include <glm/gtc/constants.hpp>
+
+namespace {
+
+	// Points and line indices of a shape with unit extents
+	struct UnitShape
+	{
+		std::vector<glm::vec3> points;
+		std::vector<uint32_t> edges;
+	};
+
+	UnitShape createPlane()
+	{
+		UnitShape plane;
+		plane.points = {
+			glm::vec3(-1.0f, 0.0f, -1.0f),
+			glm::vec3(1.0f, 0.0f, -1.0f),
+			glm::vec3(1.0f, 0.0f, 1.0f),
+			glm::vec3(-1.0f, 0.0f, 1.0f)
+		};
+		plane.edges = { 0, 1, 1, 2, 2, 3, 3, 0 };
+		return plane;
+	}
+
+	UnitShape createBox()
+	{
+		UnitShape box;
+		box.points = {
+			glm::vec3(-1.0f, -1.0f, -1.0f),
+			glm::vec3(1.0f, -1.0f, -1.0f),
+			glm::vec3(1.0f, 1.0f, -1.0f),
+			glm::vec3(-1.0f, 1.0f, -1.0f),
+			glm::vec3(-1.0f, -1.0f, 1.0f),
+			glm::vec3(1.0f, -1.0f, 1.0f),
+			glm::vec3(1.0f, 1.0f, 1.0f),
+			glm::vec3(-1.0f, 1.0f, 1.0f)
+		};
+		box.edges = {
+			0, 1, 1, 2, 2, 3, 3, 0, // Bottom face
+			4, 5, 5, 6, 6, 7, 7, 4, // Top face
+			0, 4, 1, 5, 2, 6, 3, 7 // Sides
+		};
+		return box;
+	}
+
+	UnitShape createSphere()
+	{
+		// Three great circles of radius one, one per axis plane
+		UnitShape sphere;
+		const uint32_t n = GizmoBatch::SPHERE_SEGMENTS;
+		for (uint32_t circle = 0; circle < 3; circle++) {
+			uint32_t first = static_cast<uint32_t>(sphere.points.size());
+			for (uint32_t i = 0; i < n; i++) {
+				float angle = glm::two_pi<float>() * i / n;
+				float a = std::cos(angle);
+				float b = std::sin(angle);
+
+				switch (circle) {
+				case 0: sphere.points.emplace_back(a, b, 0.0f); break;
+				case 1: sphere.points.emplace_back(a, 0.0f, b); break;
+				default: sphere.points.emplace_back(0.0f, a, b); break;
+				}
+
+				sphere.edges.push_back(first + i);
+				sphere.edges.push_back(first + (i + 1) % n);
+			}
+		}
+		return sphere;
+	}
+
+	const UnitShape& unitShape(GizmoBatch::Shape shape)
+	{
+		static const UnitShape plane = createPlane();
+		static const UnitShape box = createBox();
+		static const UnitShape sphere = createSphere();
+
+		switch (shape) {
+		case GizmoBatch::Shape::PLANE:
+			return plane;
+		case GizmoBatch::Shape::SPHERE:
+			return sphere;
+		default:
+			return box;
+		}
+	}
+
+}
+
+GizmoBatch::GizmoBatch() : lines(),
+foregroundLines(),
+iconTextures(),
+iconPositions(),
+iconCameraPositions(),
+iconScales(),
+iconInstances(),
+iconGroups(),
+transformedPoints(),
+iconOrder(),
+iconDistances()
+{
+}
+
+void GizmoBatch::clear()
+{
+	lines.clear();
+	foregroundLines.clear();
+
+	iconTextures.clear();
+	iconPositions.clear();
+	iconCameraPositions.clear();
+	iconScales.clear();
+
+	iconInstances.clear();
+	iconGroups.clear();
+}
+
+void GizmoBatch::addShape(Shape shape, const glm::mat4& model, const glm::vec4& color, bool foreground)
+{
+	const UnitShape& unit = unitShape(shape);
+
+	// Transform each point once, edges share them
+	transformedPoints.resize(unit.points.size());
+	for (size_t i = 0; i < unit.points.size(); i++) {
+		transformedPoints[i] = glm::vec3(model * glm::vec4(unit.points[i], 1.0f));
+	}
+
+	std::vector<LineVertex>& stream = foreground ? foregroundLines : lines;
+	stream.reserve(stream.size() + unit.edges.size());
+	for (uint32_t index : unit.edges) {
+		stream.push_back({ glm::vec4(transformedPoints[index], 1.0f), color });
+	}
+}
+
+void GizmoBatch::addIcon(uint32_t texture, const glm::vec3& position, float scale, const glm::vec3& cameraPosition)
+{
+	iconTextures.push_back(texture);
+	iconPositions.push_back(position);
+	iconCameraPositions.push_back(cameraPosition);
+	iconScales.push_back(scale);
+}
+
+void GizmoBatch::buildIcons(const glm::mat4& viewProjection)
+{
+	iconInstances.clear();
+	iconGroups.clear();
+
+	// Distances of all icons to their camera
+	uint32_t n = nIcons();
+	iconDistances.resize(n);
+	for (uint32_t i = 0; i < n; i++) {
+		iconDistances[i] = glm::distance(iconPositions[i], iconCameraPositions[i]);
+	}
+
+	// Keep icons within render radius, ordered by texture
+	iconOrder.clear();
+	for (uint32_t i = 0; i < n; i++) {
+		if (iconDistances[i] <= ICON_RENDER_RADIUS) iconOrder.push_back(i);
+	}
+	std::stable_sort(iconOrder.begin(), iconOrder.end(), [this](uint32_t a, uint32_t b) { return iconTextures[a] < iconTextures[b]; });
+
+	iconInstances.reserve(iconOrder.size());
+	for (uint32_t i : iconOrder) {
+		// Billboard rotating around the up axis only, facing the camera
+		glm::vec3 toCamera = iconCameraPositions[i] - iconPositions[i];
+		glm::vec3 forward = glm::vec3(toCamera.x, 0.0f, toCamera.z);
+		float length = glm::length(forward);
+		forward = length > 0.0f ? forward / length : glm::vec3(0.0f, 0.0f, 1.0f);
+		glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);
+		glm::vec3 right = glm::cross(up, forward);
+
+		float scale = iconScales[i];
+		glm::mat4 model = glm::mat4(
+			glm::vec4(right * scale, 0.0f),
+			glm::vec4(up * scale, 0.0f),
+			glm::vec4(forward * scale, 0.0f),
+			glm::vec4(iconPositions[i], 1.0f)
+		);
+
+		IconInstance instance;
+		instance.mvpMatrix = viewProjection * model;
+		instance.alpha = glm::vec4(iconAlpha(1.0f, iconDistances[i]), iconAlpha(ICON_FOREGROUND_ALPHA, iconDistances[i]), 0.0f, 0.0f);
+		iconInstances.push_back(instance);
+
+		// Start new group if texture changed
+		uint32_t texture = iconTextures[i];
+		if (iconGroups.empty() || iconGroups.back().texture != texture) {
+			iconGroups.push_back({ texture, static_cast<uint32_t>(iconInstances.size() - 1), 0 });
+		}
+		iconGroups.back().nInstances++;
+	}
+}
+
+const std::vector<GizmoBatch::LineVertex>& GizmoBatch::getLines() const
+{
+	return lines;
+}
+
+const std::vector<GizmoBatch::LineVertex>& GizmoBatch::getForegroundLines() const
+{
+	return foregroundLines;
+}
+
+const std::vector<GizmoBatch::IconInstance>& GizmoBatch::getIconInstances() const
+{
+	return iconInstances;
+}
+
+const std::vector<GizmoBatch::IconGroup>& GizmoBatch::getIconGroups() const
+{
+	return iconGroups;
+}
+
+uint32_t GizmoBatch::nIcons() const
+{
+	return static_cast<uint32_t>(iconTextures.size());
+}
+
+float GizmoBatch::iconAlpha(float baseAlpha, float distance)
+{
+	if (distance >= ICON_FADE_MAX_DISTANCE) return baseAlpha;
+
+	float t = std::clamp((distance - ICON_FADE_MIN_DISTANCE) / (ICON_FADE_MAX_DISTANCE - ICON_FADE_MIN_DISTANCE), 0.0f, 1.0f);
+	return baseAlpha * t * t * (3.0f - 2.0f * t);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// Accumulates immediate mode gizmos into cpu side streams so they can be drawn with a few draw calls
+// Shapes become a stream of world space line vertices, icons become billboard instances grouped by texture
+// Doesn't touch the graphics api, streams are uploaded and drawn by the owning renderer
+class GizmoBatch
+{
+public:
+	// Amount of segments of each circle of a sphere
+	static constexpr uint32_t SPHERE_SEGMENTS = 32;
+
+	// Icons further away from their camera aren't drawn
+	static constexpr float ICON_RENDER_RADIUS = 50.0f;
+
+	// Icons fade out once their camera gets closer than the max distance, they're invisible below the min distance
+	static constexpr float ICON_FADE_MIN_DISTANCE = 0.5f;
+	static constexpr float ICON_FADE_MAX_DISTANCE = 2.5f;
+
+	// Base alpha of icons drawn on top of everything
+	static constexpr float ICON_FOREGROUND_ALPHA = 0.06f;
+
+	enum class Shape
+	{
+		PLANE,
+		BOX,
+		SPHERE
+	};
+
+	// Vertex of line stream (std430 layout)
+	struct LineVertex
+	{
+		glm::vec4 position; // World space position, w is unused
+		glm::vec4 color;
+	};
+
+	// Per instance data of icon billboards (std430 layout)
+	struct IconInstance
+	{
+		glm::mat4 mvpMatrix;
+		glm::vec4 alpha; // x: depth tested alpha, y: foreground alpha
+	};
+
+	// Consecutive icon instances sharing the same texture
+	struct IconGroup
+	{
+		uint32_t texture;
+		uint32_t firstInstance;
+		uint32_t nInstances;
+	};
+
+	GizmoBatch();
+
+	// Removes all shapes and icons
+	void clear();
+
+	// Adds the outline of a unit shape transformed by given model matrix
+	// Foreground shapes are additionally drawn on top of everything
+	void addShape(Shape shape, const glm::mat4& model, const glm::vec4& color, bool foreground);
+
+	// Adds a camera facing icon, positions are in backend coordinates
+	void addIcon(uint32_t texture, const glm::vec3& position, float scale, const glm::vec3& cameraPosition);
+
+	// Builds billboards and distance fade of all icons at once, drops icons out of render radius and groups them by texture
+	void buildIcons(const glm::mat4& viewProjection);
+
+	// Returns line vertices of all shapes drawn with depth testing only
+	const std::vector<LineVertex>& getLines() const;
+
+	// Returns line vertices of all foreground shapes
+	const std::vector<LineVertex>& getForegroundLines() const;
+
+	// Returns icon instances built, ordered by texture
+	const std::vector<IconInstance>& getIconInstances() const;
+
+	// Returns icon groups built
+	const std::vector<IconGroup>& getIconGroups() const;
+
+	// Returns the amount of icons added
+	uint32_t nIcons() const;
+
+	// Returns the alpha of an icon at given distance to its camera
+	static float iconAlpha(float baseAlpha, float distance);
+
+private:
+	// Line vertices of shapes
+	std::vector<LineVertex> lines;
+	std::vector<LineVertex> foregroundLines;
+
+	// Icons added, stored per attribute
+	std::vector<uint32_t> iconTextures;
+	std::vector<glm::vec3> iconPositions;
+	std::vector<glm::vec3> iconCameraPositions;
+	std::vector<float> iconScales;
+
+	// Built icons
+	std::vector<IconInstance> iconInstances;
+	std::vector<IconGroup> iconGroups;
+
+	// Scratch buffers reused between builds
+	std::vector<glm::vec3> transformedPoints;
+	std::vector<uint32_t> iconOrder;
+	std::vector<float> iconDistances;
+};
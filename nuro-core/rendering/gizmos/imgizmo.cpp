@@ -1,17 +1,25 @@
 #include "imgizmo.h"
 
+#include <cstring>
+#include <algorithm>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 
 #include <utils/console.h>
-#include <rendering/model/mesh.h>
-#include <rendering/model/model.h>
 #include <rendering/shader/shader.h>
 #include <context/application_context.h>
 #include <rendering/shader/shader_pool.h>
+#include <rendering/submission/draw_submission.h>
 #include <rendering/transformation/transformation.h>
 
+// Shader storage binding point of the line vertices and icon instances (see gizmo shaders)
+static constexpr uint32_t STREAM_BINDING = 0;
+
+// Alpha of foreground shapes drawn on top of everything
+static constexpr float SHAPE_FOREGROUND_ALPHA = 0.035f;
+
 // Global gizmo resources
 IMGizmo::StaticData IMGizmo::staticData;
 
@@ -19,8 +27,7 @@ IMGizmo::IMGizmo() : color(glm::vec3(1.0f)),
 opacity(0.4f),
 foreground(false),
 iconScale(0.8f),
-shapeRenderStack(),
-iconRenderStack()
+batch()
 {
 }
 
@@ -29,30 +36,25 @@ void IMGizmo::create()
 	// Load all static data if not loaded already
 	if (!staticData.loaded) {
 
-		ResourceManager& resource = ApplicationContext::resourceManager();
-
-		auto [planeId, plane] = resource.create<Model>("gizmo-plane");
-		plane->setSource("resources/primitives/plane.fbx");
-		resource.exec(plane->create());
+		staticData.lineShader = ShaderPool::get("gizmo_line");
+		staticData.iconShader = ShaderPool::get("gizmo_icon");
 
-		auto [sphereId, sphere] = resource.create<Model>("gizmo-sphere");
-		sphere->setSource("resources/primitives/sphere.fbx");
-		resource.exec(sphere->create());
+		// Vertices are pulled from shader storage, an empty vertex array is all that's needed
+		glCreateVertexArrays(1, &staticData.vao);
 
-		staticData.fillShader = ShaderPool::get("gizmo_fill");
-		staticData.iconShader = ShaderPool::get("gizmo_icon");
+		// Query shader storage binding alignment
+		GLint alignment = 1;
+		glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		staticData.storageAlignment = std::max(alignment, 1);
 
-		staticData.planeMesh = plane->queryMesh(0);
-		staticData.boxMesh = createBoxMesh();
-		staticData.sphereMesh = sphere->queryMesh(0);
+		staticData.loaded = true;
 	}
 }
 
 void IMGizmo::newFrame()
 {
-	// Clear render stacks
-	shapeRenderStack.clear();
-	iconRenderStack.clear();
+	// Clear collected gizmos
+	batch.clear();
 }
 
 void IMGizmo::renderAll(const glm::mat4& viewProjection)
@@ -63,12 +65,28 @@ void IMGizmo::renderAll(const glm::mat4& viewProjection)
 
 void IMGizmo::renderShapes(const glm::mat4& viewProjection)
 {
-	// Cache current polygon mode
-	GLenum polygonState[2];
-	glGetIntegerv(GL_POLYGON_MODE, (GLint*)polygonState);
+	const std::vector<GizmoBatch::LineVertex>& lines = batch.getLines();
+	const std::vector<GizmoBatch::LineVertex>& foregroundLines = batch.getForegroundLines();
 
-	// Bind quick gizmo shader for upcoming renders
-	staticData.fillShader->bind();
+	uint32_t nLines = static_cast<uint32_t>(lines.size());
+	uint32_t nForegroundLines = static_cast<uint32_t>(foregroundLines.size());
+	if (nLines + nForegroundLines == 0) return;
+
+	// Stream line vertices, foreground vertices follow all others so they can be drawn again on their own
+	uint32_t size = (nLines + nForegroundLines) * sizeof(GizmoBatch::LineVertex);
+	FrameAllocator::Allocation allocation = ApplicationContext::frameAllocator().allocate(size, staticData.storageAlignment);
+	if (!allocation.valid()) return;
+	if (nLines > 0) std::memcpy(allocation.data, lines.data(), nLines * sizeof(GizmoBatch::LineVertex));
+	if (nForegroundLines > 0) std::memcpy(allocation.data + nLines * sizeof(GizmoBatch::LineVertex), foregroundLines.data(), nForegroundLines * sizeof(GizmoBatch::LineVertex));
+
+	// Bind line shader for upcoming renders, negative alpha override keeps vertex alpha
+	staticData.lineShader->bind();
+	staticData.lineShader->setMatrix4("viewProjectionMatrix", viewProjection);
+	staticData.lineShader->setFloat("alphaOverride", -1.0f);
+
+	// Bind line stream
+	DrawSubmission::bindVertexArray(staticData.vao);
+	glBindBufferRange(GL_SHADER_STORAGE_BUFFER, STREAM_BINDING, allocation.buffer, allocation.offset, allocation.size);
 
 	// Enable blending
 	glEnable(GL_BLEND);
@@ -77,57 +95,40 @@ void IMGizmo::renderShapes(const glm::mat4& viewProjection)
 	// Enable depth testing
 	glEnable(GL_DEPTH_TEST);
 
-	for (int32_t i = 0; i < shapeRenderStack.size(); i++)
-	{
-		// Get gizmo rendering target
-		ShapeRenderTarget gizmo = shapeRenderStack[i];
-
-		// Calculate mvp
-		glm::mat4 modelMatrix = getModelMatrix(gizmo.position, gizmo.rotation, gizmo.scale);
-		glm::mat4 mvpMatrix = viewProjection * modelMatrix;
+	// Render all shapes
+	DrawSubmission::drawArrays(GL_LINES, 0, nLines + nForegroundLines);
 
-		// Set material uniforms
-		staticData.fillShader->setMatrix4("mvpMatrix", mvpMatrix);
-		staticData.fillShader->setVec4("color", glm::vec4(gizmo.state.color, gizmo.state.opacity));
-
-		// Set polygon mode for gizmo render
-		if (gizmo.wireframe)
-		{
-			glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-		}
-		else
-		{
-			glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-		}
-
-		// Render mesh
-		const Mesh* mesh = queryMesh(gizmo.shape);
-		glBindVertexArray(mesh->vao());
-		glDrawElements(GL_LINES, mesh->indiceCount(), GL_UNSIGNED_INT, 0);
-
-		// Optional foreground pass without depth testing and reduced opacity
-		if (gizmo.state.foreground) {
-			staticData.fillShader->setVec4("color", glm::vec4(gizmo.state.color, 0.035f));
-			glDisable(GL_DEPTH_TEST);
-			glDrawElements(GL_LINES, mesh->indiceCount(), GL_UNSIGNED_INT, 0);
-			glEnable(GL_DEPTH_TEST);
-		}
+	// Foreground pass without depth testing and reduced opacity
+	if (nForegroundLines > 0) {
+		staticData.lineShader->setFloat("alphaOverride", SHAPE_FOREGROUND_ALPHA);
+		glDisable(GL_DEPTH_TEST);
+		DrawSubmission::drawArrays(GL_LINES, nLines, nForegroundLines);
+		glEnable(GL_DEPTH_TEST);
 	}
 
 	// Disable blending
 	glDisable(GL_BLEND);
-
-	// Restore polygon mode
-	glPolygonMode(GL_FRONT_AND_BACK, polygonState[0]);
 }
 
 void IMGizmo::renderIcons(const glm::mat4& viewProjection)
 {
-	// Setup
-	const float renderRadius = 50.0f;
+	// Build billboards and fade of all icons
+	batch.buildIcons(viewProjection);
 
-	// Bind quick gizmo shader for upcoming renders
+	const std::vector<GizmoBatch::IconInstance>& instances = batch.getIconInstances();
+	if (instances.empty()) return;
+
+	// Stream icon instances
+	FrameAllocator::Allocation allocation = ApplicationContext::frameAllocator().write(instances.data(), static_cast<uint32_t>(instances.size() * sizeof(GizmoBatch::IconInstance)), staticData.storageAlignment);
+	if (!allocation.valid()) return;
+
+	// Bind icon shader for upcoming renders
 	staticData.iconShader->bind();
+	staticData.iconShader->setVec3("tint", glm::vec3(1.0f));
+
+	// Bind icon instances
+	DrawSubmission::bindVertexArray(staticData.vao);
+	glBindBufferRange(GL_SHADER_STORAGE_BUFFER, STREAM_BINDING, allocation.buffer, allocation.offset, allocation.size);
 
 	// Enable blending
 	glEnable(GL_BLEND);
@@ -136,83 +137,21 @@ void IMGizmo::renderIcons(const glm::mat4& viewProjection)
 	// Fill polygons
 	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
-	// Enable depth testing
-	glEnable(GL_DEPTH_TEST);
+	// Render with full opacity and depth test, then with transparency but without depth test
+	glActiveTexture(GL_TEXTURE0);
+	for (int32_t foregroundPass = 0; foregroundPass < 2; foregroundPass++) {
+		if (foregroundPass) glDisable(GL_DEPTH_TEST);
+		else glEnable(GL_DEPTH_TEST);
 
-	for (int32_t i = 0; i < iconRenderStack.size(); i++)
-	{
-		//
-		// UNOPTIMIZED CODE!
-		//
-
-		// Get gizmo rendering target
-		IconRenderTarget gizmo = iconRenderStack[i];
-
-		// Dont render gizmo if exceeding render radius
-		if (glm::distance(gizmo.position, gizmo.cameraTransform.position) > renderRadius) continue;
-
-		// Bind gizmo icon texture
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, gizmo.iconTexture);
-
-		// Get cameras position and direction
-		glm::vec3 gizmoPosition = Transformation::swap(gizmo.position);
-		glm::vec3 cameraPosition = Transformation::swap(gizmo.cameraTransform.position);
-		// Compute direction vector from gizmo to camera in XZ plane
-		glm::vec3 directionToCamera = glm::normalize(glm::vec3(cameraPosition.x - gizmoPosition.x, 0.0f, cameraPosition.z - gizmoPosition.z));
-		glm::vec3 right = glm::normalize(glm::vec3(-directionToCamera.z, 0.0f, directionToCamera.x));
-		glm::vec3 forward = glm::vec3(directionToCamera.x, 0.0f, directionToCamera.z);
-		glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f); // World up
-		// Construct model matrix for gizmo
-		glm::mat4 modelMatrix = glm::mat4(
-			glm::vec4(right, 0.0f),
-			glm::vec4(up, 0.0f),
-			glm::vec4(forward, 0.0f),
-			glm::vec4(gizmoPosition, 1.0f)
-		);
-		// Calculate and apply 180-degree rotation around Z-axis
-		glm::mat4 rotation180Z = glm::mat4(
-			-1.0f, 0.0f, 0.0f, 0.0f,
-			0.0f, -1.0f, 0.0f, 0.0f,
-			0.0f, 0.0f, 1.0f, 0.0f,
-			0.0f, 0.0f, 0.0f, 1.0f
-		);
-		modelMatrix = modelMatrix * rotation180Z;
-		// Scale gizmo icon
-		modelMatrix = modelMatrix * glm::scale(glm::mat4(1.0f), glm::vec3(gizmo.scale));
-		// Calculate MVP matrix
-		glm::mat4 mvpMatrix = viewProjection * modelMatrix;
-
-		// Get mesh
-		const Mesh* mesh = queryMesh(Shape::PLANE);
-
-		// Calculates and returns the icon alpha relative to the camera
-		auto alpha = [](float baseAlpha, glm::vec3 iconPosition, glm::vec3 cameraPosition) {
-			float value = baseAlpha;
-			float minDistance = 0.5f;
-			float maxDistance = 2.5f;
-			float distance = glm::distance(iconPosition, cameraPosition);
-			if (distance < maxDistance) {
-				value = glm::mix(0.0f, value, glm::smoothstep(minDistance, maxDistance, distance));
-			}
-			return value;
-		};
-
-		// Set static material uniforms
-		staticData.iconShader->setMatrix4("mvpMatrix", mvpMatrix);
-		staticData.iconShader->setVec3("tint", glm::vec3(1.0f));
-
-		// Render with full opacity and depth test
-		staticData.iconShader->setFloat("alpha", alpha(1.0f, gizmoPosition, cameraPosition));
-		glBindVertexArray(mesh->vao());
-		glDrawElements(GL_TRIANGLES, mesh->indiceCount(), GL_UNSIGNED_INT, 0);
-
-		// Render with transparency but without depth test
-		staticData.iconShader->setFloat("alpha", alpha(0.06f, gizmoPosition, cameraPosition));
-		glDisable(GL_DEPTH_TEST);
-		glDrawElements(GL_TRIANGLES, mesh->indiceCount(), GL_UNSIGNED_INT, 0);
-		glEnable(GL_DEPTH_TEST);
+		staticData.iconShader->setInt("foregroundPass", foregroundPass);
+
+		// One instanced quad draw per icon texture
+		for (const GizmoBatch::IconGroup& group : batch.getIconGroups()) {
+			glBindTexture(GL_TEXTURE_2D, group.texture);
+			DrawSubmission::drawArrays(GL_TRIANGLES, 0, 6, group.nInstances, group.firstInstance);
+		}
 	}
+	glEnable(GL_DEPTH_TEST);
 
 	// Disable blending
 	glDisable(GL_BLEND);
@@ -220,44 +159,37 @@ void IMGizmo::renderIcons(const glm::mat4& viewProjection)
 
 void IMGizmo::plane(const glm::vec3& position, const glm::vec3& scale, const glm::quat& rotation)
 {
-	ShapeRenderTarget gizmo(Shape::PLANE, position, rotation, scale, false, getCurrentState());
-	shapeRenderStack.push_back(gizmo);
+	addShape(GizmoBatch::Shape::PLANE, position, rotation, scale);
 }
 
 void IMGizmo::box(const glm::vec3& position, const glm::vec3& scale, const glm::quat& rotation)
 {
-	ShapeRenderTarget gizmo(Shape::BOX, position, rotation, scale, false, getCurrentState());
-	shapeRenderStack.push_back(gizmo);
+	addShape(GizmoBatch::Shape::BOX, position, rotation, scale);
 }
 
 void IMGizmo::sphere(const glm::vec3& position, float radius, const glm::quat& rotation)
 {
-	ShapeRenderTarget gizmo(Shape::SPHERE, position, rotation, glm::vec3(radius * 2), false, getCurrentState());
-	shapeRenderStack.push_back(gizmo);
+	addShape(GizmoBatch::Shape::SPHERE, position, rotation, glm::vec3(radius));
 }
 
 void IMGizmo::planeWire(const glm::vec3& position, const glm::vec3& scale, const glm::quat& rotation)
 {
-	ShapeRenderTarget gizmo(Shape::PLANE, position, rotation, scale, true, getCurrentState());
-	shapeRenderStack.push_back(gizmo);
+	addShape(GizmoBatch::Shape::PLANE, position, rotation, scale);
 }
 
 void IMGizmo::boxWire(const glm::vec3& position, const glm::vec3& scale, const glm::quat& rotation)
 {
-	ShapeRenderTarget gizmo(Shape::BOX, position, rotation, scale, true, getCurrentState());
-	shapeRenderStack.push_back(gizmo);
+	addShape(GizmoBatch::Shape::BOX, position, rotation, scale);
 }
 
 void IMGizmo::sphereWire(const glm::vec3& position, float radius, const glm::quat& rotation)
 {
-	ShapeRenderTarget gizmo(Shape::SPHERE, position, rotation, glm::vec3(radius), true, getCurrentState());
-	shapeRenderStack.push_back(gizmo);
+	addShape(GizmoBatch::Shape::SPHERE, position, rotation, glm::vec3(radius));
 }
 
 void IMGizmo::icon3d(uint32_t iconTexture, const glm::vec3& position, TransformComponent& cameraTransform)
 {
-	IconRenderTarget gizmo(iconTexture, position, iconScale, cameraTransform, getCurrentState());
-	iconRenderStack.push_back(gizmo);
+	batch.addIcon(iconTexture, Transformation::swap(position), iconScale, Transformation::swap(cameraTransform.position));
 }
 
 IMGizmo::RenderState IMGizmo::getCurrentState() {
@@ -268,22 +200,10 @@ IMGizmo::RenderState IMGizmo::getCurrentState() {
 	return state;
 }
 
-const Mesh* IMGizmo::queryMesh(Shape shape)
+void IMGizmo::addShape(GizmoBatch::Shape shape, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
 {
-	switch (shape)
-	{
-	case Shape::PLANE:
-		return staticData.planeMesh;
-	case Shape::BOX:
-		return staticData.boxMesh;
-		break;
-	case Shape::SPHERE:
-		return staticData.sphereMesh;
-		break;
-	default:
-		return staticData.boxMesh;
-		break;
-	}
+	RenderState state = getCurrentState();
+	batch.addShape(shape, getModelMatrix(position, rotation, scale), glm::vec4(state.color, state.opacity), state.foreground);
 }
 
 glm::mat4 IMGizmo::getModelMatrix(glm::vec3 position, glm::quat rotation, glm::vec3 scale)
@@ -324,53 +244,3 @@ glm::mat4 IMGizmo::getModelMatrix(glm::vec3 position, glm::vec3 rotation, glm::v
 
 	return model;
 }
-
-const Mesh* IMGizmo::createPlaneMesh()
-{
-	const glm::vec2 zeroVec2 = glm::vec2(0.0f);
-	const glm::vec3 zeroVec3 = glm::vec3(0.0f);
-
-	// Vertices of the plane
-	std::vector<Model::VertexData> vertices = {
-		Model::VertexData(glm::vec3(-1.0f, 0.0f, -1.0f), zeroVec3, zeroVec2, zeroVec3, zeroVec3), // 0
-		Model::VertexData(glm::vec3(1.0f, 0.0f, -1.0f), zeroVec3, zeroVec2, zeroVec3, zeroVec3),  // 1
-		Model::VertexData(glm::vec3(1.0f, 0.0f, 1.0f), zeroVec3, zeroVec2, zeroVec3, zeroVec3),   // 2
-		Model::VertexData(glm::vec3(-1.0f, 0.0f, 1.0f), zeroVec3, zeroVec2, zeroVec3, zeroVec3)   // 3
-	};
-
-	// Indices of the planes face
-	std::vector<uint32_t> indices = {
-		0, 1, 1, 2, 2, 3, 3, 0
-	};
-
-	// Create and return mesh
-	return Model::createStaticMesh(vertices, indices);
-}
-
-const Mesh* IMGizmo::createBoxMesh()
-{
-	const glm::vec2 zeroVec2 = glm::vec2(0.0f);
-	const glm::vec3 zeroVec3 = glm::vec3(0.0f);
-
-	// Vertices of the box
-	std::vector<Model::VertexData> vertices = {
-		Model::VertexData(glm::vec3(-1.0f, -1.0f, -1.0f), zeroVec3, zeroVec2, zeroVec3, zeroVec3),  // 0
-		Model::VertexData(glm::vec3(1.0f, -1.0f, -1.0f), zeroVec3, zeroVec2, zeroVec3, zeroVec3),   // 1
-		Model::VertexData(glm::vec3(1.0f,  1.0f, -1.0f), zeroVec3, zeroVec2, zeroVec3, zeroVec3),   // 2
-		Model::VertexData(glm::vec3(-1.0f,  1.0f, -1.0f), zeroVec3, zeroVec2, zeroVec3, zeroVec3),  // 3
-		Model::VertexData(glm::vec3(-1.0f, -1.0f,  1.0f), zeroVec3, zeroVec2, zeroVec3, zeroVec3),  // 4
-		Model::VertexData(glm::vec3(1.0f, -1.0f,  1.0f), zeroVec3, zeroVec2, zeroVec3, zeroVec3),   // 5
-		Model::VertexData(glm::vec3(1.0f,  1.0f,  1.0f), zeroVec3, zeroVec2, zeroVec3, zeroVec3),   // 6
-		Model::VertexData(glm::vec3(-1.0f,  1.0f,  1.0f), zeroVec3, zeroVec2, zeroVec3, zeroVec3)   // 7
-	};
-
-	// Indices of the boxes faces
-	std::vector<uint32_t> indices = {
-		0, 1, 1, 2, 2, 3, 3, 0, // Bottom face (edges)
-		4, 5, 5, 6, 6, 7, 7, 4, // Top face (edges)
-		0, 4, 1, 5, 2, 6, 3, 7  // Side edges
-	};
-
-	// Create and return mesh
-	return Model::createStaticMesh(vertices, indices);
-}
\ No newline at end of file
@@ -7,10 +7,11 @@
 #include <ecs/components.h>
 #include <memory/resource_manager.h>
 #include <rendering/texture/texture.h>
+#include <rendering/gizmos/gizmo_batch.h>
 
 class Shader;
-class Model;
 
+// Immediate mode gizmos, collected each frame and drawn in batches
 class IMGizmo
 {
 public:
@@ -26,10 +27,10 @@ public:
 	// Renders all gizmos from render stack
 	void renderAll(const glm::mat4& viewProjection);
 
-	// Renders shapes only from render stack
+	// Renders shapes only from render stack, all shapes are drawn with one draw call (two if any is in foreground)
 	void renderShapes(const glm::mat4& viewProjection);
 
-	// Render icons only from render stack
+	// Render icons only from render stack, icons sharing a texture are drawn instanced
 	void renderIcons(const glm::mat4& viewProjection);
 
 	//
@@ -70,12 +71,14 @@ private:
 	struct StaticData {
 		bool loaded = false;
 
-		ResourceRef<Shader> fillShader = nullptr;
+		ResourceRef<Shader> lineShader = nullptr;
 		ResourceRef<Shader> iconShader = nullptr;
 
-		const Mesh* planeMesh = nullptr;
-		const Mesh* boxMesh = nullptr;
-		const Mesh* sphereMesh = nullptr;
+		// Empty vertex array, gizmo shaders pull their vertices from shader storage
+		uint32_t vao = 0;
+
+		// Required offset alignment of shader storage buffer bindings
+		uint32_t storageAlignment = 1;
 	};
 
 	struct RenderState {
@@ -84,62 +87,16 @@ private:
 		bool foreground;
 	};
 
-	enum class Shape
-	{
-		PLANE,
-		BOX,
-		SPHERE
-	};
-
-	struct ShapeRenderTarget
-	{
-		Shape shape;
-		glm::vec3 position;
-		glm::quat rotation;
-		glm::vec3 scale;
-		bool wireframe;
-		RenderState state;
-
-		ShapeRenderTarget(Shape shape, glm::vec3 position, glm::quat rotation, glm::vec3 scale, bool wireframe, RenderState state) :
-			shape(shape),
-			position(position),
-			rotation(rotation),
-			scale(scale),
-			wireframe(wireframe),
-			state(state)
-		{};
-	};
-
-	struct IconRenderTarget
-	{
-		uint32_t iconTexture;
-		glm::vec3 position;
-		float scale;
-		TransformComponent& cameraTransform;
-		RenderState state;
-
-		IconRenderTarget(uint32_t iconTexture, glm::vec3 position, float scale, TransformComponent& cameraTransform, RenderState state) :
-			iconTexture(iconTexture),
-			position(position),
-			scale(scale),
-			cameraTransform(cameraTransform),
-			state(state)
-		{};
-	};
-
 private:
-	std::vector<ShapeRenderTarget> shapeRenderStack;
-	std::vector<IconRenderTarget> iconRenderStack;
+	// Collected shapes and icons of current frame
+	GizmoBatch batch;
 
 	// Initialized once by any instance being setup, these will be needed for the rest of the application lifetime
 	static StaticData staticData;
 
 private:
 	RenderState getCurrentState();
-	const Mesh* queryMesh(Shape shape);
+	void addShape(GizmoBatch::Shape shape, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
 	glm::mat4 getModelMatrix(glm::vec3 position, glm::quat rotation, glm::vec3 scale);
 	glm::mat4 getModelMatrix(glm::vec3 position, glm::vec3 rotation, glm::vec3 scale);
-
-	const Mesh* createPlaneMesh();
-	const Mesh* createBoxMesh();
 };
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include "light_cache.h"
+
+#include <cstring>
+#include <algorithm>
+#include <glad/glad.h>
+
+#include <ecs/ecs_collection.h>
+#include <transform/transform.h>
+#include <rendering/submission/draw_submission.h>
+#include <rendering/transformation/transformation.h>
+
+// Returns if two lists of plain light data are identical
+template <typename T>
+static bool identical(const std::vector<T>& a, const std::vector<T>& b)
+{
+	return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+}
+
+LightCache::LightCache() : directionalLights(),
+pointLights(),
+spotlights(),
+gatheredDirectionalLights(),
+gatheredPointLights(),
+gatheredSpotlights(),
+directionalLightBuffer(),
+pointLightBuffer(),
+spotlightBuffer(),
+version(0)
+{
+}
+
+void LightCache::create()
+{
+	glCreateBuffers(1, &directionalLightBuffer.id);
+	glCreateBuffers(1, &pointLightBuffer.id);
+	glCreateBuffers(1, &spotlightBuffer.id);
+}
+
+void LightCache::destroy()
+{
+	for (Buffer* buffer : { &directionalLightBuffer, &pointLightBuffer, &spotlightBuffer }) {
+		glDeleteBuffers(1, &buffer->id);
+		*buffer = Buffer();
+	}
+
+	directionalLights.clear();
+	pointLights.clear();
+	spotlights.clear();
+}
+
+void LightCache::update()
+{
+	gatheredDirectionalLights.clear();
+	gatheredPointLights.clear();
+	gatheredSpotlights.clear();
+
+	//
+	// GATHER LIGHTS
+	//
+
+	ECS& ecs = ECS::main();
+
+	auto directionalLightView = ecs.view<TransformComponent, DirectionalLightComponent>();
+	for (auto [entity, transform, directionalLight] : directionalLightView.each()) {
+		if (!directionalLight.enabled) continue;
+
+		// Light shines along the forward axis of its transform
+		glm::vec3 direction = Transformation::swap(glm::normalize(Transform::forward(transform, Space::WORLD)));
+		glm::vec3 position = Transformation::swap(Transform::getPosition(transform, Space::WORLD));
+		gatheredDirectionalLights.push_back({
+			glm::vec4(direction, directionalLight.intensity),
+			glm::vec4(directionalLight.color, 0.0f),
+			glm::vec4(position, 0.0f)
+			});
+	}
+
+	auto pointLightView = ecs.view<TransformComponent, PointLightComponent>();
+	for (auto [entity, transform, pointLight] : pointLightView.each()) {
+		if (!pointLight.enabled) continue;
+
+		glm::vec3 position = Transformation::swap(Transform::getPosition(transform, Space::WORLD));
+		gatheredPointLights.push_back({
+			glm::vec4(position, pointLight.range),
+			glm::vec4(pointLight.color, pointLight.intensity),
+			glm::vec4(pointLight.falloff, 0.0f, 0.0f, 0.0f)
+			});
+	}
+
+	auto spotlightView = ecs.view<TransformComponent, SpotlightComponent>();
+	for (auto [entity, transform, spotlight] : spotlightView.each()) {
+		if (!spotlight.enabled) continue;
+
+		glm::vec3 direction = Transformation::swap(glm::normalize(Transform::forward(transform, Space::WORLD)));
+		glm::vec3 position = Transformation::swap(Transform::getPosition(transform, Space::WORLD));
+		gatheredSpotlights.push_back({
+			glm::vec4(position, spotlight.range),
+			glm::vec4(spotlight.color, spotlight.intensity),
+			glm::vec4(direction, spotlight.falloff),
+			glm::vec4(glm::cos(glm::radians(spotlight.innerAngle * 0.5f)), glm::cos(glm::radians(spotlight.outerAngle * 0.5f)), 0.0f, 0.0f)
+			});
+	}
+
+	//
+	// UPLOAD CHANGES
+	// Only lists which changed since the last update are uploaded
+	//
+
+	bool changed = false;
+
+	if (!identical(gatheredDirectionalLights, directionalLights)) {
+		std::swap(directionalLights, gatheredDirectionalLights);
+		upload(directionalLightBuffer, directionalLights.data(), static_cast<uint32_t>(directionalLights.size() * sizeof(DirectionalLightData)));
+		changed = true;
+	}
+
+	if (!identical(gatheredPointLights, pointLights)) {
+		std::swap(pointLights, gatheredPointLights);
+		upload(pointLightBuffer, pointLights.data(), static_cast<uint32_t>(pointLights.size() * sizeof(PointLightData)));
+		changed = true;
+	}
+
+	if (!identical(gatheredSpotlights, spotlights)) {
+		std::swap(spotlights, gatheredSpotlights);
+		upload(spotlightBuffer, spotlights.data(), static_cast<uint32_t>(spotlights.size() * sizeof(SpotlightData)));
+		changed = true;
+	}
+
+	if (changed) version++;
+}
+
+void LightCache::bind() const
+{
+	bindBuffer(DIRECTIONAL_LIGHT_BINDING, directionalLightBuffer, static_cast<uint32_t>(directionalLights.size() * sizeof(DirectionalLightData)));
+	bindBuffer(POINT_LIGHT_BINDING, pointLightBuffer, static_cast<uint32_t>(pointLights.size() * sizeof(PointLightData)));
+	bindBuffer(SPOTLIGHT_BINDING, spotlightBuffer, static_cast<uint32_t>(spotlights.size() * sizeof(SpotlightData)));
+}
+
+const std::vector<LightCache::DirectionalLightData>& LightCache::getDirectionalLights() const
+{
+	return directionalLights;
+}
+
+const std::vector<LightCache::PointLightData>& LightCache::getPointLights() const
+{
+	return pointLights;
+}
+
+const std::vector<LightCache::SpotlightData>& LightCache::getSpotlights() const
+{
+	return spotlights;
+}
+
+uint64_t LightCache::getVersion() const
+{
+	return version;
+}
+
+void LightCache::upload(Buffer& buffer, const void* data, uint32_t size)
+{
+	if (!buffer.id || size == 0) return;
+
+	// Grow buffer, reallocate storage
+	if (size > buffer.capacity) {
+		buffer.capacity = std::max(size, buffer.capacity * 2);
+		glNamedBufferData(buffer.id, buffer.capacity, nullptr, GL_DYNAMIC_DRAW);
+	}
+
+	DrawSubmission::uploadBuffer(buffer.id, 0, size, data);
+}
+
+void LightCache::bindBuffer(uint32_t binding, const Buffer& buffer, uint32_t size) const
+{
+	// Empty lists are never read by shaders
+	if (!buffer.id || size == 0) return;
+	glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, buffer.id, 0, size);
+}
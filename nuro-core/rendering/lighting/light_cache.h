@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Gathers all enabled lights once per frame into contiguous gpu buffers shared by all lit materials
+class LightCache
+{
+public:
+	// Shader storage binding points (see light buffers in lit shader)
+	static constexpr uint32_t POINT_LIGHT_BINDING = 1;
+	static constexpr uint32_t SPOTLIGHT_BINDING = 2;
+	static constexpr uint32_t DIRECTIONAL_LIGHT_BINDING = 5;
+
+	// Directional light as read by lit shaders (std430 layout)
+	struct DirectionalLightData
+	{
+		glm::vec4 direction; // xyz: direction, w: intensity
+		glm::vec4 color; // rgb: color
+		glm::vec4 position; // xyz: position (boilerplate for directional shadows)
+	};
+
+	// Point light as read by lit shaders (std430 layout)
+	struct PointLightData
+	{
+		glm::vec4 position; // xyz: world position, w: range
+		glm::vec4 color; // rgb: color, a: intensity
+		glm::vec4 parameters; // x: falloff
+	};
+
+	// Spotlight as read by lit shaders (std430 layout)
+	struct SpotlightData
+	{
+		glm::vec4 position; // xyz: world position, w: range
+		glm::vec4 color; // rgb: color, a: intensity
+		glm::vec4 direction; // xyz: direction, w: falloff
+		glm::vec4 cone; // x: inner cosine, y: outer cosine
+	};
+
+	LightCache();
+
+	void create(); // Creates light buffers
+	void destroy(); // Destroys light buffers
+
+	// Gathers all enabled lights, uploads them only if a light or its transform changed since the last update
+	void update();
+
+	// Binds the light buffers to their shader storage binding points
+	void bind() const;
+
+	// Returns the gathered lights
+	const std::vector<DirectionalLightData>& getDirectionalLights() const;
+	const std::vector<PointLightData>& getPointLights() const;
+	const std::vector<SpotlightData>& getSpotlights() const;
+
+	// Returns a counter incremented each time the gathered lights changed
+	uint64_t getVersion() const;
+
+private:
+	// Gpu buffer growing with its contents
+	struct Buffer
+	{
+		uint32_t id = 0;
+		uint32_t capacity = 0;
+	};
+
+	// Uploads data into a buffer, grows buffer if needed
+	void upload(Buffer& buffer, const void* data, uint32_t size);
+
+	// Binds a buffer if it holds data
+	void bindBuffer(uint32_t binding, const Buffer& buffer, uint32_t size) const;
+
+	// Gathered lights of last change
+	std::vector<DirectionalLightData> directionalLights;
+	std::vector<PointLightData> pointLights;
+	std::vector<SpotlightData> spotlights;
+
+	// Lights gathered during current update, compared against the last change
+	std::vector<DirectionalLightData> gatheredDirectionalLights;
+	std::vector<PointLightData> gatheredPointLights;
+	std::vector<SpotlightData> gatheredSpotlights;
+
+	// Light buffers
+	Buffer directionalLightBuffer;
+	Buffer pointLightBuffer;
+	Buffer spotlightBuffer;
+
+	// Change counter
+	uint64_t version;
+};
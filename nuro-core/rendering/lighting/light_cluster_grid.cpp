@@ -0,0 +1,168 @@
+#include "light_cluster_grid.h"
+
+#include <cmath>
+#include <limits>
+#include <cstring>
+#include <algorithm>
+
+#include <utils/parallel.h>
+
+LightClusterGrid::LightClusterGrid() : projection(glm::mat4(0.0f)),
+near(0.0f),
+far(0.0f),
+bounds(N_CLUSTERS),
+clusters(N_CLUSTERS),
+indices(),
+sliceIndices(GRID_Z),
+maxLightsPerCluster(0)
+{
+}
+
+void LightClusterGrid::setProjection(const glm::mat4& _projection, float _near, float _far)
+{
+	// Cluster bounds are still valid
+	if (_projection == projection && _near == near && _far == far) return;
+
+	projection = _projection;
+	near = _near;
+	far = _far;
+
+	// Scale from normalized device coordinates to view space at a depth of 1
+	float scaleX = 1.0f / projection[0][0];
+	float scaleY = 1.0f / projection[1][1];
+
+	for (uint32_t z = 0; z < GRID_Z; z++) {
+		float depthNear = sliceDepth(z);
+		float depthFar = sliceDepth(z + 1);
+
+		for (uint32_t y = 0; y < GRID_Y; y++) {
+			float ndcMinY = -1.0f + 2.0f * y / GRID_Y;
+			float ndcMaxY = -1.0f + 2.0f * (y + 1) / GRID_Y;
+
+			for (uint32_t x = 0; x < GRID_X; x++) {
+				float ndcMinX = -1.0f + 2.0f * x / GRID_X;
+				float ndcMaxX = -1.0f + 2.0f * (x + 1) / GRID_X;
+
+				// Enclose tile corners at both slice depths (view space looks down negative z)
+				Bounds& cluster = bounds[x + y * GRID_X + z * GRID_X * GRID_Y];
+				cluster.min = glm::vec3(std::numeric_limits<float>::max());
+				cluster.max = glm::vec3(std::numeric_limits<float>::lowest());
+				for (float depth : { depthNear, depthFar }) {
+					for (float ndcX : { ndcMinX, ndcMaxX }) {
+						for (float ndcY : { ndcMinY, ndcMaxY }) {
+							glm::vec3 corner(ndcX * scaleX * depth, ndcY * scaleY * depth, -depth);
+							cluster.min = glm::min(cluster.min, corner);
+							cluster.max = glm::max(cluster.max, corner);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void LightClusterGrid::assign(const std::vector<LightBounds>& pointLights, const std::vector<LightBounds>& spotlights)
+{
+	// Bin lights of each slice in parallel
+	Parallel::forEach(GRID_Z, [&](uint32_t slice) {
+		assignSlice(slice, pointLights, spotlights);
+		});
+
+	// Compact slice index lists into a single list
+	size_t nIndices = 0;
+	for (const std::vector<uint32_t>& slice : sliceIndices) nIndices += slice.size();
+	indices.resize(nIndices);
+
+	uint32_t base = 0;
+	maxLightsPerCluster = 0;
+	for (uint32_t z = 0; z < GRID_Z; z++) {
+		const std::vector<uint32_t>& slice = sliceIndices[z];
+		if (!slice.empty()) std::memcpy(indices.data() + base, slice.data(), slice.size() * sizeof(uint32_t));
+
+		// Offset clusters of slice into compact list
+		for (uint32_t i = z * GRID_X * GRID_Y; i < (z + 1) * GRID_X * GRID_Y; i++) {
+			clusters[i].offset += base;
+			maxLightsPerCluster = std::max(maxLightsPerCluster, clusters[i].nPointLights + clusters[i].nSpotlights);
+		}
+
+		base += static_cast<uint32_t>(slice.size());
+	}
+}
+
+const std::vector<LightClusterGrid::Cluster>& LightClusterGrid::getClusters() const
+{
+	return clusters;
+}
+
+const std::vector<uint32_t>& LightClusterGrid::getIndices() const
+{
+	return indices;
+}
+
+uint32_t LightClusterGrid::getMaxLightsPerCluster() const
+{
+	return maxLightsPerCluster;
+}
+
+uint32_t LightClusterGrid::clusterAt(const glm::vec2& ndc, float depth) const
+{
+	// Mirrors cluster lookup of lit shader
+	float slice = std::floor(std::log(depth / near) / std::log(far / near) * GRID_Z);
+	uint32_t z = static_cast<uint32_t>(std::clamp(slice, 0.0f, static_cast<float>(GRID_Z - 1)));
+	uint32_t x = static_cast<uint32_t>(std::clamp(std::floor((ndc.x * 0.5f + 0.5f) * GRID_X), 0.0f, static_cast<float>(GRID_X - 1)));
+	uint32_t y = static_cast<uint32_t>(std::clamp(std::floor((ndc.y * 0.5f + 0.5f) * GRID_Y), 0.0f, static_cast<float>(GRID_Y - 1)));
+	return x + y * GRID_X + z * GRID_X * GRID_Y;
+}
+
+float LightClusterGrid::sliceDepth(uint32_t slice) const
+{
+	return near * std::pow(far / near, static_cast<float>(slice) / GRID_Z);
+}
+
+void LightClusterGrid::assignSlice(uint32_t slice, const std::vector<LightBounds>& pointLights, const std::vector<LightBounds>& spotlights)
+{
+	std::vector<uint32_t>& sliceList = sliceIndices[slice];
+	sliceList.clear();
+
+	// Keep lights overlapping the slices depth range only
+	float depthNear = sliceDepth(slice);
+	float depthFar = sliceDepth(slice + 1);
+	auto overlapping = [&](const std::vector<LightBounds>& lights) {
+		std::vector<uint32_t> candidates;
+		for (uint32_t i = 0; i < lights.size(); i++) {
+			const LightBounds& light = lights[i];
+			if (light.center.z - light.radius <= -depthNear && light.center.z + light.radius >= -depthFar) candidates.push_back(i);
+		}
+		return candidates;
+		};
+	std::vector<uint32_t> pointCandidates = overlapping(pointLights);
+	std::vector<uint32_t> spotCandidates = overlapping(spotlights);
+
+	// Returns if a light sphere intersects the bounds of a cluster
+	auto intersects = [](const LightBounds& light, const Bounds& cluster) {
+		glm::vec3 closest = glm::clamp(light.center, cluster.min, cluster.max);
+		glm::vec3 delta = closest - light.center;
+		return glm::dot(delta, delta) <= light.radius * light.radius;
+		};
+
+	for (uint32_t i = slice * GRID_X * GRID_Y; i < (slice + 1) * GRID_X * GRID_Y; i++) {
+		const Bounds& clusterBounds = bounds[i];
+		Cluster& cluster = clusters[i];
+		cluster.offset = static_cast<uint32_t>(sliceList.size());
+		cluster.nPointLights = 0;
+		cluster.nSpotlights = 0;
+		cluster.padding = 0;
+
+		for (uint32_t light : pointCandidates) {
+			if (!intersects(pointLights[light], clusterBounds)) continue;
+			sliceList.push_back(light);
+			cluster.nPointLights++;
+		}
+
+		for (uint32_t light : spotCandidates) {
+			if (!intersects(spotlights[light], clusterBounds)) continue;
+			sliceList.push_back(light);
+			cluster.nSpotlights++;
+		}
+	}
+}
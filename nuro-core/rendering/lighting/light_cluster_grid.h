@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Splits a camera frustum into froxels and assigns light volumes to them, independent of any graphics backend
+class LightClusterGrid
+{
+public:
+	// Grid dimensions (see CLUSTER_GRID_* in lit shader)
+	static constexpr uint32_t GRID_X = 16;
+	static constexpr uint32_t GRID_Y = 9;
+	static constexpr uint32_t GRID_Z = 24;
+	static constexpr uint32_t N_CLUSTERS = GRID_X * GRID_Y * GRID_Z;
+
+	// View space bounding sphere of a light
+	struct LightBounds
+	{
+		glm::vec3 center;
+		float radius;
+	};
+
+	// Lights of a cluster within the index list, point light indices are followed by spotlight indices (std430 uvec4)
+	struct Cluster
+	{
+		uint32_t offset;
+		uint32_t nPointLights;
+		uint32_t nSpotlights;
+		uint32_t padding;
+	};
+
+	LightClusterGrid();
+
+	// Rebuilds the view space bounds of each cluster if the projection changed
+	// Clusters are sliced exponentially along depth between near and far
+	void setProjection(const glm::mat4& projection, float near, float far);
+
+	// Assigns point lights and spotlights to all clusters they intersect, slices are processed in parallel
+	void assign(const std::vector<LightBounds>& pointLights, const std::vector<LightBounds>& spotlights);
+
+	// Returns all clusters, indexed by x + y * GRID_X + z * GRID_X * GRID_Y
+	const std::vector<Cluster>& getClusters() const;
+
+	// Returns the compact light index list referenced by the clusters
+	const std::vector<uint32_t>& getIndices() const;
+
+	// Returns the highest amount of lights assigned to a single cluster
+	uint32_t getMaxLightsPerCluster() const;
+
+	// Returns the index of the cluster a view space position falls into
+	uint32_t clusterAt(const glm::vec2& ndc, float depth) const;
+
+private:
+	// View space bounds of a cluster
+	struct Bounds
+	{
+		glm::vec3 min;
+		glm::vec3 max;
+	};
+
+	// Returns the view space distance a depth slice starts at
+	float sliceDepth(uint32_t slice) const;
+
+	// Assigns lights to all clusters of a depth slice
+	void assignSlice(uint32_t slice, const std::vector<LightBounds>& pointLights, const std::vector<LightBounds>& spotlights);
+
+	// Projection the cluster bounds were built for
+	glm::mat4 projection;
+	float near;
+	float far;
+
+	// View space bounds of each cluster
+	std::vector<Bounds> bounds;
+
+	// Assigned lights of each cluster
+	std::vector<Cluster> clusters;
+
+	// Compact light index list
+	std::vector<uint32_t> indices;
+
+	// Light indices of each depth slice before compaction
+	std::vector<std::vector<uint32_t>> sliceIndices;
+
+	// Highest amount of lights of a single cluster
+	uint32_t maxLightsPerCluster;
+};
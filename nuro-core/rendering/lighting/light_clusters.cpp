@@ -0,0 +1,110 @@
+#include "light_clusters.h"
+
+#include <algorithm>
+#include <glad/glad.h>
+
+#include <context/application_context.h>
+#include <rendering/lighting/light_cache.h>
+
+LightClusters::LightClusters() : grid(),
+pointLightBounds(),
+spotlightBounds(),
+clusterAllocation(),
+indexAllocation(),
+storageAlignment(1),
+near(0.0f),
+far(0.0f)
+{
+}
+
+void LightClusters::create()
+{
+	// Query shader storage binding alignment
+	GLint alignment = 1;
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	storageAlignment = std::max(alignment, 1);
+}
+
+void LightClusters::destroy()
+{
+	pointLightBounds.clear();
+	spotlightBounds.clear();
+}
+
+void LightClusters::update(const LightCache& lightCache, const glm::mat4& view, const glm::mat4& projection, float _near, float _far)
+{
+	near = _near;
+	far = _far;
+
+	pointLightBounds.clear();
+	spotlightBounds.clear();
+
+	//
+	// BOUND LIGHTS
+	// Lights were gathered once this frame by the light cache, only their view space bounds are camera dependent
+	//
+
+	for (const LightCache::PointLightData& pointLight : lightCache.getPointLights()) {
+		pointLightBounds.push_back({ glm::vec3(view * glm::vec4(glm::vec3(pointLight.position), 1.0f)), pointLight.position.w });
+	}
+
+	for (const LightCache::SpotlightData& spotlight : lightCache.getSpotlights()) {
+		// Bound spotlight cone by its range sphere
+		spotlightBounds.push_back({ glm::vec3(view * glm::vec4(glm::vec3(spotlight.position), 1.0f)), spotlight.position.w });
+	}
+
+	//
+	// ASSIGN LIGHTS
+	//
+
+	grid.setProjection(projection, near, far);
+	grid.assign(pointLightBounds, spotlightBounds);
+
+	//
+	// UPLOAD
+	// Stream clusters and light indices through the frame allocator
+	//
+
+	FrameAllocator& allocator = ApplicationContext::frameAllocator();
+	const std::vector<LightClusterGrid::Cluster>& clusters = grid.getClusters();
+	const std::vector<uint32_t>& indices = grid.getIndices();
+	clusterAllocation = allocator.write(clusters.data(), static_cast<uint32_t>(clusters.size() * sizeof(LightClusterGrid::Cluster)), storageAlignment);
+	indexAllocation = allocator.write(indices.data(), static_cast<uint32_t>(indices.size() * sizeof(uint32_t)), storageAlignment);
+}
+
+void LightClusters::bind() const
+{
+	// Empty lists aren't allocated, they are never read as all clusters are empty then
+	auto bindAllocation = [](uint32_t binding, const FrameAllocator::Allocation& allocation) {
+		if (!allocation.valid()) return;
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, allocation.buffer, allocation.offset, allocation.size);
+		};
+
+	bindAllocation(CLUSTER_BINDING, clusterAllocation);
+	bindAllocation(LIGHT_INDEX_BINDING, indexAllocation);
+}
+
+float LightClusters::getNear() const
+{
+	return near;
+}
+
+float LightClusters::getFar() const
+{
+	return far;
+}
+
+uint32_t LightClusters::getNPointLights() const
+{
+	return static_cast<uint32_t>(pointLightBounds.size());
+}
+
+uint32_t LightClusters::getNSpotlights() const
+{
+	return static_cast<uint32_t>(spotlightBounds.size());
+}
+
+const LightClusterGrid& LightClusters::getGrid() const
+{
+	return grid;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include <memory/frame_allocator.h>
+#include <rendering/lighting/light_cluster_grid.h>
+
+class LightCache;
+
+// Assigns the cached point lights and spotlights to the clusters of a camera and provides them to lit shaders
+class LightClusters
+{
+public:
+	// Shader storage binding points (see light buffers in lit shader)
+	static constexpr uint32_t CLUSTER_BINDING = 3;
+	static constexpr uint32_t LIGHT_INDEX_BINDING = 4;
+
+	LightClusters();
+
+	void create(); // Creates light clusters (queries backend limits)
+	void destroy(); // Destroys light clusters
+
+	// Assigns the point lights and spotlights of the light cache to the clusters of the given camera and uploads the result
+	void update(const LightCache& lightCache, const glm::mat4& view, const glm::mat4& projection, float near, float far);
+
+	// Binds the uploaded clusters to their shader storage binding points
+	void bind() const;
+
+	// Returns the near and far clipping of the camera the clusters were built for
+	float getNear() const;
+	float getFar() const;
+
+	// Returns the amount of lights assigned this frame
+	uint32_t getNPointLights() const;
+	uint32_t getNSpotlights() const;
+
+	// Returns the cpu side cluster grid
+	const LightClusterGrid& getGrid() const;
+
+private:
+	// Cpu side cluster grid
+	LightClusterGrid grid;
+
+	// View space bounds of cached lights
+	std::vector<LightClusterGrid::LightBounds> pointLightBounds;
+	std::vector<LightClusterGrid::LightBounds> spotlightBounds;
+
+	// Uploaded data of current frame
+	FrameAllocator::Allocation clusterAllocation;
+	FrameAllocator::Allocation indexAllocation;
+
+	// Required offset alignment of shader storage buffer bindings
+	uint32_t storageAlignment;
+
+	// Clipping of camera clusters were built for
+	float near;
+	float far;
+};
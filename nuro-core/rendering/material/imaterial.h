@@ -21,4 +21,14 @@ public:
 	virtual uint32_t getId() const = 0;
 	virtual ResourceRef<Shader> getShader() const = 0;
 	virtual uint32_t getShaderId() const = 0;
+
+	// Returns if fragments may be discarded, such materials can't be shaded against depth laid down beforehand
+	virtual bool discardsFragments() const { return false; }
+
+	// Identifies the shader independent of the render state, materials with equal keys are shaded with the same shader within a view
+	virtual uint64_t getShaderKey() const { return getShaderId(); }
+
+	// Builds the shader the material is shaded with in the current render state if needed (context thread)
+	// Call before the draws of a view are batched, shader getters only look up the shader for the current render state
+	virtual void prepareShader() const {}
 };
\ No newline at end of file
@@ -13,7 +13,12 @@
 #include <transform/transform.h>
 #include <rendering/shadows/shadow_map.h>
 #include <rendering/shader/shader_pool.h>
+#include <rendering/material/lit/lit_variant.h>
 #include <rendering/shadows/shadow_disk.h>
+#include <context/application_context.h>
+#include <rendering/lighting/light_cache.h>
+#include <rendering/lighting/light_clusters.h>
+#include <rendering/shadows/cascaded_shadow_map.h>
 #include <rendering/transformation/transformation.h>
 
 uint32_t LitMaterial::instances = 0;
@@ -24,6 +29,9 @@ PostProcessing::Profile* LitMaterial::profile = nullptr;
 bool LitMaterial::castShadows = true;
 ShadowDisk* LitMaterial::mainShadowDisk = nullptr;
 ShadowMap* LitMaterial::mainShadowMap = nullptr;
+CascadedShadowMap* LitMaterial::mainCascadedShadowMap = nullptr;
+LightClusters* LitMaterial::lightClusters = nullptr;
+std::unordered_map<uint32_t, ResourceRef<Shader>> LitMaterial::variants;
 
 std::string uniformArray(const std::string& identifier, size_t arrayIndex)
 {
@@ -49,24 +57,27 @@ normalMap(nullptr),
 occlusionMap(nullptr),
 emissiveMap(nullptr),
 heightMap(nullptr),
-id(0),
-shader(ShaderPool::get("lit")),
-shaderId(0)
+id(0)
 {
 	instances++;
 
 	id = instances;
-	shaderId = shader->backendId();
 
-	shader->bind();
-	syncStaticUniforms();
-	syncLightUniforms();
+	// Variants of the base lit shader are built for each render state before draws are batched
+	auto [base, inserted] = variants.try_emplace(0, ShaderPool::get("lit"));
+	if (inserted) {
+		base->second->bind();
+		syncStaticUniforms(base->second);
+	}
 }
 
 void LitMaterial::bind() const
 {
 	// Bad temporary code
-	if (!shader || !viewport || !cameraTransform || !profile || !mainShadowDisk || !mainShadowMap) return;
+	if (!viewport || !cameraTransform || !profile || !mainShadowDisk || !mainShadowMap) return;
+
+	ResourceRef<Shader> shader = getShader();
+	if (!shader) return;
 
 	syncLightUniforms();
 
@@ -79,8 +90,6 @@ void LitMaterial::bind() const
 	shader->setVec2("configuration.viewportResolution", viewport->getResolution());
 
 	// Shadow parameters
-	shader->setBool("configuration.castShadows", castShadows);
-
 	shader->setFloat("configuration.shadowMapResolutionWidth", static_cast<float>(mainShadowMap->getResolutionWidth()));
 	shader->setFloat("configuration.shadowMapResolutionHeight", static_cast<float>(mainShadowMap->getResolutionHeight()));
 
@@ -92,8 +101,18 @@ void LitMaterial::bind() const
 	mainShadowDisk->bind(SHADOW_DISK_UNIT);
 	mainShadowMap->bind(SHADOW_MAP_UNIT);
 
+	// Cascaded shadow parameters
+	if (mainCascadedShadowMap) {
+		shader->setFloat("cascades.resolution", static_cast<float>(mainCascadedShadowMap->getResolution()));
+		shader->setMatrix4("cascades.cameraView", mainCascadedShadowMap->getCameraView());
+		for (uint32_t i = 0; i < CascadedShadowMap::N_CASCADES; i++) {
+			shader->setMatrix4(uniformArray("cascades.lightSpaces[]", i), mainCascadedShadowMap->getLightSpace(i));
+			shader->setFloat(uniformArray("cascades.splits[]", i), mainCascadedShadowMap->getSplit(i));
+		}
+		mainCascadedShadowMap->bind(CASCADED_SHADOW_MAP_UNIT);
+	}
+
 	// SSAO
-	shader->setBool("configuration.enableSSAO", profile->ambientOcclusion.enabled);
 	if (profile->ambientOcclusion.enabled) {
 		glActiveTexture(GL_TEXTURE0 + SSAO_UNIT);
 		glBindTexture(GL_TEXTURE_2D, ssaoInput);
@@ -103,19 +122,16 @@ void LitMaterial::bind() const
 	shader->setVec4("material.baseColor", baseColor);
 	shader->setVec2("material.tiling", tiling);
 	shader->setVec2("material.offset", offset);
-	shader->setBool("material.emission", emission);
 	shader->setFloat("material.emissionIntensity", emissionIntensity);
 	shader->setVec3("material.emissionColor", emissionColor);
 
 	// Set textures
-	shader->setBool("material.enableAlbedoMap", albedoMap != nullptr);
 	if (albedoMap)
 	{
 		glActiveTexture(GL_TEXTURE0 + ALBEDO_UNIT);
 		glBindTexture(GL_TEXTURE_2D, albedoMap->backendId());
 	}
 
-	shader->setBool("material.enableRoughnessMap", roughnessMap != nullptr);
 	if (roughnessMap)
 	{
 		glActiveTexture(GL_TEXTURE0 + ROUGHNESS_UNIT);
@@ -126,7 +142,6 @@ void LitMaterial::bind() const
 		shader->setFloat("material.roughness", roughness);
 	}
 
-	shader->setBool("material.enableMetallicMap", metallicMap != nullptr);
 	if (metallicMap)
 	{
 		glActiveTexture(GL_TEXTURE0 + METALLIC_UNIT);
@@ -137,7 +152,6 @@ void LitMaterial::bind() const
 		shader->setFloat("material.metallic", metallic);
 	}
 
-	shader->setBool("material.enableNormalMap", normalMap != nullptr);
 	if (normalMap)
 	{
 		glActiveTexture(GL_TEXTURE0 + NORMAL_UNIT);
@@ -145,21 +159,18 @@ void LitMaterial::bind() const
 	}
 	shader->setFloat("material.normalMapIntensity", normalMapIntensity);
 
-	shader->setBool("material.enableOcclusionMap", false);
 	if (occlusionMap)
 	{
 		glActiveTexture(GL_TEXTURE0 + OCCLUSION_UNIT);
 		glBindTexture(GL_TEXTURE_2D, occlusionMap->backendId());
 	}
 
-	shader->setBool("material.enableEmissiveMap", emissiveMap != nullptr);
 	if (emissiveMap)
 	{
 		glActiveTexture(GL_TEXTURE0 + EMISSIVE_UNIT);
 		glBindTexture(GL_TEXTURE_2D, emissiveMap->backendId());
 	}
 
-	shader->setBool("material.enableHeightMap", heightMap != nullptr);
 	if (heightMap)
 	{
 		glActiveTexture(GL_TEXTURE0 + HEIGHT_UNIT);
@@ -175,15 +186,29 @@ uint32_t LitMaterial::getId() const
 
 ResourceRef<Shader> LitMaterial::getShader() const
 {
-	return shader;
+	// Variant of current render state, base shader until it's prepared or if it can't be built
+	if (auto it = variants.find(getVariant()); it != variants.end()) return it->second;
+	return variants[0];
 }
 
 uint32_t LitMaterial::getShaderId() const
 {
-	return shaderId;
+	return getShader()->backendId();
+}
+
+uint64_t LitMaterial::getShaderKey() const
+{
+	// Render state features are the same for all lit materials of a view, materials sharing their own features share a shader
+	return (static_cast<uint64_t>(variants[0]->backendId()) << 32) | materialFeatures();
 }
 
-void LitMaterial::syncStaticUniforms() const
+bool LitMaterial::discardsFragments() const
+{
+	// Parallax occlusion mapping discards fragments outside of the displaced uv range
+	return heightMap != nullptr;
+}
+
+void LitMaterial::syncStaticUniforms(const ResourceRef<Shader>& shader) const
 {
 	//
 	// Sync static texture units
@@ -199,6 +224,7 @@ void LitMaterial::syncStaticUniforms() const
 	shader->setInt("configuration.shadowDisk", SHADOW_DISK_UNIT);
 	shader->setInt("configuration.shadowMap", SHADOW_MAP_UNIT);
 	shader->setInt("configuration.ssaoBuffer", SSAO_UNIT);
+	shader->setInt("cascades.shadowMap", CASCADED_SHADOW_MAP_UNIT);
 
 	//
 	// Sync scene
@@ -214,87 +240,84 @@ void LitMaterial::syncStaticUniforms() const
 
 void LitMaterial::syncLightUniforms() const
 {
+	ResourceRef<Shader> shader = getShader();
+
 	//
 	// Sync lights
+	// All lights are gathered once per frame by the light cache, materials only reference its buffers
 	//
 
-	// Fetch lights
-	ECS& ecs = ECS::main();
-	auto directionalLights = ecs.view<TransformComponent, DirectionalLightComponent>();
-	auto pointLights = ecs.view<TransformComponent, PointLightComponent>();
-	auto spotlights = ecs.view<TransformComponent, SpotlightComponent>();
-
-	// Light count
-	size_t nDirectionalLights = 0;
-	size_t nPointLights = 0;
-	size_t nSpotlights = 0;
-
-	// Limitations
-	size_t maxDirectionalLights = 1;
-	size_t maxPointLights = 15;
-	size_t maxSpotlights = 8;
-
-	// Setup all directional lights
-	for (auto [entity, transform, directionalLight] : directionalLights.each()) {
-		glm::vec3 directionalDirection = glm::vec3(-0.7f, -0.8f, 1.0f);
-		glm::vec3 directionalPosition = glm::vec3(4.0f, 5.0f, -7.0f);
-
-		if (!directionalLight.enabled) continue;
-		shader->setFloat(uniformArray("directionalLights[].intensity", nDirectionalLights), directionalLight.intensity);
-		shader->setVec3(uniformArray("directionalLights[].direction", nDirectionalLights), Transformation::swap(directionalDirection));
-		shader->setVec3(uniformArray("directionalLights[].color", nDirectionalLights), directionalLight.color);
-		shader->setVec3(uniformArray("directionalLights[].position", nDirectionalLights), Transformation::swap(directionalPosition));
-
-		nDirectionalLights++;
-		if (nDirectionalLights >= maxDirectionalLights) break;
-	}
+	const LightCache& lightCache = ApplicationContext::lightCache();
+	lightCache.bind();
 
-	// Setup all point lights
-	for (auto [entity, transform, pointLight] : pointLights.each()) {
-		if (!pointLight.enabled) continue;
-		shader->setVec3(uniformArray("pointLights[].position", nPointLights), Transformation::swap(Transform::getPosition(transform, Space::WORLD)));
-		shader->setVec3(uniformArray("pointLights[].color", nPointLights), pointLight.color);
-		shader->setFloat(uniformArray("pointLights[].intensity", nPointLights), pointLight.intensity);
-		shader->setFloat(uniformArray("pointLights[].range", nPointLights), pointLight.range);
-		shader->setFloat(uniformArray("pointLights[].falloff", nPointLights), pointLight.falloff);
-
-		nPointLights++;
-		if (nPointLights >= maxPointLights) break;
-	}
+	// Lighting parameters
+	shader->setInt("configuration.numDirectionalLights", static_cast<int32_t>(lightCache.getDirectionalLights().size()));
 
-	// Setup all spotlights
-	for (auto [entity, transform, spotlight] : spotlights.each()) {
-		glm::vec3 spotlightDirection = glm::vec3(0.0f, 0.0f, 1.0f);
-
-		if (!spotlight.enabled) continue;
-		shader->setVec3(uniformArray("spotlights[].position", nSpotlights), Transformation::swap(Transform::getPosition(transform, Space::WORLD)));
-		shader->setVec3(uniformArray("spotlights[].direction", nSpotlights), Transformation::swap(spotlightDirection));
-		shader->setVec3(uniformArray("spotlights[].color", nSpotlights), spotlight.color);
-		shader->setFloat(uniformArray("spotlights[].intensity", nSpotlights), spotlight.intensity);
-		shader->setFloat(uniformArray("spotlights[].range", nSpotlights), spotlight.range);
-		shader->setFloat(uniformArray("spotlights[].falloff", nSpotlights), spotlight.falloff);
-		shader->setFloat(uniformArray("spotlights[].innerCos", nSpotlights), glm::cos(glm::radians(spotlight.innerAngle * 0.5f)));
-		shader->setFloat(uniformArray("spotlights[].outerCos", nSpotlights), glm::cos(glm::radians(spotlight.outerAngle * 0.5f)));
-
-		nSpotlights++;
-		if (nSpotlights >= maxSpotlights) break;
+	// Point lights and spotlights are read from the light clusters, the variant decides if they're sampled
+	if (lightClusters) {
+		shader->setFloat("clusters.near", lightClusters->getNear());
+		shader->setFloat("clusters.far", lightClusters->getFar());
+		lightClusters->bind();
 	}
-
-	// Lighting parameters
-	shader->setInt("configuration.numDirectionalLights", nDirectionalLights);
-	shader->setInt("configuration.numPointLights", nPointLights);
-	shader->setInt("configuration.numSpotLights", nSpotlights);
 }
 
 void LitMaterial::setSampleDirectionalLight() const
 {
+	ResourceRef<Shader> shader = getShader();
 	shader->setInt("configuration.numDirectionalLights", 1);
-	shader->setInt("configuration.numPointLights", 0);
-	shader->setInt("configuration.numSpotLights", 0);
-
-	size_t index = 0;
-	shader->setFloat(uniformArray("directionalLights[].intensity", index), 1.0f);
-	shader->setVec3(uniformArray("directionalLights[].direction", index), Transformation::swap(glm::vec3(-0.5f, -0.5f, 0.5f)));
-	shader->setVec3(uniformArray("directionalLights[].color", index), glm::vec3(1.0f, 1.0f, 1.0f));
-	shader->setVec3(uniformArray("directionalLights[].position", index), Transformation::swap(glm::vec3(0.0f, 0.0f, 0.0f)));
+
+	// Stream sample light through the frame allocator, rebound to the light cache by the next sync
+	LightCache::DirectionalLightData sampleLight;
+	sampleLight.direction = glm::vec4(Transformation::swap(glm::vec3(-0.5f, -0.5f, 0.5f)), 1.0f);
+	sampleLight.color = glm::vec4(1.0f, 1.0f, 1.0f, 0.0f);
+	sampleLight.position = glm::vec4(Transformation::swap(glm::vec3(0.0f, 0.0f, 0.0f)), 0.0f);
+
+	GLint alignment = 1;
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	FrameAllocator::Allocation allocation = ApplicationContext::frameAllocator().write(&sampleLight, sizeof(sampleLight), static_cast<uint32_t>(alignment));
+	if (allocation.valid()) glBindBufferRange(GL_SHADER_STORAGE_BUFFER, LightCache::DIRECTIONAL_LIGHT_BINDING, allocation.buffer, allocation.offset, allocation.size);
 }
+
+uint32_t LitMaterial::getVariant() const
+{
+	return LitVariant::normalize(materialFeatures() | renderStateFeatures());
+}
+
+void LitMaterial::prepareShader() const
+{
+	uint32_t features = getVariant();
+	if (variants.find(features) != variants.end()) return;
+
+	// Build variant, materials keep being shaded with the base shader if it can't be built
+	ResourceRef<Shader> shader = ShaderPool::variant("lit", features, LitVariant::defines(features));
+	if (!shader) return;
+
+	// Sync static uniforms of new variant once
+	variants[features] = shader;
+	shader->bind();
+	syncStaticUniforms(shader);
+}
+
+uint32_t LitMaterial::materialFeatures() const
+{
+	LitVariant::Selection selection;
+	selection.albedoMap = albedoMap != nullptr;
+	selection.roughnessMap = roughnessMap != nullptr;
+	selection.metallicMap = metallicMap != nullptr;
+	selection.normalMap = normalMap != nullptr;
+	selection.occlusionMap = false; // Occlusion maps aren't sampled for now
+	selection.emission = emission;
+	selection.emissiveMap = emissiveMap != nullptr;
+	selection.heightMap = heightMap != nullptr;
+	return LitVariant::select(selection);
+}
+
+uint32_t LitMaterial::renderStateFeatures()
+{
+	LitVariant::Selection selection;
+	selection.castShadows = castShadows;
+	selection.cascadedShadows = mainCascadedShadowMap != nullptr;
+	selection.ssao = profile && profile->ambientOcclusion.enabled;
+	selection.lightClusters = lightClusters != nullptr;
+	return LitVariant::select(selection);
+}
\ No newline at end of file
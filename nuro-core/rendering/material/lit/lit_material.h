@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <glm/glm.hpp>
+#include <unordered_map>
 
 #include "../imaterial.h"
 
@@ -13,6 +14,8 @@
 
 class ShadowDisk;
 class ShadowMap;
+class CascadedShadowMap;
+class LightClusters;
 
 class LitMaterial : public IMaterial
 {
@@ -23,6 +26,9 @@ public:
 	uint32_t getId() const override;
 	ResourceRef<Shader> getShader() const override;
 	uint32_t getShaderId() const override;
+	uint64_t getShaderKey() const override;
+	bool discardsFragments() const override;
+	void prepareShader() const override;
 
 	glm::vec4 baseColor;
 	glm::vec2 tiling;
@@ -43,10 +49,12 @@ public:
 	ResourceRef<Texture> emissiveMap;
 	ResourceRef<Texture> heightMap;
 
-	void syncStaticUniforms() const;
 	void syncLightUniforms() const;
 	void setSampleDirectionalLight() const;
 
+	// Returns the features of the shader variant matching the material and the current render state
+	uint32_t getVariant() const;
+
 public:
 	// Instance counter
 	static uint32_t instances;
@@ -62,6 +70,8 @@ public:
 	static bool castShadows;
 	static ShadowDisk* mainShadowDisk; // tmp until global shadow system
 	static ShadowMap* mainShadowMap; // tmp until global shadow system
+	static CascadedShadowMap* mainCascadedShadowMap; // tmp until global shadow system, optional
+	static LightClusters* lightClusters; // Point lights and spotlights assigned to the clusters of the current camera, optional
 
 private:
 	enum TextureUnits
@@ -75,10 +85,21 @@ private:
 		HEIGHT_UNIT,
 		SHADOW_DISK_UNIT,
 		SHADOW_MAP_UNIT,
-		SSAO_UNIT
+		SSAO_UNIT,
+		CASCADED_SHADOW_MAP_UNIT
 	};
 
+	// Variants built so far by features, static uniforms are synced once per variant
+	static std::unordered_map<uint32_t, ResourceRef<Shader>> variants;
+
+	// Returns the features selected by the material itself
+	uint32_t materialFeatures() const;
+
+	// Returns the features selected by the current render state
+	static uint32_t renderStateFeatures();
+
+	// Syncs uniforms that never change to given variant (must be bound)
+	void syncStaticUniforms(const ResourceRef<Shader>& shader) const;
+
 	uint32_t id;
-	ResourceRef<Shader> shader;
-	uint32_t shaderId;
 };
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "lit_variant.h"
+
+namespace LitVariant {
+
+	uint32_t select(const Selection& selection)
+	{
+		uint32_t features = 0;
+
+		if (selection.albedoMap) features |= ALBEDO_MAP;
+		if (selection.roughnessMap) features |= ROUGHNESS_MAP;
+		if (selection.metallicMap) features |= METALLIC_MAP;
+		if (selection.normalMap) features |= NORMAL_MAP;
+		if (selection.occlusionMap) features |= OCCLUSION_MAP;
+		if (selection.emission) features |= EMISSION;
+		if (selection.emissiveMap) features |= EMISSIVE_MAP;
+		if (selection.heightMap) features |= HEIGHT_MAP;
+		if (selection.castShadows) features |= SHADOWS;
+		if (selection.cascadedShadows) features |= CASCADED_SHADOWS;
+		if (selection.ssao) features |= SSAO;
+		if (selection.lightClusters) features |= LIGHT_CLUSTERS;
+
+		return normalize(features);
+	}
+
+	uint32_t normalize(uint32_t features)
+	{
+		// Drop unknown bits
+		features &= (1u << N_FEATURES) - 1;
+
+		// Emissive map only tints emission
+		if (!(features & EMISSION)) features &= ~EMISSIVE_MAP;
+
+		// Cascades are only sampled if shadows are cast
+		if (!(features & SHADOWS)) features &= ~CASCADED_SHADOWS;
+
+		return features;
+	}
+
+	const char* define(Feature feature)
+	{
+		switch (feature) {
+		case ALBEDO_MAP: return "LIT_ALBEDO_MAP";
+		case ROUGHNESS_MAP: return "LIT_ROUGHNESS_MAP";
+		case METALLIC_MAP: return "LIT_METALLIC_MAP";
+		case NORMAL_MAP: return "LIT_NORMAL_MAP";
+		case OCCLUSION_MAP: return "LIT_OCCLUSION_MAP";
+		case EMISSION: return "LIT_EMISSION";
+		case EMISSIVE_MAP: return "LIT_EMISSIVE_MAP";
+		case HEIGHT_MAP: return "LIT_HEIGHT_MAP";
+		case SHADOWS: return "LIT_SHADOWS";
+		case CASCADED_SHADOWS: return "LIT_CASCADED_SHADOWS";
+		case SSAO: return "LIT_SSAO";
+		case LIGHT_CLUSTERS: return "LIT_LIGHT_CLUSTERS";
+		default: return "";
+		}
+	}
+
+	std::vector<std::string> defines(uint32_t features)
+	{
+		features = normalize(features);
+
+		std::vector<std::string> result;
+		for (uint32_t i = 0; i < N_FEATURES; i++) {
+			Feature feature = static_cast<Feature>(1u << i);
+			if (features & feature) result.push_back(define(feature));
+		}
+		return result;
+	}
+
+}
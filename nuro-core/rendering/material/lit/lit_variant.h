@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Feature set of a lit shader variant, features are compiled into the lit shader as LIT_* defines instead of branching on uniforms
+// Doesn't touch the graphics api, selecting a variant and its defines can happen anywhere
+namespace LitVariant
+{
+	enum Feature : uint32_t
+	{
+		ALBEDO_MAP = 1 << 0,
+		ROUGHNESS_MAP = 1 << 1,
+		METALLIC_MAP = 1 << 2,
+		NORMAL_MAP = 1 << 3,
+		OCCLUSION_MAP = 1 << 4,
+		EMISSION = 1 << 5,
+		EMISSIVE_MAP = 1 << 6,
+		HEIGHT_MAP = 1 << 7,
+		SHADOWS = 1 << 8,
+		CASCADED_SHADOWS = 1 << 9,
+		SSAO = 1 << 10,
+		LIGHT_CLUSTERS = 1 << 11
+	};
+
+	// Amount of features
+	constexpr uint32_t N_FEATURES = 12;
+
+	// Everything a variant is selected by
+	struct Selection
+	{
+		// Material
+		bool albedoMap = false;
+		bool roughnessMap = false;
+		bool metallicMap = false;
+		bool normalMap = false;
+		bool occlusionMap = false;
+		bool emission = false;
+		bool emissiveMap = false;
+		bool heightMap = false;
+
+		// Render state
+		bool castShadows = false;
+		bool cascadedShadows = false;
+		bool ssao = false;
+		bool lightClusters = false;
+	};
+
+	// Returns the features of the variant for given selection
+	uint32_t select(const Selection& selection);
+
+	// Removes features without effect, features depending on a disabled feature are dropped so equivalent selections share one variant
+	uint32_t normalize(uint32_t features);
+
+	// Returns the define enabling a single feature
+	const char* define(Feature feature);
+
+	// Returns the defines enabling given features, ordered by feature bit
+	std::vector<std::string> defines(uint32_t features);
+};
@@ -0,0 +1,162 @@
+#include "geometry_arena.h"
+
+#include <algorithm>
+#include <glad/glad.h>
+
+#include <utils/console.h>
+#include <rendering/submission/draw_submission.h>
+
+GeometryArena::GeometryArena(uint32_t vertexStride, std::vector<Attribute> attributes) : vertexStride(vertexStride),
+attributes(std::move(attributes)),
+_vao(0),
+_vbo(0),
+_ebo(0),
+vertices(),
+indices()
+{
+}
+
+void GeometryArena::create(uint32_t vertexCapacity, uint32_t indexCapacity)
+{
+	// Make sure arena wasn't created already
+	if (_vao) return;
+
+	// Generate vertex array
+	glCreateVertexArrays(1, &_vao);
+
+	// Setup vertex format, all attributes are sourced from binding point 0
+	for (const Attribute& attribute : attributes) {
+		glEnableVertexArrayAttrib(_vao, attribute.location);
+		glVertexArrayAttribFormat(_vao, attribute.location, attribute.nComponents, GL_FLOAT, GL_FALSE, attribute.offset);
+		glVertexArrayAttribBinding(_vao, attribute.location, 0);
+	}
+
+	// Allocate shared buffers
+	growVertexBuffer(std::max(vertexCapacity, 1u));
+	growIndexBuffer(std::max(indexCapacity, 1u));
+}
+
+void GeometryArena::destroy()
+{
+	glDeleteVertexArrays(1, &_vao);
+	glDeleteBuffers(1, &_vbo);
+	glDeleteBuffers(1, &_ebo);
+	_vao = 0;
+	_vbo = 0;
+	_ebo = 0;
+
+	vertices = RangeAllocator();
+	indices = RangeAllocator();
+}
+
+GeometryArena::Allocation GeometryArena::allocate(const void* vertexData, uint32_t nVertices, const uint32_t* indexData, uint32_t nIndices)
+{
+	// Nothing to allocate
+	if (nVertices == 0 || nIndices == 0) return Allocation();
+
+	// Create arena lazily
+	if (!_vao) create(nVertices, nIndices);
+
+	// Allocate vertex range, grow vertex buffer if needed
+	uint32_t baseVertex = vertices.allocate(nVertices);
+	if (baseVertex == RangeAllocator::INVALID_OFFSET) {
+		growVertexBuffer(std::max(vertices.capacity() * 2, vertices.capacity() + nVertices));
+		baseVertex = vertices.allocate(nVertices);
+	}
+
+	// Allocate index range, grow element buffer if needed
+	uint32_t firstIndex = indices.allocate(nIndices);
+	if (firstIndex == RangeAllocator::INVALID_OFFSET) {
+		growIndexBuffer(std::max(indices.capacity() * 2, indices.capacity() + nIndices));
+		firstIndex = indices.allocate(nIndices);
+	}
+
+	// Upload data to its ranges
+	DrawSubmission::uploadBuffer(_vbo, static_cast<size_t>(baseVertex) * vertexStride, static_cast<size_t>(nVertices) * vertexStride, vertexData);
+	DrawSubmission::uploadBuffer(_ebo, static_cast<size_t>(firstIndex) * sizeof(uint32_t), static_cast<size_t>(nIndices) * sizeof(uint32_t), indexData);
+
+	Allocation allocation;
+	allocation.baseVertex = baseVertex;
+	allocation.nVertices = nVertices;
+	allocation.firstIndex = firstIndex;
+	allocation.nIndices = nIndices;
+	return allocation;
+}
+
+void GeometryArena::free(const Allocation& allocation)
+{
+	if (!allocation.valid()) return;
+
+	vertices.free(allocation.baseVertex);
+	indices.free(allocation.firstIndex);
+}
+
+void GeometryArena::bind() const
+{
+	DrawSubmission::bindVertexArray(_vao);
+}
+
+uint32_t GeometryArena::vao() const
+{
+	return _vao;
+}
+
+uint32_t GeometryArena::vbo() const
+{
+	return _vbo;
+}
+
+uint32_t GeometryArena::ebo() const
+{
+	return _ebo;
+}
+
+const RangeAllocator& GeometryArena::vertexAllocator() const
+{
+	return vertices;
+}
+
+const RangeAllocator& GeometryArena::indexAllocator() const
+{
+	return indices;
+}
+
+void GeometryArena::growVertexBuffer(uint32_t capacity)
+{
+	// Create new vertex buffer
+	uint32_t vbo = 0;
+	glCreateBuffers(1, &vbo);
+	glNamedBufferStorage(vbo, static_cast<GLsizeiptr>(capacity) * vertexStride, nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+	// Copy existing vertices and delete old vertex buffer
+	if (_vbo) {
+		glCopyNamedBufferSubData(_vbo, vbo, 0, 0, static_cast<GLsizeiptr>(vertices.capacity()) * vertexStride);
+		glDeleteBuffers(1, &_vbo);
+		Console::out::info("Geometry Arena", "Vertex buffer grown to " + std::to_string(capacity) + " vertices");
+	}
+
+	// Attach new vertex buffer
+	_vbo = vbo;
+	glVertexArrayVertexBuffer(_vao, 0, _vbo, 0, vertexStride);
+	vertices.grow(capacity);
+}
+
+void GeometryArena::growIndexBuffer(uint32_t capacity)
+{
+	// Create new element buffer
+	uint32_t ebo = 0;
+	glCreateBuffers(1, &ebo);
+	glNamedBufferStorage(ebo, static_cast<GLsizeiptr>(capacity) * sizeof(uint32_t), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+	// Copy existing indices and delete old element buffer
+	if (_ebo) {
+		glCopyNamedBufferSubData(_ebo, ebo, 0, 0, static_cast<GLsizeiptr>(indices.capacity()) * sizeof(uint32_t));
+		glDeleteBuffers(1, &_ebo);
+		Console::out::info("Geometry Arena", "Element buffer grown to " + std::to_string(capacity) + " indices");
+	}
+
+	// Attach new element buffer
+	_ebo = ebo;
+	glVertexArrayElementBuffer(_vao, _ebo);
+	indices.grow(capacity);
+}
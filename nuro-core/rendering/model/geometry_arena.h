@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <memory/range_allocator.h>
+
+// Shared vertex and index buffers of a single vertex format, meshes are sub-allocated from it
+class GeometryArena
+{
+public:
+	// Float vertex attribute of the arenas vertex format
+	struct Attribute
+	{
+		// Shader location of attribute
+		uint32_t location = 0;
+
+		// Number of float components
+		int32_t nComponents = 0;
+
+		// Byte offset of attribute within a vertex
+		uint32_t offset = 0;
+	};
+
+	// Location of a mesh within the arena
+	struct Allocation
+	{
+		// Offset of the meshes first vertex in vertices
+		uint32_t baseVertex = 0;
+
+		// Number of vertices
+		uint32_t nVertices = 0;
+
+		// Offset of the meshes first index in indices
+		uint32_t firstIndex = 0;
+
+		// Number of indices
+		uint32_t nIndices = 0;
+
+		// Returns if allocation is backed by arena memory
+		bool valid() const { return nVertices > 0 && nIndices > 0; }
+	};
+
+	explicit GeometryArena(uint32_t vertexStride, std::vector<Attribute> attributes);
+
+	// Creates the arenas buffers and vertex array with an initial capacity
+	void create(uint32_t vertexCapacity, uint32_t indexCapacity);
+
+	// Destroys the arenas buffers and vertex array
+	void destroy();
+
+	// Uploads the given vertices and indices to the arena, grows the arena if needed
+	Allocation allocate(const void* vertices, uint32_t nVertices, const uint32_t* indices, uint32_t nIndices);
+
+	// Releases an allocation
+	void free(const Allocation& allocation);
+
+	// Binds the arenas vertex array
+	void bind() const;
+
+	// Returns the arenas vertex array object
+	uint32_t vao() const;
+
+	// Returns the arenas shared vertex buffer object
+	uint32_t vbo() const;
+
+	// Returns the arenas shared element buffer object
+	uint32_t ebo() const;
+
+	// Returns the vertex range allocator
+	const RangeAllocator& vertexAllocator() const;
+
+	// Returns the index range allocator
+	const RangeAllocator& indexAllocator() const;
+
+private:
+	// Reallocates the vertex buffer with a bigger capacity, keeping its contents
+	void growVertexBuffer(uint32_t capacity);
+
+	// Reallocates the element buffer with a bigger capacity, keeping its contents
+	void growIndexBuffer(uint32_t capacity);
+
+	// Size of a single vertex in bytes
+	uint32_t vertexStride;
+
+	// Attributes of the vertex format
+	std::vector<Attribute> attributes;
+
+	uint32_t _vao;
+	uint32_t _vbo;
+	uint32_t _ebo;
+
+	RangeAllocator vertices;
+	RangeAllocator indices;
+};
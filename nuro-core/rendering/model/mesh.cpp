@@ -1,37 +1,65 @@
 #include "mesh.h"
 
-Mesh::Mesh() : _vao(0),
-_vbo(0),
-_ebo(0),
+Mesh::Mesh() : _arena(nullptr),
+_baseVertex(0),
+_firstIndex(0),
 _nVertices(0),
 _nIndices(0),
-_materialIndex(0)
+_materialIndex(0),
+_boundsCenter(0.0f),
+_boundsRadius(0.0f)
 {
 }
 
-void Mesh::setData(uint32_t _vao, uint32_t _vbo, uint32_t _ebo, uint32_t _nVertices, uint32_t _nIndices, uint32_t _materialIndex)
+void Mesh::setData(const GeometryArena* arena, const GeometryArena::Allocation& allocation, uint32_t materialIndex)
 {
-	this->_vao = _vao;
-	this->_vbo = _vbo;
-	this->_ebo = _ebo;
-	this->_nVertices = _nVertices;
-	this->_nIndices = _nIndices;
-	this->_materialIndex = _materialIndex;
+	_arena = arena;
+	_baseVertex = allocation.baseVertex;
+	_firstIndex = allocation.firstIndex;
+	_nVertices = allocation.nVertices;
+	_nIndices = allocation.nIndices;
+	_materialIndex = materialIndex;
+}
+
+void Mesh::setBounds(const glm::vec3& center, float radius)
+{
+	_boundsCenter = center;
+	_boundsRadius = radius;
 }
 
 uint32_t Mesh::vao() const
 {
-	return _vao;
+	return _arena ? _arena->vao() : 0;
 }
 
 uint32_t Mesh::vbo() const
 {
-	return _vbo;
+	return _arena ? _arena->vbo() : 0;
 }
 
 uint32_t Mesh::ebo() const
 {
-	return _ebo;
+	return _arena ? _arena->ebo() : 0;
+}
+
+uint32_t Mesh::baseVertex() const
+{
+	return _baseVertex;
+}
+
+uint32_t Mesh::firstIndex() const
+{
+	return _firstIndex;
+}
+
+GeometryArena::Allocation Mesh::allocation() const
+{
+	GeometryArena::Allocation allocation;
+	allocation.baseVertex = _baseVertex;
+	allocation.nVertices = _nVertices;
+	allocation.firstIndex = _firstIndex;
+	allocation.nIndices = _nIndices;
+	return allocation;
 }
 
 uint32_t Mesh::verticeCount() const
@@ -47,4 +75,14 @@ uint32_t Mesh::indiceCount() const
 uint32_t Mesh::materialIndex() const
 {
 	return _materialIndex;
+}
+
+const glm::vec3& Mesh::boundsCenter() const
+{
+	return _boundsCenter;
+}
+
+float Mesh::boundsRadius() const
+{
+	return _boundsRadius;
 }
\ No newline at end of file
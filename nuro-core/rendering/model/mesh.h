@@ -4,23 +4,37 @@
 #include <vector>
 #include <glm/glm.hpp>
 
+#include <rendering/model/geometry_arena.h>
+
 class Mesh
 {
 public:
 	Mesh();
 
-	// Sets the meshes existing backend buffers and metrics
-	void setData(uint32_t vao, uint32_t vbo, uint32_t ebo, uint32_t nVertices, uint32_t nIndices, uint32_t materialIndex);
+	// Sets the geometry arena the mesh was allocated from, its allocation within the arena and metrics
+	void setData(const GeometryArena* arena, const GeometryArena::Allocation& allocation, uint32_t materialIndex);
+
+	// Sets the meshes local bounding sphere
+	void setBounds(const glm::vec3& center, float radius);
 	
-	// Returns the meshes vertex array object
+	// Returns the meshes vertex array object (shared by all meshes of the same geometry arena)
 	uint32_t vao() const;
 
-	// Returns the meshes vertex buffer object
+	// Returns the meshes vertex buffer object (shared by all meshes of the same geometry arena)
 	uint32_t vbo() const;
 
-	// Return the meshes element buffer object
+	// Return the meshes element buffer object (shared by all meshes of the same geometry arena)
 	uint32_t ebo() const;
 
+	// Returns the offset of the meshes first vertex within the vertex buffer
+	uint32_t baseVertex() const;
+
+	// Returns the offset of the meshes first index within the element buffer
+	uint32_t firstIndex() const;
+
+	// Returns the meshes allocation within its geometry arena
+	GeometryArena::Allocation allocation() const;
+
 	// Returns the meshes amount of vertices
 	uint32_t verticeCount() const;
 
@@ -30,12 +44,22 @@ public:
 	// Returns the meshes material index related to the parent model
 	uint32_t materialIndex() const;
 
+	// Returns the center of the meshes local bounding sphere
+	const glm::vec3& boundsCenter() const;
+
+	// Returns the radius of the meshes local bounding sphere
+	float boundsRadius() const;
+
 private:
-	uint32_t _vao;
-	uint32_t _vbo;
-	uint32_t _ebo;
+	const GeometryArena* _arena;
+
+	uint32_t _baseVertex;
+	uint32_t _firstIndex;
 
 	uint32_t _nVertices;
 	uint32_t _nIndices;
 	uint32_t _materialIndex;
+
+	glm::vec3 _boundsCenter;
+	float _boundsRadius;
 };
\ No newline at end of file
@@ -53,60 +53,33 @@ Model::Metrics Model::getMetrics() const
 
 Mesh* Model::createStaticMesh(std::vector<VertexData>& vertices, std::vector<uint32_t>& indices)
 {
-	// Get mesh data metrics
-	uint32_t nVertices = vertices.size();
-	uint32_t nIndices = indices.size();
-	uint32_t materialIndex = 0;
-
-	// VAO, VBO and EBO backend ids
-	uint32_t vao, vbo, ebo;
-
-	// Generate VAO, VBO and EBO
-	glGenVertexArrays(1, &vao);
-	glGenBuffers(1, &vbo);
-	glGenBuffers(1, &ebo);
-
-	// Bind VAO
-	glBindVertexArray(vao);
-
-	// Bind VBO, allocate its memory send vertex data
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBufferData(GL_ARRAY_BUFFER, nVertices * sizeof(VertexData), vertices.data(), GL_STATIC_DRAW);
-
-	// Bind EBO, allocate its memory and send indice data
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, nIndices * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
-
-	// Set attributes for VAO
-	// Vertex position attribute (location = 0)
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, position));
-	// Normal attribute (location = 1)
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, normal));
-	// Texture coordinates attribute (location = 2)
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, uv));
-	// Tangent attribute (location = 3)
-	glEnableVertexAttribArray(3);
-	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, tangent));
-	// Bitangent attribute (location = 3)
-	glEnableVertexAttribArray(4);
-	glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, bitangent));
-
-	// Unbind VAO, ABO and EBO
-	glBindVertexArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	// Upload mesh data to geometry arena
+	GeometryArena& arena = geometryArena();
+	GeometryArena::Allocation allocation = arena.allocate(vertices.data(), vertices.size(), indices.data(), indices.size());
 
 	// Create mesh container object
 	Mesh* mesh = new Mesh();
-	mesh->setData(vao, vbo, ebo, nVertices, nIndices, materialIndex);
+	mesh->setData(&arena, allocation, 0);
+	setMeshBounds(*mesh, vertices);
 
 	// Return mesh
 	return mesh;
 }
 
+GeometryArena& Model::geometryArena()
+{
+	// Vertex format of model meshes
+	static GeometryArena arena(sizeof(VertexData), {
+		{ 0, 3, offsetof(VertexData, position) }, // Vertex position attribute (location = 0)
+		{ 1, 3, offsetof(VertexData, normal) }, // Normal attribute (location = 1)
+		{ 2, 2, offsetof(VertexData, uv) }, // Texture coordinates attribute (location = 2)
+		{ 3, 3, offsetof(VertexData, tangent) }, // Tangent attribute (location = 3)
+		{ 4, 3, offsetof(VertexData, bitangent) } // Bitangent attribute (location = 4)
+	});
+
+	return arena;
+}
+
 void Model::processNode(aiNode* node, const aiScene* scene)
 {
 	for (uint32_t i = 0; i < node->mNumMeshes; i++)
@@ -227,53 +200,14 @@ bool Model::uploadBuffers()
 	// Don't dispatch model if there is no data
 	if (meshData.empty()) return false;
 
-	// Dispatch each mesh
+	// Dispatch each mesh into the shared geometry arena
+	GeometryArena& arena = geometryArena();
 	for (uint32_t i = 0; i < meshData.size(); i++) {
-		// Get mesh data metrics
-		uint32_t nVertices = meshData[i].vertices.size();
-		uint32_t nIndices = meshData[i].indices.size();
-		uint32_t materialIndex = meshData[i].materialIndex;
-
-		// VAO, VBO and EBO backend ids
-		uint32_t vao, vbo, ebo;
-
-		// Generate VAO, VBO and EBO
-		glGenVertexArrays(1, &vao);
-		glGenBuffers(1, &vbo);
-		glGenBuffers(1, &ebo);
-
-		// Bind VAO
-		glBindVertexArray(vao);
-
-		// Bind VBO, allocate its memory send vertex data
-		glBindBuffer(GL_ARRAY_BUFFER, vbo);
-		glBufferData(GL_ARRAY_BUFFER, nVertices * sizeof(VertexData), meshData[i].vertices.data(), GL_STATIC_DRAW);
-
-		// Bind EBO, allocate its memory and send indice data
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, nIndices * sizeof(uint32_t), meshData[i].indices.data(), GL_STATIC_DRAW);
-
-		// Set attributes for VAO
-		// Vertex position attribute (location = 0)
-		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, position));
-		// Normal attribute (location = 1)
-		glEnableVertexAttribArray(1);
-		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, normal));
-		// Texture coordinates attribute (location = 2)
-		glEnableVertexAttribArray(2);
-		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, uv));
-		// Tangent attribute (location = 3)
-		glEnableVertexAttribArray(3);
-		glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, tangent));
-		// Bitangent attribute (location = 3)
-		glEnableVertexAttribArray(4);
-		glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, bitangent));
-
-		// Unbind VAO, ABO and EBO
-		glBindVertexArray(0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		// Get mesh data
+		const MeshData& data = meshData[i];
+
+		// Upload vertex and indice data
+		GeometryArena::Allocation allocation = arena.allocate(data.vertices.data(), data.vertices.size(), data.indices.data(), data.indices.size());
 
 		// Mesh is not existing yet, create empty mesh
 		if (meshes.find(i) == meshes.end()) {
@@ -281,7 +215,8 @@ bool Model::uploadBuffers()
 		}
 
 		// Update mesh
-		meshes[i].setData(vao, vbo, ebo, nVertices, nIndices, materialIndex);
+		meshes[i].setData(&arena, allocation, data.materialIndex);
+		setMeshBounds(meshes[i], data.vertices);
 	}
 
 	return true;
@@ -289,15 +224,36 @@ bool Model::uploadBuffers()
 
 void Model::deleteBuffers()
 {
+	// Release each meshes arena ranges
+	GeometryArena& arena = geometryArena();
 	for (auto& [id, mesh] : meshes) {
-		uint32_t vao = mesh.vao(), vbo = mesh.vbo(), ebo = mesh.ebo();
-		glDeleteVertexArrays(1, &vao);
-		glDeleteBuffers(1, &vbo);
-		glDeleteBuffers(1, &ebo);
+		arena.free(mesh.allocation());
 	}
 	meshes.clear();
 }
 
+void Model::setMeshBounds(Mesh& mesh, const std::vector<VertexData>& vertices)
+{
+	if (vertices.empty()) return;
+
+	// Center bounding sphere on the meshes local bounding box
+	glm::vec3 min = vertices[0].position;
+	glm::vec3 max = vertices[0].position;
+	for (const VertexData& vertex : vertices) {
+		min = glm::min(min, vertex.position);
+		max = glm::max(max, vertex.position);
+	}
+	glm::vec3 center = (min + max) * 0.5f;
+
+	// Radius is the distance to the furthest vertex
+	float radius = 0.0f;
+	for (const VertexData& vertex : vertices) {
+		radius = glm::max(radius, glm::distance(center, vertex.position));
+	}
+
+	mesh.setBounds(center, radius);
+}
+
 void Model::addMeshToMetrics(const std::vector<VertexData>& vertices, uint32_t nFaces)
 {
 	// Add number of vertices and faces to metrics
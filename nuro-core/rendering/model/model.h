@@ -8,6 +8,7 @@
 #include <utils/fsutil.h>
 #include <memory/resource.h>
 #include <rendering/model/mesh.h>
+#include <rendering/model/geometry_arena.h>
 
 class aiScene;
 class aiNode;
@@ -104,6 +105,9 @@ public:
 	// Creates a static mesh with the given vertices and indices
 	static Mesh* createStaticMesh(std::vector<VertexData>& vertices, std::vector<uint32_t>& indices);
 
+	// Returns the geometry arena all model meshes are allocated from (vertex format of VertexData)
+	static GeometryArena& geometryArena();
+
 private:
 	//
 	// MODEL CREATION
@@ -117,6 +121,9 @@ private:
 	bool uploadBuffers();
 	void deleteBuffers();
 
+	// Calculates and sets the local bounding sphere of a mesh from its vertices
+	static void setMeshBounds(Mesh& mesh, const std::vector<VertexData>& vertices);
+
 	//
 	// MODEL DATA
 	//
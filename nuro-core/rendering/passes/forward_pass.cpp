@@ -4,14 +4,20 @@
 
 #include <utils/console.h>
 #include <rendering/model/mesh.h>
+#include <rendering/model/model.h>
 #include <memory/resource_manager.h>
 #include <rendering/skybox/skybox.h>
+#include <diagnostics/profiler.h>
 #include <diagnostics/diagnostics.h>
+#include <rendering/shader/shader.h>
+#include <rendering/shader/shader_pool.h>
 #include <rendering/material/imaterial.h>
+#include <rendering/submission/draw_submission.h>
 #include <rendering/transformation/transformation.h>
 
 ForwardPass::ForwardPass(const Viewport& viewport) : drawSkybox(false),
 drawGizmos(false),
+depthPrePass(true),
 viewport(viewport),
 skybox(nullptr),
 gizmos(nullptr),
@@ -21,7 +27,9 @@ outputColor(0),
 outputDepth(0),
 multisampledFbo(0),
 multisampledRbo(0),
-multisampledColorBuffer(0)
+multisampledColorBuffer(0),
+batch(),
+depthShader(ShaderPool::empty())
 {
 }
 
@@ -74,6 +82,12 @@ void ForwardPass::create(const uint32_t msaaSamples)
 	}
 
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	// Create draw batch
+	batch.create();
+
+	// Get depth pre pass shader
+	depthShader = ShaderPool::get("depth_pass");
 }
 
 void ForwardPass::destroy() {
@@ -100,6 +114,12 @@ void ForwardPass::destroy() {
 	// Delete multisampled framebuffer
 	glDeleteFramebuffers(1, &multisampledFbo);
 	multisampledFbo = 0;
+
+	// Destroy draw batch
+	batch.destroy();
+
+	// Remove shaders
+	depthShader = nullptr;
 }
 
 uint32_t ForwardPass::render(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& viewProjection)
@@ -122,24 +142,7 @@ uint32_t ForwardPass::render(const glm::mat4& view, const glm::mat4& projection,
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_LESS);
 
-	// INJECTED PRE PASS START
-	/*
-	// Disable color writing
-	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
-	// Bind pre pass shader
-	prePassShader->bind();
-	// Pre pass render each entity
-	for (int32_t i = 0; i < entityStack.size(); i++) {
-		entityStack[i]->meshRenderer->prePass();
-	}
-	// Re-enable color writing after pre pass
-	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-	// GL_EQUAL depth testing for upcoming forward pass to use pre pass depth data
-	glDepthFunc(GL_EQUAL);
-	*/
-	// INJECTED PRE PASS END
-
-	// Render each entity
+	// Render each entity, with a depth pre pass if enabled
 	renderMeshes();
 
 	// Disable culling before rendering skybox
@@ -179,50 +182,74 @@ void ForwardPass::setClearColor(glm::vec4 _clearColor)
 	clearColor = _clearColor;
 }
 
-void ForwardPass::renderMesh(TransformComponent& transform, MeshRendererComponent& renderer)
+void ForwardPass::renderMeshes()
 {
 	// Transform components model and mvp must have been calculated beforehand
 
-	// Renderer must be enabled
-	if (!renderer.enabled) return;
+	// Build shader variants of the current render state before batching
+	ECS::main().prepareShaders();
 
-	// Make sure mesh is available
-	if (!renderer.mesh) return;
+	// Collect draws of all render targets, render queue is sorted by shader and material
+	batch.clear();
+	uint32_t nQueued = 0;
+	uint32_t nDrawn = 0;
+	for (auto& [entity, transform, renderer] : ECS::main().getRenderQueue()) {
+		nQueued++;
 
-	// Set shader uniforms
-	ResourceRef<Shader> shader = renderer.material->getShader();
-	shader->setMatrix4("mvpMatrix", transform.mvp);
-	shader->setMatrix4("modelMatrix", transform.model);
-	shader->setMatrix3("normalMatrix", transform.normal);
+		// Renderer must be enabled and mesh must be available
+		if (!renderer.enabled || !renderer.mesh) continue;
 
-	// Bind mesh
-	glBindVertexArray(renderer.mesh->vao());
+		batch.add(renderer.material, *renderer.mesh, transform.model, transform.mvp, transform.normal);
+		nDrawn++;
+	}
 
-	// Render mesh
-	glDrawElements(GL_TRIANGLES, renderer.mesh->indiceCount(), GL_UNSIGNED_INT, 0);
-}
+	// Every queued entity is handled on the cpu, only drawn ones reach the gpu
+	Diagnostics::addNEntitiesCPU(nQueued);
+	Diagnostics::addNEntitiesGPU(nDrawn);
 
-void ForwardPass::renderMeshes()
-{
-	uint32_t currentShaderId = 0;
-	uint32_t currentMaterialId = 0;
+	// Upload collected draws
+	batch.upload();
 
-	// Render each entity
-	for (auto& [entity, transform, renderer] : ECS::main().getRenderQueue()) {
+	// Bind shared geometry of all meshes
+	Model::geometryArena().bind();
+
+	// Depth pre pass, rasterizes the already uploaded batch without color writes
+	// Materials discarding fragments are left out, their depth is written while shading them
+	bool prePass = depthPrePass && depthShader;
+	if (prePass) {
+		Profiler::startPass("forward_depth");
+
+		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+		depthShader->bind();
+		for (const IndirectBatch::Group& group : batch.getGroups()) {
+			if (!group.material->discardsFragments()) batch.draw(group);
+		}
+		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+		Profiler::stopPass("forward_depth");
+	}
 
-		uint32_t shaderId = renderer.material->getShaderId();
+	// Submit each material group with a single draw call
+	uint32_t currentShaderId = 0;
+	for (const IndirectBatch::Group& group : batch.getGroups()) {
+
+		uint32_t shaderId = group.material->getShaderId();
 		if (shaderId != currentShaderId) {
-			renderer.material->getShader()->bind();
+			group.material->getShader()->bind();
 			currentShaderId = shaderId;
 		}
 
-		uint32_t materialId = renderer.material->getId();
-		if (materialId != currentMaterialId) {
-			renderer.material->bind();
-			currentMaterialId = materialId;
-		}
+		// Only shade the visible surface of groups whose depth was laid down already
+		bool depthPrePassed = prePass && !group.material->discardsFragments();
+		glDepthFunc(depthPrePassed ? GL_EQUAL : GL_LESS);
+		glDepthMask(depthPrePassed ? GL_FALSE : GL_TRUE);
 
-		renderMesh(transform, renderer);
+		DrawSubmission::bindMaterial(*group.material);
+		batch.draw(group);
 
 	}
+
+	// Restore default depth state
+	glDepthFunc(GL_LESS);
+	glDepthMask(GL_TRUE);
 }
\ No newline at end of file
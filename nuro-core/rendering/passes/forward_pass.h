@@ -6,9 +6,12 @@
 
 #include <viewport/viewport.h>
 #include <ecs/ecs_collection.h>
+#include <memory/resource_manager.h>
 #include <rendering/gizmos/imgizmo.h>
+#include <rendering/batching/indirect_batch.h>
 
 class Skybox;
+class Shader;
 
 class ForwardPass
 {
@@ -29,6 +32,9 @@ public:
 	void linkGizmos(IMGizmo* gizmos);
 	bool drawGizmos;
 
+	// Lays down depth of all meshes before shading them with GL_EQUAL, so each covered sample is shaded once
+	bool depthPrePass;
+
 	void setClearColor(glm::vec4 clearColor); // Clear color for forward pass
 private:
 	const Viewport& viewport; // Viewport forward pass instance is linked to
@@ -46,6 +52,9 @@ private:
 	uint32_t multisampledRbo;		 // Anti-aliasing renderbuffer
 	uint32_t multisampledColorBuffer; // Anti-aliasing color buffer texture
 
-	void renderMesh(TransformComponent& transform, MeshRendererComponent& renderer);
+	IndirectBatch batch; // Batch collecting all mesh draws of the forward pass
+
+	ResourceRef<Shader> depthShader; // Depth only shader of batched draws used by the depth pre pass
+
 	void renderMeshes();
 };
\ No newline at end of file
@@ -8,12 +8,14 @@
 #include <rendering/model/mesh.h>
 #include <rendering/shader/shader.h>
 #include <rendering/shader/shader_pool.h>
+#include <rendering/submission/draw_submission.h>
 #include <rendering/transformation/transformation.h>
 
 PrePass::PrePass(const Viewport& viewport) : viewport(viewport),
 fbo(0),
 depthOutput(0),
 normalOutput(0),
+velocityOutput(0),
 prePassShader(ShaderPool::empty())
 {
 }
@@ -55,6 +57,20 @@ void PrePass::create()
 	// Set normal output as rendering target
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, normalOutput, 0);
 
+	// Generate velocity output
+	glGenTextures(1, &velocityOutput);
+	glBindTexture(GL_TEXTURE_2D, velocityOutput);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, viewport.getWidth_gl(), viewport.getHeight_gl(), 0, GL_RGB, GL_FLOAT, nullptr);
+
+	// Set velocity output parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	// Set velocity output as second rendering target
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, velocityOutput, 0);
+
 	// Check for framebuffer errors
 	GLenum fboStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER);
 	if (fboStatus != GL_FRAMEBUFFER_COMPLETE)
@@ -75,6 +91,10 @@ void PrePass::destroy() {
 	glDeleteTextures(1, &normalOutput);
 	normalOutput = 0;
 
+	// Delete velocity output texture
+	glDeleteTextures(1, &velocityOutput);
+	velocityOutput = 0;
+
 	// Delete framebuffer
 	glDeleteFramebuffers(1, &fbo);
 	fbo = 0;
@@ -83,7 +103,7 @@ void PrePass::destroy() {
 	prePassShader = nullptr;
 }
 
-void PrePass::render(glm::mat4 viewProjection, glm::mat3 viewNormal)
+void PrePass::render(const glm::mat4& viewProjection, const glm::mat3& viewNormal, bool writeVelocity)
 {
 	// Set viewport for upcoming pre pass
 	glViewport(0, 0, viewport.getWidth_gl(), viewport.getHeight_gl());
@@ -91,6 +111,10 @@ void PrePass::render(glm::mat4 viewProjection, glm::mat3 viewNormal)
 	// Bind pre pass framebuffer
 	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
 
+	// Write velocity output only if needed
+	const GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, writeVelocity ? GL_COLOR_ATTACHMENT1 : GL_NONE };
+	glDrawBuffers(2, drawBuffers);
+
 	// Clear color and depth buffer
 	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -104,21 +128,29 @@ void PrePass::render(glm::mat4 viewProjection, glm::mat3 viewNormal)
 
 	// Bind pre pass shader
 	prePassShader->bind();
+	prePassShader->setMatrix3("viewNormalMatrix", viewNormal);
 
 	// Pre pass render each entity
 	auto targets = ECS::main().view<TransformComponent, MeshRendererComponent>();
 	for (auto [entity, transform, renderer] : targets.each()) {
-		if (!renderer.mesh) return;
+		if (!renderer.enabled || !renderer.mesh) continue;
 
 		// Bind mesh
-		glBindVertexArray(renderer.mesh->vao());
+		DrawSubmission::bindVertexArray(renderer.mesh->vao());
 
 		// Set depth pre pass shader uniforms
 		prePassShader->setMatrix4("mvpMatrix", transform.mvp);
-		prePassShader->setMatrix3("viewNormalMatrix", viewNormal);
+
+		// Object motion of entities with velocity blur, in screen space of the current camera so camera motion isn't included
+		if (writeVelocity) {
+			VelocityBlurComponent* velocity = ECS::main().reg().try_get<VelocityBlurComponent>(entity);
+			bool moving = velocity && velocity->enabled;
+			prePassShader->setMatrix4("previousMvpMatrix", moving ? viewProjection * transform.previousModel : transform.mvp);
+			prePassShader->setFloat("velocityIntensity", moving ? velocity->intensity : 0.0f);
+		}
 
 		// Render mesh
-		glDrawElements(GL_TRIANGLES, renderer.mesh->indiceCount(), GL_UNSIGNED_INT, 0);
+		DrawSubmission::drawElements(GL_TRIANGLES, renderer.mesh->indiceCount(), renderer.mesh->firstIndex(), static_cast<int32_t>(renderer.mesh->baseVertex()));
 	}
 }
 
@@ -132,4 +164,10 @@ uint32_t PrePass::getNormalOutput()
 {
 	// Return pre pass normal output
 	return normalOutput;
+}
+
+uint32_t PrePass::getVelocityOutput()
+{
+	// Return pre pass velocity output
+	return velocityOutput;
 }
\ No newline at end of file
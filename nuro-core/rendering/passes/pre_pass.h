@@ -17,17 +17,23 @@ public:
 	void create();
 	void destroy();
 
-	void render(glm::mat4 viewProjection, glm::mat3 viewNormal);
+	// Renders depth and view space normals of all meshes, optionally object motion vectors as second output
+	void render(const glm::mat4& viewProjection, const glm::mat3& viewNormal, bool writeVelocity);
 
 	uint32_t getDepthOutput();
 	uint32_t getNormalOutput();
 
+	// Returns object motion vectors of entities with a velocity blur component
+	// RED CHANNEL = x velocity | GREEN CHANNEL = y velocity | BLUE CHANNEL = view space depth
+	uint32_t getVelocityOutput();
+
 private:
 	const Viewport& viewport;
 
 	uint32_t fbo;
 	uint32_t depthOutput;
 	uint32_t normalOutput;
+	uint32_t velocityOutput;
 
 	ResourceRef<Shader> prePassShader;
 };
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include <glad/glad.h>
 
+#include <rendering/submission/draw_submission.h>
+
 namespace GlobalQuad {
 
 	uint32_t _vbo = 0;
@@ -34,12 +36,12 @@ namespace GlobalQuad {
 
 	void bind()
 	{
-		glBindVertexArray(_vao);
+		DrawSubmission::bindVertexArray(_vao);
 	}
 
 	void render()
 	{
-		glDrawArrays(GL_TRIANGLES, 0, 6);
+		DrawSubmission::drawArrays(GL_TRIANGLES, 0, 6);
 	}
 
 	const uint32_t vbo()
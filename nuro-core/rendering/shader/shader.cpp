@@ -5,10 +5,18 @@
 
 #include <utils/fsutil.h>
 #include <utils/console.h>
+#include <rendering/shader/shader_cache.h>
+#include <rendering/shader/shader_preprocessor.h>
+#include <rendering/submission/draw_submission.h>
 
 Shader::Shader() : sourcePath(),
+defines(),
 data(),
 uniforms(),
+cacheKey(0),
+_cached(false),
+vertexShader(0),
+fragmentShader(0),
 _backendId(0)
 {
 }
@@ -28,9 +36,14 @@ void Shader::setSource(const FS::Path& _sourcePath)
 	sourcePath = _sourcePath;
 }
 
+void Shader::setDefines(const std::vector<std::string>& _defines)
+{
+	defines = _defines;
+}
+
 void Shader::bind() const
 {
-	glUseProgram(_backendId);
+	DrawSubmission::bindShader(_backendId);
 }
 
 uint32_t Shader::backendId() const
@@ -108,7 +121,7 @@ bool Shader::programLinked(int32_t program)
 	// Fetch shader program linking status
 	int32_t success;
 	char shader_log[512];
-	glGetProgramiv(program, GL_COMPILE_STATUS, &success);
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
 
 	// Shader program linking failed, terminate program
 	if (!success)
@@ -122,58 +135,137 @@ bool Shader::programLinked(int32_t program)
 	return true;
 }
 
-bool Shader::loadIoData()
+bool Shader::loadSources()
 {
-	data.vertexSource = FS::readFile(sourcePath / ".vert");
-	data.fragmentSource = FS::readFile(sourcePath / ".frag");
+	// Shared files are included from the include directory next to the shader groups
+	FS::Path includeDirectory = sourcePath.parent_path().parent_path() / "include";
 
+	std::string error;
+	if (!ShaderPreprocessor::process(sourcePath / ".vert", includeDirectory, defines, data.vertexSource, error) ||
+		!ShaderPreprocessor::process(sourcePath / ".frag", includeDirectory, defines, data.fragmentSource, error)) {
+		Console::out::warning("Shader", "Preprocessing of shader '" + sourcePath.filename().string() + "' failed!", error);
+		freeIoData();
+		return false;
+	}
+
+	cacheKey = ShaderCache::key(data.vertexSource, data.fragmentSource);
 	return true;
 }
 
-void Shader::freeIoData()
+bool Shader::issueProgram()
 {
-	data.vertexSource.clear();
-	data.fragmentSource.clear();
+	// Don't dispatch shader if there is no data
+	if (data.vertexSource.empty() || data.fragmentSource.empty()) return false;
+
+	_backendId = glCreateProgram();
+
+	// Program binary of an earlier run is the fastest way
+	_cached = ShaderCache::load(cacheKey, _backendId);
+	if (!_cached) compileSources();
+
+	return true;
 }
 
-bool Shader::uploadBuffers()
+bool Shader::finishProgram()
 {
-	// Don't dispatch shader if there is no data
-	if (data.vertexSource.empty() || data.fragmentSource.empty()) return false;
+	// Program wasn't issued
+	if (!_backendId) {
+		freeIoData();
+		return false;
+	}
+
+	// Fetch shader program linking status, this waits for the driver
+	int32_t linked = 0;
+	glGetProgramiv(_backendId, GL_LINK_STATUS, &linked);
+
+	// Cached binary was rejected, build program from sources
+	if (!linked && _cached) {
+		_cached = false;
+		compileSources();
+		glGetProgramiv(_backendId, GL_LINK_STATUS, &linked);
+	}
+
+	// Report failed stages
+	if (!linked) {
+		if (vertexShader) shaderCompiled("vertex", vertexShader);
+		if (fragmentShader) shaderCompiled("fragment", fragmentShader);
+		programLinked(_backendId);
+		deleteBuffers();
+		freeIoData();
+		return false;
+	}
+
+	// Keep binary of programs built from sources for the next run
+	if (!_cached) ShaderCache::store(cacheKey, _backendId);
+
+	// Delete shader sources
+	deleteStages();
+	freeIoData();
+
+	return true;
+}
 
-	// Shader backend ids
-	uint32_t vertexShader, fragmentShader;
+bool Shader::cached() const
+{
+	return _cached;
+}
 
+void Shader::compileSources()
+{
 	// Compile vertex shader source
 	const char* vertexSource = data.vertexSource.c_str();
 	vertexShader = glCreateShader(GL_VERTEX_SHADER);
 	glShaderSource(vertexShader, 1, &vertexSource, nullptr);
 	glCompileShader(vertexShader);
-	if (!shaderCompiled("vertex", vertexShader)) return false;
 
 	// Compile fragment shader source
 	const char* fragmentSource = data.fragmentSource.c_str();
 	fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
 	glShaderSource(fragmentShader, 1, &fragmentSource, nullptr);
 	glCompileShader(fragmentShader);
-	if (!shaderCompiled("fragment", fragmentShader)) return false;
 
-	// Create and link shader program
-	_backendId = glCreateProgram();
+	// Link shader program, compile status is only checked once linking failed
 	glAttachShader(_backendId, vertexShader);
 	glAttachShader(_backendId, fragmentShader);
+	if (ShaderCache::enabled()) glProgramParameteri(_backendId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	glLinkProgram(_backendId);
-	if (!programLinked(_backendId)) return false;
+}
 
-	// Delete shader sources
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
+void Shader::deleteStages()
+{
+	if (vertexShader) {
+		if (_backendId) glDetachShader(_backendId, vertexShader);
+		glDeleteShader(vertexShader);
+	}
 
-	return true;
+	if (fragmentShader) {
+		if (_backendId) glDetachShader(_backendId, fragmentShader);
+		glDeleteShader(fragmentShader);
+	}
+
+	vertexShader = 0;
+	fragmentShader = 0;
+}
+
+bool Shader::loadIoData()
+{
+	return loadSources();
+}
+
+void Shader::freeIoData()
+{
+	data.vertexSource.clear();
+	data.fragmentSource.clear();
+}
+
+bool Shader::uploadBuffers()
+{
+	return issueProgram() && finishProgram();
 }
 
 void Shader::deleteBuffers()
 {
+	deleteStages();
 	if (_backendId) glDeleteProgram(_backendId);
 	_backendId = 0;
 }
\ No newline at end of file
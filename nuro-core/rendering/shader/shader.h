@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <cstdint>
 #include <glm/glm.hpp>
 #include <unordered_map>
@@ -21,9 +22,31 @@ public:
 			>> BIND_TASK_WITH_FLAGS(Shader, uploadBuffers, TaskFlags::UseContextThread));
 	}
 
+	// Pipe finishing a shader whose sources were loaded and whose program was issued beforehand (see ShaderPool::loadAllSync)
+	ResourcePipe createIssued() {
+		return std::move(pipe()
+			>> BIND_TASK_WITH_FLAGS(Shader, finishProgram, TaskFlags::UseContextThread));
+	}
+
+	// Loads and preprocesses the shaders sources, may run on any thread
+	bool loadSources();
+
+	// Starts building the program from the loaded sources or from the program binary cache without waiting for the result (context thread)
+	// Issuing many programs before finishing any lets drivers build them in parallel
+	bool issueProgram();
+
+	// Waits for the issued program and checks it, falls back to the sources if a cached binary was rejected (context thread)
+	bool finishProgram();
+
+	// Returns if the program was loaded from the program binary cache
+	bool cached() const;
+
 	// Sets the path of the shaders source
 	void setSource(const FS::Path& sourcePath);
 
+	// Sets the defines inserted into both stages when the sources are loaded, each one is a name optionally followed by a value
+	void setDefines(const std::vector<std::string>& defines);
+
 	// Binds the shader program
 	void bind() const;
 
@@ -48,12 +71,25 @@ private:
 	// Path of shader source
 	FS::Path sourcePath;
 
+	// Defines inserted into the shader sources
+	std::vector<std::string> defines;
+
 	// Shader source data
 	Data data;
 
 	// Shader program uniform location cache
 	std::unordered_map<std::string, int32_t> uniforms;
 
+	// Key of the shader within the program binary cache
+	uint64_t cacheKey;
+
+	// Set if the program was loaded from the program binary cache
+	bool _cached;
+
+	// Shader stages attached to the program until it's finished
+	uint32_t vertexShader;
+	uint32_t fragmentShader;
+
 	// Shader program backend id
 	uint32_t _backendId;
 
@@ -63,6 +99,12 @@ private:
 	bool shaderCompiled(const char* type, int32_t shader);
 	bool programLinked(int32_t program);
 
+	// Compiles the loaded sources and links them into the program without waiting for the result
+	void compileSources();
+
+	// Deletes the shader stages
+	void deleteStages();
+
 	bool loadIoData();
 	void freeIoData();
 	bool uploadBuffers();
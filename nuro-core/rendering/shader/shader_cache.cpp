@@ -0,0 +1,158 @@
+#include "shader_cache.h"
+
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <glad/glad.h>
+
+#include <utils/console.h>
+
+namespace ShaderCache {
+
+	// Header of each cache entry, followed by the program binary
+	struct EntryHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t format;
+		uint32_t size;
+	};
+
+	constexpr char ENTRY_MAGIC[4] = { 'N', 'S', 'H', 'B' };
+
+	bool gEnabled = false;
+	FS::Path gDirectory;
+
+	// Hash of the driver identification, part of every key
+	uint64_t gDriverHash = HASH_SEED;
+
+	std::string _getString(GLenum name)
+	{
+		const char* value = reinterpret_cast<const char*>(glGetString(name));
+		return value ? value : "";
+	}
+
+	FS::Path _entryPath(uint64_t key)
+	{
+		char name[32];
+		std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+		return gDirectory / name;
+	}
+
+	void create(const FS::Path& directory)
+	{
+		std::string driver = _getString(GL_VENDOR) + "|" + _getString(GL_RENDERER) + "|" + _getString(GL_VERSION);
+		gDriverHash = hash(driver.data(), driver.size());
+
+		// Drivers may not support any binary format
+		int32_t nFormats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &nFormats);
+		if (nFormats <= 0) {
+			Console::out::warning("Shader Cache", "Driver doesn't support program binaries, shaders are always compiled");
+			gEnabled = false;
+			return;
+		}
+
+		std::error_code ec;
+		std::filesystem::create_directories(directory, ec);
+		if (ec) {
+			Console::out::warning("Shader Cache", "Couldn't create cache directory '" + directory.string() + "'");
+			gEnabled = false;
+			return;
+		}
+
+		gDirectory = directory;
+		gEnabled = true;
+	}
+
+	void destroy()
+	{
+		gEnabled = false;
+		gDirectory.clear();
+	}
+
+	bool enabled()
+	{
+		return gEnabled;
+	}
+
+	uint64_t key(const std::string& vertexSource, const std::string& fragmentSource)
+	{
+		uint64_t result = gDriverHash;
+		result = hash(&VERSION, sizeof(VERSION), result);
+		result = hash(vertexSource.data(), vertexSource.size(), result);
+
+		// Separate stages so moving code between them changes the key
+		const char separator = 0;
+		result = hash(&separator, sizeof(separator), result);
+
+		return hash(fragmentSource.data(), fragmentSource.size(), result);
+	}
+
+	uint64_t hash(const void* data, size_t size, uint64_t seed)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		uint64_t result = seed;
+		for (size_t i = 0; i < size; i++) {
+			result ^= bytes[i];
+			result *= 0x100000001b3ull;
+		}
+		return result;
+	}
+
+	bool load(uint64_t key, uint32_t program)
+	{
+		if (!gEnabled) return false;
+
+		std::ifstream file(_entryPath(key), std::ios::binary);
+		if (!file) return false;
+
+		EntryHeader header;
+		if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+			std::memcmp(header.magic, ENTRY_MAGIC, sizeof(ENTRY_MAGIC)) != 0 ||
+			header.version != VERSION || header.size == 0) return false;
+
+		std::vector<char> binary(header.size);
+		if (!file.read(binary.data(), header.size)) return false;
+
+		glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(header.size));
+		return true;
+	}
+
+	void store(uint64_t key, uint32_t program)
+	{
+		if (!gEnabled) return;
+
+		int32_t size = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size);
+		if (size <= 0) return;
+
+		std::vector<char> binary(size);
+		GLenum format = 0;
+		glGetProgramBinary(program, size, nullptr, &format, binary.data());
+
+		EntryHeader header;
+		std::memcpy(header.magic, ENTRY_MAGIC, sizeof(ENTRY_MAGIC));
+		header.version = VERSION;
+		header.format = format;
+		header.size = static_cast<uint32_t>(size);
+
+		// Write to a temporary file first, an interrupted write never leaves a truncated entry behind
+		FS::Path path = _entryPath(key);
+		FS::Path temporaryPath = path;
+		temporaryPath += ".tmp";
+		{
+			std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+			if (!file) return;
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(binary.data(), size);
+			if (!file) return;
+		}
+
+		std::error_code ec;
+		std::filesystem::rename(temporaryPath, path, ec);
+		if (ec) Console::out::warning("Shader Cache", "Couldn't write cache entry '" + path.string() + "'");
+	}
+
+}
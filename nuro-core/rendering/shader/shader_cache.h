@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#include <utils/fsutil.h>
+
+// Persists linked shader program binaries between runs
+// Entries are keyed by the preprocessed sources and the driver, a driver update or source change never hits a stale binary
+namespace ShaderCache
+{
+	// Version of cache entries, entries of other versions are ignored
+	constexpr uint32_t VERSION = 1;
+
+	// Offset basis of the 64 bit fnv-1a hash used for keys
+	constexpr uint64_t HASH_SEED = 0xcbf29ce484222325ull;
+
+	// Enables the cache within given directory if the driver supports program binaries (context thread)
+	void create(const FS::Path& directory);
+
+	// Disables the cache, written entries are kept
+	void destroy();
+
+	// Returns if program binaries are loaded from and stored to the cache
+	bool enabled();
+
+	// Returns the key of a program built from given preprocessed sources with the current driver
+	uint64_t key(const std::string& vertexSource, const std::string& fragmentSource);
+
+	// Continues given 64 bit fnv-1a hash with given data
+	uint64_t hash(const void* data, size_t size, uint64_t seed = HASH_SEED);
+
+	// Loads the cached binary of given key into a program, returns false if there is none (context thread)
+	// Link status must be checked afterwards, drivers may still reject a binary
+	bool load(uint64_t key, uint32_t program);
+
+	// Stores the binary of a linked program for given key (context thread)
+	void store(uint64_t key, uint32_t program);
+};
@@ -2,10 +2,13 @@
 #include "shader_pool.h"
 
 #include <thread>
+#include <cstdio>
 #include <chrono>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <utils/console.h>
+#include <utils/parallel.h>
 #include <rendering/shader/shader.h>
 #include <context/application_context.h>
 
@@ -14,6 +17,15 @@ namespace ShaderPool {
 	ResourceRef<Shader> gEmpty = std::make_shared<Shader>();
 	std::unordered_map<std::string, ResourceRef<Shader>> gShaders;
 
+	// Source paths of loaded shaders, variants are built from them
+	std::unordered_map<std::string, FS::Path> gSources;
+
+	// Lazily built variants of loaded shaders by identifier and key
+	std::unordered_map<std::string, std::unordered_map<uint64_t, ResourceRef<Shader>>> gVariants;
+
+	// Keys of variants that failed to build, their sources won't change so they aren't rebuilt
+	std::unordered_map<std::string, std::unordered_set<uint64_t>> gFailedVariants;
+
 	void _loadAll(const FS::Path& directory, bool async)
 	{
 		ResourceManager& resource = ApplicationContext::resourceManager();
@@ -29,6 +41,8 @@ namespace ShaderPool {
 			shaderNames.push_back(shaderPath.filename().string());
 		}
 
+		std::vector<ResourceRef<Shader>> created;
+
 		for (int32_t i = 0; i < shaderPaths.size(); i++)
 		{
 			// Get shaders identifier
@@ -41,15 +55,35 @@ namespace ShaderPool {
 			auto [shaderId, shader] = resource.create<Shader>(identifier + "_shader");
 			shader->setSource(shaderPaths[i]);
 
-			// Load shader
-			if (async) {
-				resource.exec(shader->create());
-			}
-			else {
-				resource.execAsDependency(shader->create());
-			}
+			// Load shader asynchronously
+			if (async) resource.exec(shader->create());
+			else created.push_back(shader);
+
 			gShaders[identifier] = shader;
+			gSources[identifier] = shaderPaths[i];
 		}
+
+		if (async || created.empty()) return;
+
+		auto start = std::chrono::steady_clock::now();
+
+		// Read and preprocess all sources in parallel
+		Parallel::forEach(static_cast<uint32_t>(created.size()), [&created](uint32_t i) {
+			created[i]->loadSources();
+			});
+
+		// Issue every program before waiting for any, drivers with parallel shader compilation build them concurrently
+		for (auto& shader : created) shader->issueProgram();
+
+		// Wait for programs in order
+		uint32_t nCached = 0;
+		for (auto& shader : created) {
+			resource.execAsDependency(shader->createIssued());
+			if (shader->cached()) nCached++;
+		}
+
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		Console::out::info("Shader Pool", "Built " + std::to_string(created.size()) + " shaders (" + std::to_string(nCached) + " cached) in " + std::to_string(static_cast<int32_t>(ms)) + "ms");
 	}
 
 	void loadAllSync(const FS::Path& directory)
@@ -82,4 +116,43 @@ namespace ShaderPool {
 		}
 	}
 
+	ResourceRef<Shader> variant(const std::string& identifier, uint64_t key, const std::vector<std::string>& defines)
+	{
+		if (key == 0) return get(identifier);
+
+		// Variant was built already
+		auto& variants = gVariants[identifier];
+		if (auto it = variants.find(key); it != variants.end()) return it->second;
+
+		auto source = gSources.find(identifier);
+		if (source == gSources.end()) {
+			Console::out::warning("Shader Pool", "Variant of shader '" + identifier + "' was requested but the shader does not exist!");
+			return gEmpty;
+		}
+
+		// Variant failed to build before
+		auto& failed = gFailedVariants[identifier];
+		if (failed.count(key)) return nullptr;
+
+		char suffix[24];
+		std::snprintf(suffix, sizeof(suffix), "_%llx", static_cast<unsigned long long>(key));
+
+		// Build variant right away, the resource processor may be running already so it can't be executed as a dependency
+		// Program binary cache makes this cheap after the first run
+		ResourceManager& resource = ApplicationContext::resourceManager();
+		auto [shaderId, shader] = resource.create<Shader>(identifier + suffix + "_shader");
+		shader->setSource(source->second);
+		shader->setDefines(defines);
+
+		if (!shader->loadSources() || !shader->issueProgram() || !shader->finishProgram()) {
+			Console::out::warning("Shader Pool", "Couldn't build variant" + std::string(suffix) + " of shader '" + identifier + "'");
+			resource.release(shaderId);
+			failed.insert(key);
+			return nullptr;
+		}
+
+		variants[key] = shader;
+		return shader;
+	}
+
 }
\ No newline at end of file
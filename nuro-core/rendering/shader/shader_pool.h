@@ -2,6 +2,7 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 
 #include <utils/fsutil.h>
 #include <memory/resource_manager.h>
@@ -21,4 +22,9 @@ namespace ShaderPool
 
 	// Returns a loaded shader by the given identifier
 	ResourceRef<Shader> get(const std::string& identifier);
+
+	// Returns a variant of a loaded shader built with given defines, the variant is identified by the key and compiled on its first request (context thread)
+	// Returns nullptr if the variant can't be built, failed variants are never cached or retried
+	// Key 0 returns the loaded shader itself, which must not be given any defines
+	ResourceRef<Shader> variant(const std::string& identifier, uint64_t key, const std::vector<std::string>& defines);
 };
@@ -0,0 +1,132 @@
+#include "shader_preprocessor.h"
+
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+
+namespace ShaderPreprocessor {
+
+	namespace {
+
+		bool readSource(const FS::Path& path, std::string& source)
+		{
+			std::ifstream file(path, std::ios::in | std::ios::binary);
+			if (!file) return false;
+
+			std::stringstream buffer;
+			buffer << file.rdbuf();
+			source = buffer.str();
+			return true;
+		}
+
+		// Returns the file name of an include directive, empty if the line isn't one
+		std::string includedFile(const std::string& line)
+		{
+			size_t start = line.find_first_not_of(" \t");
+			if (start == std::string::npos || line.compare(start, 8, "#include") != 0) return "";
+
+			size_t open = line.find('"', start + 8);
+			size_t close = open == std::string::npos ? std::string::npos : line.find('"', open + 1);
+			if (close == std::string::npos) return "";
+
+			return line.substr(open + 1, close - open - 1);
+		}
+
+		bool isVersionDirective(const std::string& line)
+		{
+			size_t start = line.find_first_not_of(" \t");
+			return start != std::string::npos && line.compare(start, 8, "#version") == 0;
+		}
+
+		struct Context
+		{
+			const FS::Path& includeDirectory;
+			std::unordered_set<std::string> included;
+			std::string& output;
+			std::string& error;
+		};
+
+		bool expand(Context& context, const std::string& source, const FS::Path& sourceDirectory, uint32_t depth)
+		{
+			std::istringstream lines(source);
+			std::string line;
+			while (std::getline(lines, line)) {
+				if (!line.empty() && line.back() == '\r') line.pop_back();
+
+				std::string file = includedFile(line);
+				if (file.empty()) {
+					context.output += line;
+					context.output += '\n';
+					continue;
+				}
+
+				if (depth >= MAX_INCLUDE_DEPTH) {
+					context.error = "Includes nested deeper than " + std::to_string(MAX_INCLUDE_DEPTH) + " levels at '" + file + "'";
+					return false;
+				}
+
+				// Look up relative to the including file first
+				FS::Path path = (sourceDirectory / file).lexically_normal();
+				std::string included;
+				if (!readSource(path, included)) {
+					path = (context.includeDirectory / file).lexically_normal();
+					if (!readSource(path, included)) {
+						context.error = "Couldn't resolve include '" + file + "'";
+						return false;
+					}
+				}
+
+				// Each file is only included once
+				if (!context.included.insert(path.generic_string()).second) continue;
+
+				if (!expand(context, included, path.parent_path(), depth + 1)) return false;
+			}
+
+			return true;
+		}
+
+	}
+
+	bool process(const FS::Path& path, const FS::Path& includeDirectory, const std::vector<std::string>& defines, std::string& output, std::string& error)
+	{
+		std::string source;
+		if (!readSource(path, source)) {
+			error = "Couldn't read shader source at '" + path.string() + "'";
+			return false;
+		}
+
+		return process(source, path.parent_path(), includeDirectory, defines, output, error);
+	}
+
+	bool process(const std::string& source, const FS::Path& sourceDirectory, const FS::Path& includeDirectory, const std::vector<std::string>& defines, std::string& output, std::string& error)
+	{
+		output.clear();
+		output.reserve(source.size());
+
+		// Defines must follow the version directive, which has to come first
+		std::string version;
+		std::string body = source;
+		size_t lineEnd = source.find('\n');
+		std::string firstLine = source.substr(0, lineEnd);
+		if (isVersionDirective(firstLine)) {
+			version = firstLine;
+			body = lineEnd == std::string::npos ? "" : source.substr(lineEnd + 1);
+		}
+
+		if (!version.empty()) {
+			if (version.back() == '\r') version.pop_back();
+			output += version;
+			output += '\n';
+		}
+
+		for (const std::string& define : defines) {
+			output += "#define ";
+			output += define;
+			output += '\n';
+		}
+
+		Context context{ includeDirectory, {}, output, error };
+		return expand(context, body, sourceDirectory, 0);
+	}
+
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <utils/fsutil.h>
+
+// Resolves includes and injects defines into glsl sources, doesn't touch the graphics api so it can run on any thread
+namespace ShaderPreprocessor
+{
+	// Maximum depth of nested includes
+	constexpr uint32_t MAX_INCLUDE_DEPTH = 16;
+
+	// Reads the source at given path and resolves all #include "file" directives recursively
+	// Includes are looked up relative to the including file first, then within the include directory, each file is included once
+	// Given defines are inserted as #define directives right after the #version directive
+	// Returns false and describes the issue in error if a file couldn't be read
+	bool process(const FS::Path& path, const FS::Path& includeDirectory, const std::vector<std::string>& defines, std::string& output, std::string& error);
+
+	// Same as above for a source that was already read, includes relative to the source are looked up in given source directory
+	bool process(const std::string& source, const FS::Path& sourceDirectory, const FS::Path& includeDirectory, const std::vector<std::string>& defines, std::string& output, std::string& error);
+};
@@ -0,0 +1,267 @@
+#include "cascaded_shadow_map.h"
+
+#include <cmath>
+#include <algorithm>
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <utils/console.h>
+#include <utils/parallel.h>
+#include <transform/transform.h>
+#include <rendering/model/mesh.h>
+#include <rendering/model/model.h>
+#include <rendering/culling/frustum.h>
+#include <diagnostics/diagnostics.h>
+#include <rendering/shader/shader_pool.h>
+#include <rendering/transformation/transformation.h>
+
+CascadedShadowMap::CascadedShadowMap(uint32_t resolution, float distance, float splitLambda) : resolution(resolution),
+distance(distance),
+splitLambda(splitLambda),
+texture(0),
+framebuffer(0),
+cascades(),
+cameraView(glm::mat4(1.0f)),
+casters(),
+batch(),
+shadowPassShader(nullptr)
+{
+}
+
+void CascadedShadowMap::create()
+{
+	// Get shader
+	shadowPassShader = ShaderPool::get("shadow_pass");
+
+	// Generate texture array holding one layer per cascade
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, resolution, resolution, N_CASCADES, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+
+	// Set texture parameters
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+
+	// Set texture border
+	float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+
+	// Generate framebuffer, cascade layers are attached when rendered
+	glGenFramebuffers(1, &framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0, 0);
+	glDrawBuffer(GL_NONE);
+	glReadBuffer(GL_NONE);
+
+	// Check for framebuffer error
+	GLenum fboStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	if (fboStatus != GL_FRAMEBUFFER_COMPLETE)
+	{
+		Console::out::warning("Cascaded Shadow Map", "Issue while generating framebuffer: " + std::to_string(fboStatus));
+	}
+
+	// Unbind framebuffer
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	// Create caster batch
+	batch.create();
+}
+
+void CascadedShadowMap::destroy()
+{
+	// Delete texture
+	glDeleteTextures(1, &texture);
+	texture = 0;
+
+	// Delete framebuffer
+	glDeleteFramebuffers(1, &framebuffer);
+	framebuffer = 0;
+
+	// Destroy caster batch
+	batch.destroy();
+	casters.clear();
+
+	// Reset cascades
+	cascades = {};
+
+	// Reset shader
+	shadowPassShader = nullptr;
+}
+
+void CascadedShadowMap::castShadows(DirectionalLightComponent& directionalLight, TransformComponent& transform, const glm::mat4& _cameraView, float fov, float aspect, float near, float far)
+{
+	// Light shines along the forward axis of its transform
+	glm::vec3 direction = glm::normalize(Transformation::swap(Transform::forward(transform, Space::WORLD)));
+	cameraView = _cameraView;
+
+	//
+	// GATHER CASTERS
+	//
+
+	casters.clear();
+	auto targets = ECS::main().view<TransformComponent, MeshRendererComponent>();
+	for (auto [entity, casterTransform, renderer] : targets.each()) {
+		if (!renderer.enabled || !renderer.mesh) continue;
+		casters.push_back({ renderer.mesh, &casterTransform.model, glm::vec3(0.0f), 0.0f });
+	}
+
+	// Calculate world space bounding spheres of casters in parallel
+	Parallel::forRanges(static_cast<uint32_t>(casters.size()), 256, [&](uint32_t begin, uint32_t end) {
+		for (uint32_t i = begin; i < end; i++) {
+			Caster& caster = casters[i];
+			Frustum::transformSphere(*caster.model, caster.mesh->boundsCenter(), caster.mesh->boundsRadius(), caster.center, caster.radius);
+		}
+		});
+
+	//
+	// SETUP CASCADES
+	// Split view frustum and fit and cull each cascade in parallel
+	//
+
+	float shadowFar = std::min(far, distance);
+	Parallel::forEach(N_CASCADES, [&](uint32_t i) {
+		// Blend logarithmic and uniform split distribution
+		auto split = [&](uint32_t index) {
+			float t = static_cast<float>(index) / N_CASCADES;
+			float logarithmic = near * std::pow(shadowFar / near, t);
+			float uniform = near + (shadowFar - near) * t;
+			return splitLambda * logarithmic + (1.0f - splitLambda) * uniform;
+			};
+		setupCascade(cascades[i], direction, cameraView, fov, aspect, split(i), split(i + 1));
+		});
+
+	//
+	// RENDER CASCADES
+	//
+
+	glViewport(0, 0, resolution, resolution);
+	glEnable(GL_DEPTH_TEST);
+
+	// Set culling to front face
+	glEnable(GL_CULL_FACE);
+	glCullFace(GL_FRONT);
+
+	// Bind shadow pass shader and shared geometry
+	shadowPassShader->bind();
+	Model::geometryArena().bind();
+
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	for (uint32_t i = 0; i < N_CASCADES; i++) {
+		renderCascade(i);
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void CascadedShadowMap::bind(uint32_t unit)
+{
+	glActiveTexture(GL_TEXTURE0 + unit);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+}
+
+uint32_t CascadedShadowMap::getTexture() const
+{
+	return texture;
+}
+
+uint32_t CascadedShadowMap::getResolution() const
+{
+	return resolution;
+}
+
+const glm::mat4& CascadedShadowMap::getLightSpace(uint32_t cascade) const
+{
+	return cascades[cascade].lightSpace;
+}
+
+float CascadedShadowMap::getSplit(uint32_t cascade) const
+{
+	return cascades[cascade].split;
+}
+
+const glm::mat4& CascadedShadowMap::getCameraView() const
+{
+	return cameraView;
+}
+
+void CascadedShadowMap::setupCascade(Cascade& cascade, const glm::vec3& lightDirection, const glm::mat4& view, float fov, float aspect, float sliceNear, float sliceFar)
+{
+	cascade.split = sliceFar;
+
+	// Get world space corners of view frustum slice
+	glm::mat4 inverse = glm::inverse(Transformation::projection(fov, aspect, sliceNear, sliceFar) * view);
+	glm::vec3 corners[8];
+	uint32_t nCorners = 0;
+	for (float x : { -1.0f, 1.0f }) {
+		for (float y : { -1.0f, 1.0f }) {
+			for (float z : { -1.0f, 1.0f }) {
+				glm::vec4 corner = inverse * glm::vec4(x, y, z, 1.0f);
+				corners[nCorners++] = glm::vec3(corner) / corner.w;
+			}
+		}
+	}
+
+	// Enclose slice with a sphere, its size doesn't change with camera rotation which keeps shadows stable
+	glm::vec3 center(0.0f);
+	for (const glm::vec3& corner : corners) center += corner;
+	center /= 8.0f;
+
+	float radius = 0.0f;
+	for (const glm::vec3& corner : corners) radius = std::max(radius, glm::distance(center, corner));
+	radius = std::ceil(radius * 16.0f) / 16.0f;
+
+	// Look at slice from behind, leave room for casters between light and slice
+	float casterDistance = distance;
+	glm::vec3 up = std::abs(lightDirection.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+	glm::mat4 lightView = glm::lookAt(center - lightDirection * (radius + casterDistance), center, up);
+	glm::mat4 lightProjection = glm::ortho(-radius, radius, -radius, radius, 0.0f, radius * 2.0f + casterDistance);
+
+	// Snap projection to texel grid so shadow edges don't shimmer when the camera moves
+	glm::vec4 origin = lightProjection * lightView * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	glm::vec2 texelOrigin = glm::vec2(origin) * (resolution * 0.5f);
+	glm::vec2 offset = (glm::round(texelOrigin) - texelOrigin) * (2.0f / resolution);
+	lightProjection[3][0] += offset.x;
+	lightProjection[3][1] += offset.y;
+
+	cascade.lightSpace = lightProjection * lightView;
+
+	// Cull casters against cascade
+	Frustum frustum(cascade.lightSpace);
+	cascade.casters.clear();
+	for (uint32_t i = 0; i < casters.size(); i++) {
+		if (frustum.intersectsSphere(casters[i].center, casters[i].radius)) cascade.casters.push_back(i);
+	}
+
+	// Sort by mesh so identical meshes are merged into instanced commands
+	std::sort(cascade.casters.begin(), cascade.casters.end(), [&](uint32_t a, uint32_t b) {
+		return casters[a].mesh < casters[b].mesh;
+		});
+}
+
+void CascadedShadowMap::renderCascade(uint32_t index)
+{
+	const Cascade& cascade = cascades[index];
+
+	// Attach and clear cascade layer
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0, index);
+	glClear(GL_DEPTH_BUFFER_BIT);
+
+	uint32_t nCasters = static_cast<uint32_t>(cascade.casters.size());
+	Diagnostics::addCurrentShadowCasters(nCasters);
+	Diagnostics::addCurrentShadowCastersCulled(static_cast<uint32_t>(casters.size()) - nCasters);
+	if (cascade.casters.empty()) return;
+
+	// Collect casters, mvp matrix holds the light space model matrix
+	batch.clear();
+	for (uint32_t i : cascade.casters) {
+		const Caster& caster = casters[i];
+		batch.add(nullptr, *caster.mesh, *caster.model, cascade.lightSpace * *caster.model, *caster.model);
+	}
+	batch.upload();
+
+	// Submit casters
+	for (const IndirectBatch::Group& group : batch.getGroups()) {
+		batch.draw(group);
+	}
+}
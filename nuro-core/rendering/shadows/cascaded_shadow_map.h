@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include <ecs/ecs_collection.h>
+#include <rendering/shader/shader.h>
+#include <memory/resource_manager.h>
+#include <rendering/batching/indirect_batch.h>
+
+class Mesh;
+
+// Shadow map of a directional light split into cascades along the view frustum of a camera
+class CascadedShadowMap
+{
+public:
+	// Amount of cascades (see MAX_CASCADES in lit shader)
+	static constexpr uint32_t N_CASCADES = 4;
+
+	explicit CascadedShadowMap(uint32_t resolution, float distance, float splitLambda);
+
+	// Create the cascaded shadow map
+	void create();
+
+	// Destroy the cascaded shadow map
+	void destroy();
+
+	// Renders all cascades for a directional light source, fitted to the view frustum of the given camera
+	void castShadows(DirectionalLightComponent& directionalLight, TransformComponent& transform, const glm::mat4& cameraView, float fov, float aspect, float near, float far);
+
+	// Bind the cascade texture array to a given unit
+	void bind(uint32_t unit);
+
+	// Returns the cascade texture array
+	uint32_t getTexture() const;
+
+	// Returns the resolution of each cascade
+	uint32_t getResolution() const;
+
+	// Returns the light space matrix of a cascade
+	const glm::mat4& getLightSpace(uint32_t cascade) const;
+
+	// Returns the view space distance a cascade ends at
+	float getSplit(uint32_t cascade) const;
+
+	// Returns the view matrix of the camera the cascades were last fitted to
+	const glm::mat4& getCameraView() const;
+
+private:
+	// Caster with its world space bounding sphere
+	struct Caster
+	{
+		const Mesh* mesh;
+		const glm::mat4* model;
+		glm::vec3 center;
+		float radius;
+	};
+
+	// Single cascade
+	struct Cascade
+	{
+		// Light space matrix of cascade
+		glm::mat4 lightSpace = glm::mat4(1.0f);
+
+		// View space distance cascade ends at
+		float split = 0.0f;
+
+		// Indices of casters within the cascade, sorted by mesh
+		std::vector<uint32_t> casters;
+	};
+
+	// Fits a cascade to the view frustum slice between the given distances and culls its casters
+	void setupCascade(Cascade& cascade, const glm::vec3& lightDirection, const glm::mat4& view, float fov, float aspect, float sliceNear, float sliceFar);
+
+	// Renders the casters of a cascade into its texture layer
+	void renderCascade(uint32_t index);
+
+	// Resolution of each cascade
+	uint32_t resolution;
+
+	// Maximum view distance shadows are cast within
+	float distance;
+
+	// Blend between uniform (0) and logarithmic (1) split distribution
+	float splitLambda;
+
+	// Backend texture array id
+	uint32_t texture;
+
+	// Backend framebuffer id
+	uint32_t framebuffer;
+
+	// Cascades
+	std::array<Cascade, N_CASCADES> cascades;
+
+	// View matrix of the camera the cascades were last fitted to
+	glm::mat4 cameraView;
+
+	// Casters gathered for current render
+	std::vector<Caster> casters;
+
+	// Batch submitting casters
+	IndirectBatch batch;
+
+	// Shadow pass shader
+	ResourceRef<Shader> shadowPassShader;
+};
@@ -2,12 +2,17 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <cmath>
 #include <vector>
+#include <algorithm>
 #include <stb_image_write.h>
 
 #include <utils/console.h>
 #include <transform/transform.h>
 #include <rendering/model/mesh.h>
+#include <rendering/model/model.h>
+#include <rendering/culling/frustum.h>
+#include <diagnostics/diagnostics.h>
 #include <rendering/shader/shader_pool.h>
 #include <rendering/transformation/transformation.h>
 
@@ -15,6 +20,15 @@ ShadowMap::ShadowMap(uint32_t resolutionWidth, uint32_t resolutionHeight) : reso
 resolutionHeight(resolutionHeight),
 texture(0),
 framebuffer(0),
+staticTexture(0),
+staticFramebuffer(0),
+staticCacheValid(false),
+dynamicCastersDrawn(false),
+nRenders(0),
+casterStates(),
+staticCasters(),
+dynamicCasters(),
+batch(),
 lightSpace(glm::mat4(1.0f)),
 shadowPassShader(nullptr)
 {
@@ -25,50 +39,35 @@ void ShadowMap::create()
 	// Get shader
 	shadowPassShader = ShaderPool::get("shadow_pass");
 
-	// Generate framebuffer
-	glGenFramebuffers(1, &framebuffer);
-
-	// Generate texture
-	glGenTextures(1, &texture);
-	glBindTexture(GL_TEXTURE_2D, texture);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, resolutionWidth, resolutionHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-
-	// Set texture parameters
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-
-	// Set texture border
-	float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-	glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-
-	// Set framebuffer attachments
-	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture, 0);
-	glDrawBuffer(GL_NONE);
-	glReadBuffer(GL_NONE);
+	// Create shadow map and static caster cache
+	texture = createDepthTexture();
+	framebuffer = createDepthFramebuffer(texture);
+	staticTexture = createDepthTexture();
+	staticFramebuffer = createDepthFramebuffer(staticTexture);
 
-	// Unbind framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-	// Check for forward pass framebuffer error
-	GLenum fboStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-	if (fboStatus != GL_FRAMEBUFFER_COMPLETE)
-	{
-		Console::out::warning("Shadow Map", "Issue while generating framebuffer: " + std::to_string(fboStatus));
-	}
+	// Create caster batch
+	batch.create();
 }
 
 void ShadowMap::destroy()
 {
-	// Delete texture
+	// Delete textures
 	glDeleteTextures(1, &texture);
 	texture = 0;
+	glDeleteTextures(1, &staticTexture);
+	staticTexture = 0;
 
-	// Delete framebuffer
+	// Delete framebuffers
 	glDeleteFramebuffers(1, &framebuffer);
 	framebuffer = 0;
+	glDeleteFramebuffers(1, &staticFramebuffer);
+	staticFramebuffer = 0;
+
+	// Destroy caster batch
+	batch.destroy();
+
+	// Reset caster cache
+	invalidate();
 
 	// Reset light space matrix
 	lightSpace = glm::mat4(1.0f);
@@ -77,20 +76,10 @@ void ShadowMap::destroy()
 	shadowPassShader = nullptr;
 }
 
-void ShadowMap::castShadows(DirectionalLightComponent& directionalLight, TransformComponent& transform, float boundsWidth, float boundsHeight, float near, float far)
-{
-	glm::vec3 position = glm::vec3(80.0f, 80.0f, -80.0f); // tmp
-	glm::vec3 direction = glm::vec3(-0.7f, -0.8f, 1.0f); // tmp
-
-	glm::mat4 view = getView(position, direction);
-	glm::mat4 projection = getProjectionOrthographic(boundsWidth, boundsHeight, near, far);
-
-	renderSingular(view, projection);
-}
-
 void ShadowMap::castShadows(SpotlightComponent& spotlight, TransformComponent& transform)
 {
-	glm::vec3 direction = glm::vec3(0.0f, 0.0f, 1.0f); // tmp
+	// Match the direction the light cache shades the spotlight with
+	glm::vec3 direction = Transform::forward(transform, Space::WORLD);
 
 	glm::mat4 view = getView(Transform::getPosition(transform, Space::WORLD), direction);
 	glm::mat4 projection = getProjectionPerspective(spotlight.outerAngle, 1.0f, 0.3f, spotlight.range);
@@ -155,58 +144,215 @@ bool ShadowMap::saveAsImage(int32_t width, int32_t height, const std::string& fi
 	}
 }
 
+void ShadowMap::invalidate()
+{
+	casterStates.clear();
+	staticCacheValid = false;
+	dynamicCastersDrawn = false;
+}
+
 void ShadowMap::renderSingular(glm::mat4 view, glm::mat4 projection)
 {
-	// Calculate light space
-	lightSpace = projection * view;
+	nRenders++;
 
-	// Set viewport and bind shadow map framebuffer
-	glViewport(0, 0, resolutionWidth, resolutionHeight);
-	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
-	glClear(GL_DEPTH_BUFFER_BIT);
+	// Calculate light space, static caster cache has to be rebuilt if it changed
+	glm::mat4 newLightSpace = projection * view;
+	bool rebuildStatic = !staticCacheValid || newLightSpace != lightSpace;
+	lightSpace = newLightSpace;
+
+	Frustum frustum(lightSpace);
+	staticCasters.clear();
+	dynamicCasters.clear();
+
+	//
+	// CLASSIFY CASTERS
+	// Casters which didn't change for a while are static, everything else is dynamic
+	//
+
+	auto targets = ECS::main().view<TransformComponent, MeshRendererComponent>();
+	for (auto [entity, transform, renderer] : targets.each()) {
+		if (!renderer.enabled || !renderer.mesh) continue;
+
+		// Update casters state
+		auto [it, inserted] = casterStates.try_emplace(entity);
+		CasterState& state = it->second;
+		if (inserted || state.model != transform.model || state.mesh != renderer.mesh) {
+			// Caster changed, its stale depth has to leave the static caster cache
+			if (state.baked) rebuildStatic = true;
+			state.model = transform.model;
+			state.mesh = renderer.mesh;
+			state.stillFrames = 0;
+			state.baked = false;
+		}
+		else if (state.stillFrames < STATIC_CASTER_FRAMES) {
+			state.stillFrames++;
+		}
+		state.lastSeen = nRenders;
+
+		// Caster just became static, bake it into static caster cache
+		bool isStatic = state.stillFrames >= STATIC_CASTER_FRAMES;
+		if (isStatic && !state.baked) rebuildStatic = true;
+
+		// Cull casters outside of the lights frustum
+		glm::vec3 center;
+		float radius;
+		Frustum::transformSphere(transform.model, renderer.mesh->boundsCenter(), renderer.mesh->boundsRadius(), center, radius);
+		if (!frustum.intersectsSphere(center, radius)) {
+			Diagnostics::addCurrentShadowCastersCulled(1);
+			continue;
+		}
+
+		if (isStatic) staticCasters.push_back({ renderer.mesh, &transform.model });
+		else dynamicCasters.push_back({ renderer.mesh, &transform.model });
+	}
+
+	// Drop casters which don't exist anymore
+	for (auto it = casterStates.begin(); it != casterStates.end();) {
+		if (it->second.lastSeen == nRenders) {
+			++it;
+			continue;
+		}
+		if (it->second.baked) rebuildStatic = true;
+		it = casterStates.erase(it);
+	}
+
+	//
+	// SKIP UNCHANGED
+	// Shadow map is still valid if the static caster cache is and there are no dynamic casters to add or remove
+	//
+
+	if (!rebuildStatic && dynamicCasters.empty() && !dynamicCastersDrawn) {
+		Diagnostics::addShadowRender(true);
+		return;
+	}
+	Diagnostics::addShadowRender(false);
 
-	// Bind shadow pass shader and render each objects depth on shadow map
+	// Set viewport and render state
+	glViewport(0, 0, resolutionWidth, resolutionHeight);
 	glEnable(GL_DEPTH_TEST);
 
 	// Set culling to front face
 	glEnable(GL_CULL_FACE);
 	glCullFace(GL_FRONT);
 
+	// Bind shadow pass shader and shared geometry
 	shadowPassShader->bind();
+	Model::geometryArena().bind();
+
+	//
+	// STATIC CASTER CACHE
+	// Rebuild static caster cache if needed
+	//
+
+	if (rebuildStatic) {
+		glBindFramebuffer(GL_FRAMEBUFFER, staticFramebuffer);
+		glClear(GL_DEPTH_BUFFER_BIT);
+		drawCasters(staticCasters);
+
+		// All static casters are part of the cache now
+		for (auto& [entity, state] : casterStates) {
+			state.baked = state.stillFrames >= STATIC_CASTER_FRAMES;
+		}
+		staticCacheValid = true;
+	}
 
-	auto targets = ECS::main().view<TransformComponent, MeshRendererComponent>();
-	for (auto [entity, transform, renderer] : targets.each()) {
-		if (!renderer.mesh) return; 
+	//
+	// DYNAMIC CASTERS
+	// Restore static caster cache and draw dynamic casters on top
+	//
 
-		// Set shadow pass shader uniforms
-		shadowPassShader->setMatrix4("modelMatrix", transform.model);
-		shadowPassShader->setMatrix4("lightSpaceMatrix", lightSpace);
+	glCopyImageSubData(staticTexture, GL_TEXTURE_2D, 0, 0, 0, 0, texture, GL_TEXTURE_2D, 0, 0, 0, 0, resolutionWidth, resolutionHeight, 1);
 
-		// Bind mesh
-		glBindVertexArray(renderer.mesh->vao());
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	drawCasters(dynamicCasters);
+	dynamicCastersDrawn = !dynamicCasters.empty();
 
-		// Render mesh
-		glDrawElements(GL_TRIANGLES, renderer.mesh->indiceCount(), GL_UNSIGNED_INT, 0);
+	// Unbind shadow map framebuffer
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void ShadowMap::drawCasters(std::vector<Caster>& casters)
+{
+	if (casters.empty()) return;
+
+	// Sort casters by mesh so identical meshes are merged into instanced commands
+	std::sort(casters.begin(), casters.end(), [](const Caster& a, const Caster& b) {
+		return a.mesh < b.mesh;
+		});
+
+	// Collect casters, mvp matrix holds the light space model matrix
+	batch.clear();
+	for (const Caster& caster : casters) {
+		batch.add(nullptr, *caster.mesh, *caster.model, lightSpace * *caster.model, *caster.model);
 	}
+	batch.upload();
 
-	// Unbind shadow map framebuffer
+	// Submit casters
+	for (const IndirectBatch::Group& group : batch.getGroups()) {
+		batch.draw(group);
+	}
+
+	Diagnostics::addCurrentShadowCasters(static_cast<uint32_t>(casters.size()));
+}
+
+uint32_t ShadowMap::createDepthTexture() const
+{
+	// Generate texture
+	uint32_t depthTexture = 0;
+	glGenTextures(1, &depthTexture);
+	glBindTexture(GL_TEXTURE_2D, depthTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, resolutionWidth, resolutionHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+
+	// Set texture parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+
+	// Set texture border
+	float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+
+	return depthTexture;
+}
+
+uint32_t ShadowMap::createDepthFramebuffer(uint32_t depthTexture) const
+{
+	// Generate framebuffer
+	uint32_t depthFramebuffer = 0;
+	glGenFramebuffers(1, &depthFramebuffer);
+
+	// Set framebuffer attachments
+	glBindFramebuffer(GL_FRAMEBUFFER, depthFramebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+	glDrawBuffer(GL_NONE);
+	glReadBuffer(GL_NONE);
+
+	// Check for framebuffer error
+	GLenum fboStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	if (fboStatus != GL_FRAMEBUFFER_COMPLETE)
+	{
+		Console::out::warning("Shadow Map", "Issue while generating framebuffer: " + std::to_string(fboStatus));
+	}
+
+	// Unbind framebuffer
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	return depthFramebuffer;
 }
 
 glm::mat4 ShadowMap::getView(const glm::vec3& lightPosition, const glm::vec3& lightDirection) const
 {
 	// Calculate light view matrix parameters
 	glm::vec3 position = Transformation::swap(lightPosition);
-	glm::vec3 target = position + glm::normalize(Transformation::swap(lightDirection));
+	glm::vec3 direction = glm::normalize(Transformation::swap(lightDirection));
+	glm::vec3 target = position + direction;
 
-	// Create and return light view matrix
-	return glm::lookAt(position, target, glm::vec3(0.0f, 1.0f, 0.0f));
-}
+	// Up vector must not be parallel to a light pointing straight up or down
+	glm::vec3 up = std::abs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
 
-glm::mat4 ShadowMap::getProjectionOrthographic(float boundsWidth, float boundsHeight, float near, float far) const
-{
-	// Create and return light projection matrix using orthographic projection
-	return glm::ortho(-boundsWidth * 0.5f, boundsWidth * 0.5f, -boundsHeight * 0.5f, boundsHeight * 0.5f, near, far);
+	// Create and return light view matrix
+	return glm::lookAt(position, target, up);
 }
 
 glm::mat4 ShadowMap::getProjectionPerspective(float fov, float aspect, float near, float far) const
@@ -2,15 +2,22 @@
 
 #include <cstdint>
 #include <vector>
+#include <unordered_map>
 #include <glm/glm.hpp>
 
 #include <ecs/ecs_collection.h>
 #include <rendering/shader/shader.h>
 #include <memory/resource_manager.h>
+#include <rendering/batching/indirect_batch.h>
+
+class Mesh;
 
 class ShadowMap
 {
 public:
+	// Amount of frames a caster has to stay unchanged until it's baked into the static caster cache
+	static constexpr uint32_t STATIC_CASTER_FRAMES = 30;
+
 	explicit ShadowMap(uint32_t resolutionWidth, uint32_t resolutionHeight);
 
 	// Create the shadow map
@@ -19,9 +26,6 @@ public:
 	// Destroy the shadow map
 	void destroy();
 
-	// Renders the shadow map for a directional light source
-	void castShadows(DirectionalLightComponent& directionalLight, TransformComponent& transform, float boundsWidth, float boundsHeight, float near, float far);
-
 	// Renders the shadow map for a spotlight source
 	void castShadows(SpotlightComponent& spotlight, TransformComponent& transform);
 
@@ -46,16 +50,49 @@ public:
 	// Saves the latest render of the shadow map as an image
 	bool saveAsImage(int32_t width, int32_t height, const std::string& filename);
 
+	// Discards the static caster cache, forcing a full render next time shadows are cast
+	void invalidate();
+
 private:
-	// Render onto singular texture
+	// Tracked state of a shadow caster
+	struct CasterState
+	{
+		// Model matrix and mesh the caster was last seen with
+		glm::mat4 model = glm::mat4(1.0f);
+		const Mesh* mesh = nullptr;
+
+		// Amount of consecutive frames the caster didn't change
+		uint32_t stillFrames = 0;
+
+		// Render the caster was last seen in
+		uint64_t lastSeen = 0;
+
+		// Set if the caster is part of the static caster cache
+		bool baked = false;
+	};
+
+	// Caster to be drawn
+	struct Caster
+	{
+		const Mesh* mesh;
+		const glm::mat4* model;
+	};
+
+	// Render onto singular texture, skips rendering if neither the light nor any caster changed
 	void renderSingular(glm::mat4 view, glm::mat4 projection);
 
+	// Draws the given casters into the currently bound framebuffer
+	void drawCasters(std::vector<Caster>& casters);
+
+	// Creates a depth texture with shadow map parameters
+	uint32_t createDepthTexture() const;
+
+	// Creates a framebuffer with the given depth texture attached
+	uint32_t createDepthFramebuffer(uint32_t depthTexture) const;
+
 	// Returns a view matrix for a light
 	glm::mat4 getView(const glm::vec3& lightPosition, const glm::vec3& lightDirection) const;
 
-	// Returns an orthograpghic projection matrix for a light
-	glm::mat4 getProjectionOrthographic(float boundsWidth, float boundsHeight, float near, float far) const;
-
 	// Returns a perspective projection matrix for a light
 	glm::mat4 getProjectionPerspective(float fov, float aspect, float near, float far) const;
 
@@ -71,6 +108,29 @@ private:
 	// Shadow map backend framebuffer id
 	uint32_t framebuffer;
 
+	// Depth texture and framebuffer holding static casters only
+	uint32_t staticTexture;
+	uint32_t staticFramebuffer;
+
+	// Set if the static caster cache matches the current light space matrix
+	bool staticCacheValid;
+
+	// Set if dynamic casters were drawn on top of the static caster cache during the last render
+	bool dynamicCastersDrawn;
+
+	// Amount of renders issued
+	uint64_t nRenders;
+
+	// Tracked state of each shadow caster
+	std::unordered_map<Entity, CasterState> casterStates;
+
+	// Casters visible to the light during current render
+	std::vector<Caster> staticCasters;
+	std::vector<Caster> dynamicCasters;
+
+	// Batch submitting casters
+	IndirectBatch batch;
+
 	// Cache for latest light space matrix
 	glm::mat4 lightSpace;
 
@@ -1,19 +1,23 @@
 #include "cubemap.h"
 
-#include <stb_image.h>
+#include <cstring>
 #include <glad/glad.h>
 
 #include <utils/console.h>
+#include <diagnostics/diagnostics.h>
 
 Cubemap::Cubemap() : source(),
-data(),
-_backendId(0)
+image(),
+_backendId(0),
+stagingBuffer(0),
+staging(nullptr)
 {
 }
 
 Cubemap::~Cubemap()
 {
 	freeIoData();
+	deleteStaging();
 	deleteBuffers();
 }
 
@@ -47,104 +51,19 @@ void Cubemap::setSource_Individual(const FS::Path& rightPath, const FS::Path& le
 	source.paths = { rightPath, leftPath, topPath, bottomPath, frontPath, backPath };
 }
 
-uint32_t Cubemap::backendId() const
-{
-	return _backendId;
-}
-
-Cubemap::ImageData Cubemap::loadImageData(const FS::Path& sourcePath)
-{
-	stbi_set_flip_vertically_on_load(false);
-
-	int32_t width, height, channels;
-	std::string pathStr = sourcePath.string();
-	unsigned char* data = stbi_load(pathStr.c_str(), &width, &height, &channels, 0);
-	if (!data)
-	{
-		Console::out::warning("Cubemap", "Failed to load cubemap at " + sourcePath.string());
-		return ImageData();
-	}
-
-	return ImageData(data, width, height, channels);
-}
-
-void Cubemap::loadCrossCubemap(const FS::Path& sourcePath)
+void Cubemap::setSource_Cooked(const FS::Path& sourcePath)
 {
-	//
-	// WORK ON MEMORY EFFICIENCY HERE!
-	//
-	
-	// Load temporary image data
-	ImageData image = loadImageData(sourcePath);
-
-	// Calculate dimensions of each face (assuming default 4x3 layout)
-	int32_t faceWidth = image.width / 4;
-	int32_t faceHeight = image.height / 3;
-
-	// Resize data vector to hold 6 faces
-	data.resize(6);
-
-	// Define offsets for each face
-	std::vector<std::pair<int32_t, int32_t>> offsets = {
-		{2 * faceWidth, 1 * faceHeight}, // Positive X (Right)
-		{0 * faceWidth, 1 * faceHeight}, // Negative X (Left)
-		{1 * faceWidth, 0 * faceHeight}, // Positive Y (Top)
-		{1 * faceWidth, 2 * faceHeight}, // Negative Y (Bottom)
-		{1 * faceWidth, 1 * faceHeight}, // Positive Z (Front)
-		{3 * faceWidth, 1 * faceHeight}  // Negative Z (Back)
-	};
-
-	// Extract pixel data for each face
-	for (size_t i = 0; i < offsets.size(); ++i)
-	{
-		int32_t xOffset = offsets[i].first;
-		int32_t yOffset = offsets[i].second;
-
-		// Allocate memory for face data
-		data[i].data.resize(faceWidth * faceHeight * image.channels);
-		data[i].width = faceWidth;
-		data[i].height = faceHeight;
-		data[i].channels = image.channels;
-
-		// Copy pixel data for each face
-		for (int32_t y = 0; y < faceHeight; ++y)
-		{
-			for (int32_t x = 0; x < faceWidth; ++x)
-			{
-				int32_t srcIndex = ((yOffset + y) * image.width + (xOffset + x)) * image.channels;
-				int32_t dstIndex = (y * faceWidth + x) * image.channels;
-				memcpy(&data[i].data[dstIndex], &image.data[srcIndex], image.channels);
-			}
-		}
-	}
+	// Validate source path
+	if (!FS::exists(sourcePath))
+		Console::out::warning("Cubemap", "Cooked cubemap at '" + sourcePath.string() + "' could not be found");
 
-	// Free temporary image data
-	stbi_image_free(image.data);
+	source.type = Source::Type::COOKED;
+	source.paths = { sourcePath };
 }
 
-void Cubemap::loadIndividualFace(const FS::Path& sourcePath)
+uint32_t Cubemap::backendId() const
 {
-	//
-	// WORK ON MEMORY EFFICIENCY HERE!
-	// Can be optimized using move semantics etc
-	//
-
-	// Load temporary image data
-	ImageData image = loadImageData(sourcePath);
-
-	// Initialize face data
-	std::vector<unsigned char> faceData(image.data, image.data + (image.width * image.height * image.channels));
-
-	// Create face
-	FaceData face;
-	face.data = faceData;
-	face.width = image.width;
-	face.height = image.height;
-	face.channels = image.channels;
-	data.push_back(face);
-
-	// Free temporary image data
-	stbi_image_free(image.data);
+	return _backendId;
 }
 
 bool Cubemap::loadIoData()
@@ -152,57 +71,104 @@ bool Cubemap::loadIoData()
 	switch (source.type) {
 	case Source::Type::CROSS:
 		if (source.paths.empty()) return false;
-		loadCrossCubemap(source.paths[0]);
-		break;
+		return image.loadCross(source.paths[0]);
 	case Source::Type::INDIVIDUAL:
-		if (source.paths.size() < 6) return false;
-		loadIndividualFace(source.paths[0]);
-		loadIndividualFace(source.paths[1]);
-		loadIndividualFace(source.paths[2]);
-		loadIndividualFace(source.paths[3]);
-		loadIndividualFace(source.paths[4]);
-		loadIndividualFace(source.paths[5]);
-		break;
+		if (source.paths.size() < CubemapImage::N_FACES) return false;
+		return image.loadFaces({ source.paths[0], source.paths[1], source.paths[2], source.paths[3], source.paths[4], source.paths[5] });
+	case Source::Type::COOKED:
+		if (source.paths.empty()) return false;
+		return image.loadCooked(source.paths[0]);
 	default:
-		break;
+		return false;
 	}
-
-	return true;
 }
 
 void Cubemap::freeIoData()
 {
-	data.clear();
+	image.clear();
 }
 
-bool Cubemap::uploadBuffers()
+bool Cubemap::mapStaging()
 {
-	// Don't dispatch cubemap if there is no data
-	if (data.empty()) return false;
+	// Don't stage cubemap if there is no data
+	if (image.empty()) return false;
+
+	// Only creating and mapping the staging buffer needs the context thread, the loader thread fills it
+	glCreateBuffers(1, &stagingBuffer);
+	glNamedBufferStorage(stagingBuffer, image.pixelBytes(), nullptr, GL_MAP_WRITE_BIT);
+	staging = static_cast<uint8_t*>(glMapNamedBufferRange(stagingBuffer, 0, image.pixelBytes(), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+	if (!staging) {
+		Console::out::warning("Cubemap", "Couldn't map staging buffer of cubemap");
+		deleteStaging();
+		return false;
+	}
 
-	glGenTextures(1, &_backendId);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, _backendId);
+	return true;
+}
 
-	for (int32_t i = 0; i < data.size(); i++)
-	{
-		FaceData face = data[i];
+bool Cubemap::fillStaging()
+{
+	if (!staging || image.empty()) return false;
 
-		GLenum format = GL_RGB;
-		if (face.channels == 4)
-		{
-			format = GL_RGBA;
-		}
+	// Regions keep their offsets, the whole pixel block is copied at once
+	std::memcpy(staging, image.pixels(), image.pixelBytes());
+	return true;
+}
 
-		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_SRGB, face.width, face.height, 0, format, GL_UNSIGNED_BYTE, face.data.data());
+bool Cubemap::uploadBuffers()
+{
+	// Don't dispatch cubemap if there is no staged data
+	if (image.empty() || !stagingBuffer) return false;
+
+	// Staged pixels are handed to the gpu once the buffer is unmapped
+	if (!glUnmapNamedBuffer(stagingBuffer)) {
+		Console::out::warning("Cubemap", "Staged cubemap pixels got corrupted");
+		deleteStaging();
+		return false;
 	}
+	staging = nullptr;
+	Diagnostics::addUploadedBytes(image.pixelBytes());
+
+	// Get backend formats, hdr pixels are kept as half floats
+	bool rgba = image.channels() == 4;
+	GLenum format = rgba ? GL_RGBA : GL_RGB;
+	GLenum type = image.hdr() ? GL_FLOAT : GL_UNSIGNED_BYTE;
+	GLenum internalFormat = image.hdr() ? (rgba ? GL_RGBA16F : GL_RGB16F) : (rgba ? GL_SRGB8_ALPHA8 : GL_SRGB8);
+
+	// Sources without a mip chain get one generated
+	uint32_t size = image.faceSize();
+	uint32_t nMips = image.nMips() > 1 ? image.nMips() : CubemapImage::fullMipCount(size);
+
+	glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &_backendId);
+	glTextureStorage2D(_backendId, nMips, internalFormat, size, size);
+
+	// Gpu copies faces out of the staging buffer, faces may be strided views into a larger image so the unpack row length skips the rest of each row
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	for (uint32_t mip = 0; mip < image.nMips(); mip++) {
+		for (uint32_t face = 0; face < CubemapImage::N_FACES; face++) {
+			const CubemapImage::Region& region = image.region(mip, face);
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, region.rowLength);
+			glTextureSubImage3D(_backendId, mip, 0, 0, face, region.size, region.size, 1, format, type, reinterpret_cast<const void*>(region.offset));
+		}
+	}
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	// Deletion is deferred by the driver until pending copies finished
+	deleteStaging();
 
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+	if (image.nMips() < nMips) glGenerateTextureMipmap(_backendId);
 
-	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+	glTextureParameteri(_backendId, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTextureParameteri(_backendId, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTextureParameteri(_backendId, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTextureParameteri(_backendId, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTextureParameteri(_backendId, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+	// Pixels live on the gpu now
+	freeIoData();
 
 	return true;
 }
@@ -211,4 +177,12 @@ void Cubemap::deleteBuffers()
 {
 	if (_backendId) glDeleteTextures(1, &_backendId);
 	_backendId = 0;
+}
+
+void Cubemap::deleteStaging()
+{
+	if (staging) glUnmapNamedBuffer(stagingBuffer);
+	if (stagingBuffer) glDeleteBuffers(1, &stagingBuffer);
+	stagingBuffer = 0;
+	staging = nullptr;
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 #include <utils/fsutil.h>
 #include <memory/resource.h>
+#include <rendering/skybox/cubemap_image.h>
 
 class Cubemap : public Resource
 {
@@ -17,6 +18,8 @@ public:
 	ResourcePipe create() {
 		return std::move(pipe()
 			>> BIND_TASK(Cubemap, loadIoData)
+			>> BIND_TASK_WITH_FLAGS(Cubemap, mapStaging, TaskFlags::UseContextThread)
+			>> BIND_TASK(Cubemap, fillStaging)
 			>> BIND_TASK_WITH_FLAGS(Cubemap, uploadBuffers, TaskFlags::UseContextThread));
 	}
 
@@ -26,6 +29,9 @@ public:
 	// Sets cubemaps source to be multiple individual faces
 	void setSource_Individual(const FS::Path& rightPath, const FS::Path& leftPath, const FS::Path& topPath, const FS::Path& bottomPath, const FS::Path& frontPath, const FS::Path& backPath);
 
+	// Sets cubemaps source to be a cooked cubemap file, its mip levels are uploaded as they are
+	void setSource_Cooked(const FS::Path& sourcePath);
+
 	// Returns the backend id of the cubemap texture
 	uint32_t backendId() const;
 
@@ -33,7 +39,8 @@ private:
 	struct Source {
 		enum class Type {
 			CROSS,
-			INDIVIDUAL
+			INDIVIDUAL,
+			COOKED
 		};
 
 		// Type of the cubemap source
@@ -43,57 +50,27 @@ private:
 		std::vector<FS::Path> paths;
 	};
 
-	struct FaceData
-	{
-		std::vector<unsigned char> data;
-		int32_t width = 0;
-		int32_t height = 0;
-		int32_t channels = 0;
-	};
-
-	struct ImageData
-	{
-		unsigned char* data;
-		int32_t width;
-		int32_t height;
-		int32_t channels;
-
-		ImageData() :
-			data(nullptr),
-			width(0),
-			height(0),
-			channels(0)
-		{};
-
-		ImageData(unsigned char* data, uint32_t width, uint32_t height, uint32_t channels) :
-			data(data),
-			width(width),
-			height(height),
-			channels(channels)
-		{};
-	};
-
 private:
-	// Loads a cubemap by multiple faces in one file
-	void loadCrossCubemap(const FS::Path& sourcePath);
-
-	// Loads an individual face for a cubemap
-	void loadIndividualFace(const FS::Path& sourcePath);
-
 	bool loadIoData();
 	void freeIoData();
+	bool mapStaging();
+	bool fillStaging();
 	bool uploadBuffers();
 	void deleteBuffers();
+	void deleteStaging();
 
 	// Cubemap source
 	Source source;
 
-	// Cubemap data
-	std::vector<FaceData> data;
+	// Cubemap pixels, freed once uploaded
+	CubemapImage image;
 
 	// Backend id of cubemap texture
 	uint32_t _backendId;
 
-	// Loads given images data
-	ImageData loadImageData(const FS::Path& sourcePath);
+	// Pixel buffer the pixel block is staged in until it's copied into the texture
+	uint32_t stagingBuffer;
+
+	// Mapping of the staging buffer, written by the loader thread
+	uint8_t* staging;
 };
\ No newline at end of file
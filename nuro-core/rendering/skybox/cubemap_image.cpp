@@ -0,0 +1,384 @@
+#include "cubemap_image.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <type_traits>
+#include <stb_image.h>
+
+#include <utils/console.h>
+
+namespace {
+
+	// Magic at the start of cooked cubemap files
+	constexpr char COOKED_MAGIC[4] = { 'N', 'C', 'U', 'B' };
+
+	// Header of cooked cubemap files, followed by tightly packed faces ordered by mip level, then face
+	struct CookedHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t hdr;
+		uint32_t channels;
+		uint32_t faceSize;
+		uint32_t nMips;
+	};
+
+	// Decoded image owned by stb_image
+	struct DecodedImage
+	{
+		void* pixels = nullptr;
+		int32_t width = 0;
+		int32_t height = 0;
+		int32_t channels = 0;
+		bool hdr = false;
+	};
+
+	DecodedImage decode(const std::filesystem::path& path)
+	{
+		DecodedImage image;
+		std::string pathStr = path.string();
+		image.hdr = stbi_is_hdr(pathStr.c_str());
+		if (image.hdr) image.pixels = stbi_loadf(pathStr.c_str(), &image.width, &image.height, &image.channels, 0);
+		else image.pixels = stbi_load(pathStr.c_str(), &image.width, &image.height, &image.channels, 0);
+		return image;
+	}
+
+	void freePixels(void* pixels)
+	{
+		std::free(pixels);
+	}
+
+	void freeDecoded(void* pixels)
+	{
+		stbi_image_free(pixels);
+	}
+
+	void noDeleter(void*)
+	{
+	}
+
+	// Box filters a face region into the next smaller mip level, channels are averaged in their stored space
+	template <typename T>
+	void downsample(const uint8_t* source, const CubemapImage::Region& from, uint8_t* target, const CubemapImage::Region& to, uint32_t channels)
+	{
+		const T* src = reinterpret_cast<const T*>(source + from.offset);
+		T* dst = reinterpret_cast<T*>(target + to.offset);
+
+		for (uint32_t y = 0; y < to.size; y++) {
+			uint32_t y0 = std::min(y * 2, from.size - 1);
+			uint32_t y1 = std::min(y * 2 + 1, from.size - 1);
+			for (uint32_t x = 0; x < to.size; x++) {
+				uint32_t x0 = std::min(x * 2, from.size - 1);
+				uint32_t x1 = std::min(x * 2 + 1, from.size - 1);
+				for (uint32_t c = 0; c < channels; c++) {
+					float sum = static_cast<float>(src[(y0 * from.rowLength + x0) * channels + c]) +
+						static_cast<float>(src[(y0 * from.rowLength + x1) * channels + c]) +
+						static_cast<float>(src[(y1 * from.rowLength + x0) * channels + c]) +
+						static_cast<float>(src[(y1 * from.rowLength + x1) * channels + c]);
+
+					if constexpr (std::is_integral_v<T>) dst[(y * to.rowLength + x) * channels + c] = static_cast<T>(sum * 0.25f + 0.5f);
+					else dst[(y * to.rowLength + x) * channels + c] = sum * 0.25f;
+				}
+			}
+		}
+	}
+
+}
+
+CubemapImage::CubemapImage() : block(nullptr, noDeleter),
+blockSize(0),
+regions(),
+_hdr(false),
+_channels(0)
+{
+}
+
+bool CubemapImage::loadCross(const std::filesystem::path& path)
+{
+	clear();
+
+	stbi_set_flip_vertically_on_load(false);
+	DecodedImage image = decode(path);
+	if (!image.pixels) {
+		Console::out::warning("Cubemap Image", "Failed to load cubemap at " + path.string());
+		return false;
+	}
+
+	if (image.channels < 3 || image.width / 4 != image.height / 3) {
+		Console::out::warning("Cubemap Image", "Cubemap at " + path.string() + " isn't a 4x3 cross layout with rgb or rgba channels");
+		stbi_image_free(image.pixels);
+		return false;
+	}
+
+	_hdr = image.hdr;
+	_channels = image.channels;
+	setBlock(static_cast<uint8_t*>(image.pixels), static_cast<size_t>(image.width) * image.height * pixelSize(), freeDecoded);
+
+	// Faces are strided views into the cross, (column, row) of each face within the layout
+	const uint32_t size = image.width / 4;
+	const std::pair<uint32_t, uint32_t> cells[N_FACES] = {
+		{ 2, 1 }, // Positive X (Right)
+		{ 0, 1 }, // Negative X (Left)
+		{ 1, 0 }, // Positive Y (Top)
+		{ 1, 2 }, // Negative Y (Bottom)
+		{ 1, 1 }, // Positive Z (Front)
+		{ 3, 1 }  // Negative Z (Back)
+	};
+
+	regions.resize(N_FACES);
+	for (uint32_t i = 0; i < N_FACES; i++) {
+		size_t firstPixel = static_cast<size_t>(cells[i].second * size) * image.width + cells[i].first * size;
+		regions[i].offset = firstPixel * pixelSize();
+		regions[i].size = size;
+		regions[i].rowLength = image.width;
+	}
+
+	return true;
+}
+
+bool CubemapImage::loadFaces(const std::array<std::filesystem::path, N_FACES>& paths)
+{
+	clear();
+
+	// Decode faces serially, images are loaded on the resource processor and the shared worker pool is reserved for per frame work
+	stbi_set_flip_vertically_on_load(false);
+	std::array<DecodedImage, N_FACES> faces;
+	for (uint32_t i = 0; i < N_FACES; i++) {
+		faces[i] = decode(paths[i]);
+	}
+
+	// Validate faces share one square size and format
+	bool valid = true;
+	for (uint32_t i = 0; i < N_FACES; i++) {
+		const DecodedImage& face = faces[i];
+		if (!face.pixels) {
+			Console::out::warning("Cubemap Image", "Failed to load cubemap face at " + paths[i].string());
+			valid = false;
+		}
+		else if (face.width != face.height || face.width != faces[0].width || face.channels != faces[0].channels || face.hdr != faces[0].hdr || face.channels < 3) {
+			Console::out::warning("Cubemap Image", "Cubemap face at " + paths[i].string() + " doesn't match the size or format of the other faces");
+			valid = false;
+		}
+	}
+
+	if (valid) {
+		_hdr = faces[0].hdr;
+		_channels = faces[0].channels;
+		size_t bytes = setTightRegions(faces[0].width, 1);
+		setBlock(static_cast<uint8_t*>(std::malloc(bytes)), bytes, freePixels);
+
+		// Faces are tight already, one bulk copy each
+		size_t faceBytes = bytes / N_FACES;
+		for (uint32_t i = 0; i < N_FACES; i++) {
+			std::memcpy(block.get() + regions[i].offset, faces[i].pixels, faceBytes);
+		}
+	}
+
+	for (DecodedImage& face : faces) {
+		if (face.pixels) stbi_image_free(face.pixels);
+	}
+
+	if (!valid) clear();
+	return valid;
+}
+
+bool CubemapImage::loadCooked(const std::filesystem::path& path)
+{
+	clear();
+
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file) {
+		Console::out::warning("Cubemap Image", "Failed to open cooked cubemap at " + path.string());
+		return false;
+	}
+
+	size_t fileSize = static_cast<size_t>(file.tellg());
+	file.seekg(0);
+
+	CookedHeader header;
+	if (fileSize < sizeof(header) || !file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+		std::memcmp(header.magic, COOKED_MAGIC, sizeof(COOKED_MAGIC)) != 0 || header.version != COOKED_VERSION ||
+		(header.channels != 3 && header.channels != 4) || header.faceSize == 0 ||
+		header.nMips == 0 || header.nMips > fullMipCount(header.faceSize)) {
+		Console::out::warning("Cubemap Image", "Cooked cubemap at " + path.string() + " is invalid or of an unsupported version");
+		return false;
+	}
+
+	_hdr = header.hdr != 0;
+	_channels = header.channels;
+	size_t bytes = setTightRegions(header.faceSize, header.nMips);
+
+	// Pixels are stored exactly as they are uploaded, read them in one go
+	if (fileSize - sizeof(header) != bytes) {
+		Console::out::warning("Cubemap Image", "Cooked cubemap at " + path.string() + " is truncated");
+		clear();
+		return false;
+	}
+
+	setBlock(static_cast<uint8_t*>(std::malloc(bytes)), bytes, freePixels);
+	if (!file.read(reinterpret_cast<char*>(block.get()), static_cast<std::streamsize>(bytes))) {
+		Console::out::warning("Cubemap Image", "Failed to read cooked cubemap at " + path.string());
+		clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool CubemapImage::saveCooked(const std::filesystem::path& path) const
+{
+	if (empty()) return false;
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file) return false;
+
+	CookedHeader header;
+	std::memcpy(header.magic, COOKED_MAGIC, sizeof(COOKED_MAGIC));
+	header.version = COOKED_VERSION;
+	header.hdr = _hdr ? 1 : 0;
+	header.channels = _channels;
+	header.faceSize = faceSize();
+	header.nMips = nMips();
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	// Strided faces are written row by row, tight faces at once
+	for (const Region& region : regions) {
+		size_t rowBytes = static_cast<size_t>(region.size) * pixelSize();
+		if (region.rowLength == region.size) {
+			file.write(reinterpret_cast<const char*>(block.get() + region.offset), static_cast<std::streamsize>(rowBytes * region.size));
+			continue;
+		}
+
+		size_t strideBytes = static_cast<size_t>(region.rowLength) * pixelSize();
+		for (uint32_t y = 0; y < region.size; y++) {
+			file.write(reinterpret_cast<const char*>(block.get() + region.offset + y * strideBytes), static_cast<std::streamsize>(rowBytes));
+		}
+	}
+
+	return static_cast<bool>(file);
+}
+
+void CubemapImage::generateMips()
+{
+	if (empty()) return;
+
+	// Base level regions of the current block
+	std::vector<Region> base(regions.begin(), regions.begin() + N_FACES);
+
+	// Allocate tightly packed block for full chain
+	uint32_t nLevels = fullMipCount(faceSize());
+	size_t bytes = setTightRegions(faceSize(), nLevels);
+	uint8_t* target = static_cast<uint8_t*>(std::malloc(bytes));
+
+	for (uint32_t face = 0; face < N_FACES; face++) {
+		// Copy base level row by row, dropping the stride of the source
+		const Region& from = base[face];
+		const Region& to = regions[face];
+		size_t rowBytes = static_cast<size_t>(to.size) * pixelSize();
+		size_t strideBytes = static_cast<size_t>(from.rowLength) * pixelSize();
+		for (uint32_t y = 0; y < to.size; y++) {
+			std::memcpy(target + to.offset + y * rowBytes, block.get() + from.offset + y * strideBytes, rowBytes);
+		}
+
+		// Filter each level from the previous one
+		for (uint32_t mip = 1; mip < nLevels; mip++) {
+			const Region& larger = regions[(mip - 1) * N_FACES + face];
+			const Region& smaller = regions[mip * N_FACES + face];
+			if (_hdr) downsample<float>(target, larger, target, smaller, _channels);
+			else downsample<uint8_t>(target, larger, target, smaller, _channels);
+		}
+	}
+
+	setBlock(target, bytes, freePixels);
+}
+
+void CubemapImage::clear()
+{
+	block.reset();
+	blockSize = 0;
+	regions.clear();
+	_hdr = false;
+	_channels = 0;
+}
+
+bool CubemapImage::empty() const
+{
+	return !block || regions.empty();
+}
+
+bool CubemapImage::hdr() const
+{
+	return _hdr;
+}
+
+uint32_t CubemapImage::channels() const
+{
+	return _channels;
+}
+
+uint32_t CubemapImage::pixelSize() const
+{
+	return _channels * static_cast<uint32_t>(_hdr ? sizeof(float) : sizeof(uint8_t));
+}
+
+uint32_t CubemapImage::faceSize() const
+{
+	return regions.empty() ? 0 : regions[0].size;
+}
+
+uint32_t CubemapImage::nMips() const
+{
+	return static_cast<uint32_t>(regions.size() / N_FACES);
+}
+
+const CubemapImage::Region& CubemapImage::region(uint32_t mip, uint32_t face) const
+{
+	return regions[mip * N_FACES + face];
+}
+
+const uint8_t* CubemapImage::pixels() const
+{
+	return block.get();
+}
+
+size_t CubemapImage::pixelBytes() const
+{
+	return blockSize;
+}
+
+uint32_t CubemapImage::fullMipCount(uint32_t size)
+{
+	uint32_t count = 1;
+	while (size > 1) {
+		size /= 2;
+		count++;
+	}
+	return count;
+}
+
+void CubemapImage::setBlock(uint8_t* pixels, size_t size, void(*deleter)(void*))
+{
+	block = std::unique_ptr<uint8_t, void(*)(void*)>(pixels, deleter);
+	blockSize = size;
+}
+
+size_t CubemapImage::setTightRegions(uint32_t size, uint32_t mips)
+{
+	regions.resize(static_cast<size_t>(mips) * N_FACES);
+
+	size_t offset = 0;
+	for (uint32_t mip = 0; mip < mips; mip++) {
+		uint32_t mipSize = std::max(size >> mip, 1u);
+		for (uint32_t face = 0; face < N_FACES; face++) {
+			Region& region = regions[mip * N_FACES + face];
+			region.offset = offset;
+			region.size = mipSize;
+			region.rowLength = mipSize;
+			offset += static_cast<size_t>(mipSize) * mipSize * pixelSize();
+		}
+	}
+
+	return offset;
+}
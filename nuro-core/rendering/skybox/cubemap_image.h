@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+
+// Cpu side pixels of the six faces of a cubemap and their mip levels, doesn't touch the graphics api
+// All faces are regions of one contiguous pixel block, regions may be strided so faces of a cross layout are never copied
+// Faces are ordered +x, -x, +y, -y, +z, -z, hdr pixels are 32 bit floats, ldr pixels are 8 bit
+class CubemapImage
+{
+public:
+	// Amount of faces of a cubemap
+	static constexpr uint32_t N_FACES = 6;
+
+	// Version of cooked cubemap files written
+	static constexpr uint32_t COOKED_VERSION = 1;
+
+	// Location of a face of a mip level within the pixel block
+	struct Region
+	{
+		size_t offset = 0; // Byte offset of the first pixel
+		uint32_t size = 0; // Width and height in pixels
+		uint32_t rowLength = 0; // Amount of pixels from the start of one row to the start of the next
+	};
+
+	CubemapImage();
+
+	// Loads a horizontal 4x3 cross layout, faces reference the decoded image directly
+	bool loadCross(const std::filesystem::path& path);
+
+	// Loads six individual face images, ordered +x, -x, +y, -y, +z, -z
+	bool loadFaces(const std::array<std::filesystem::path, N_FACES>& paths);
+
+	// Loads a cooked cubemap file including all of its mip levels
+	bool loadCooked(const std::filesystem::path& path);
+
+	// Writes all faces and mip levels to a cooked cubemap file
+	bool saveCooked(const std::filesystem::path& path) const;
+
+	// Replaces all mip levels below the base level with a box filtered chain down to 1x1
+	void generateMips();
+
+	// Frees all pixels
+	void clear();
+
+	// Returns if no pixels are loaded
+	bool empty() const;
+
+	// Returns if pixels are 32 bit floats
+	bool hdr() const;
+
+	// Returns the amount of channels per pixel (3 or 4)
+	uint32_t channels() const;
+
+	// Returns the size of a single pixel in bytes
+	uint32_t pixelSize() const;
+
+	// Returns the width and height of each face of the base level
+	uint32_t faceSize() const;
+
+	// Returns the amount of mip levels loaded
+	uint32_t nMips() const;
+
+	// Returns the region of given face of given mip level
+	const Region& region(uint32_t mip, uint32_t face) const;
+
+	// Returns the pixel block all regions point into
+	const uint8_t* pixels() const;
+
+	// Returns the size of the pixel block in bytes
+	size_t pixelBytes() const;
+
+	// Returns the amount of mip levels of a full chain for given face size
+	static uint32_t fullMipCount(uint32_t size);
+
+private:
+	// Pixel block, freed by the deleter of whoever allocated it
+	std::unique_ptr<uint8_t, void(*)(void*)> block;
+
+	// Size of pixel block in bytes
+	size_t blockSize;
+
+	// Regions of all faces, N_FACES per mip level
+	std::vector<Region> regions;
+
+	// Pixel format
+	bool _hdr;
+	uint32_t _channels;
+
+	// Takes ownership of given pixel block
+	void setBlock(uint8_t* pixels, size_t size, void(*deleter)(void*));
+
+	// Sets regions of tightly packed faces for given amount of mip levels, returns the size of the block they span
+	size_t setTightRegions(uint32_t size, uint32_t mips);
+};
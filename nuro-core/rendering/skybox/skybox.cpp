@@ -6,6 +6,7 @@
 #include <rendering/shader/shader_pool.h>
 #include <rendering/shader/shader.h>
 #include <utils/console.h>
+#include <rendering/submission/draw_submission.h>
 
 Skybox::Skybox() : cubemap(nullptr),
 shader(nullptr),
@@ -122,14 +123,14 @@ void Skybox::render(const glm::mat4& viewMatrix, const glm::mat4& projectionMatr
 	shader->setFloat("emission", emission);
 
 	// Bind skybox vao
-	glBindVertexArray(vao);
+	DrawSubmission::bindVertexArray(vao);
 
 	// Bind cubemap texture
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap->backendId());
 
 	// Draw skybox
-	glDrawArrays(GL_TRIANGLES, 0, 36);
+	DrawSubmission::drawArrays(GL_TRIANGLES, 0, 36);
 
 	// Reset depth function
 	glDepthFunc(GL_LESS);
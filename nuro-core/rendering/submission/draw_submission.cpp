@@ -0,0 +1,79 @@
+#include "draw_submission.h"
+
+#include <glad/glad.h>
+
+#include <diagnostics/diagnostics.h>
+#include <rendering/material/imaterial.h>
+
+namespace DrawSubmission {
+
+	uint32_t _nPolygons(const uint32_t mode, const uint32_t count)
+	{
+		// Only triangles count as polygons
+		switch (mode) {
+		case GL_TRIANGLES:
+			return count / 3;
+		case GL_TRIANGLE_STRIP:
+		case GL_TRIANGLE_FAN:
+			return count > 2 ? count - 2 : 0;
+		default:
+			return 0;
+		}
+	}
+
+	void bindShader(const uint32_t program)
+	{
+		glUseProgram(program);
+		Diagnostics::addShaderBind();
+	}
+
+	void bindMaterial(const IMaterial& material)
+	{
+		material.bind();
+		Diagnostics::addMaterialBind();
+	}
+
+	void bindVertexArray(const uint32_t vao)
+	{
+		glBindVertexArray(vao);
+		Diagnostics::addVaoBind();
+	}
+
+	void drawElements(const uint32_t mode, const uint32_t count, const uint32_t firstIndex, const int32_t baseVertex, const uint32_t instances)
+	{
+		const void* offset = reinterpret_cast<const void*>(static_cast<uintptr_t>(firstIndex) * sizeof(uint32_t));
+		if (instances == 1) {
+			glDrawElementsBaseVertex(mode, count, GL_UNSIGNED_INT, offset, baseVertex);
+		}
+		else {
+			glDrawElementsInstancedBaseVertex(mode, count, GL_UNSIGNED_INT, offset, instances, baseVertex);
+		}
+
+		Diagnostics::addDrawCall(count * instances, _nPolygons(mode, count) * instances, instances);
+	}
+
+	void drawArrays(const uint32_t mode, const uint32_t first, const uint32_t count, const uint32_t instances, const uint32_t baseInstance)
+	{
+		if (instances == 1 && baseInstance == 0) {
+			glDrawArrays(mode, first, count);
+		}
+		else {
+			glDrawArraysInstancedBaseInstance(mode, first, count, instances, baseInstance);
+		}
+
+		Diagnostics::addDrawCall(count * instances, _nPolygons(mode, count) * instances, instances);
+	}
+
+	void multiDrawElementsIndirect(const void* indirect, const uint32_t nCommands, const uint32_t nIndices, const uint32_t nInstances)
+	{
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, indirect, nCommands, 0);
+		Diagnostics::addDrawCall(nIndices, nIndices / 3, nInstances);
+	}
+
+	void uploadBuffer(const uint32_t buffer, const size_t offset, const size_t size, const void* data)
+	{
+		glNamedBufferSubData(buffer, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+		Diagnostics::addUploadedBytes(size);
+	}
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class IMaterial;
+
+// Thin layer all draws, binds and buffer uploads of the renderer are submitted through
+// Forwards each call to the graphics api and reports it to the draw stats of the current pass
+namespace DrawSubmission
+{
+
+	// Binds a shader program
+	void bindShader(const uint32_t program);
+
+	// Binds a material, its shader must be bound beforehand
+	void bindMaterial(const IMaterial& material);
+
+	// Binds a vertex array
+	void bindVertexArray(const uint32_t vao);
+
+	// Draws a range of indices of the bound element buffer
+	void drawElements(const uint32_t mode, const uint32_t count, const uint32_t firstIndex, const int32_t baseVertex, const uint32_t instances = 1);
+
+	// Draws a range of vertices of the bound vertex array
+	void drawArrays(const uint32_t mode, const uint32_t first, const uint32_t count, const uint32_t instances = 1, const uint32_t baseInstance = 0);
+
+	// Draws indexed triangles of multiple commands of the bound indirect buffer, counts are totals of all commands
+	void multiDrawElementsIndirect(const void* indirect, const uint32_t nCommands, const uint32_t nIndices, const uint32_t nInstances);
+
+	// Uploads data to a range of a buffer
+	void uploadBuffer(const uint32_t buffer, const size_t offset, const size_t size, const void* data);
+
+};
@@ -0,0 +1,167 @@
+#include "prefab.h"
+
+#include <tuple>
+#include <type_traits>
+
+#include <utils/console.h>
+#include <transform/transform.h>
+
+namespace {
+
+	// Backend handles are created by the construction listeners of each instance, blueprints never own any
+	template <typename T>
+	void clearHandles(T& component) {}
+
+	void clearHandles(BoxColliderComponent& collider) {
+		collider.material = nullptr;
+		collider.shape = nullptr;
+	}
+
+	void clearHandles(SphereColliderComponent& collider) {
+		collider.material = nullptr;
+		collider.shape = nullptr;
+	}
+
+	void clearHandles(RigidbodyComponent& rigidbody) {
+		rigidbody.actor = nullptr;
+	}
+
+	void clearHandles(AudioSourceComponent& source) {
+		source.id = 0;
+		source.usingMultichannel = false;
+	}
+
+}
+
+Prefab::Prefab() : blueprint()
+{
+}
+
+void Prefab::capture(ECS& ecs, Entity root)
+{
+	blueprint = SceneData();
+
+	if (!ecs.has<TransformComponent>(root)) {
+		Console::out::warning("Prefab", "Tried to capture prefab from invalid entity");
+		return;
+	}
+
+	// Collect entities breadth first so parents precede their children
+	std::vector<Entity> entities = { root };
+	blueprint.parents.push_back(SceneData::NO_PARENT);
+	for (uint32_t i = 0; i < entities.size(); i++) {
+		for (Entity child : ecs.get<HierarchyComponent>(entities[i]).children) {
+			entities.push_back(child);
+			blueprint.parents.push_back(i);
+		}
+	}
+
+	// Copy transforms and names without their hierarchy links, those are recreated per instance
+	blueprint.transforms.reserve(entities.size());
+	blueprint.names.reserve(entities.size());
+	for (uint32_t i = 0; i < entities.size(); i++) {
+		TransformComponent transform = ecs.get<TransformComponent>(entities[i]);
+		uint32_t parent = blueprint.parents[i];
+
+		transform.parent = entt::null;
+		transform.depth = parent == SceneData::NO_PARENT ? 0 : blueprint.transforms[parent].depth + 1;
+		transform.modified = true;
+
+		blueprint.transforms.push_back(std::move(transform));
+		blueprint.names.push_back(ecs.get<IdentityComponent>(entities[i]).name);
+	}
+
+	// Copy all other components column wise
+	std::apply([&](auto&... column) {
+		([&](auto& column) {
+			using T = typename std::decay_t<decltype(column.components)>::value_type;
+
+			for (uint32_t i = 0; i < entities.size(); i++) {
+				if (!ecs.has<T>(entities[i])) continue;
+
+				T component = ecs.get<T>(entities[i]);
+				clearHandles(component);
+
+				column.entities.push_back(i);
+				column.components.push_back(std::move(component));
+			}
+			}(column), ...);
+		}, blueprint.columns);
+}
+
+std::vector<Entity> Prefab::instantiate(ECS& ecs, size_t count, const std::vector<PrefabTransform>& transforms) const
+{
+	uint32_t n = nEntities();
+	if (n == 0 || count == 0) return {};
+
+	if (!transforms.empty() && transforms.size() != count) {
+		Console::out::warning("Prefab", "Couldn't instantiate prefab, expected " + std::to_string(count) + " transforms but got " + std::to_string(transforms.size()));
+		return {};
+	}
+
+	// Create all entity handles at once
+	std::vector<Entity> entities = ecs.createEntities(count * n);
+
+	// Build transforms and names of all instances, parents are resolved within their instance
+	std::vector<TransformComponent> instanceTransforms;
+	std::vector<std::string> instanceNames;
+	instanceTransforms.reserve(entities.size());
+	instanceNames.reserve(entities.size());
+	for (size_t instance = 0; instance < count; instance++) {
+		size_t base = instance * n;
+		instanceNames.insert(instanceNames.end(), blueprint.names.begin(), blueprint.names.end());
+
+		for (uint32_t i = 0; i < n; i++) {
+			TransformComponent& transform = instanceTransforms.emplace_back(blueprint.transforms[i]);
+
+			uint32_t parent = blueprint.parents[i];
+			if (parent != SceneData::NO_PARENT) transform.parent = entities[base + parent];
+		}
+
+		// Place root
+		if (!transforms.empty()) {
+			TransformComponent& root = instanceTransforms[base];
+			const PrefabTransform& placement = transforms[instance];
+			root.position = placement.position;
+			root.rotation = placement.rotation;
+			root.eulerAngles = Transform::toEuler(placement.rotation);
+			root.scale = placement.scale;
+		}
+	}
+
+	// Listeners deferring their work until the batch ends are notified once for all instances
+	ecs.beginBatch();
+
+	ecs.insertTransforms(entities.begin(), entities.end(), instanceTransforms.begin(), instanceNames.begin());
+
+	// Link children to their parents
+	for (size_t instance = 0; instance < count; instance++) {
+		size_t base = instance * n;
+		for (uint32_t i = 1; i < n; i++) {
+			ecs.get<HierarchyComponent>(entities[base + blueprint.parents[i]]).children.push_back(entities[base + i]);
+		}
+	}
+
+	// Insert each blueprint component into the same entity of all instances at once
+	std::vector<Entity> targets(count);
+	std::apply([&](const auto&... column) {
+		([&](const auto& column) {
+			for (size_t c = 0; c < column.components.size(); c++) {
+				uint32_t i = column.entities[c];
+				for (size_t instance = 0; instance < count; instance++) {
+					targets[instance] = entities[instance * n + i];
+				}
+				ecs.insertCopies(targets.begin(), targets.end(), column.components[c]);
+			}
+			}(column), ...);
+		}, blueprint.columns);
+
+	ecs.endBatch();
+
+	return entities;
+}
+
+uint32_t Prefab::nEntities() const
+{
+	return blueprint.nEntities();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <ecs/ecs.h>
+#include <scene/scene_serializer.h>
+
+// Placement of the root entity of a prefab instance in local space
+struct PrefabTransform {
+
+	glm::vec3 position = glm::vec3(0.0f);
+	glm::quat rotation = glm::identity<glm::quat>();
+	glm::vec3 scale = glm::vec3(1.0f);
+
+};
+
+// Blueprint of an entity and all of its descendants, instantiated in bulk
+class Prefab {
+public:
+	Prefab();
+
+	// Captures an entity and all of its descendants as the blueprint, replaces the previous blueprint
+	void capture(ECS& ecs, Entity root);
+
+	// Instantiates the blueprint the given amount of times with all components inserted in batches per type
+	// Each instances root is placed by the corresponding transform, the captured root transform is used if none are given
+	// Returns the created entities, instance i occupies the range [i * nEntities(), (i + 1) * nEntities()) with its root first
+	std::vector<Entity> instantiate(ECS& ecs, size_t count, const std::vector<PrefabTransform>& transforms = {}) const;
+
+	// Returns the amount of entities of a single instance
+	uint32_t nEntities() const;
+
+private:
+	// Components of the captured entities, parents precede their children
+	SceneData blueprint;
+};
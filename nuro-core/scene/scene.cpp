@@ -1 +1,202 @@
-#include "scene.h"
\ No newline at end of file
+#include "scene.h"
+
+#include <algorithm>
+
+#include <utils/console.h>
+#include <scene/scene_section.h>
+#include <context/application_context.h>
+
+Scene::Scene(std::string name, FS::Path file) : _name(name),
+_file(file),
+_entities(),
+_state(SceneState::UNLOADED),
+_streamedIn(false),
+_assets(),
+_section(nullptr),
+_insertion()
+{
+}
+
+const std::string& Scene::name() const
+{
+	return _name;
+}
+
+const FS::Path& Scene::file() const
+{
+	return _file;
+}
+
+const std::vector<Entity>& Scene::entities() const
+{
+	return _entities;
+}
+
+bool Scene::load(ECS& ecs, const SceneAssetResolver& assets)
+{
+	if (_state != SceneState::UNLOADED) {
+		Console::out::warning("Scene", "Scene '" + _name + "' is already loaded or streaming");
+		return false;
+	}
+
+	if (_file.empty()) {
+		Console::out::warning("Scene", "Scene '" + _name + "' has no scene file to load");
+		return false;
+	}
+
+	// Decode whole scene before touching the ecs
+	SceneData data;
+	if (!SceneSerializer::read(_file, data, assets)) return false;
+
+	_entities = SceneSerializer::insert(ecs, data);
+	_state = SceneState::LOADED;
+	_streamedIn = true;
+	return true;
+}
+
+bool Scene::save(ECS& ecs, const SceneAssetResolver& assets) const
+{
+	if (_file.empty()) {
+		Console::out::warning("Scene", "Scene '" + _name + "' has no scene file to save to");
+		return false;
+	}
+
+	return SceneSerializer::write(_file, ecs, assets);
+}
+
+void Scene::streamIn(const SceneAssetResolver& assets)
+{
+	if (_file.empty()) {
+		Console::out::warning("Scene", "Scene '" + _name + "' has no scene file to stream in");
+		return;
+	}
+
+	_assets = assets;
+	_streamedIn = true;
+
+	// Start decoding right away, other states are advanced while streaming
+	if (_state == SceneState::UNLOADED) decode();
+}
+
+void Scene::streamOut()
+{
+	_streamedIn = false;
+}
+
+uint32_t Scene::stream(ECS& ecs, uint32_t entityBudget)
+{
+	switch (_state) {
+
+	case SceneState::UNLOADED:
+	{
+		if (_streamedIn) decode();
+		return 0;
+	}
+
+	case SceneState::DECODING:
+	{
+		ResourceState sectionState = _section->resourceState();
+
+		// Section is still queued or decoding
+		if (sectionState != ResourceState::READY && sectionState != ResourceState::FAILED) return 0;
+
+		// Decoding failed or scene isn't wanted anymore
+		if (sectionState == ResourceState::FAILED || !_streamedIn) {
+			if (sectionState == ResourceState::FAILED) {
+				Console::out::warning("Scene", "Couldn't stream in scene '" + _name + "'");
+				_streamedIn = false;
+			}
+			releaseSection();
+			_state = SceneState::UNLOADED;
+			return 0;
+		}
+
+		// Create entity handles and start merging
+		SceneSerializer::beginInsert(ecs, _section->data(), _insertion);
+		_state = SceneState::MERGING;
+		return 0;
+	}
+
+	case SceneState::MERGING:
+	{
+		// Scene isn't wanted anymore, destroy what was merged so far
+		if (!_streamedIn) {
+			// Handles of entities never merged don't have any components yet, destroy them right away
+			std::vector<Entity>& entities = _insertion.entities;
+			ecs.destroyEntities(entities.begin() + _insertion.nInserted, entities.end());
+			entities.resize(_insertion.nInserted);
+
+			_entities = std::move(entities);
+			releaseSection();
+			_state = SceneState::UNLOADING;
+			return 0;
+		}
+
+		uint32_t nInserted = _insertion.nInserted;
+		bool done = SceneSerializer::insertSlice(ecs, _section->data(), _insertion, entityBudget);
+		uint32_t processed = _insertion.nInserted - nInserted;
+
+		if (done) {
+			_entities = std::move(_insertion.entities);
+			releaseSection();
+			_state = SceneState::LOADED;
+		}
+
+		return processed;
+	}
+
+	case SceneState::LOADED:
+	{
+		if (!_streamedIn) _state = SceneState::UNLOADING;
+		return 0;
+	}
+
+	case SceneState::UNLOADING:
+	{
+		// Destroy entities in reverse scene order, children are destroyed before their parents
+		uint32_t processed = std::min(entityBudget, static_cast<uint32_t>(_entities.size()));
+		ecs.destroyEntities(_entities.end() - processed, _entities.end());
+		_entities.resize(_entities.size() - processed);
+
+		if (_entities.empty()) _state = SceneState::UNLOADED;
+
+		return processed;
+	}
+
+	}
+
+	return 0;
+}
+
+SceneState Scene::state() const
+{
+	return _state;
+}
+
+void Scene::decode()
+{
+	ResourceManager& resources = ApplicationContext::resourceManager();
+
+	// Decode scene file on the resource processor thread
+	auto [id, section] = resources.create<SceneSection>(_name);
+	section->setSource(_file, _assets);
+	_section = section;
+
+	if (!resources.exec(_section->create())) {
+		Console::out::warning("Scene", "Couldn't queue decoding of scene '" + _name + "'");
+		releaseSection();
+		_streamedIn = false;
+		return;
+	}
+
+	_state = SceneState::DECODING;
+}
+
+void Scene::releaseSection()
+{
+	if (!_section) return;
+
+	ApplicationContext::resourceManager().release(_section->resourceId());
+	_section = nullptr;
+	_insertion = SceneInsertion();
+}
@@ -3,15 +3,90 @@
 #include <string>
 #include <vector>
 
-struct SceneEntity {
+#include <ecs/ecs.h>
+#include <utils/fsutil.h>
+#include <memory/resource_manager.h>
+#include <scene/scene_serializer.h>
 
-	
+class SceneSection;
 
+enum class SceneState {
+	// Scene isn't loaded
+	UNLOADED,
+
+	// Scene file is being decoded asynchronously
+	DECODING,
+
+	// Decoded scene is being merged into the ecs in slices
+	MERGING,
+
+	// All entities of the scene are loaded
+	LOADED,
+
+	// Entities of the scene are being destroyed in slices
+	UNLOADING
 };
 
 class Scene {
 public:
+	Scene(std::string name, FS::Path file);
+
+	// Returns the name of the scene
+	const std::string& name() const;
+
+	// Returns the scene file, empty if none
+	const FS::Path& file() const;
+
+	// Returns the entities the scene loaded into its ecs
+	const std::vector<Entity>& entities() const;
+
+	// Loads the scene file into an ecs, returns success
+	bool load(ECS& ecs, const SceneAssetResolver& assets);
+
+	// Saves all entities of an ecs to the scene file, returns success
+	bool save(ECS& ecs, const SceneAssetResolver& assets) const;
+
+	// Requests the scene to be streamed in, its scene file is decoded by the resource manager (resolver must be thread safe)
+	void streamIn(const SceneAssetResolver& assets);
+
+	// Requests the scene to be streamed out
+	void streamOut();
+
+	// Advances streaming, merges or destroys up to the given amount of entities, returns the amount of entities processed
+	uint32_t stream(ECS& ecs, uint32_t entityBudget);
+
+	// Returns the streaming state of the scene
+	SceneState state() const;
 
 private:
+	// Name of the scene
+	std::string _name;
+
+	// Scene file
+	FS::Path _file;
+
+	// Entities loaded by the scene
+	std::vector<Entity> _entities;
+
+	// Streaming state
+	SceneState _state;
+
+	// Set if the scene should be streamed in
+	bool _streamedIn;
+
+	// Resolver used for streaming the scene in
+	SceneAssetResolver _assets;
 
-};
\ No newline at end of file
+	// Section decoding the scene file while streaming in
+	ResourceRef<SceneSection> _section;
+
+	// Progress of merging the decoded section
+	SceneInsertion _insertion;
+
+	// Starts decoding the scene file
+	void decode();
+
+	// Releases the decoding section
+	void releaseSection();
+
+};
@@ -1,21 +1,109 @@
 #include "scene_manager.h"
 
+#include <algorithm>
+
+#include <utils/console.h>
+
 #include "scene.h"
 
-SceneManager::SceneManager() : scenes() 
+SceneManager::SceneManager() : scenes(), assetResolver(), streamingBudget(2048)
 {
 }
 
 SceneName SceneManager::createScene(std::string name)
 {
-	return SceneName();
+	if (scenes.find(name) != scenes.end()) {
+		Console::out::warning("Scene Manager", "Scene '" + name + "' already exists");
+		return name;
+	}
+
+	scenes[name] = std::make_shared<Scene>(name, FS::Path());
+	return name;
 }
 
 SceneName SceneManager::createScene(FS::Path sceneFile)
 {
-	return SceneName();
+	SceneName name = sceneFile.stem().string();
+	if (scenes.find(name) != scenes.end()) {
+		Console::out::warning("Scene Manager", "Scene '" + name + "' already exists");
+		return name;
+	}
+
+	scenes[name] = std::make_shared<Scene>(name, sceneFile);
+	return name;
 }
 
 void SceneManager::loadScene(SceneName name)
 {
+	SceneRef scene = getScene(name);
+	if (!scene) {
+		Console::out::warning("Scene Manager", "Tried to load unknown scene '" + name + "'");
+		return;
+	}
+
+	if (scene->load(ECS::main(), assetResolver)) {
+		Console::out::done("Scene Manager", "Loaded scene '" + name + "' with " + std::to_string(scene->entities().size()) + " entities");
+	}
+}
+
+void SceneManager::saveScene(SceneName name)
+{
+	SceneRef scene = getScene(name);
+	if (!scene) {
+		Console::out::warning("Scene Manager", "Tried to save unknown scene '" + name + "'");
+		return;
+	}
+
+	scene->save(ECS::main(), assetResolver);
+}
+
+void SceneManager::streamIn(SceneName name)
+{
+	SceneRef scene = getScene(name);
+	if (!scene) {
+		Console::out::warning("Scene Manager", "Tried to stream in unknown scene '" + name + "'");
+		return;
+	}
+
+	scene->streamIn(assetResolver);
+}
+
+void SceneManager::streamOut(SceneName name)
+{
+	SceneRef scene = getScene(name);
+	if (!scene) {
+		Console::out::warning("Scene Manager", "Tried to stream out unknown scene '" + name + "'");
+		return;
+	}
+
+	scene->streamOut();
+}
+
+uint32_t SceneManager::update()
+{
+	// Scenes share the per frame budget, each is given what's left of it
+	ECS& ecs = ECS::main();
+	uint32_t processed = 0;
+	for (auto& [name, scene] : scenes) {
+		if (processed >= streamingBudget) break;
+		processed += scene->stream(ecs, streamingBudget - processed);
+	}
+	return processed;
+}
+
+void SceneManager::setStreamingBudget(uint32_t entities)
+{
+	streamingBudget = std::max(entities, 1u);
+}
+
+SceneRef SceneManager::getScene(SceneName name) const
+{
+	auto it = scenes.find(name);
+	if (it != scenes.end()) return it->second;
+	return nullptr;
+}
+
+void SceneManager::setAssetResolver(const SceneAssetResolver& resolver)
+{
+	assetResolver = resolver;
 }
@@ -2,9 +2,11 @@
 
 #include <memory>
 #include <string>
+#include <cstdint>
 #include <unordered_map>
 
 #include <utils/fsutil.h>
+#include <scene/scene_serializer.h>
 
 class Scene;
 
@@ -21,10 +23,38 @@ public:
 	// Creates a scene loaded from a scene file 
 	SceneName createScene(FS::Path sceneFile);
 
-	// Loads a scene by its name
+	// Loads a scene by its name into the main ecs
 	void loadScene(SceneName name);
 
+	// Saves the main ecs to the scene file of a scene by its name
+	void saveScene(SceneName name);
+
+	// Requests a scene to be streamed into the main ecs by its name, decoded asynchronously and merged in slices
+	void streamIn(SceneName name);
+
+	// Requests a scene to be streamed out of the main ecs by its name, destroyed in slices
+	void streamOut(SceneName name);
+
+	// Advances streaming of all scenes, call once per frame
+	// Returns the amount of entities processed, only exceeds the budget if a scene overran the budget it was given
+	uint32_t update();
+
+	// Sets the maximum amount of entities merged or destroyed per frame
+	void setStreamingBudget(uint32_t entities);
+
+	// Returns a scene by its name, nullptr if none
+	SceneRef getScene(SceneName name) const;
+
+	// Sets the resolver mapping asset references to guids when loading or saving scenes
+	void setAssetResolver(const SceneAssetResolver& resolver);
+
 private:
 	std::unordered_map<SceneName, SceneRef> scenes;
 
-};
\ No newline at end of file
+	// Resolver for asset references of scenes
+	SceneAssetResolver assetResolver;
+
+	// Maximum amount of entities merged or destroyed per frame
+	uint32_t streamingBudget;
+
+};
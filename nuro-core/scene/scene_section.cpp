@@ -0,0 +1,33 @@
+#include "scene_section.h"
+
+SceneSection::SceneSection() : _file(),
+_assets(),
+_data()
+{
+}
+
+SceneSection::~SceneSection()
+{
+	free();
+}
+
+void SceneSection::setSource(const FS::Path& file, const SceneAssetResolver& assets)
+{
+	_file = file;
+	_assets = assets;
+}
+
+SceneData& SceneSection::data()
+{
+	return _data;
+}
+
+void SceneSection::free()
+{
+	_data = SceneData();
+}
+
+bool SceneSection::decode()
+{
+	return SceneSerializer::read(_file, _data, _assets);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <memory/resource.h>
+#include <scene/scene_serializer.h>
+
+// Scene file decoded asynchronously by the resource manager, staged until it's merged into an ecs
+class SceneSection : public Resource
+{
+public:
+	SceneSection();
+	~SceneSection() override;
+
+	// Default pipe for decoding the scene section on the resource processor thread
+	ResourcePipe create() {
+		return std::move(pipe()
+			>> BIND_TASK(SceneSection, decode));
+	}
+
+	// Sets the scene file to decode and the resolver for its asset references (must be thread safe)
+	void setSource(const FS::Path& file, const SceneAssetResolver& assets);
+
+	// Returns the decoded scene, only valid once the section is ready
+	SceneData& data();
+
+	// Frees the decoded scene
+	void free();
+
+private:
+	bool decode();
+
+	FS::Path _file;
+	SceneAssetResolver _assets;
+
+	SceneData _data;
+};
@@ -0,0 +1,647 @@
+#include "scene_serializer.h"
+
+#include <array>
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <fstream>
+#include <type_traits>
+#include <unordered_map>
+
+#include <utils/console.h>
+
+//
+// FILE LAYOUT
+// Header, asset guid table, then one chunk per component type
+// Each chunk stores its components column wise: the entity index of each component, then one contiguous column per member
+// Entities are stored by index in hierarchy order, the transform chunk defines all entities and their parents
+// Asset references are stored as indices into the guid table
+// Chunks of unknown types are skipped, all values are little endian
+//
+
+namespace SceneSerializer {
+
+	// Scene file signature ("NSCN")
+	constexpr uint32_t MAGIC = 0x4E43534E;
+
+	// Scene file format version
+	constexpr uint32_t VERSION = 1;
+
+	// Asset index of unset asset references
+	constexpr uint32_t NO_ASSET = UINT32_MAX;
+
+	// Chunk type of the asset guid table
+	constexpr entt::id_type ASSET_CHUNK = "Assets"_hs;
+
+	// Chunk type of the transform chunk
+	constexpr entt::id_type TRANSFORM_CHUNK = "Transform"_hs;
+
+	struct FileHeader {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t nEntities;
+		uint32_t nChunks;
+	};
+
+	struct ChunkHeader {
+		uint32_t type;
+		uint32_t count;
+		uint64_t size;
+	};
+
+	//
+	// BINARY IO
+	//
+
+	class Writer {
+	public:
+		// Appends raw bytes
+		void bytes(const void* data, size_t size) {
+			const uint8_t* source = static_cast<const uint8_t*>(data);
+			buffer.insert(buffer.end(), source, source + size);
+		}
+
+		// Appends a value
+		template <typename T>
+		void value(const T& value) {
+			bytes(&value, sizeof(T));
+		}
+
+		// Appends uninitialized bytes, returns their offset
+		size_t reserve(size_t size) {
+			size_t offset = buffer.size();
+			buffer.resize(offset + size);
+			return offset;
+		}
+
+		std::vector<uint8_t> buffer;
+	};
+
+	class Reader {
+	public:
+		Reader(const uint8_t* data, size_t size) : cursor(data), end(data + size), failed(false) {}
+
+		// Consumes the given amount of bytes, returns nullptr if exceeding the data
+		const uint8_t* skip(size_t size) {
+			if (failed || static_cast<size_t>(end - cursor) < size) {
+				failed = true;
+				return nullptr;
+			}
+			const uint8_t* data = cursor;
+			cursor += size;
+			return data;
+		}
+
+		// Reads a value
+		template <typename T>
+		T value() {
+			T value{};
+			const uint8_t* data = skip(sizeof(T));
+			if (data) std::memcpy(&value, data, sizeof(T));
+			return value;
+		}
+
+		const uint8_t* cursor;
+		const uint8_t* end;
+		bool failed;
+	};
+
+	//
+	// COMPONENT COLUMNS
+	// Plain members of each component type are taken from its reflection table, asset references aren't reflected and are listed here
+	//
+
+	template <typename T>
+	struct AssetColumns {
+		template <typename F> static void each(F&&) {}
+	};
+
+	template <>
+	struct AssetColumns<MeshRendererComponent> {
+		template <typename F> static void each(F&& f) {
+			f(&MeshRendererComponent::mesh);
+			f(&MeshRendererComponent::material);
+		}
+	};
+
+	template <>
+	struct AssetColumns<AudioSourceComponent> {
+		template <typename F> static void each(F&& f) {
+			f(&AudioSourceComponent::clip);
+		}
+	};
+
+	// Returns the reflected type of a component stored in scene files
+	template <typename T>
+	const ECSReflection::Component& reflected()
+	{
+		const ECSReflection::Component* type = ECSReflection::resolve<T>();
+		if (!type) Console::out::error("Scene Serializer", "Fatal: Component type stored in scene files isn't reflected");
+
+		// Members are stored bytewise
+		for (const ECSReflection::Member& member : type->members) {
+			if (member.size == 0) Console::out::error("Scene Serializer", "Fatal: Reflected member '" + std::string(member.name) + "' of " + std::string(type->name) + " can't be stored in columns");
+		}
+
+		return *type;
+	}
+
+	// Returns if a member type is an asset reference stored through the guid table
+	template <typename M>
+	constexpr bool isAsset = std::is_same_v<M, const Mesh*> || std::is_same_v<M, const IMaterial*> || std::is_same_v<M, ResourceRef<AudioClip>>;
+
+	//
+	// ASSET TABLES
+	//
+
+	// Collects unique asset guids while writing
+	class AssetWriteTable {
+	public:
+		explicit AssetWriteTable(const SceneAssetResolver& resolver) : resolver(resolver) {}
+
+		// Returns the table index of an asset reference
+		template <typename M>
+		uint32_t indexOf(const M& asset) {
+			XG::GUID guid;
+			if constexpr (std::is_same_v<M, const Mesh*>) {
+				if (asset && resolver.meshToGUID) guid = resolver.meshToGUID(asset);
+			}
+			else if constexpr (std::is_same_v<M, const IMaterial*>) {
+				if (asset && resolver.materialToGUID) guid = resolver.materialToGUID(asset);
+			}
+			else {
+				if (asset && resolver.audioClipToGUID) guid = resolver.audioClipToGUID(asset);
+			}
+			if (!guid.isValid()) return NO_ASSET;
+
+			auto [it, inserted] = indices.try_emplace(guid, static_cast<uint32_t>(guids.size()));
+			if (inserted) guids.push_back(guid);
+			return it->second;
+		}
+
+		std::vector<XG::GUID> guids;
+
+	private:
+		const SceneAssetResolver& resolver;
+		std::unordered_map<XG::GUID, uint32_t> indices;
+	};
+
+	// Resolves each guid of the table once per asset type while reading
+	class AssetReadTable {
+	public:
+		AssetReadTable(const SceneAssetResolver& resolver) : guids(), resolver(resolver), meshes(), materials(), audioClips() {}
+
+		// Returns the asset referenced by a table index
+		template <typename M>
+		M resolve(uint32_t index) {
+			if (index >= guids.size()) return M();
+
+			if constexpr (std::is_same_v<M, const Mesh*>) {
+				return cached(meshes, index, resolver.meshFromGUID);
+			}
+			else if constexpr (std::is_same_v<M, const IMaterial*>) {
+				return cached(materials, index, resolver.materialFromGUID);
+			}
+			else {
+				return cached(audioClips, index, resolver.audioClipFromGUID);
+			}
+		}
+
+		std::vector<XG::GUID> guids;
+
+	private:
+		template <typename M, typename F>
+		M cached(std::vector<std::optional<M>>& cache, uint32_t index, const F& resolve) {
+			if (cache.size() != guids.size()) cache.resize(guids.size());
+			std::optional<M>& slot = cache[index];
+			if (!slot) slot = resolve ? resolve(guids[index]) : M();
+			return *slot;
+		}
+
+		const SceneAssetResolver& resolver;
+		std::vector<std::optional<const Mesh*>> meshes;
+		std::vector<std::optional<const IMaterial*>> materials;
+		std::vector<std::optional<ResourceRef<AudioClip>>> audioClips;
+	};
+
+	//
+	// COLUMN IO
+	//
+
+	// Writes an asset reference member of all given components as a single column of asset indices
+	template <typename T, typename M>
+	void writeColumn(Writer& writer, AssetWriteTable& assets, const std::vector<const T*>& components, M T::* member)
+	{
+		static_assert(isAsset<M>, "Only asset references are stored through the guid table");
+		size_t offset = writer.reserve(components.size() * sizeof(uint32_t));
+		uint8_t* out = writer.buffer.data() + offset;
+		for (const T* component : components) {
+			uint32_t index = assets.indexOf(component->*member);
+			std::memcpy(out, &index, sizeof(uint32_t));
+			out += sizeof(uint32_t);
+		}
+	}
+
+	// Reads a column of asset indices into an asset reference member of all given components
+	template <typename T, typename M>
+	void readColumn(Reader& reader, AssetReadTable& assets, std::vector<T>& components, M T::* member)
+	{
+		static_assert(isAsset<M>, "Only asset references are stored through the guid table");
+		const uint8_t* in = reader.skip(components.size() * sizeof(uint32_t));
+		if (!in) return;
+		for (T& component : components) {
+			uint32_t index;
+			std::memcpy(&index, in, sizeof(uint32_t));
+			component.*member = assets.resolve<M>(index);
+			in += sizeof(uint32_t);
+		}
+	}
+
+	// Writes a reflected member of all given components as a single contiguous column
+	template <typename T>
+	void writeColumn(Writer& writer, const std::vector<const T*>& components, const ECSReflection::Member& member)
+	{
+		size_t offset = writer.reserve(components.size() * member.size);
+		uint8_t* out = writer.buffer.data() + offset;
+		for (const T* component : components) {
+			std::memcpy(out, reinterpret_cast<const uint8_t*>(component) + member.offset, member.size);
+			out += member.size;
+		}
+	}
+
+	// Reads a column into a reflected member of all given components
+	template <typename T>
+	void readColumn(Reader& reader, std::vector<T>& components, const ECSReflection::Member& member)
+	{
+		const uint8_t* in = reader.skip(components.size() * member.size);
+		if (!in) return;
+		for (T& component : components) {
+			std::memcpy(reinterpret_cast<uint8_t*>(&component) + member.offset, in, member.size);
+			in += member.size;
+		}
+	}
+
+	// Writes all columns of the given components, reflected members first followed by asset references
+	template <typename T>
+	void writeColumns(Writer& writer, AssetWriteTable& assets, const std::vector<const T*>& components)
+	{
+		for (const ECSReflection::Member& member : reflected<T>().members) {
+			writeColumn(writer, components, member);
+		}
+		AssetColumns<T>::each([&](auto member) { writeColumn(writer, assets, components, member); });
+	}
+
+	// Reads all columns into the given components
+	template <typename T>
+	void readColumns(Reader& reader, AssetReadTable& assets, std::vector<T>& components)
+	{
+		for (const ECSReflection::Member& member : reflected<T>().members) {
+			readColumn(reader, components, member);
+		}
+		AssetColumns<T>::each([&](auto member) { readColumn(reader, assets, components, member); });
+	}
+
+	// Writes the chunk of a component type
+	template <typename T>
+	void writeChunk(Writer& writer, AssetWriteTable& assets, ECS& ecs, const std::vector<uint32_t>& indices, uint32_t& nChunks)
+	{
+		// Gather components
+		std::vector<std::pair<uint32_t, const T*>> gathered;
+		for (auto [entity, component] : ecs.view<T>().each()) {
+			uint32_t slot = entt::to_entity(entity);
+			if (slot >= indices.size() || indices[slot] == UINT32_MAX) continue;
+			gathered.emplace_back(indices[slot], &component);
+		}
+		if (gathered.empty()) return;
+
+		// Store components in scene order, allows inserting scenes in slices
+		std::sort(gathered.begin(), gathered.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+		std::vector<uint32_t> entities(gathered.size());
+		std::vector<const T*> components(gathered.size());
+		for (size_t i = 0; i < gathered.size(); i++) {
+			entities[i] = gathered[i].first;
+			components[i] = gathered[i].second;
+		}
+
+		// Write header, size is patched once the chunk is complete
+		size_t headerOffset = writer.reserve(sizeof(ChunkHeader));
+		size_t start = writer.buffer.size();
+
+		// Write entity index column and one column per member
+		writer.bytes(entities.data(), entities.size() * sizeof(uint32_t));
+		writeColumns(writer, assets, components);
+
+		ChunkHeader header{ reflected<T>().id, static_cast<uint32_t>(components.size()), writer.buffer.size() - start };
+		std::memcpy(writer.buffer.data() + headerOffset, &header, sizeof(ChunkHeader));
+		nChunks++;
+	}
+
+	// Reads the chunk of a component type if the chunk header matches it, returns if it did
+	template <typename T>
+	bool readChunk(Reader& reader, AssetReadTable& assets, const ChunkHeader& header, uint32_t nEntities, SceneColumn<T>& column)
+	{
+		if (header.type != reflected<T>().id) return false;
+
+		// Read entity index column
+		column.entities.resize(header.count);
+		const uint8_t* in = reader.skip(header.count * sizeof(uint32_t));
+		if (!in) return true;
+		std::memcpy(column.entities.data(), in, header.count * sizeof(uint32_t));
+
+		// Validate entity indices, components are stored in scene order
+		for (size_t i = 0; i < column.entities.size(); i++) {
+			if (column.entities[i] >= nEntities || (i > 0 && column.entities[i] <= column.entities[i - 1])) {
+				reader.failed = true;
+				return true;
+			}
+		}
+
+		// Read member columns
+		column.components.resize(header.count);
+		readColumns(reader, assets, column.components);
+
+		return true;
+	}
+
+	//
+	// SERIALIZATION
+	//
+
+	bool write(const FS::Path& path, ECS& ecs, const SceneAssetResolver& assets)
+	{
+		ECSReflection::registerAll();
+
+		//
+		// ORDER ENTITIES
+		// Breadth first through the hierarchy, parents always precede their children
+		//
+
+		std::vector<Entity> entities;
+		for (auto [entity, transform] : ecs.view<TransformComponent>().each()) {
+			if (transform.parent == entt::null) entities.push_back(entity);
+		}
+		for (size_t i = 0; i < entities.size(); i++) {
+			const std::vector<Entity>& children = ecs.get<HierarchyComponent>(entities[i]).children;
+			entities.insert(entities.end(), children.begin(), children.end());
+		}
+
+		// Map entities to their scene index
+		std::vector<uint32_t> indices;
+		for (uint32_t i = 0; i < entities.size(); i++) {
+			uint32_t slot = entt::to_entity(entities[i]);
+			if (slot >= indices.size()) indices.resize(slot + 1, UINT32_MAX);
+			indices[slot] = i;
+		}
+
+		uint32_t nEntities = static_cast<uint32_t>(entities.size());
+		uint32_t nChunks = 0;
+
+		Writer chunks;
+		AssetWriteTable assetTable(assets);
+
+		//
+		// TRANSFORM CHUNK
+		//
+
+		{
+			std::vector<const TransformComponent*> transforms(nEntities);
+			std::vector<const std::string*> names(nEntities);
+			std::vector<uint32_t> parents(nEntities);
+			std::vector<uint32_t> nameLengths(nEntities);
+			size_t nameBytes = 0;
+			for (uint32_t i = 0; i < nEntities; i++) {
+				const TransformComponent& transform = ecs.get<TransformComponent>(entities[i]);
+				const std::string& name = ecs.get<IdentityComponent>(entities[i]).name;
+				transforms[i] = &transform;
+				names[i] = &name;
+				parents[i] = transform.parent == entt::null ? SceneData::NO_PARENT : indices[entt::to_entity(transform.parent)];
+				nameLengths[i] = static_cast<uint32_t>(name.size());
+				nameBytes += name.size();
+			}
+
+			size_t headerOffset = chunks.reserve(sizeof(ChunkHeader));
+			size_t start = chunks.buffer.size();
+
+			chunks.bytes(parents.data(), parents.size() * sizeof(uint32_t));
+			writeColumns(chunks, assetTable, transforms);
+
+			// Names are stored as length column followed by all characters
+			chunks.bytes(nameLengths.data(), nameLengths.size() * sizeof(uint32_t));
+			size_t namesOffset = chunks.reserve(nameBytes);
+			uint8_t* out = chunks.buffer.data() + namesOffset;
+			for (const std::string* name : names) {
+				std::memcpy(out, name->data(), name->size());
+				out += name->size();
+			}
+
+			ChunkHeader header{ TRANSFORM_CHUNK, nEntities, chunks.buffer.size() - start };
+			std::memcpy(chunks.buffer.data() + headerOffset, &header, sizeof(ChunkHeader));
+			nChunks++;
+		}
+
+		//
+		// COMPONENT CHUNKS
+		//
+
+		// Same component types as decoded scenes hold
+		decltype(SceneData::columns) columns;
+		std::apply([&](auto&... column) {
+			(writeChunk<typename std::decay_t<decltype(column.components)>::value_type>(chunks, assetTable, ecs, indices, nChunks), ...);
+			}, columns);
+
+		//
+		// ASSEMBLE FILE
+		// Asset table is written first so it's available when reading component chunks
+		//
+
+		Writer file;
+		file.value(FileHeader{ MAGIC, VERSION, nEntities, nChunks + 1 });
+		file.value(ChunkHeader{ ASSET_CHUNK, static_cast<uint32_t>(assetTable.guids.size()), assetTable.guids.size() * 16 });
+		for (const XG::GUID& guid : assetTable.guids) {
+			file.bytes(guid.bytes().data(), 16);
+		}
+		file.bytes(chunks.buffer.data(), chunks.buffer.size());
+
+		std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+		if (!stream) {
+			Console::out::warning("Scene Serializer", "Couldn't open scene file for writing", path.string());
+			return false;
+		}
+		stream.write(reinterpret_cast<const char*>(file.buffer.data()), static_cast<std::streamsize>(file.buffer.size()));
+
+		return static_cast<bool>(stream);
+	}
+
+	bool read(const FS::Path& path, SceneData& data, const SceneAssetResolver& assets)
+	{
+		ECSReflection::registerAll();
+
+		data = SceneData();
+
+		// Read whole file at once
+		std::ifstream stream(path, std::ios::binary | std::ios::ate);
+		if (!stream) {
+			Console::out::warning("Scene Serializer", "Couldn't open scene file", path.string());
+			return false;
+		}
+		std::vector<uint8_t> file(static_cast<size_t>(stream.tellg()));
+		stream.seekg(0);
+		stream.read(reinterpret_cast<char*>(file.data()), static_cast<std::streamsize>(file.size()));
+
+		Reader reader(file.data(), file.size());
+
+		// Validate header
+		FileHeader fileHeader = reader.value<FileHeader>();
+		if (reader.failed || fileHeader.magic != MAGIC || fileHeader.version != VERSION) {
+			Console::out::warning("Scene Serializer", "Invalid scene file or unsupported version", path.string());
+			return false;
+		}
+
+		uint32_t nEntities = fileHeader.nEntities;
+		AssetReadTable assetTable(assets);
+		bool hasTransforms = false;
+
+		for (uint32_t chunk = 0; chunk < fileHeader.nChunks && !reader.failed; chunk++) {
+			ChunkHeader header = reader.value<ChunkHeader>();
+			if (reader.failed || header.size > static_cast<uint64_t>(reader.end - reader.cursor)) {
+				reader.failed = true;
+				break;
+			}
+
+			// Chunk is read by its own reader, making sure it can't exceed its bounds
+			Reader chunkReader(reader.skip(static_cast<size_t>(header.size)), static_cast<size_t>(header.size));
+
+			// Asset guid table
+			if (header.type == ASSET_CHUNK) {
+				assetTable.guids.reserve(header.count);
+				for (uint32_t i = 0; i < header.count && !chunkReader.failed; i++) {
+					assetTable.guids.emplace_back(chunkReader.value<std::array<unsigned char, 16>>());
+				}
+			}
+			// Transforms of all entities
+			else if (header.type == TRANSFORM_CHUNK) {
+				if (header.count != nEntities) {
+					chunkReader.failed = true;
+				}
+				else {
+					hasTransforms = true;
+					data.transforms.resize(nEntities);
+					data.parents.resize(nEntities);
+					data.names.resize(nEntities);
+
+					// Parents must precede their children
+					const uint8_t* in = chunkReader.skip(nEntities * sizeof(uint32_t));
+					if (in) std::memcpy(data.parents.data(), in, nEntities * sizeof(uint32_t));
+					for (uint32_t i = 0; i < nEntities && in; i++) {
+						if (data.parents[i] != SceneData::NO_PARENT && data.parents[i] >= i) chunkReader.failed = true;
+					}
+
+					readColumns(chunkReader, assetTable, data.transforms);
+
+					// Names
+					std::vector<uint32_t> nameLengths(nEntities);
+					in = chunkReader.skip(nEntities * sizeof(uint32_t));
+					if (in) std::memcpy(nameLengths.data(), in, nEntities * sizeof(uint32_t));
+					for (uint32_t i = 0; i < nEntities && !chunkReader.failed; i++) {
+						const uint8_t* name = chunkReader.skip(nameLengths[i]);
+						if (name) data.names[i].assign(reinterpret_cast<const char*>(name), nameLengths[i]);
+					}
+				}
+			}
+			// Component chunks, unknown types are skipped
+			else {
+				std::apply([&](auto&... column) {
+					(readChunk(chunkReader, assetTable, header, nEntities, column) || ...);
+					}, data.columns);
+			}
+
+			if (chunkReader.failed) reader.failed = true;
+		}
+
+		if (reader.failed || !hasTransforms) {
+			Console::out::warning("Scene Serializer", "Scene file is corrupted", path.string());
+			data = SceneData();
+			return false;
+		}
+
+		return true;
+	}
+
+	void beginInsert(ECS& ecs, SceneData& data, SceneInsertion& insertion)
+	{
+		uint32_t nEntities = data.nEntities();
+
+		// Create all entity handles at once, they only become visible once their components are inserted
+		insertion.entities = ecs.createEntities(nEntities);
+		insertion.nInserted = 0;
+		insertion.cursors.fill(0);
+
+		// Resolve parents and depths in a single pass, parents precede their children
+		for (uint32_t i = 0; i < nEntities; i++) {
+			uint32_t parent = data.parents[i];
+			if (parent == SceneData::NO_PARENT) continue;
+
+			TransformComponent& transform = data.transforms[i];
+			transform.parent = insertion.entities[parent];
+			transform.depth = data.transforms[parent].depth + 1;
+		}
+	}
+
+	bool insertSlice(ECS& ecs, SceneData& data, SceneInsertion& insertion, uint32_t maxEntities)
+	{
+		uint32_t nEntities = data.nEntities();
+		uint32_t first = insertion.nInserted;
+		uint32_t last = first + std::min(maxEntities, nEntities - first);
+		if (first == last) return insertion.nInserted == nEntities;
+
+		const std::vector<Entity>& entities = insertion.entities;
+
+		ecs.beginBatch();
+
+		// Insert transforms of slice at once
+		ecs.insertTransforms(entities.begin() + first, entities.begin() + last, data.transforms.begin() + first, data.names.begin() + first);
+
+		// Link children to their parents, parents were inserted by this or a previous slice
+		for (uint32_t i = first; i < last; i++) {
+			uint32_t parent = data.parents[i];
+			if (parent == SceneData::NO_PARENT) continue;
+			ecs.get<HierarchyComponent>(entities[parent]).children.push_back(entities[i]);
+		}
+
+		// Insert components of slice at once per type, columns are sorted by entity index
+		std::vector<Entity> targets;
+		size_t columnIndex = 0;
+		std::apply([&](auto&... column) {
+			([&](auto& column) {
+				using T = typename std::decay_t<decltype(column.components)>::value_type;
+				size_t& cursor = insertion.cursors[columnIndex++];
+
+				size_t begin = cursor;
+				while (cursor < column.entities.size() && column.entities[cursor] < last) cursor++;
+				if (begin == cursor) return;
+
+				targets.resize(cursor - begin);
+				for (size_t i = 0; i < targets.size(); i++) {
+					targets[i] = entities[column.entities[begin + i]];
+				}
+				ecs.insert<T>(targets.begin(), targets.end(), column.components.begin() + begin);
+				}(column), ...);
+			}, data.columns);
+
+		ecs.endBatch();
+
+		insertion.nInserted = last;
+		return last == nEntities;
+	}
+
+	std::vector<Entity> insert(ECS& ecs, SceneData& data)
+	{
+		SceneInsertion insertion;
+		beginInsert(ecs, data, insertion);
+		insertSlice(ecs, data, insertion, data.nEntities());
+
+		data = SceneData();
+		return std::move(insertion.entities);
+	}
+
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+#include <ecs/ecs.h>
+#include <utils/guid.h>
+#include <utils/fsutil.h>
+
+// Maps asset references of components to guids and back, unset functions map to an invalid guid or no asset
+struct SceneAssetResolver {
+
+	std::function<XG::GUID(const Mesh*)> meshToGUID;
+	std::function<const Mesh* (const XG::GUID&)> meshFromGUID;
+
+	std::function<XG::GUID(const IMaterial*)> materialToGUID;
+	std::function<const IMaterial* (const XG::GUID&)> materialFromGUID;
+
+	std::function<XG::GUID(const ResourceRef<AudioClip>&)> audioClipToGUID;
+	std::function<ResourceRef<AudioClip>(const XG::GUID&)> audioClipFromGUID;
+
+};
+
+// Components of a single type decoded from a scene
+template <typename T>
+struct SceneColumn {
+
+	// Index of the entity each component belongs to
+	std::vector<uint32_t> entities;
+
+	// Decoded components
+	std::vector<T> components;
+
+};
+
+// Scene decoded from a scene file, independent of any registry
+struct SceneData {
+
+	// Parent index of root entities
+	static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+	// Transform of each entity, parents always precede their children
+	std::vector<TransformComponent> transforms;
+
+	// Index of each entities parent
+	std::vector<uint32_t> parents;
+
+	// Name of each entity
+	std::vector<std::string> names;
+
+	// All other components
+	std::tuple<
+		SceneColumn<MeshRendererComponent>,
+		SceneColumn<CameraComponent>,
+		SceneColumn<DirectionalLightComponent>,
+		SceneColumn<PointLightComponent>,
+		SceneColumn<SpotlightComponent>,
+		SceneColumn<VelocityBlurComponent>,
+		SceneColumn<BoxColliderComponent>,
+		SceneColumn<SphereColliderComponent>,
+		SceneColumn<RigidbodyComponent>,
+		SceneColumn<AudioListenerComponent>,
+		SceneColumn<AudioSourceComponent>
+	> columns;
+
+	// Returns the amount of entities
+	uint32_t nEntities() const { return static_cast<uint32_t>(transforms.size()); }
+
+};
+
+// Progress of inserting a decoded scene into an ecs in slices
+struct SceneInsertion {
+
+	// Entity of each scene index
+	std::vector<Entity> entities;
+
+	// Amount of entities inserted so far, entities are inserted in scene order
+	uint32_t nInserted = 0;
+
+	// Next component of each column to insert
+	std::array<size_t, std::tuple_size_v<decltype(SceneData::columns)>> cursors{};
+
+};
+
+namespace SceneSerializer {
+
+	// Writes all entities of an ecs to a binary scene file, returns success
+	bool write(const FS::Path& path, ECS& ecs, const SceneAssetResolver& assets);
+
+	// Reads a binary scene file, returns success (thread safe as long as the asset resolver is)
+	bool read(const FS::Path& path, SceneData& data, const SceneAssetResolver& assets);
+
+	// Prepares inserting a decoded scene into an ecs in slices, creates all entity handles
+	void beginInsert(ECS& ecs, SceneData& data, SceneInsertion& insertion);
+
+	// Moves up to the given amount of entities of a decoded scene into an ecs, returns if all entities were inserted
+	bool insertSlice(ECS& ecs, SceneData& data, SceneInsertion& insertion, uint32_t maxEntities);
+
+	// Moves all entities of a decoded scene into an ecs, returns the created entities in scene order
+	std::vector<Entity> insert(ECS& ecs, SceneData& data);
+
+}
@@ -1,11 +0,0 @@
-#version 330 core 
-
-out vec4 FragColor;
-
-in vec2 v_uv;
-
-uniform vec4 color;
-
-void main() {
-    FragColor = color;
-}
\ No newline at end of file
@@ -1,14 +1,14 @@
-#version 330 core 
+#version 460 core 
 
 out vec4 FragColor;
 
 in vec2 v_uv;
+in float v_alpha;
 
 uniform sampler2D icon;
 uniform vec3 tint;
-uniform float alpha;
 
 void main() {
-    vec4 color = texture(icon, v_uv).rgba * vec4(tint, alpha);
+    vec4 color = texture(icon, v_uv).rgba * vec4(tint, v_alpha);
     FragColor = color;
 }
\ No newline at end of file
@@ -1,15 +1,33 @@
-#version 330 core
+#version 460 core
 
-layout(location = 0) in vec3 position_in;
-layout(location = 2) in vec2 uv_in;
+struct IconInstance {
+    mat4 mvpMatrix;
+    vec4 alpha; // x: depth tested alpha, y: foreground alpha
+};
 
-uniform mat4 mvpMatrix;
+// Camera facing billboards of all icons
+layout(std430, binding = 0) readonly buffer IconBuffer {
+    IconInstance icons[];
+};
+
+// If icons are drawn on top of everything
+uniform int foregroundPass;
 
 out vec2 v_uv;
+out float v_alpha;
+
+const vec2 corners[6] = vec2[](
+    vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0),
+    vec2(-1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0)
+);
 
 void main() 
 {
-    v_uv = uv_in;
+    IconInstance icon = icons[gl_BaseInstance + gl_InstanceID];
+    vec2 corner = corners[gl_VertexID];
+
+    v_uv = corner * 0.5 + 0.5;
+    v_alpha = foregroundPass == 1 ? icon.alpha.y : icon.alpha.x;
 
-    gl_Position = mvpMatrix * vec4(position_in, 1.0);
+    gl_Position = icon.mvpMatrix * vec4(corner, 0.0, 1.0);
 }
@@ -0,0 +1,9 @@
+#version 460 core 
+
+out vec4 FragColor;
+
+in vec4 v_color;
+
+void main() {
+    FragColor = v_color;
+}
\ No newline at end of file
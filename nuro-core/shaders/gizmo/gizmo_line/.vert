@@ -0,0 +1,27 @@
+#version 460 core
+
+struct LineVertex {
+    vec4 position;
+    vec4 color;
+};
+
+// World space line vertices of all gizmo shapes
+layout(std430, binding = 0) readonly buffer LineBuffer {
+    LineVertex vertices[];
+};
+
+uniform mat4 viewProjectionMatrix;
+
+// Replaces the alpha of all vertices if not negative
+uniform float alphaOverride;
+
+out vec4 v_color;
+
+void main() 
+{
+    LineVertex vertex = vertices[gl_VertexID];
+
+    v_color = vec4(vertex.color.rgb, alphaOverride < 0.0 ? vertex.color.a : alphaOverride);
+
+    gl_Position = viewProjectionMatrix * vec4(vertex.position.xyz, 1.0);
+}
@@ -0,0 +1,10 @@
+struct DrawData {
+    mat4 modelMatrix;
+    mat4 mvpMatrix;
+    mat4 normalMatrix;
+};
+
+// Per instance data of batched (and instanced) draws, indexed by base instance + instance id
+layout(std430, binding = 0) readonly buffer DrawBuffer {
+    DrawData draws[];
+};
@@ -1,4 +1,4 @@
-#version 330 core
+#version 460 core
 
 #define PI 3.14159265359
 
@@ -7,9 +7,13 @@
 #define EXPONENTIAL_FOG 2
 #define EXPONENTIAL_SQUARED_FOG 3
 
-#define MAX_DIRECTIONAL_LIGHTS 1
-#define MAX_POINT_LIGHTS 15
-#define MAX_SPOT_LIGHTS 8
+#define CLUSTER_GRID_X 16
+#define CLUSTER_GRID_Y 9
+#define CLUSTER_GRID_Z 24
+
+#define MAX_CASCADES 4
+
+// Feature toggles are compiled into variants (see LitVariant), each LIT_* define enables one feature
 
 out vec4 FragColor;
 
@@ -31,7 +35,6 @@ struct Configuration {
     vec2 viewportResolution;
 
     // Shadow parameters
-    bool castShadows;
     sampler2D shadowMap;
     float shadowMapResolutionWidth;
     float shadowMapResolutionHeight;
@@ -46,22 +49,27 @@ struct Configuration {
 
     // Lighting parameters
     int numDirectionalLights;
-    int numPointLights;
-    int numSpotLights;
 
     // SSAO
-    bool enableSSAO;
     sampler2D ssaoBuffer;
 };
 uniform Configuration configuration;
 
+struct Cascades {
+    sampler2DArray shadowMap;
+    float resolution;
+    mat4 cameraView;
+    mat4 lightSpaces[MAX_CASCADES];
+    float splits[MAX_CASCADES];
+};
+uniform Cascades cascades;
+
 struct DirectionalLight {
     float intensity;
     vec3 direction;
     vec3 color;
     vec3 position; // boilerplate for directional shadows
 };
-uniform DirectionalLight directionalLights[MAX_DIRECTIONAL_LIGHTS];
 
 struct PointLight {
     vec3 position;
@@ -70,7 +78,6 @@ struct PointLight {
     float range;
     float falloff;
 };
-uniform PointLight pointLights[MAX_POINT_LIGHTS];
 
 struct Spotlight {
     vec3 position;
@@ -82,7 +89,57 @@ struct Spotlight {
     float innerCos;
     float outerCos;
 };
-uniform Spotlight spotlights[MAX_SPOT_LIGHTS];
+
+// Packed directional light (direction.w: intensity)
+struct DirectionalLightData {
+    vec4 direction;
+    vec4 color;
+    vec4 position;
+};
+layout(std430, binding = 5) readonly buffer DirectionalLightBuffer {
+    DirectionalLightData directionalLightData[];
+};
+
+// Packed point light (position.w: range, color.a: intensity, parameters.x: falloff)
+struct PointLightData {
+    vec4 position;
+    vec4 color;
+    vec4 parameters;
+};
+layout(std430, binding = 1) readonly buffer PointLightBuffer {
+    PointLightData pointLightData[];
+};
+
+// Packed spotlight (position.w: range, color.a: intensity, direction.w: falloff, cone.xy: inner and outer cosine)
+struct SpotlightData {
+    vec4 position;
+    vec4 color;
+    vec4 direction;
+    vec4 cone;
+};
+layout(std430, binding = 2) readonly buffer SpotlightBuffer {
+    SpotlightData spotlightData[];
+};
+
+// Lights of a cluster within the light index list, point light indices are followed by spotlight indices
+struct Cluster {
+    uint offset;
+    uint nPointLights;
+    uint nSpotlights;
+    uint padding;
+};
+layout(std430, binding = 3) readonly buffer ClusterBuffer {
+    Cluster clusterData[];
+};
+layout(std430, binding = 4) readonly buffer LightIndexBuffer {
+    uint lightIndices[];
+};
+
+struct Clusters {
+    float near;
+    float far;
+};
+uniform Clusters clusters;
 
 struct Fog {
     int type;
@@ -97,31 +154,23 @@ struct Material {
     vec2 tiling;
     vec2 offset;
 
-    bool enableAlbedoMap;
     sampler2D albedoMap;
 
     float roughness;
-    bool enableRoughnessMap;
     sampler2D roughnessMap;
 
     float metallic;
-    bool enableMetallicMap;
     sampler2D metallicMap;
 
-    bool enableNormalMap;
     sampler2D normalMap;
     float normalMapIntensity;
 
-    bool enableOcclusionMap;
     sampler2D occlusionMap;
 
-    bool emission;
     float emissionIntensity;
     vec3 emissionColor;
-    bool enableEmissiveMap;
     sampler2D emissiveMap;
 
-    bool enableHeightMap;
     sampler2D heightMap;
     float heightMapScale;
 };
@@ -136,6 +185,62 @@ float sqr(float x)
     return x * x;
 }
 
+//
+// LIGHT CLUSTERS
+//
+
+// get cluster the fragment falls into
+Cluster getCluster() {
+    // get linear view depth of fragment
+    float ndcDepth = gl_FragCoord.z * 2.0 - 1.0;
+    float depth = (2.0 * clusters.near * clusters.far) / (clusters.far + clusters.near - ndcDepth * (clusters.far - clusters.near));
+
+    // depth slices are distributed exponentially between near and far
+    float slice = floor(log(depth / clusters.near) / log(clusters.far / clusters.near) * float(CLUSTER_GRID_Z));
+    uint z = uint(clamp(slice, 0.0, float(CLUSTER_GRID_Z - 1)));
+    uvec2 xy = uvec2(clamp(floor(gl_FragCoord.xy / configuration.viewportResolution * vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y)), vec2(0.0), vec2(CLUSTER_GRID_X - 1, CLUSTER_GRID_Y - 1)));
+
+    return clusterData[xy.x + xy.y * CLUSTER_GRID_X + z * CLUSTER_GRID_X * CLUSTER_GRID_Y];
+}
+
+// unpack point light at given index
+PointLight getPointLight(uint index) {
+    PointLightData data = pointLightData[index];
+    PointLight pointLight;
+    pointLight.position = data.position.xyz;
+    pointLight.range = data.position.w;
+    pointLight.color = data.color.rgb;
+    pointLight.intensity = data.color.a;
+    pointLight.falloff = data.parameters.x;
+    return pointLight;
+}
+
+// unpack directional light at given index
+DirectionalLight getDirectionalLight(int index) {
+    DirectionalLightData data = directionalLightData[index];
+    DirectionalLight directionalLight;
+    directionalLight.direction = data.direction.xyz;
+    directionalLight.intensity = data.direction.w;
+    directionalLight.color = data.color.rgb;
+    directionalLight.position = data.position.xyz;
+    return directionalLight;
+}
+
+// unpack spotlight at given index
+Spotlight getSpotlight(uint index) {
+    SpotlightData data = spotlightData[index];
+    Spotlight spotlight;
+    spotlight.position = data.position.xyz;
+    spotlight.range = data.position.w;
+    spotlight.color = data.color.rgb;
+    spotlight.intensity = data.color.a;
+    spotlight.direction = data.direction.xyz;
+    spotlight.falloff = data.direction.w;
+    spotlight.innerCos = data.cone.x;
+    spotlight.outerCos = data.cone.y;
+    return spotlight;
+}
+
 //
 // SHADOWING
 //
@@ -159,7 +264,9 @@ float getShadowBias(vec3 lightDirection) {
 float getShadowHard(vec3 lightDirection)
 {
     // make sure shadows are enabled
-    if (!configuration.castShadows) return 0.0;
+#ifndef LIT_SHADOWS
+    return 0.0;
+#endif
 
     // get shadow coordinates
     vec3 shadowCoords = getShadowCoords();
@@ -180,7 +287,9 @@ float getShadowHard(vec3 lightDirection)
 float getShadowSoft(vec3 lightDirection)
 {
     // make sure shadows are enabled
-    if (!configuration.castShadows) return 0.0;
+#ifndef LIT_SHADOWS
+    return 0.0;
+#endif
 
     // get shadow coordinates
     vec3 shadowCoords = getShadowCoords();
@@ -274,6 +383,55 @@ float getShadowSoft(vec3 lightDirection)
     return shadow;
 }
 
+// get index of cascade covering fragment, -1 if fragment is beyond all cascades
+int getCascade() {
+    float depth = -(cascades.cameraView * vec4(v_fragmentWorldPosition, 1.0)).z;
+    for (int i = 0; i < MAX_CASCADES; i++) {
+        if (depth < cascades.splits[i]) return i;
+    }
+    return -1;
+}
+
+// get shadow casted by directional light using cascaded shadow maps
+float getCascadedShadow(vec3 lightDirection, bool soft)
+{
+    // make sure cascaded shadows are enabled
+#ifndef LIT_CASCADED_SHADOWS
+    return 0.0;
+#endif
+
+    // get cascade of fragment
+    int cascade = getCascade();
+    if (cascade < 0) return 0.0;
+
+    // get shadow coordinates within cascade
+    vec4 lightSpacePosition = cascades.lightSpaces[cascade] * vec4(v_fragmentWorldPosition, 1.0);
+    vec3 shadowCoords = lightSpacePosition.xyz / lightSpacePosition.w * 0.5 + 0.5;
+
+    // if shadow coordinate's depth is beyond 1.0, fragment isn't in shadow
+    if (shadowCoords.z > 1.0) return 0.0;
+
+    // slope scaled bias, grows with cascade as texels cover more world space
+    float bias = max(0.0005 * (1.0 - dot(normal, lightDirection)), 0.00005) * float(cascade + 1);
+
+    // single sample for hard shadows
+    if (!soft) {
+        float depth = texture(cascades.shadowMap, vec3(shadowCoords.xy, cascade)).r;
+        return shadowCoords.z - bias > depth ? 1.0 : 0.0;
+    }
+
+    // 3x3 percentage closer filtering for soft shadows
+    float texelSize = 1.0 / cascades.resolution;
+    float sum = 0.0;
+    for (int x = -1; x <= 1; x++) {
+        for (int y = -1; y <= 1; y++) {
+            float depth = texture(cascades.shadowMap, vec3(shadowCoords.xy + vec2(x, y) * texelSize, cascade)).r;
+            sum += shadowCoords.z - bias > depth ? 1.0 : 0.0;
+        }
+    }
+    return sum / 9.0;
+}
+
 //
 // FOG
 //
@@ -569,9 +727,9 @@ vec2 getUv() {
     vec2 _uv = v_uv * material.tiling + material.offset;
 
     // height map enabled, transform texture coordinates by heightmap
-    if (material.enableHeightMap) {
-        _uv = POM_getUv(_uv);
-    }
+#ifdef LIT_HEIGHT_MAP
+    _uv = POM_getUv(_uv);
+#endif
 
     // return texture coordinates
     return _uv;
@@ -580,9 +738,9 @@ vec2 getUv() {
 // get normal vector
 vec3 getNormal() {
     // no normal mapping, return input normal
-    if (!material.enableNormalMap) {
-        return v_normal;
-    }
+#ifndef LIT_NORMAL_MAP
+    return v_normal;
+#endif
 
     // normal mapping enabled
 
@@ -609,10 +767,10 @@ vec3 getAlbedo()
     vec3 albedo = vec3(1.0);
 
     // sample albedo map if enabled
-    if (material.enableAlbedoMap) {
-        vec3 albedoSample = texture(material.albedoMap, uv).rgb;
-        albedo = pow(albedoSample, vec3(configuration.gamma));
-    }
+#ifdef LIT_ALBEDO_MAP
+    vec3 albedoSample = texture(material.albedoMap, uv).rgb;
+    albedo = pow(albedoSample, vec3(configuration.gamma));
+#endif
 
     // tint albedo by materials base color
     albedo *= vec3(material.baseColor);
@@ -628,12 +786,12 @@ float getRoughness()
     float roughness = 0.0;
 
     // roughness map enabled, sample roughness by roughness map
-    if (material.enableRoughnessMap) {
-        roughness = texture(material.roughnessMap, uv).r;
-        // no roughness map, set to materials roughness property
-    } else {
-        roughness = material.roughness;
-    }
+#ifdef LIT_ROUGHNESS_MAP
+    roughness = texture(material.roughnessMap, uv).r;
+#else
+    // no roughness map, set to materials roughness property
+    roughness = material.roughness;
+#endif
 
     // return roughness
     return roughness;
@@ -646,12 +804,12 @@ float getMetallic()
     float metallic = 0.0;
 
     // metallic map enabled, sample metallic by metallic map
-    if (material.enableMetallicMap) {
-        metallic = texture(material.metallicMap, uv).r;
-        // no metallic map, set to materials metallic property
-    } else {
-        metallic = material.metallic;
-    }
+#ifdef LIT_METALLIC_MAP
+    metallic = texture(material.metallicMap, uv).r;
+#else
+    // no metallic map, set to materials metallic property
+    metallic = material.metallic;
+#endif
 
     // return metallic
     return metallic;
@@ -664,9 +822,9 @@ float getOcclusionMapSample()
     float occlusionMapSample = 1.0;
 
     // occlusion map enabled, sample by occlusion map
-    if (material.enableOcclusionMap) {
-        occlusionMapSample = texture(material.occlusionMap, uv).r;
-    }
+#ifdef LIT_OCCLUSION_MAP
+    occlusionMapSample = texture(material.occlusionMap, uv).r;
+#endif
 
     // return occlusion map sample
     return occlusionMapSample;
@@ -678,9 +836,9 @@ float getSSAO() {
     float ssao = 1.0;
 
     // ssao enabled, sample by ssao buffer
-    if (configuration.enableSSAO) {
-        ssao = texture(configuration.ssaoBuffer, viewportUv).r;
-    }
+#ifdef LIT_SSAO
+    ssao = texture(configuration.ssaoBuffer, viewportUv).r;
+#endif
 
     // return ssao sample
     return ssao;
@@ -689,17 +847,17 @@ float getSSAO() {
 // get emission color
 vec3 getEmission() {
     // return zero if emission isnt enabled
-    if (!material.emission) {
-        return vec3(0.0);
-    }
+#ifndef LIT_EMISSION
+    return vec3(0.0);
+#endif
 
     // get emission by intensity and color
     vec3 emission = vec3(material.emissionIntensity) * material.emissionColor;
 
     // emissive map enabled, tint emission by emissive map sample
-    if (material.enableEmissiveMap) {
-        emission *= texture(material.emissiveMap, uv).rgb;
-    }
+#ifdef LIT_EMISSIVE_MAP
+    emission *= texture(material.emissiveMap, uv).rgb;
+#endif
 
     // return emission
     return emission;
@@ -784,13 +942,13 @@ vec4 shadePBR() {
 
         for (int i = 0; i < configuration.numDirectionalLights; i++)
         {
-            DirectionalLight directionalLight = directionalLights[i];
+            DirectionalLight directionalLight = getDirectionalLight(i);
 
             float attenuation = 1.0;
             vec3 L = normalize(-directionalLight.direction);
 
             float shadow = 0.0;
-            //shadow += getShadowSoft(L);
+            if (i == 0) shadow += getCascadedShadow(L, true);
            
             // PARALLAX OCCLUSION MAPPED SHADOW FOR DIRECTIONAL LIGHT //
             /*if (material.enableHeightMap && i == 0) {
@@ -816,8 +974,17 @@ vec4 shadePBR() {
         // POINT LIGHTS
         //
 
-        for (int i = 0; i < configuration.numPointLights; i++) {
-            PointLight pointLight = pointLights[i];
+        // get lights affecting fragments cluster
+        Cluster cluster;
+        cluster.offset = 0;
+        cluster.nPointLights = 0;
+        cluster.nSpotlights = 0;
+#ifdef LIT_LIGHT_CLUSTERS
+        cluster = getCluster();
+#endif
+
+        for (uint i = 0; i < cluster.nPointLights; i++) {
+            PointLight pointLight = getPointLight(lightIndices[cluster.offset + i]);
 
             float distance = length(pointLight.position - v_fragmentWorldPosition);
             float attenuation = getAttenuation_range_falloff_cusp(distance, pointLight.range, pointLight.falloff);
@@ -848,8 +1015,8 @@ vec4 shadePBR() {
         // SPOT LIGHTS
         //
 
-        for (int i = 0; i < configuration.numSpotLights; i++) {
-            Spotlight spotlight = spotlights[i];
+        for (uint i = 0; i < cluster.nSpotlights; i++) {
+            Spotlight spotlight = getSpotlight(lightIndices[cluster.offset + cluster.nPointLights + i]);
 
             float distance = length(spotlight.position - v_fragmentWorldPosition);
             float attenuation = getAttenuation_range_falloff_cusp(distance, spotlight.range, spotlight.falloff);
@@ -889,9 +1056,9 @@ vec4 shadePBR() {
     color *= occlusionMapSample * ssao;
 
     // gamma correct if using albedo map
-    if (material.enableAlbedoMap) {
-        color = pow(color, vec3(1.0 / configuration.gamma));
-    }
+#ifdef LIT_ALBEDO_MAP
+    color = pow(color, vec3(1.0 / configuration.gamma));
+#endif
 
     // get fog
     float fogFactor = 1.0;
@@ -922,21 +1089,21 @@ vec4 shadeSolid()
 
     for (int i = 0; i < configuration.numDirectionalLights; i++)
     {
-        DirectionalLight directionalLight = directionalLights[i];
+        DirectionalLight directionalLight = getDirectionalLight(i);
 
         float attenuation = 1.0;
         vec3 L = normalize(-directionalLight.direction);
 
         vec3 shadowDirection = normalize(directionalLight.position - v_fragmentWorldPosition);
-        float shadow = getShadowHard(L);
+        float shadow = i == 0 ? getCascadedShadow(L, false) : 0.0;
 
         diffuse += max(dot(N, L), 0.0) * directionalLight.color * directionalLight.intensity * attenuation * (1.0 - shadow);
     }
 
     vec3 albedo = vec3(1.0);
-    if (material.enableAlbedoMap) {
-        albedo = texture(material.albedoMap, uv).rgb;
-    }
+#ifdef LIT_ALBEDO_MAP
+    albedo = texture(material.albedoMap, uv).rgb;
+#endif
     albedo *= vec3(material.baseColor);
 
     vec3 color = diffuse * albedo;
@@ -1,4 +1,4 @@
-#version 330 core
+#version 460 core
 
 layout(location = 0) in vec3 position_in;
 layout(location = 1) in vec3 normal_in;
@@ -6,11 +6,13 @@ layout(location = 2) in vec2 uv_in;
 layout(location = 3) in vec3 tangent_in;
 layout(location = 4) in vec3 bitangent_in;
 
-uniform mat4 mvpMatrix;
-uniform mat4 modelMatrix;
-uniform mat3 normalMatrix;
+#include "draw_data.glsl"
+
 uniform mat4 lightSpaceMatrix;
 
+mat4 modelMatrix;
+mat3 normalMatrix;
+
 out vec3 v_normal;
 out vec2 v_uv;
 out mat3 v_tbn;
@@ -18,6 +20,9 @@ out mat3 v_tbnTransposed;
 out vec3 v_fragmentWorldPosition;
 out vec4 v_fragmentLightSpacePosition;
 
+// Matches the forward depth pre pass bit for bit so it can be depth tested with GL_EQUAL
+invariant gl_Position;
+
 vec3 getNormal() {
     return normalize(normalMatrix * normal_in);
 }
@@ -39,6 +44,10 @@ vec4 getFragmentLightSpacePosition() {
 
 void main()
 {
+    DrawData draw = draws[gl_BaseInstance + gl_InstanceID];
+    modelMatrix = draw.modelMatrix;
+    normalMatrix = mat3(draw.normalMatrix);
+
     v_normal = getNormal();
     v_uv = uv_in;
     v_tbn = getTBNMatrix();
@@ -46,5 +55,5 @@ void main()
     v_fragmentWorldPosition = getFragmentWorldPosition();
     v_fragmentLightSpacePosition = getFragmentLightSpacePosition();
 
-    gl_Position = mvpMatrix * vec4(position_in, 1.0);
+    gl_Position = draw.mvpMatrix * vec4(position_in, 1.0);
 }
\ No newline at end of file
@@ -1,15 +1,20 @@
-#version 330 core
+#version 460 core
 
 layout(location = 0) in vec3 position_in;
 layout(location = 2) in vec2 uv_in;
 
-uniform mat4 mvpMatrix;
+#include "draw_data.glsl"
 
 out vec2 v_uv;
 
+// Matches the forward depth pre pass bit for bit so it can be depth tested with GL_EQUAL
+invariant gl_Position;
+
 void main()
 {
+    DrawData draw = draws[gl_BaseInstance + gl_InstanceID];
+
     v_uv = uv_in;
 
-    gl_Position = mvpMatrix * vec4(position_in, 1.0);
+    gl_Position = draw.mvpMatrix * vec4(position_in, 1.0);
 }
@@ -0,0 +1,13 @@
+#version 460 core
+
+layout(location = 0) in vec3 position_in;
+
+#include "draw_data.glsl"
+
+// Must match material shaders bit for bit, they're depth tested against this output with GL_EQUAL
+invariant gl_Position;
+
+void main()
+{
+    gl_Position = draws[gl_BaseInstance + gl_InstanceID].mvpMatrix * vec4(position_in, 1.0);
+}
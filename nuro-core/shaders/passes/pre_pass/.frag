@@ -1,16 +1,33 @@
 #version 330 core
 
-out vec4 FragColor;
+layout(location = 0) out vec4 FragColor;
+layout(location = 1) out vec4 VelocityColor;
 
 in vec3 v_viewNormal;
+in vec4 v_position;
+in vec4 v_previousPosition;
+
+uniform float velocityIntensity;
 
 vec3 encodeNormalOutput(vec3 normal) {
     // remap from [-1, 1] to [0, 1]
     return normal * 0.5 + 0.5;
 }
 
+vec2 getVelocity() {
+    vec2 current = v_position.xy / v_position.w;
+    vec2 previous = v_previousPosition.xy / v_previousPosition.w;
+    return (current - previous) * 0.5 * velocityIntensity;
+}
+
 void main()
 {
     // encode view space normal as color and set as output
     FragColor = vec4(encodeNormalOutput(v_viewNormal), 1.0);
+
+    // clip space w of a perspective projection is the negated view space depth
+    float viewSpaceDepth = -v_position.w;
+
+    // RED CHANNEL = x velocity | GREEN CHANNEL = y velocity | BLUE CHANNEL = view space depth
+    VelocityColor = vec4(getVelocity(), viewSpaceDepth, 1.0);
 }
@@ -4,9 +4,12 @@ layout(location = 0) in vec3 position_in;
 layout(location = 1) in vec3 normal_in;
 
 uniform mat4 mvpMatrix;
+uniform mat4 previousMvpMatrix;
 uniform mat3 viewNormalMatrix;
 
 out vec3 v_viewNormal;
+out vec4 v_position;
+out vec4 v_previousPosition;
 
 vec3 getViewNormal() {
     return normalize(viewNormalMatrix * normal_in);
@@ -15,5 +18,7 @@ vec3 getViewNormal() {
 void main()
 {
     v_viewNormal = getViewNormal();
-    gl_Position = mvpMatrix * vec4(position_in, 1.0);
+    v_position = mvpMatrix * vec4(position_in, 1.0);
+    v_previousPosition = previousMvpMatrix * vec4(position_in, 1.0);
+    gl_Position = v_position;
 }
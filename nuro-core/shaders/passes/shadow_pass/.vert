@@ -1,11 +1,11 @@
-#version 330 core
+#version 460 core
 
 layout(location = 0) in vec3 position_in;
 
-uniform mat4 lightSpaceMatrix;
-uniform mat4 modelMatrix;
+// Per instance data of batched shadow casters, mvp matrix holds the light space model matrix
+#include "draw_data.glsl"
 
 void main()
 {
-    gl_Position = lightSpaceMatrix * modelMatrix * vec4(position_in, 1.0);
+    gl_Position = draws[gl_BaseInstance + gl_InstanceID].mvpMatrix * vec4(position_in, 1.0);
 }
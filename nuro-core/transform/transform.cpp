@@ -41,6 +41,14 @@ namespace Transform {
 		transform.mvp = viewProjection * transform.model;
 	}
 
+	void step()
+	{
+		// Runs once per frame before anything moves, every pipeline rendering this frame sees the same previous transforms
+		for (auto [entity, transform] : ECS::main().view<TransformComponent>().each()) {
+			transform.previousModel = transform.model;
+		}
+	}
+
 	void _tmp_updateModel(TransformComponent& transform)
 	{
 		if (hasParent(transform)) {
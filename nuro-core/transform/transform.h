@@ -35,6 +35,9 @@ namespace Transform
 	// Updates a transforms model-view-projection matrix
 	void updateMvp(TransformComponent& transform, const glm::mat4& viewProjection);
 
+	// Caches the model matrix of every transform as its previous model matrix (handled by application context)
+	void step();
+
 	//
 	// TRANSFORMATION
 	//
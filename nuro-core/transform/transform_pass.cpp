@@ -11,32 +11,32 @@ void TransformPass::perform(glm::mat4 viewProjection)
 	// Evaluate transforms
 	for (auto [entity, transform] : ECS::main().view<TransformComponent>().each()) {
 		// Evaluate root node
-		if (Transform::isRoot(transform)) evaluate(transform);
+		if (Transform::isRoot(transform)) evaluate(entity, transform);
 
 		// Update transforms model-view-projection
 		Transform::updateMvp(transform, viewProjection);
 	}
 }
 
-void TransformPass::evaluate(TransformComponent& transform)
+void TransformPass::evaluate(Entity entity, TransformComponent& transform)
 {
 	if(transform.modified) Transform::evaluate(transform);
 
-	for (Entity child : transform.children) {
-		evaluate(ECS::main().get<TransformComponent>(child), transform, transform.modified);
+	for (Entity child : ECS::main().get<HierarchyComponent>(entity).children) {
+		evaluate(child, ECS::main().get<TransformComponent>(child), transform, transform.modified);
 	}
 
 	transform.modified = false;
 }
 
-void TransformPass::evaluate(TransformComponent& transform, TransformComponent& parent, bool propagateModified)
+void TransformPass::evaluate(Entity entity, TransformComponent& transform, TransformComponent& parent, bool propagateModified)
 {
 	if (propagateModified) transform.modified = true;
 
 	if(transform.modified) Transform::evaluate(transform, parent);
 
-	for (Entity child : transform.children) {
-		evaluate(ECS::main().get<TransformComponent>(child), transform, transform.modified);
+	for (Entity child : ECS::main().get<HierarchyComponent>(entity).children) {
+		evaluate(child, ECS::main().get<TransformComponent>(child), transform, transform.modified);
 	}
 
 	transform.modified = false; 
@@ -12,6 +12,6 @@ public:
 	void perform(glm::mat4 viewProjection);
 
 private:
-	void evaluate(TransformComponent& transform);
-	void evaluate(TransformComponent& transform, TransformComponent& parent, bool propagateModified);
+	void evaluate(Entity entity, TransformComponent& transform);
+	void evaluate(Entity entity, TransformComponent& transform, TransformComponent& parent, bool propagateModified);
 };
\ No newline at end of file
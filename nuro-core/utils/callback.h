@@ -1,23 +1,147 @@
-#include <functional>
+#pragma once
 
+#include <new>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+// Type an argument is passed through callbacks and events with
+// Scalars and references are passed as they are, other values by const reference so only subscribers taking them by value copy them
+template <typename T>
+using CallbackParam = std::conditional_t<std::is_reference_v<T> || std::is_scalar_v<T>, T, const T&>;
+
+// Type erased, move only delegate
+// Small callables (e.g. lambdas capturing a few pointers) are stored inline without any heap allocation
 template <typename... Args>
 class Callback
 {
 public:
-	using FuncType = std::function<void(Args...)>;
+	// Callables up to this size are stored inline
+	static constexpr size_t INLINE_SIZE = 4 * sizeof(void*);
+
+	Callback() noexcept : storage(), invoker(nullptr), manager(nullptr) {};
+
+	template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Callback> && std::is_invocable_v<std::decay_t<F>&, CallbackParam<Args>...>>>
+	Callback(F&& func) : storage(), invoker(nullptr), manager(nullptr)
+	{
+		using Functor = std::decay_t<F>;
 
-	Callback() = default;
-	Callback(FuncType func) : callback(std::move(func)) {};
+		// Empty function pointers and std::functions produce an empty callback
+		if constexpr (std::is_constructible_v<bool, const Functor&>) {
+			if (!static_cast<bool>(func)) return;
+		}
+
+		if constexpr (storedInline<Functor>) {
+			::new (static_cast<void*>(storage)) Functor(std::forward<F>(func));
+		}
+		else {
+			Functor* heap = new Functor(std::forward<F>(func));
+			::new (static_cast<void*>(storage)) Functor*(heap);
+		}
+
+		invoker = &invoke<Functor>;
+		manager = &manage<Functor>;
+	};
+
+	Callback(Callback&& other) noexcept : storage(), invoker(nullptr), manager(nullptr)
+	{
+		take(other);
+	}
 
-	void operator()(Args... args) const 
+	Callback& operator=(Callback&& other) noexcept
 	{
-		if (callback) callback(std::forward<Args>(args)...);
+		if (this != &other) {
+			reset();
+			take(other);
+		}
+		return *this;
+	}
+
+	Callback(const Callback&) = delete;
+	Callback& operator=(const Callback&) = delete;
+
+	~Callback()
+	{
+		reset();
+	}
+
+	void operator()(CallbackParam<Args>... args) const
+	{
+		if (invoker) invoker(const_cast<unsigned char*>(storage), std::forward<CallbackParam<Args>>(args)...);
 	}
 
 	explicit operator bool() const noexcept {
-		return static_cast<bool>(callback);
+		return invoker != nullptr;
+	}
+
+	// Destroys the stored callable
+	void reset() noexcept
+	{
+		if (manager) manager(Operation::DESTROY, storage, nullptr);
+		invoker = nullptr;
+		manager = nullptr;
 	}
 
 private:
-	FuncType callback;
-};
\ No newline at end of file
+	enum class Operation {
+		MOVE,
+		DESTROY
+	};
+
+	using Invoker = void(*)(void*, CallbackParam<Args>...);
+	using Manager = void(*)(Operation, void*, void*);
+
+	// Callables are only stored inline if they fit and can be moved without throwing
+	template <typename Functor>
+	static constexpr bool storedInline = sizeof(Functor) <= INLINE_SIZE && alignof(Functor) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<Functor>;
+
+	// Inline callable or pointer to heap allocated callable
+	alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+
+	// Calls the stored callable
+	Invoker invoker;
+
+	// Moves or destroys the stored callable
+	Manager manager;
+
+	template <typename Functor>
+	static Functor& functor(void* storage)
+	{
+		if constexpr (storedInline<Functor>) return *std::launder(static_cast<Functor*>(storage));
+		else return **std::launder(static_cast<Functor**>(storage));
+	}
+
+	template <typename Functor>
+	static void invoke(void* storage, CallbackParam<Args>... args)
+	{
+		functor<Functor>(storage)(std::forward<CallbackParam<Args>>(args)...);
+	}
+
+	template <typename Functor>
+	static void manage(Operation operation, void* source, void* destination)
+	{
+		if constexpr (storedInline<Functor>) {
+			Functor* instance = std::launder(static_cast<Functor*>(source));
+			if (operation == Operation::MOVE) ::new (destination) Functor(std::move(*instance));
+			instance->~Functor();
+		}
+		else {
+			// Heap allocated callables are moved by handing over the pointer
+			Functor* instance = *std::launder(static_cast<Functor**>(source));
+			if (operation == Operation::MOVE) ::new (destination) Functor*(instance);
+			else delete instance;
+		}
+	}
+
+	// Moves the callable of another callback into this empty callback
+	void take(Callback& other) noexcept
+	{
+		if (!other.manager) return;
+
+		other.manager(Operation::MOVE, other.storage, storage);
+		invoker = other.invoker;
+		manager = other.manager;
+		other.invoker = nullptr;
+		other.manager = nullptr;
+	}
+};
@@ -1,41 +1,153 @@
 #pragma once
 
-#include <memory>
 #include <vector>
+#include <cstdint>
+#include <algorithm>
 
 #include <utils/callback.h>
 
+// Stable handle of an event subscription, stays valid until it's unsubscribed
+struct EventHandle {
+
+	// Slot of the subscription
+	uint32_t index = UINT32_MAX;
+
+	// Generation of the slot when the subscription was made, detects stale handles
+	uint32_t generation = 0;
+
+	explicit operator bool() const noexcept {
+		return index != UINT32_MAX;
+	}
+
+};
+
+// Dispatches to subscribers stored contiguously in a slot map
+// Subscribing and unsubscribing is safe from within a dispatch:
+// Subscribers added during a dispatch are first called by the next dispatch, removed ones aren't called anymore
 template <typename... Args>
 class Event {
 public:
-	using FuncType = std::function<void(Args...)>;
 	using CallbackType = Callback<Args...>;
-	using CallbackPointer = std::shared_ptr<CallbackType>;
 
-	CallbackPointer subscribe(CallbackType callback) {
-		auto callbackPointer = std::make_shared<CallbackType>(std::move(callback));
-		callbacks.emplace_back(callbackPointer);
-		return callbackPointer;
+	Event() : slots(), freeSlots(), pendingSlots(), releasedSlots(), dispatchDepth(0)
+	{
 	}
 
-	CallbackPointer subscribe(FuncType func) {
-		auto callbackPointer = std::make_shared<CallbackType>(std::move(func));
-		callbacks.emplace_back(callbackPointer);
-		return callbackPointer;
+	Event(const Event&) = delete;
+	Event& operator=(const Event&) = delete;
+
+	// Adds a subscriber, returns its handle
+	EventHandle subscribe(CallbackType callback) {
+		// Slots can't be reused or reallocated while they're dispatched, stage subscriber until dispatch ends
+		if (dispatchDepth > 0) {
+			uint32_t index = static_cast<uint32_t>(slots.size() + pendingSlots.size());
+			Slot& slot = pendingSlots.emplace_back();
+			slot.callback = std::move(callback);
+			slot.active = true;
+			return EventHandle{ index, slot.generation };
+		}
+
+		uint32_t index;
+		if (!freeSlots.empty()) {
+			index = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		else {
+			index = static_cast<uint32_t>(slots.size());
+			slots.emplace_back();
+		}
+
+		Slot& slot = slots[index];
+		slot.callback = std::move(callback);
+		slot.active = true;
+		return EventHandle{ index, slot.generation };
+	}
+
+	// Removes a subscriber, stale or empty handles are ignored
+	void unsubscribe(EventHandle handle) {
+		if (!subscribed(handle)) return;
+
+		Slot& slot = handle.index < slots.size() ? slots[handle.index] : pendingSlots[handle.index - slots.size()];
+		slot.active = false;
+
+		// Callback might be running right now, release it once dispatch ends (staged slots are released when they're flushed)
+		if (dispatchDepth > 0) {
+			if (handle.index < slots.size()) releasedSlots.push_back(handle.index);
+			return;
+		}
+
+		release(handle.index);
 	}
 
-	void unsubscribe(CallbackPointer callback) {
-		callbacks.erase(std::remove(callbacks.begin(), callbacks.end(), callback), callbacks.end());
+	// Returns if the handle refers to a current subscriber
+	bool subscribed(EventHandle handle) const {
+		if (!handle) return false;
+
+		const Slot* slot = nullptr;
+		if (handle.index < slots.size()) slot = &slots[handle.index];
+		else if (handle.index - slots.size() < pendingSlots.size()) slot = &pendingSlots[handle.index - slots.size()];
+
+		return slot && slot->active && slot->generation == handle.generation;
 	}
 
-	void operator()(Args... args) const {
-		for (const auto& callback : callbacks) {
-			if (callback) {
-				(*callback)(std::forward<Args>(args)...);
-			}
+	// Calls all subscribers, arguments are handed to each subscriber without intermediate copies
+	void operator()(CallbackParam<Args>... args) {
+		dispatchDepth++;
+
+		// Subscribers added during dispatch are staged, the slots aren't reallocated until dispatch ends
+		const Slot* first = slots.data();
+		const Slot* last = first + slots.size();
+		for (const Slot* slot = first; slot != last; slot++) {
+			if (slot->active) slot->callback(args...);
 		}
+
+		dispatchDepth--;
+		if (dispatchDepth == 0 && (!pendingSlots.empty() || !releasedSlots.empty())) flush();
 	}
 
 private:
-	std::vector<CallbackPointer> callbacks;
-};
\ No newline at end of file
+	struct Slot {
+		CallbackType callback;
+		uint32_t generation = 0;
+		bool active = false;
+	};
+
+	// Subscriber slots, inactive slots are listed as free
+	std::vector<Slot> slots;
+
+	// Indices of inactive slots to reuse
+	std::vector<uint32_t> freeSlots;
+
+	// Subscribers added during dispatch, appended to the slots once dispatch ends
+	std::vector<Slot> pendingSlots;
+
+	// Slots unsubscribed during dispatch, released once dispatch ends
+	std::vector<uint32_t> releasedSlots;
+
+	// Depth of nested dispatches
+	uint32_t dispatchDepth;
+
+	// Destroys the callback of a slot and makes it reusable
+	void release(uint32_t index) {
+		Slot& slot = slots[index];
+		slot.callback.reset();
+		slot.generation++;
+		freeSlots.push_back(index);
+	}
+
+	// Applies subscribe and unsubscribe calls made during dispatch
+	void flush() {
+		// Pending slots keep the indices their handles were given
+		for (Slot& slot : pendingSlots) {
+			uint32_t index = static_cast<uint32_t>(slots.size());
+			slots.push_back(std::move(slot));
+			if (!slots.back().active) releasedSlots.push_back(index);
+		}
+		pendingSlots.clear();
+
+		for (uint32_t index : releasedSlots) {
+			release(index);
+		}
+		releasedSlots.clear();
+	}
+};
@@ -34,7 +34,6 @@ THE SOFTWARE.
 
 #include "guid.h"
 
-#include <chrono>
 #include <random>
 #include <cstring>
 
@@ -83,33 +82,54 @@ void initJni(JNIEnv* env)
 }
 #endif
 
+namespace
+{
+	// Byte offsets of the dashes within the string form
+	constexpr bool isDashPosition(std::size_t i)
+	{
+		return i == 8 || i == 13 || i == 18 || i == 23;
+	}
+
+	// Lowercase hex digit pairs of every byte value
+	struct HexPairs
+	{
+		char chars[256][2];
+
+		constexpr HexPairs() : chars()
+		{
+			constexpr char digits[] = "0123456789abcdef";
+			for (int i = 0; i < 256; i++) {
+				chars[i][0] = digits[i >> 4];
+				chars[i][1] = digits[i & 0xF];
+			}
+		}
+	};
+	constexpr HexPairs hexPairs;
+
+	// Value of every hex digit character, -1 for all other characters
+	struct HexValues
+	{
+		signed char values[256];
+
+		constexpr HexValues() : values()
+		{
+			for (int i = 0; i < 256; i++) values[i] = -1;
+			for (int i = 0; i < 10; i++) values['0' + i] = static_cast<signed char>(i);
+			for (int i = 0; i < 6; i++) {
+				values['a' + i] = static_cast<signed char>(10 + i);
+				values['A' + i] = static_cast<signed char>(10 + i);
+			}
+		}
+	};
+	constexpr HexValues hexValues;
+}
+
 // overload << so that it's easy to convert to a string
 std::ostream& operator<<(std::ostream& s, const GUID& guid)
 {
-	std::ios_base::fmtflags f(s.flags()); // politely don't leave the ostream in hex mode
-	s << std::hex << std::setfill('0')
-		<< std::setw(2) << (int)guid._bytes[0]
-		<< std::setw(2) << (int)guid._bytes[1]
-		<< std::setw(2) << (int)guid._bytes[2]
-		<< std::setw(2) << (int)guid._bytes[3]
-		<< "-"
-		<< std::setw(2) << (int)guid._bytes[4]
-		<< std::setw(2) << (int)guid._bytes[5]
-		<< "-"
-		<< std::setw(2) << (int)guid._bytes[6]
-		<< std::setw(2) << (int)guid._bytes[7]
-		<< "-"
-		<< std::setw(2) << (int)guid._bytes[8]
-		<< std::setw(2) << (int)guid._bytes[9]
-		<< "-"
-		<< std::setw(2) << (int)guid._bytes[10]
-		<< std::setw(2) << (int)guid._bytes[11]
-		<< std::setw(2) << (int)guid._bytes[12]
-		<< std::setw(2) << (int)guid._bytes[13]
-		<< std::setw(2) << (int)guid._bytes[14]
-		<< std::setw(2) << (int)guid._bytes[15];
-	s.flags(f);
-	return s;
+	char buffer[GUID::STRING_LENGTH + 1];
+	guid.str(buffer);
+	return s.write(buffer, GUID::STRING_LENGTH);
 }
 
 bool operator<(const XG::GUID& lhs, const XG::GUID& rhs)
@@ -123,30 +143,28 @@ bool GUID::isValid() const
 	return *this != empty;
 }
 
-// convert to string using std::snprintf() and std::string
+// convert to string through the allocation free overload
 std::string GUID::str() const
 {
-	char one[10], two[6], three[6], four[6], five[14];
-
-	snprintf(one, 10, "%02x%02x%02x%02x",
-		_bytes[0], _bytes[1], _bytes[2], _bytes[3]);
-	snprintf(two, 6, "%02x%02x",
-		_bytes[4], _bytes[5]);
-	snprintf(three, 6, "%02x%02x",
-		_bytes[6], _bytes[7]);
-	snprintf(four, 6, "%02x%02x",
-		_bytes[8], _bytes[9]);
-	snprintf(five, 14, "%02x%02x%02x%02x%02x%02x",
-		_bytes[10], _bytes[11], _bytes[12], _bytes[13], _bytes[14], _bytes[15]);
-	const std::string sep("-");
-	std::string out(one);
-
-	out += sep + two;
-	out += sep + three;
-	out += sep + four;
-	out += sep + five;
-
-	return out;
+	char buffer[STRING_LENGTH + 1];
+	str(buffer);
+	return std::string(buffer, STRING_LENGTH);
+}
+
+// write string form using the hex pair table
+void GUID::str(char* buffer) const
+{
+	std::size_t byte = 0;
+	for (std::size_t i = 0; i < STRING_LENGTH; i++) {
+		if (isDashPosition(i)) {
+			buffer[i] = '-';
+			continue;
+		}
+		const char* pair = hexPairs.chars[_bytes[byte++]];
+		buffer[i++] = pair[0];
+		buffer[i] = pair[1];
+	}
+	buffer[STRING_LENGTH] = '\0';
 }
 
 // conversion operator for std::string
@@ -171,78 +189,33 @@ GUID::GUID(std::array<unsigned char, 16>&& bytes) : _bytes(std::move(bytes))
 {
 }
 
-// converts a single hex char to a number (0 - 15)
-unsigned char hexDigitToChar(char ch)
+// create a guid from string, dashes are skipped anywhere, any other non hex character or a wrong amount of digits yields an empty guid
+GUID::GUID(std::string_view fromString) : _bytes{ {0} }
 {
-	// 0-9
-	if (ch > 47 && ch < 58)
-		return ch - 48;
-
-	// a-f
-	if (ch > 96 && ch < 103)
-		return ch - 87;
-
-	// A-F
-	if (ch > 64 && ch < 71)
-		return ch - 55;
-
-	return 0;
-}
-
-bool isValidHexChar(char ch)
-{
-	// 0-9
-	if (ch > 47 && ch < 58)
-		return true;
-
-	// a-f
-	if (ch > 96 && ch < 103)
-		return true;
-
-	// A-F
-	if (ch > 64 && ch < 71)
-		return true;
-
-	return false;
-}
-
-// converts the two hexadecimal characters to an unsigned char (a byte)
-unsigned char hexPairToChar(char a, char b)
-{
-	return hexDigitToChar(a) * 16 + hexDigitToChar(b);
-}
-
-// create a guid from string
-GUID::GUID(std::string_view fromString)
-{
-	char charOne = '\0';
-	char charTwo = '\0';
-	bool lookingForFirstChar = true;
 	unsigned nextByte = 0;
+	int high = -1;
 
-	for (const char& ch : fromString)
+	for (char ch : fromString)
 	{
 		if (ch == '-')
 			continue;
 
-		if (nextByte >= 16 || !isValidHexChar(ch))
+		signed char value = hexValues.values[static_cast<unsigned char>(ch)];
+		if (nextByte >= 16 || value < 0)
 		{
 			// Invalid string so bail
 			zeroify();
 			return;
 		}
 
-		if (lookingForFirstChar)
+		if (high < 0)
 		{
-			charOne = ch;
-			lookingForFirstChar = false;
+			high = value;
 		}
 		else
 		{
-			charTwo = ch;
-			auto byte = hexPairToChar(charOne, charTwo);
-			_bytes[nextByte++] = byte;
-			lookingForFirstChar = true;
+			_bytes[nextByte++] = static_cast<unsigned char>((high << 4) | value);
+			high = -1;
 		}
 	}
 
@@ -407,26 +380,17 @@ GUID createGUID()
 #if !defined(GUID_LIBUUID) && !defined(GUID_CFUUID) && !defined(GUID_WINDOWS) && !defined(GUID_ANDROID)
 GUID createGUID()
 {
-	// Create a seed from system clock and a random device
-	std::random_device rd;
-	auto seed = rd() ^ (
-		static_cast<std::mt19937::result_type>(
-			std::chrono::high_resolution_clock::now().time_since_epoch().count()
-			) +
-		static_cast<std::mt19937::result_type>(
-			std::chrono::system_clock::now().time_since_epoch().count()
-			)
-		);
-
-	std::mt19937 gen(seed);
-	std::uniform_int_distribution<unsigned int> distrib(0, 255);
-
-	std::array<unsigned char, 16> bytes;
+	// Each thread seeds its own generator once from the random device, which is backed by the os csprng
+	thread_local std::mt19937_64 gen = []() {
+		std::random_device rd;
+		std::seed_seq seed{ rd(), rd(), rd(), rd(), rd(), rd(), rd(), rd() };
+		return std::mt19937_64(seed);
+		}();
 
 	// Generate 16 random bytes
-	for (int i = 0; i < 16; i++) {
-		bytes[i] = static_cast<unsigned char>(distrib(gen));
-	}
+	uint64_t words[2] = { gen(), gen() };
+	std::array<unsigned char, 16> bytes;
+	std::memcpy(bytes.data(), words, sizeof(words));
 
 	// Set variant and version for RFC 4122 compliance (v4 random UUID)
 	// Variant 1 - bits: 10xx
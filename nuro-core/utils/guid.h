@@ -45,7 +45,8 @@ THE SOFTWARE.
 #include <sstream>
 #include <string_view>
 #include <utility>
-#include <iomanip>
+#include <cstdint>
+#include <cstring>
 
 #define BEGIN_XG_NAMESPACE namespace XG {
 #define END_XG_NAMESPACE }
@@ -59,6 +60,9 @@ BEGIN_XG_NAMESPACE
 class GUID
 {
 public:
+	// Length of the string form xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
+	static constexpr std::size_t STRING_LENGTH = 36;
+
 	explicit GUID(const std::array<unsigned char, 16>& bytes);
 	explicit GUID(std::array<unsigned char, 16>&& bytes);
 
@@ -74,6 +78,10 @@ public:
 	bool operator!=(const GUID& other) const;
 
 	std::string str() const;
+
+	// Writes the string form without allocating, buffer must hold STRING_LENGTH + 1 characters and is null terminated
+	void str(char* buffer) const;
+
 	operator std::string() const;
 	const std::array<unsigned char, 16>& bytes() const;
 	void swap(GUID& other);
@@ -145,14 +153,14 @@ namespace std
 	void swap(XG::GUID& guid0, XG::GUID& guid1) noexcept;
 
 	// Specialization for std::hash<GUID> -- this implementation
-	// uses std::hash<std::string> on the stringification of the guid
-	// to calculate the hash
+	// combines the hashes of both 64 bit halves of the guid
 	template <>
 	struct hash<XG::GUID>
 	{
 		std::size_t operator()(XG::GUID const& guid) const
 		{
-			const uint64_t* p = reinterpret_cast<const uint64_t*>(guid.bytes().data());
+			uint64_t p[2];
+			std::memcpy(p, guid.bytes().data(), sizeof(p));
 			return XG::details::hash<uint64_t, uint64_t>{}(p[0], p[1]);
 		}
 	};
@@ -0,0 +1,149 @@
+#include "parallel.h"
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <condition_variable>
+
+namespace Parallel {
+
+	// Work shared between the calling thread and the workers
+	struct Dispatch
+	{
+		const std::function<void(uint32_t)>* job = nullptr;
+		uint32_t count = 0;
+		std::atomic<uint32_t> next = 0;
+
+		// Amount of workers currently executing jobs of the dispatch (guarded by pool mutex)
+		uint32_t active = 0;
+	};
+
+	// Persistent worker threads, started on first use and joined on exit
+	struct Pool
+	{
+		std::vector<std::thread> workers;
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::condition_variable done;
+		Dispatch* dispatch = nullptr;
+		uint64_t generation = 0;
+		bool shutdown = false;
+
+		// Serializes dispatches issued from different threads
+		std::mutex dispatchMutex;
+
+		~Pool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				shutdown = true;
+			}
+			wake.notify_all();
+			for (std::thread& worker : workers) worker.join();
+		}
+	};
+
+	// Set while the current thread executes a job
+	thread_local bool tInsideJob = false;
+
+	void execute(Dispatch& dispatch)
+	{
+		tInsideJob = true;
+		for (uint32_t i = dispatch.next.fetch_add(1); i < dispatch.count; i = dispatch.next.fetch_add(1)) {
+			(*dispatch.job)(i);
+		}
+		tInsideJob = false;
+	}
+
+	void workerLoop(Pool& pool)
+	{
+		uint64_t seen = 0;
+		while (true) {
+			std::unique_lock<std::mutex> lock(pool.mutex);
+			pool.wake.wait(lock, [&] { return pool.shutdown || pool.generation != seen; });
+			if (pool.shutdown) return;
+			seen = pool.generation;
+
+			// Dispatch may already be finished
+			Dispatch* dispatch = pool.dispatch;
+			if (!dispatch) continue;
+			dispatch->active++;
+			lock.unlock();
+
+			execute(*dispatch);
+
+			lock.lock();
+			if (--dispatch->active == 0) pool.done.notify_all();
+		}
+	}
+
+	Pool& pool()
+	{
+		static Pool gPool;
+		static std::once_flag started;
+		std::call_once(started, [] {
+			uint32_t nWorkers = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+			for (uint32_t i = 0; i < nWorkers; i++) {
+				gPool.workers.emplace_back(workerLoop, std::ref(gPool));
+			}
+			});
+		return gPool;
+	}
+
+	uint32_t nThreads()
+	{
+		return static_cast<uint32_t>(pool().workers.size()) + 1;
+	}
+
+	void forEach(uint32_t count, const std::function<void(uint32_t)>& job)
+	{
+		// Not worth dispatching or called from within a job
+		if (count == 0) return;
+		if (count == 1 || tInsideJob) {
+			for (uint32_t i = 0; i < count; i++) job(i);
+			return;
+		}
+
+		Pool& workers = pool();
+		std::lock_guard<std::mutex> dispatchLock(workers.dispatchMutex);
+
+		Dispatch dispatch;
+		dispatch.job = &job;
+		dispatch.count = count;
+
+		// Wake workers
+		{
+			std::lock_guard<std::mutex> lock(workers.mutex);
+			workers.dispatch = &dispatch;
+			workers.generation++;
+		}
+		workers.wake.notify_all();
+
+		// Calling thread participates
+		execute(dispatch);
+
+		// Wait until no worker executes jobs of the dispatch anymore
+		std::unique_lock<std::mutex> lock(workers.mutex);
+		workers.done.wait(lock, [&] { return dispatch.active == 0; });
+		workers.dispatch = nullptr;
+	}
+
+	void forRanges(uint32_t count, uint32_t minRangeSize, const std::function<void(uint32_t, uint32_t)>& job)
+	{
+		if (count == 0) return;
+
+		// Split into one range per thread, but keep ranges big enough to be worth it
+		uint32_t rangeSize = std::max(minRangeSize, (count + nThreads() - 1) / nThreads());
+		rangeSize = std::max(rangeSize, 1u);
+		uint32_t nRanges = (count + rangeSize - 1) / rangeSize;
+
+		forEach(nRanges, [&](uint32_t range) {
+			uint32_t begin = range * rangeSize;
+			uint32_t end = std::min(begin + rangeSize, count);
+			job(begin, end);
+			});
+	}
+
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace Parallel
+{
+
+	// Returns the amount of threads executing parallel jobs (worker threads and the calling thread)
+	uint32_t nThreads();
+
+	// Invokes the job for each index within [0, count) across all worker threads and the calling thread
+	// Blocks until every invocation returned, nested calls from within a job run on the calling thread only
+	void forEach(uint32_t count, const std::function<void(uint32_t)>& job);
+
+	// Splits [0, count) into contiguous ranges and invokes the job for each range (begin, end) in parallel
+	void forRanges(uint32_t count, uint32_t minRangeSize, const std::function<void(uint32_t, uint32_t)>& job);
+
+};
@@ -20,11 +20,16 @@ namespace AssetMeta {
 			if (!std::getline(file, line))
 				return AssetGUID();
 
-			// Extract guid string
-			const std::string guidPrefix = "guid: ";
-			if (line.rfind(guidPrefix, 0) != 0)
+			// Parse guid string in place
+			constexpr std::string_view guidPrefix = "guid: ";
+			std::string_view guidStr = line;
+			if (guidStr.substr(0, guidPrefix.length()) != guidPrefix)
 				return AssetGUID();
-			std::string guidStr = line.substr(guidPrefix.length());
+			guidStr.remove_prefix(guidPrefix.length());
+
+			// Tolerate headers written with windows line endings
+			if (!guidStr.empty() && guidStr.back() == '\r')
+				guidStr.remove_suffix(1);
 
 			return AssetGUID(guidStr);
 		}
@@ -16,6 +16,7 @@
 // initialize with users editor settings later
 GameViewPipeline::GameViewPipeline() : drawSkybox(true),
 drawGizmos(false),
+depthPrePass(true),
 viewport(),
 msaaSamples(4),
 profile(),
@@ -25,7 +26,7 @@ transformPass(),
 prePass(viewport),
 forwardPass(viewport),
 ssaoPass(viewport),
-velocityBuffer(viewport),
+lightClusters(),
 postProcessingPipeline(viewport, false),
 cameraAvailable(false),
 ssaoOutput(0),
@@ -47,8 +48,6 @@ void GameViewPipeline::destroy()
 
 void GameViewPipeline::render()
 {
-	Profiler::start("render");
-
 	// Get active camera
 	auto _camera = ECS::main().getActiveCamera();
 	if (!_camera) {
@@ -57,6 +56,10 @@ void GameViewPipeline::render()
 		return;
 	}
 	cameraAvailable = true;
+
+	// Start render pass once rendering can't be cancelled anymore, it opens a gpu zone that must be closed
+	Profiler::startPass("render");
+
 	auto& [cameraTransform, cameraHandle] = *_camera;
 
 	// Get transformation matrices
@@ -71,21 +74,38 @@ void GameViewPipeline::render()
 	// 
 	transformPass.perform(viewProjection);
 
+	//
+	// CASCADED SHADOW PASS
+	// Render directional light cascades fitted to the game camera
+	//
+	CascadedShadowMap* cascadedShadowMap = Runtime::castDirectionalShadows(view, cameraHandle.fov, viewport.getAspect(), cameraHandle.near, cameraHandle.far);
+
+	//
+	// LIGHT CULLING
+	// Assign point lights and spotlights to the clusters of the game camera
+	//
+	Profiler::start("light_culling");
+	lightClusters.update(ApplicationContext::lightCache(), view, projection, cameraHandle.near, cameraHandle.far);
+	Profiler::stop("light_culling");
+
 	//
 	// PRE PASS
-	// Create geometry pass with depth buffer before forward pass
+	// Create geometry pass with depth buffer before forward pass, writes object motion vectors if needed
 	//
-	Profiler::start("pre_pass");
-	prePass.render(viewProjection, viewNormal);
-	Profiler::stop("pre_pass");
+	Profiler::startPass("pre_pass");
+	bool velocityBufferNeeded = profile.motionBlur.objectEnabled;
+	prePass.render(viewProjection, viewNormal, velocityBufferNeeded);
+	Profiler::stopPass("pre_pass");
 	const uint32_t PRE_PASS_DEPTH_OUTPUT = prePass.getDepthOutput();
 	const uint32_t PRE_PASS_NORMAL_OUTPUT = prePass.getNormalOutput();
+	velocityOutput = velocityBufferNeeded ? prePass.getVelocityOutput() : 0;
+	const uint32_t VELOCITY_BUFFER_OUTPUT = velocityOutput;
 
 	//
 	// SCREEN SPACE AMBIENT OCCLUSION PASS
 	// Calculate screen space ambient occlusion if enabled
 	//
-	Profiler::start("ssao");
+	Profiler::startPass("ssao");
 	bool ssaoNeeded = profile.ambientOcclusion.enabled;
 	ssaoOutput = 0;
 	if (ssaoNeeded)
@@ -93,20 +113,7 @@ void GameViewPipeline::render()
 		ssaoOutput = ssaoPass.render(projection, profile, PRE_PASS_DEPTH_OUTPUT, PRE_PASS_NORMAL_OUTPUT);
 	}
 	const uint32_t SSAO_OUTPUT = ssaoOutput;
-	Profiler::stop("ssao");
-
-	//
-	// VELOCITY BUFFER RENDER PASS
-	//
-	Profiler::start("velocity_buffer");
-	bool velocityBufferNeeded = profile.motionBlur.objectEnabled;
-	velocityOutput = 0;
-
-	if (velocityBufferNeeded)
-		velocityOutput = velocityBuffer.render(view, projection, profile);
-
-	const uint32_t VELOCITY_BUFFER_OUTPUT = velocityOutput;
-	Profiler::stop("velocity_buffer");
+	Profiler::stopPass("ssao");
 
 	//
 	// FORWARD PASS: Perform rendering for every object with materials, lighting etc.
@@ -120,23 +127,26 @@ void GameViewPipeline::render()
 	LitMaterial::castShadows = true;
 	LitMaterial::mainShadowDisk = Runtime::mainShadowDisk();
 	LitMaterial::mainShadowMap = Runtime::mainShadowMap();
+	LitMaterial::mainCascadedShadowMap = cascadedShadowMap;
+	LitMaterial::lightClusters = &lightClusters;
 
-	Profiler::start("forward_pass");
+	Profiler::startPass("forward_pass");
 	forwardPass.drawSkybox = drawSkybox;
 	forwardPass.drawGizmos = drawGizmos && gizmos;
+	forwardPass.depthPrePass = depthPrePass;
 	if (forwardPass.drawGizmos) forwardPass.linkGizmos(gizmos);
 	uint32_t FORWARD_PASS_OUTPUT = forwardPass.render(view, projection, viewProjection);
-	Profiler::stop("forward_pass");
+	Profiler::stopPass("forward_pass");
 
 	//
 	// POST PROCESSING PASS
 	// Render post processing pass to screen using forward pass output as input
 	//
-	Profiler::start("post_processing");
+	Profiler::startPass("post_processing");
 	postProcessingPipeline.render(view, projection, viewProjection, profile, FORWARD_PASS_OUTPUT, PRE_PASS_DEPTH_OUTPUT, VELOCITY_BUFFER_OUTPUT);
-	Profiler::stop("post_processing");
+	Profiler::stopPass("post_processing");
 
-	Profiler::stop("render");
+	Profiler::stopPass("render");
 }
 
 uint32_t GameViewPipeline::getOutput()
@@ -211,7 +221,7 @@ void GameViewPipeline::createPasses()
 	prePass.create();
 	forwardPass.create(msaaSamples);
 	ssaoPass.create();
-	velocityBuffer.create();
+	lightClusters.create();
 	postProcessingPipeline.create();
 }
 
@@ -220,6 +230,6 @@ void GameViewPipeline::destroyPasses()
 	prePass.destroy();
 	forwardPass.destroy();
 	ssaoPass.destroy();
-	velocityBuffer.destroy();
+	lightClusters.destroy();
 	postProcessingPipeline.destroy();
 }
\ No newline at end of file
@@ -7,8 +7,8 @@
 #include <transform/transform_pass.h>
 #include <rendering/passes/pre_pass.h>
 #include <rendering/passes/ssao_pass.h>
+#include <rendering/lighting/light_clusters.h>
 #include <rendering/passes/forward_pass.h>
-#include <rendering/velocitybuffer/velocity_buffer.h>
 #include <rendering/postprocessing/post_processing.h>
 #include <rendering/postprocessing/post_processing_pipeline.h>
 
@@ -58,13 +58,16 @@ public:
 	// Gizmos will be drawn if this is set
 	bool drawGizmos;
 
+	// Depth of all meshes is laid down before shading them if this is set, trades a vertex only pass for zero overdraw
+	bool depthPrePass;
+
 	// Returns true if there was a camera render target available during the last render
 	bool getCameraAvailable();
 
 	// Returns the last ssao output
 	uint32_t getSSAOOutput() const;
 
-	// Returns the velocity buffers last output
+	// Returns the last object motion vectors output
 	uint32_t getVelocityOutput() const;
 
 private:
@@ -97,7 +100,7 @@ private:
 	PrePass prePass;
 	ForwardPass forwardPass;
 	SSAOPass ssaoPass;
-	VelocityBuffer velocityBuffer;
+	LightClusters lightClusters;
 	PostProcessingPipeline postProcessingPipeline;
 
 	//
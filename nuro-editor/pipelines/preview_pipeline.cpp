@@ -8,12 +8,14 @@
 #include <memory/resource_manager.h>
 #include <rendering/shader/shader_pool.h>
 #include <rendering/primitives/global_quad.h>
+#include <rendering/submission/draw_submission.h>
 #include <rendering/material/lit/lit_material.h>
 #include <rendering/transformation/transformation.h>
 
 PreviewPipeline::PreviewPipeline() : fbo(0),
 outputs(),
-renderInstructions()
+renderInstructions(),
+batch()
 {
 }
 
@@ -22,6 +24,9 @@ void PreviewPipeline::create()
 	// Generate framebuffer
 	glCreateFramebuffers(1, &fbo);
 	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+	// Create draw batch
+	batch.create();
 }
 
 void PreviewPipeline::destroy()
@@ -35,6 +40,9 @@ void PreviewPipeline::destroy()
 		glDeleteTextures(1, &output.texture);
 	}
 	outputs.clear();
+
+	// Destroy draw batch
+	batch.destroy();
 }
 
 size_t PreviewPipeline::createOutput()
@@ -113,10 +121,11 @@ void PreviewPipeline::render()
 		// Set viewport
 		glViewport(0, 0, output.viewport.getWidth_gl(), output.viewport.getHeight_gl());
 
-		// Bind shader and material
+		// Build shader variant of the preview render state, bind shader and material
+		instruction.modelMaterial->prepareShader();
 		ResourceRef<Shader> shader = instruction.modelMaterial->getShader();
 		shader->bind();
-		instruction.modelMaterial->bind();
+		DrawSubmission::bindMaterial(*instruction.modelMaterial);
 		instruction.modelMaterial->setSampleDirectionalLight();
 
 		// Calculate and sync transform matrices
@@ -125,15 +134,17 @@ void PreviewPipeline::render()
 		glm::mat4 _projection = Transformation::projection(45.0f, output.viewport.getAspect(), 0.3f, 1000.0f);
 		glm::mat4 _mvp = _projection * _view * _model;
 		glm::mat4 _normal = Transformation::normal(_model);
-		shader->setMatrix4("mvpMatrix", _mvp);
-		shader->setMatrix4("modelMatrix", _model);
-		shader->setMatrix3("normalMatrix", _normal);
 
-		// Bind and render all meshes of model
+		// Batch and render all meshes of model
+		batch.clear();
 		for (int i = 0; i < instruction.model->nLoadedMeshes(); i++) {
 			const Mesh* mesh = instruction.model->queryMesh(i);
-			glBindVertexArray(mesh->vao());
-			glDrawElements(GL_TRIANGLES, mesh->indiceCount(), GL_UNSIGNED_INT, 0);
+			batch.add(instruction.modelMaterial, *mesh, _model, _mvp, _normal);
+		}
+		batch.upload();
+		Model::geometryArena().bind();
+		for (const IndirectBatch::Group& group : batch.getGroups()) {
+			batch.draw(group);
 		}
 
 		instruction.modelMaterial->syncLightUniforms();
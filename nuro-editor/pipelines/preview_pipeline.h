@@ -5,6 +5,7 @@
 
 #include <ecs/components.h>
 #include <viewport/viewport.h>
+#include <rendering/batching/indirect_batch.h>
 
 class Model;
 class LitMaterial;
@@ -55,4 +56,5 @@ private:
 	uint32_t rbo;
 	std::vector<PreviewOutput> outputs;
 	std::vector<PreviewRenderInstruction> renderInstructions;
+	IndirectBatch batch;
 };
\ No newline at end of file
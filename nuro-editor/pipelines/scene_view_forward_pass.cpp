@@ -5,9 +5,11 @@
 #include <utils/console.h>
 #include <transform/transform.h>
 #include <rendering/model/mesh.h>
+#include <rendering/model/model.h>
 #include <rendering/skybox/skybox.h>
 #include <memory/resource_manager.h>
 #include <rendering/material/imaterial.h>
+#include <rendering/submission/draw_submission.h>
 #include <rendering/transformation/transformation.h>
 #include <rendering/material/unlit/unlit_material.h>
 
@@ -25,7 +27,8 @@ outputColor(0),
 multisampledFbo(0),
 multisampledRbo(0),
 multisampledColorBuffer(0),
-selectionMaterial(nullptr)
+selectionMaterial(nullptr),
+batch()
 {
 }
 
@@ -82,6 +85,9 @@ void SceneViewForwardPass::create(uint32_t msaaSamples)
 	}
 
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	// Create draw batch
+	batch.create();
 }
 
 void SceneViewForwardPass::destroy() {
@@ -108,6 +114,9 @@ void SceneViewForwardPass::destroy() {
 	// Delete framebuffer
 	glDeleteFramebuffers(1, &multisampledFbo);
 	multisampledFbo = 0;
+
+	// Destroy draw batch
+	batch.destroy();
 }
 
 uint32_t SceneViewForwardPass::render(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& viewProjection, const Camera& camera, const std::vector<EntityContainer*>& selectedEntities)
@@ -192,38 +201,39 @@ void SceneViewForwardPass::linkGizmos(IMGizmo* _gizmos)
 	gizmos = _gizmos;
 }
 
-void SceneViewForwardPass::renderMesh(TransformComponent& transform, MeshRendererComponent& renderer)
+void SceneViewForwardPass::renderBatch()
 {
-	// Transform components model and mvp must have been calculated beforehand
+	// Upload collected draws
+	batch.upload();
 
-	// Renderer must be enabled
-	if (!renderer.enabled) return;
+	// Bind shared geometry of all meshes
+	Model::geometryArena().bind();
 
-	// Make sure mesh is available
-	if (!renderer.mesh) return;
+	// Submit each material group with a single draw call
+	uint32_t currentShaderId = 0;
+	for (const IndirectBatch::Group& group : batch.getGroups()) {
 
-	// Set shader uniforms
-	ResourceRef<Shader> shader = renderer.material->getShader();
-	shader->setMatrix4("mvpMatrix", transform.mvp);
-	shader->setMatrix4("modelMatrix", transform.model);
-	shader->setMatrix3("normalMatrix", transform.normal);
+		uint32_t shaderId = group.material->getShaderId();
+		if (shaderId != currentShaderId) {
+			group.material->getShader()->bind();
+			currentShaderId = shaderId;
+		}
 
-	// Bind mesh
-	glBindVertexArray(renderer.mesh->vao());
+		DrawSubmission::bindMaterial(*group.material);
+		batch.draw(group);
 
-	// Render mesh
-	glDrawElements(GL_TRIANGLES, renderer.mesh->indiceCount(), GL_UNSIGNED_INT, 0);
+	}
 }
 
 void SceneViewForwardPass::renderMeshes(const std::vector<EntityContainer*>& skippedEntities)
 {
-	uint32_t currentShaderId = 0;
-	uint32_t currentMaterialId = 0;
+	// Transform components model and mvp must have been calculated beforehand
 
-	uint16_t newBoundShaders = 0;
-	uint16_t newBoundMaterials = 0;
+	// Build shader variants of the current render state before batching
+	ECS::main().prepareShaders();
 
-	// Render each entity except for skipped one
+	// Collect draws of all render targets except for skipped ones
+	batch.clear();
 	for (auto& [entity, transform, renderer] : ECS::main().getRenderQueue()) {
 
 		// Skip if target entity is selected entity
@@ -232,23 +242,14 @@ void SceneViewForwardPass::renderMeshes(const std::vector<EntityContainer*>& ski
 			if (skippedEntities[0]->handle() == entity) continue;
 		}
 
-		uint32_t shaderId = renderer.material->getShaderId();
-		if (shaderId != currentShaderId) {
-			renderer.material->getShader()->bind();
-			currentShaderId = shaderId;
-			newBoundShaders++;
-		}
-
-		uint32_t materialId = renderer.material->getId();
-		if (materialId != currentMaterialId) {
-			renderer.material->bind();
-			currentMaterialId = materialId;
-			newBoundMaterials++;
-		}
+		// Renderer must be enabled and mesh must be available
+		if (!renderer.enabled || !renderer.mesh) continue;
 
-		renderMesh(transform, renderer);
+		batch.add(renderer.material, *renderer.mesh, transform.model, transform.mvp, transform.normal);
 
 	}
+
+	renderBatch();
 }
 
 void SceneViewForwardPass::renderSelectedEntity(EntityContainer* entity, const glm::mat4& viewProjection, const Camera& camera)
@@ -263,8 +264,8 @@ void SceneViewForwardPass::renderSelectedEntity(EntityContainer* entity, const g
 	TransformComponent& transform = entity->transform();
 	MeshRendererComponent& renderer = entity->get<MeshRendererComponent>();
 
-	// Renderer must be enabled
-	if (!renderer.enabled) return;
+	// Renderer must be enabled and mesh must be available
+	if (!renderer.enabled || !renderer.mesh) return;
 
 	// Get camera transform
 	TransformComponent& cameraTransform = std::get<0>(camera);
@@ -274,14 +275,9 @@ void SceneViewForwardPass::renderSelectedEntity(EntityContainer* entity, const g
 	glStencilMask(0xFF); // Enable stencil writes
 		
 	// Forward render entities base mesh
-	ResourceRef<Shader> shader = renderer.material->getShader();
-	shader->bind();
-	shader->setMatrix4("mvpMatrix", transform.mvp);
-	shader->setMatrix4("modelMatrix", transform.model);
-	shader->setMatrix3("normalMatrix", transform.normal);
-	renderer.material->bind();
-	glBindVertexArray(renderer.mesh->vao());
-	glDrawElements(GL_TRIANGLES, renderer.mesh->indiceCount(), GL_UNSIGNED_INT, 0);
+	batch.clear();
+	batch.add(renderer.material, *renderer.mesh, transform.model, transform.mvp, transform.normal);
+	renderBatch();
 
 	// Don't render outline if wireframe is enabled
 	if (wireframe) return;
@@ -306,12 +302,9 @@ void SceneViewForwardPass::renderSelectedEntity(EntityContainer* entity, const g
 	Transform::updateMvp(outlineTransform, viewProjection);
 
 	// Render mesh as outline
-	shader = selectionMaterial->getShader();
-	shader->bind();
-	shader->setMatrix4("mvpMatrix", outlineTransform.mvp);
-	selectionMaterial->bind();
-	glBindVertexArray(renderer.mesh->vao());
-	glDrawElements(GL_TRIANGLES, renderer.mesh->indiceCount(), GL_UNSIGNED_INT, 0);
+	batch.clear();
+	batch.add(selectionMaterial, *renderer.mesh, outlineTransform.model, outlineTransform.mvp, outlineTransform.normal);
+	renderBatch();
 
 	// Reset state
 	glDisable(GL_BLEND);
@@ -7,6 +7,7 @@
 #include <viewport/viewport.h>
 #include <ecs/ecs_collection.h>
 #include <rendering/gizmos/imgizmo.h>
+#include <rendering/batching/indirect_batch.h>
 
 class Skybox;
 class IMaterial;
@@ -46,10 +47,12 @@ private:
 
 	UnlitMaterial* selectionMaterial; // Material for selection outline
 
+	IndirectBatch batch; // Batch collecting mesh draws of the scene view
+
 	// Default scene view clearing color rgb values
 	static constexpr float defaultClearColor[3] = { 0.015f, 0.015f, 0.015f };
 
-	void renderMesh(TransformComponent& transform, MeshRendererComponent& renderer); // Renders a given entities mesh
+	void renderBatch(); // Uploads and renders all draws collected in batch
 	void renderMeshes(const std::vector<EntityContainer*>& skippedEntities); // Renders all meshes
 	void renderSelectedEntity(EntityContainer* entity, const glm::mat4& viewProjection, const Camera& camera); // Renders the selected entity with an outline
 };
\ No newline at end of file
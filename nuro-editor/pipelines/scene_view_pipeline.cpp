@@ -30,6 +30,7 @@ transformPass(),
 prePass(viewport),
 sceneViewForwardPass(viewport),
 ssaoPass(viewport),
+lightClusters(),
 postProcessingPipeline(viewport, false),
 view(glm::mat4(1.0f)),
 projection(glm::mat4(1.0f)),
@@ -71,7 +72,7 @@ void SceneViewPipeline::destroy()
 
 void SceneViewPipeline::render()
 {
-	Profiler::start("scene_view");
+	Profiler::startPass("scene_view");
 
 	// Pick variable items for rendering
 	Camera& camera = flyCamera;
@@ -102,13 +103,30 @@ void SceneViewPipeline::render()
 	transformPass.perform(viewProjection);
 	Profiler::stop("transform_pass");
 
+	//
+	// CASCADED SHADOW PASS
+	// Render directional light cascades fitted to the scene view camera
+	//
+	CascadedShadowMap* cascadedShadowMap = nullptr;
+	if (renderingShadows) {
+		cascadedShadowMap = Runtime::castDirectionalShadows(view, cameraHandle.fov, viewport.getAspect(), cameraHandle.near, cameraHandle.far);
+	}
+
+	//
+	// LIGHT CULLING
+	// Assign point lights and spotlights to the clusters of the scene view camera
+	//
+	Profiler::start("light_culling");
+	lightClusters.update(ApplicationContext::lightCache(), view, projection, cameraHandle.near, cameraHandle.far);
+	Profiler::stop("light_culling");
+
 	//
 	// PRE PASS
 	// Create geometry pass with depth buffer before forward pass
 	//
-	Profiler::start("pre_pass");
-	prePass.render(viewProjection, viewNormal);
-	Profiler::stop("pre_pass");
+	Profiler::startPass("pre_pass");
+	prePass.render(viewProjection, viewNormal, false);
+	Profiler::stopPass("pre_pass");
 	const uint32_t PRE_PASS_DEPTH_OUTPUT = prePass.getDepthOutput();
 	const uint32_t PRE_PASS_NORMAL_OUTPUT = prePass.getNormalOutput();
 
@@ -116,14 +134,14 @@ void SceneViewPipeline::render()
 	// SCREEN SPACE AMBIENT OCCLUSION PASS
 	// Calculate screen space ambient occlusion if enabled
 	//
-	Profiler::start("ssao");
+	Profiler::startPass("ssao");
 	uint32_t _ssaoOutput = 0;
 	if (targetProfile.ambientOcclusion.enabled)
 	{
 		_ssaoOutput = ssaoPass.render(projection, targetProfile, PRE_PASS_DEPTH_OUTPUT, PRE_PASS_NORMAL_OUTPUT);
 	}
 	const uint32_t SSAO_OUTPUT = _ssaoOutput;
-	Profiler::stop("ssao");
+	Profiler::stopPass("ssao");
 
 	//
 	// VELOCITY BUFFER RENDER PASS (NONE)
@@ -142,6 +160,8 @@ void SceneViewPipeline::render()
 	LitMaterial::castShadows = renderingShadows;
 	LitMaterial::mainShadowDisk = Runtime::mainShadowDisk();
 	LitMaterial::mainShadowMap = Runtime::mainShadowMap();
+	LitMaterial::mainCascadedShadowMap = cascadedShadowMap;
+	LitMaterial::lightClusters = &lightClusters;
 
 	sceneViewForwardPass.wireframe = wireframe;
 	sceneViewForwardPass.drawSkybox = showSkybox;
@@ -155,7 +175,7 @@ void SceneViewPipeline::render()
 	//
 	postProcessingPipeline.render(view, projection, viewProjection, targetProfile, FORWARD_PASS_OUTPUT, PRE_PASS_DEPTH_OUTPUT, VELOCITY_BUFFER_OUTPUT);
 
-	Profiler::stop("scene_view");
+	Profiler::stopPass("scene_view");
 }
 
 uint32_t SceneViewPipeline::getOutput()
@@ -235,6 +255,7 @@ void SceneViewPipeline::createPasses()
 	sceneViewForwardPass.create(msaaSamples);
 	sceneViewForwardPass.linkGizmos(&Runtime::sceneGizmos());
 	ssaoPass.create();
+	lightClusters.create();
 	postProcessingPipeline.create();
 }
 
@@ -243,5 +264,6 @@ void SceneViewPipeline::destroyPasses()
 	prePass.destroy();
 	sceneViewForwardPass.destroy();
 	ssaoPass.destroy();
+	lightClusters.destroy();
 	postProcessingPipeline.destroy();
 }
\ No newline at end of file
@@ -10,7 +10,7 @@
 #include <transform/transform_pass.h>
 #include <rendering/passes/pre_pass.h>
 #include <rendering/passes/ssao_pass.h>
-#include <rendering/velocitybuffer/velocity_buffer.h>
+#include <rendering/lighting/light_clusters.h>
 #include <rendering/postprocessing/post_processing.h>
 #include <rendering/postprocessing/post_processing_pipeline.h>
 
@@ -111,6 +111,7 @@ private:
 	PrePass prePass;
 	SceneViewForwardPass sceneViewForwardPass;
 	SSAOPass ssaoPass;
+	LightClusters lightClusters;
 	PostProcessingPipeline postProcessingPipeline;
 
 	//
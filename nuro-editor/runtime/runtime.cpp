@@ -25,11 +25,13 @@
 
 #include <rendering/model/model.h>
 #include <rendering/shader/shader.h>
+#include <rendering/shader/shader_cache.h>
 #include <rendering/skybox/cubemap.h>
 #include <rendering/texture/texture.h>
 #include <rendering/shader/shader_pool.h>
 #include <rendering/shadows/shadow_map.h>
 #include <rendering/shadows/shadow_disk.h>
+#include <rendering/shadows/cascaded_shadow_map.h>
 #include <rendering/material/lit/lit_material.h>
 #include <rendering/transformation/transformation.h>
 
@@ -49,6 +51,7 @@ namespace Runtime {
 	// Shadow
 	ShadowDisk* gMainShadowDisk = nullptr;
 	ShadowMap* gMainShadowMap = nullptr;
+	CascadedShadowMap* gMainCascadedShadowMap = nullptr;
 
 	// Default assets
 	Skybox gDefaultSkybox;
@@ -71,6 +74,9 @@ namespace Runtime {
 
 		ResourceManager& resource = ApplicationContext::resourceManager();
 
+		// Reuse program binaries of previous runs
+		ShaderCache::create("./cache/shaders");
+
 		// Load shaders
 		ShaderPool::loadAllSync("./shaders/materials");
 		ShaderPool::loadAllSync("./shaders/postprocessing");
@@ -124,6 +130,13 @@ namespace Runtime {
 		gMainShadowMap = new ShadowMap(4096, 4096);
 		gMainShadowMap->create();
 
+		// Create main cascaded shadow map for directional lights
+		uint32_t cascadeResolution = 2048;
+		float cascadeDistance = 150.0f;
+		float cascadeSplitLambda = 0.75f;
+		gMainCascadedShadowMap = new CascadedShadowMap(cascadeResolution, cascadeDistance, cascadeSplitLambda);
+		gMainCascadedShadowMap->create();
+
 		Console::out::done("Runtime", "Created resources");
 
 	}
@@ -148,12 +161,15 @@ namespace Runtime {
 		// Make sure shadow map is created
 		if (!gMainShadowMap) return;
 
+		// The shadow map tracks its casters model matrices and skips rendering if neither
+		// the light nor any caster changed, casters unchanged for a while are cached as static
+
 		// Temporary: Render first spotlight to be found in registry
 		auto spotlights = ECS::main().view<TransformComponent, SpotlightComponent>();
 		for (auto [entity, transform, spotlight] : spotlights.each()) {
-			Profiler::start("shadow_pass");
+			Profiler::startPass("shadow_pass");
 			gMainShadowMap->castShadows(spotlight, transform);
-			Profiler::stop("shadow_pass");
+			Profiler::stopPass("shadow_pass");
 			break;
 		}
 	}
@@ -241,6 +257,11 @@ namespace Runtime {
 		// UPDATE GAME IF GAME IS RUNNING
 		if (gGameState == GameState::GAME_RUNNING) _stepGame();
 
+		// GATHER LIGHTS ONCE FOR ALL PIPELINES
+		Profiler::start("light_gathering");
+		ApplicationContext::lightCache().update();
+		Profiler::stop("light_gathering");
+
 		// RENDER NEXT FRAME
 		_renderShadowsGlobal();
 		gSceneViewPipeline.render();
@@ -249,10 +270,10 @@ namespace Runtime {
 
 		// RENDER EDITOR
 		gProjectManager.pollEvents();
-		Profiler::start("ui_pass");
+		Profiler::startPass("ui_pass");
 		EditorUI::newFrame();
 		EditorUI::render();
-		Profiler::stop("ui_pass");
+		Profiler::stopPass("ui_pass");
 
 		// END CURRENT FRAME
 		ApplicationContext::endFrame();
@@ -326,6 +347,9 @@ namespace Runtime {
 		// Perform awake logic
 		gameAwake();
 
+		// Discard cached shadow casters of scene state before game start
+		if (gMainShadowMap) gMainShadowMap->invalidate();
+
 		// Set game running state
 		gGameState = GameState::GAME_RUNNING;
 	}
@@ -340,6 +364,9 @@ namespace Runtime {
 
 		// Restore scene state
 		// ...
+
+		// Discard cached shadow casters of game state
+		if (gMainShadowMap) gMainShadowMap->invalidate();
 	}
 
 	void pauseGame() {
@@ -386,4 +413,28 @@ namespace Runtime {
 		return gMainShadowMap;
 	}
 
+	CascadedShadowMap* mainCascadedShadowMap()
+	{
+		return gMainCascadedShadowMap;
+	}
+
+	CascadedShadowMap* castDirectionalShadows(const glm::mat4& view, float fov, float aspect, float near, float far)
+	{
+		// Make sure cascaded shadow map is created
+		if (!gMainCascadedShadowMap) return nullptr;
+
+		// Temporary: Render first enabled directional light to be found in registry
+		auto directionalLights = ECS::main().view<TransformComponent, DirectionalLightComponent>();
+		for (auto [entity, transform, directionalLight] : directionalLights.each()) {
+			if (!directionalLight.enabled) continue;
+
+			Profiler::startPass("cascaded_shadow_pass");
+			gMainCascadedShadowMap->castShadows(directionalLight, transform, view, fov, aspect, near, far);
+			Profiler::stopPass("cascaded_shadow_pass");
+			return gMainCascadedShadowMap;
+		}
+
+		return nullptr;
+	}
+
 }
\ No newline at end of file
@@ -10,6 +10,7 @@
 
 class ShadowDisk;
 class ShadowMap;
+class CascadedShadowMap;
 
 class Model;
 class LitMaterial;
@@ -67,4 +68,9 @@ namespace Runtime
 
 	ShadowDisk* mainShadowDisk();
 	ShadowMap* mainShadowMap();
+	CascadedShadowMap* mainCascadedShadowMap();
+
+	// Renders the cascaded shadow map for the first enabled directional light fitted to the given camera
+	// Returns the cascaded shadow map or nullptr if there is no directional light
+	CascadedShadowMap* castDirectionalShadows(const glm::mat4& view, float fov, float aspect, float near, float far);
 };
\ No newline at end of file
@@ -96,6 +96,7 @@ void _physics_example() {
 
 	// Directional light (sun)
 	EntityContainer sun(ecs.createEntity("Sun"));
+	Transform::setRotation(sun.transform(), Transform::toQuat(glm::vec3(32.0f, -35.0f, 0.0f)));
 	DirectionalLightComponent& sunLight = sun.add<DirectionalLightComponent>();
 	sunLight.enabled = false;
 	sunLight.intensity = 0.3f;
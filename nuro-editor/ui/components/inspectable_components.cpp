@@ -171,8 +171,8 @@ namespace InspectableComponents {
 			IMComponents::input("Position", transform.position);
 			IMComponents::input("Rotation", transform.eulerAngles);
 			IMComponents::input("Scale", transform.scale);
-			if (Transform::hasParent(transform)) IMComponents::label("Parent: " + Transform::fetchParent(transform).name);
-			IMComponents::label("ID: " + std::to_string(transform.id));
+			if (Transform::hasParent(transform)) IMComponents::label("Parent: " + ECS::main().get<IdentityComponent>(transform.parent).name);
+			IMComponents::label("ID: " + std::to_string(ECS::main().get<IdentityComponent>(entity).id));
 			IMComponents::label("Depth: " + std::to_string(transform.depth));
 
 			if (Transform::hasParent(transform)) {
@@ -198,7 +198,8 @@ namespace InspectableComponents {
 			_headline("General");
 
 			if (meshRenderer.mesh) {
-				IMComponents::label("Mesh ID: " + std::to_string(meshRenderer.mesh->vao()));
+				IMComponents::label("Mesh Vertices: " + std::to_string(meshRenderer.mesh->baseVertex()) + " + " + std::to_string(meshRenderer.mesh->verticeCount()));
+				IMComponents::label("Mesh Indices: " + std::to_string(meshRenderer.mesh->firstIndex()) + " + " + std::to_string(meshRenderer.mesh->indiceCount()));
 			}
 
 			if (meshRenderer.material) {
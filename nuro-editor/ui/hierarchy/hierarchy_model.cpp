@@ -0,0 +1,231 @@
+#include "hierarchy_model.h"
+
+#include <algorithm>
+
+HierarchyModel::HierarchyModel() : items(),
+roots(),
+_rows(),
+rowsDirty(false),
+_nItems(0),
+pendingEntities(),
+destroyedEntities(),
+dirtyParents(),
+reparentSubscription()
+{
+}
+
+HierarchyModel::~HierarchyModel()
+{
+	destroy();
+}
+
+void HierarchyModel::create()
+{
+	// Make sure model wasn't created already
+	if (reparentSubscription) return;
+
+	ECS& ecs = ECS::main();
+
+	// Subscribe to transform construction, destruction and reparenting
+	ecs.reg().on_construct<TransformComponent>().connect<&HierarchyModel::onConstruct>(this);
+	ecs.reg().on_destroy<TransformComponent>().connect<&HierarchyModel::onDestroy>(this);
+	reparentSubscription = ecs.reparentEvent().subscribe([this](Entity entity) { pendingEntities.push_back(entity); });
+
+	// Add all existing entities, iterated in reverse to retain their creation order
+	for (Entity entity : ecs.view<TransformComponent>()) {
+		pendingEntities.push_back(entity);
+	}
+	std::reverse(pendingEntities.begin(), pendingEntities.end());
+}
+
+void HierarchyModel::destroy()
+{
+	if (!reparentSubscription) return;
+
+	ECS& ecs = ECS::main();
+	ecs.reg().on_construct<TransformComponent>().disconnect<&HierarchyModel::onConstruct>(this);
+	ecs.reg().on_destroy<TransformComponent>().disconnect<&HierarchyModel::onDestroy>(this);
+	ecs.reparentEvent().unsubscribe(reparentSubscription);
+	reparentSubscription = EventHandle();
+
+	items.clear();
+	roots.clear();
+	_rows.clear();
+	rowsDirty = false;
+	_nItems = 0;
+	pendingEntities.clear();
+	destroyedEntities.clear();
+	dirtyParents.clear();
+}
+
+bool HierarchyModel::sync()
+{
+	bool removed = !destroyedEntities.empty();
+
+	if (removed) {
+		// Remove items of destroyed entities
+		for (Entity entity : destroyedEntities) {
+			HierarchyItem* item = find(entity);
+			if (!item) continue;
+
+			// Children are either orphaned or destroyed too, reevaluate them
+			pendingEntities.insert(pendingEntities.end(), item->children.begin(), item->children.end());
+
+			dirtyParents.push_back(item->parent);
+			*item = HierarchyItem();
+			_nItems--;
+		}
+		destroyedEntities.clear();
+
+		// Destroying components may move other transforms within their storage, refetch the cached transforms
+		for (HierarchyItem& item : items) {
+			if (item.entity.handle() != entt::null) item.entity = EntityContainer(item.entity.handle());
+		}
+	}
+
+	// Add new entities and move reparented ones
+	for (size_t i = 0; i < pendingEntities.size(); i++) {
+		link(pendingEntities[i]);
+	}
+	pendingEntities.clear();
+
+	compact();
+
+	if (rowsDirty) buildRows();
+
+	return removed;
+}
+
+const std::vector<HierarchyRow>& HierarchyModel::rows() const
+{
+	return _rows;
+}
+
+HierarchyItem* HierarchyModel::find(Entity entity)
+{
+	if (entity == entt::null) return nullptr;
+
+	size_t index = entt::to_entity(entity);
+	if (index >= items.size()) return nullptr;
+
+	HierarchyItem& item = items[index];
+	return item.entity.handle() == entity ? &item : nullptr;
+}
+
+void HierarchyModel::setExpanded(HierarchyItem& item, bool expanded)
+{
+	if (item.expanded == expanded) return;
+
+	item.expanded = expanded;
+	if (!item.children.empty()) rowsDirty = true;
+}
+
+size_t HierarchyModel::nItems() const
+{
+	return _nItems;
+}
+
+void HierarchyModel::onConstruct(Entity entity)
+{
+	pendingEntities.push_back(entity);
+}
+
+void HierarchyModel::onDestroy(Entity entity)
+{
+	destroyedEntities.push_back(entity);
+}
+
+void HierarchyModel::link(Entity entity)
+{
+	ECS& ecs = ECS::main();
+	if (!ecs.verify(entity) || !ecs.has<TransformComponent>(entity)) return;
+
+	// Evaluate parent, entities with invalid parents are listed as roots
+	Entity parent = ecs.get<TransformComponent>(entity).parent;
+	if (parent != entt::null && (!ecs.verify(parent) || !ecs.has<TransformComponent>(parent))) parent = entt::null;
+
+	HierarchyItem* item = find(entity);
+	if (item) {
+		// Already listed under its parent
+		if (item->parent == parent) return;
+
+		// Listed under previous parent, removed from there when compacting
+		dirtyParents.push_back(item->parent);
+	}
+	else {
+		// Create item
+		size_t index = entt::to_entity(entity);
+		if (index >= items.size()) items.resize(index + 1);
+		item = &items[index];
+		*item = HierarchyItem(EntityContainer(entity));
+		_nItems++;
+	}
+
+	// Make sure parent is listed before its children
+	std::vector<Entity>* siblings = &roots;
+	if (parent != entt::null) {
+		HierarchyItem* parentItem = find(parent);
+		if (!parentItem) {
+			link(parent);
+			parentItem = find(parent);
+		}
+		siblings = &parentItem->children;
+	}
+
+	siblings->push_back(entity);
+	item->parent = parent;
+	rowsDirty = true;
+}
+
+void HierarchyModel::compact()
+{
+	if (dirtyParents.empty()) return;
+
+	std::sort(dirtyParents.begin(), dirtyParents.end());
+	dirtyParents.erase(std::unique(dirtyParents.begin(), dirtyParents.end()), dirtyParents.end());
+
+	for (Entity parent : dirtyParents) {
+		// Fetch children list of parent, removed parents don't have one anymore
+		std::vector<Entity>* children = &roots;
+		if (parent != entt::null) {
+			HierarchyItem* parentItem = find(parent);
+			if (!parentItem) continue;
+			children = &parentItem->children;
+		}
+
+		// Keep children still listed under this parent
+		auto moved = [&](Entity child) {
+			HierarchyItem* childItem = find(child);
+			return !childItem || childItem->parent != parent;
+			};
+		children->erase(std::remove_if(children->begin(), children->end(), moved), children->end());
+	}
+	dirtyParents.clear();
+
+	rowsDirty = true;
+}
+
+void HierarchyModel::buildRows()
+{
+	_rows.clear();
+
+	// Depth first traversal of expanded items, the stack holds items in reverse display order
+	std::vector<HierarchyRow> stack;
+	auto push = [&](const std::vector<Entity>& entities, uint32_t indentation) {
+		for (auto it = entities.rbegin(); it != entities.rend(); ++it) {
+			HierarchyItem* item = find(*it);
+			if (item) stack.push_back({ item, indentation });
+		}
+		};
+
+	push(roots, 0);
+	while (!stack.empty()) {
+		HierarchyRow row = stack.back();
+		stack.pop_back();
+		_rows.push_back(row);
+
+		if (row.item->expanded) push(row.item->children, row.indentation + 1);
+	}
+
+	rowsDirty = false;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <cstdint>
+
+#include <utils/event.h>
+#include <ecs/ecs_collection.h>
+
+// Item of the entity hierarchy, its address stays stable as long as its entity exists
+struct HierarchyItem {
+
+	explicit HierarchyItem(EntityContainer entity = EntityContainer()) : entity(entity), parent(entt::null), children(), expanded(false)
+	{
+	};
+
+	EntityContainer entity;
+
+	// Parent the item is currently listed under (null for root items)
+	Entity parent;
+
+	// Children in display order
+	std::vector<Entity> children;
+
+	bool expanded;
+
+	bool operator==(const HierarchyItem& other) {
+		return entity.id() == other.entity.id();
+	}
+
+};
+
+// Visible row of the flattened hierarchy
+struct HierarchyRow {
+
+	HierarchyItem* item;
+	uint32_t indentation;
+
+};
+
+// View model of the entity hierarchy, updated incrementally using the ecs signals instead of being rebuilt
+class HierarchyModel {
+public:
+	HierarchyModel();
+	~HierarchyModel();
+
+	void create(); // Subscribes to the main ecs and adds all existing entities
+	void destroy(); // Unsubscribes from the main ecs and clears all items
+
+	// Applies all entity changes since the last sync and rebuilds the rows if needed, returns true if any items were removed
+	bool sync();
+
+	// Returns all rows currently visible (stays valid until the next sync)
+	const std::vector<HierarchyRow>& rows() const;
+
+	// Returns the item of an entity or nullptr if the entity isn't part of the hierarchy
+	HierarchyItem* find(Entity entity);
+
+	// Expands or collapses an item, takes effect on the next sync
+	void setExpanded(HierarchyItem& item, bool expanded);
+
+	// Returns the amount of items
+	size_t nItems() const;
+
+private:
+	// Items indexed by entity index
+	std::deque<HierarchyItem> items;
+
+	// Root entities in display order
+	std::vector<Entity> roots;
+
+	// Flattened expanded hierarchy
+	std::vector<HierarchyRow> _rows;
+
+	// Set if the rows need to be rebuilt on the next sync
+	bool rowsDirty;
+
+	// Amount of items
+	size_t _nItems;
+
+	// Entities constructed or reparented since the last sync
+	std::vector<Entity> pendingEntities;
+
+	// Entities destroyed since the last sync
+	std::vector<Entity> destroyedEntities;
+
+	// Parents (null for roots) whose children lists contain moved or removed entities
+	std::vector<Entity> dirtyParents;
+
+	// Subscription to the ecs reparent event
+	EventHandle reparentSubscription;
+
+	// Registry signal receivers
+	void onConstruct(Entity entity);
+	void onDestroy(Entity entity);
+
+	// Adds an entity or moves it to its current parent, adds the parent first if needed
+	void link(Entity entity);
+
+	// Removes entries of moved or removed entities from the children lists of all dirty parents
+	void compact();
+
+	// Rebuilds the rows from all expanded items
+	void buildRows();
+};
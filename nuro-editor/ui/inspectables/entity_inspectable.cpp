@@ -20,12 +20,17 @@ void EntityInspectable::renderStaticContent(ImDrawList& drawList)
 	IMComponents::label(item.entity.name(), EditorUI::getFonts().h3_bold);
 	ImGui::Dummy(ImVec2(0.0f, 3.0f));
 
+	// Entity may have been destroyed while inspected
+	if (!item.entity.verify()) return;
+
 	ImVec2 searchPosition = ImGui::GetCursorScreenPos() + ImVec2(0.0f, 38.0f);
 	if (IMComponents::buttonBig("Add Component")) SearchPopup::searchComponents(searchPosition, item.entity.handle());
 }
 
 void EntityInspectable::renderDynamicContent(ImDrawList& drawList)
 {
+	if (!item.entity.verify()) return;
+
 	const auto& components = ComponentRegistry::get();
 	const auto& keysOrdered = ComponentRegistry::keysOrdered();
 
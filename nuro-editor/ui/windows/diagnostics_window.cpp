@@ -6,6 +6,28 @@
 #include <time/time.h>
 #include <diagnostics/profiler.h>
 #include <diagnostics/diagnostics.h>
+#include <diagnostics/frame_recorder.h>
+#include <context/application_context.h>
+
+namespace {
+
+	// Shows cpu and gpu time of a pass side by side
+	void _passLabel(const std::string& label, const std::string& identifier)
+	{
+		char buffer[64];
+		snprintf(buffer, sizeof(buffer), "%.2f / %.2f", Profiler::getMs(identifier), Profiler::getGpuMs(identifier));
+		IMComponents::indicatorLabel(label, std::string(buffer), "ms (CPU / GPU)");
+	}
+
+	// Shows draw calls, polygons and state changes of a pass
+	void _drawStatsLabel(const std::string& label, const Diagnostics::DrawStats& stats)
+	{
+		char buffer[96];
+		snprintf(buffer, sizeof(buffer), "%u / %u / %u", stats.drawCalls, stats.polygons, stats.shaderBinds + stats.materialBinds + stats.vaoBinds);
+		IMComponents::indicatorLabel(label, std::string(buffer), "(Draws / Polygons / Binds)");
+	}
+
+}
 
 DiagnosticsWindow::DiagnosticsWindow() : fpsCache(std::deque<float>(100)),
 fpsUpdateTimer(0.0f)
@@ -67,6 +89,17 @@ void DiagnosticsWindow::render()
 		IMComponents::indicatorLabel("Current Draw Calls:", Diagnostics::getCurrentDrawCalls());
 		IMComponents::indicatorLabel("Current Vertices:", Diagnostics::getCurrentVertices());
 		IMComponents::indicatorLabel("Current Polygons:", Diagnostics::getCurrentPolygons());
+		IMComponents::indicatorLabel("Draws Saved By Instancing:", Diagnostics::getCurrentInstancedDrawsSaved());
+
+		// Stats of last completed frame, current frame is still being rendered
+		const Diagnostics::FrameDrawStats& drawStats = Diagnostics::getLastDrawStats();
+		IMComponents::indicatorLabel("Shader Binds:", drawStats.total.shaderBinds);
+		IMComponents::indicatorLabel("Material Binds:", drawStats.total.materialBinds);
+		IMComponents::indicatorLabel("VAO Binds:", drawStats.total.vaoBinds);
+		IMComponents::indicatorLabel("Uploaded:", static_cast<float>(drawStats.total.uploadedBytes / 1024.0), "KB");
+		for (const Diagnostics::PassDrawStats& pass : drawStats.passes) {
+			_drawStatsLabel(pass.identifier + ":", pass.stats);
+		}
 
 		ImGui::Dummy(ImVec2(0.0f, 5.0f));
 
@@ -75,17 +108,36 @@ void DiagnosticsWindow::render()
 
 		ImGui::Dummy(ImVec2(0.0f, 5.0f));
 
-		IMComponents::indicatorLabel("Rendering:", Profiler::getMs("render"), "ms");
+		IMComponents::indicatorLabel("Shadow Casters:", Diagnostics::getCurrentShadowCasters());
+		IMComponents::indicatorLabel("Shadow Casters Culled:", Diagnostics::getCurrentShadowCastersCulled());
+		IMComponents::indicatorLabel("Shadow Renders Skipped:", Diagnostics::getShadowSkipRate() * 100.0f, "%");
+
+		ImGui::Dummy(ImVec2(0.0f, 5.0f));
+
+		_passLabel("Rendering:", "render");
 		IMComponents::indicatorLabel("Physics:", Profiler::getMs("physics"), "ms");
-		IMComponents::indicatorLabel("Shadow Pass:", Profiler::getMs("shadow_pass"), "ms");
+		_passLabel("Shadow Pass:", "shadow_pass");
+		_passLabel("Cascaded Shadow Pass:", "cascaded_shadow_pass");
+		IMComponents::indicatorLabel("Light Gathering:", Profiler::getMs("light_gathering"), "ms");
+		IMComponents::indicatorLabel("Light Culling:", Profiler::getMs("light_culling"), "ms");
 		IMComponents::indicatorLabel("Transform Pass:", Profiler::getUs("transform_pass"), "ns");
-		IMComponents::indicatorLabel("Pre Pass:", Profiler::getMs("pre_pass"), "ms");
-		IMComponents::indicatorLabel("SSAO Pass:", Profiler::getMs("ssao"), "ms");
-		IMComponents::indicatorLabel("Velocity Buffer Pass:", Profiler::getMs("velocity_buffer"), "ms");
-		IMComponents::indicatorLabel("Forward Pass:", Profiler::getMs("forward_pass"), "ms");
-		IMComponents::indicatorLabel("PP Pass:", Profiler::getMs("post_processing"), "ms");
-		IMComponents::indicatorLabel("UI Pass:", Profiler::getMs("ui_pass"), "ms");
-		IMComponents::indicatorLabel("Scene View:", Profiler::getMs("scene_view"), "ms");
+		_passLabel("Pre Pass:", "pre_pass");
+		_passLabel("SSAO Pass:", "ssao");
+		_passLabel("Forward Pass:", "forward_pass");
+		_passLabel("Forward Depth:", "forward_depth");
+		IMComponents::input("Depth Pre Pass", Runtime::gameViewPipeline().depthPrePass);
+		_passLabel("PP Pass:", "post_processing");
+		_passLabel("UI Pass:", "ui_pass");
+		_passLabel("Scene View:", "scene_view");
+
+		ImGui::Dummy(ImVec2(0.0f, 5.0f));
+
+		// Write recorded frames for offline analysis with nuro-capture
+		FrameRecorder& recorder = ApplicationContext::frameRecorder();
+		IMComponents::indicatorLabel("Recorded Frames:", recorder.nFrames());
+		if (IMComponents::buttonBig("Dump Frame Capture", "Writes all recorded frames to frame_capture.ncap")) {
+			if (recorder.dump("frame_capture.ncap")) Console::out::done("Diagnostics", "Wrote " + std::to_string(recorder.nFrames()) + " frames to frame_capture.ncap");
+		}
 	}
 	ImGui::End();
 }
\ No newline at end of file
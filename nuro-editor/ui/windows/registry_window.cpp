@@ -16,7 +16,7 @@ enum DropType {
 
 RegistryWindow::RegistryWindow() : searchBuffer(""),
 contextMenuUsed(false),
-currentHierarchy(),
+hierarchy(),
 selectedItems(),
 lastSelected(nullptr),
 lastHovered(nullptr),
@@ -36,6 +36,14 @@ cameraTarget(nullptr)
 	dragRectText.color = IM_COL32(255, 255, 255, 255);
 	dragRectText.alignment = TextAlign::CENTER;
 	dragRect.addText(dragRectText);
+
+	// Start tracking the hierarchy
+	hierarchy.create();
+}
+
+RegistryWindow::~RegistryWindow()
+{
+	hierarchy.destroy();
 }
 
 void RegistryWindow::render()
@@ -78,20 +86,22 @@ void RegistryWindow::renderSearch(ImDrawList& drawList)
 
 void RegistryWindow::renderHierarchy(ImDrawList& drawList)
 {
-	// tmp
-	static bool builtHierarchy = false;
-	if (!builtHierarchy) {
-		buildSceneHierarchy();
-		builtHierarchy = true;
-	}
+	// Apply entity changes since last frame
+	if (hierarchy.sync()) pruneRemovedItems();
 
 	// Push font
 	ImGui::PushFont(EditorUI::getFonts().p_bold);
 
-	// Render hierarchy
-	for (auto& item : currentHierarchy) {
-		renderItem(drawList, item, 0);
+	// Render visible rows only
+	const std::vector<HierarchyRow>& rows = hierarchy.rows();
+	ImGuiListClipper clipper;
+	clipper.Begin(static_cast<int>(rows.size()));
+	while (clipper.Step()) {
+		for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+			renderItem(drawList, *rows[i].item, rows[i].indentation);
+		}
 	}
+	clipper.End();
 
 	// Update camera movement
 	updateCameraMovement();
@@ -119,9 +129,9 @@ void RegistryWindow::renderItem(ImDrawList& drawList, HierarchyItem& item, uint3
 
 	ImGuiIO& io = ImGui::GetIO();
 
-	uint32_t itemId = item.entity.id();
+	Entity itemEntity = item.entity.handle();
 
-	const bool selected = selectedItems.count(itemId) > 0;
+	const bool selected = selectedItems.count(itemEntity) > 0;
 	const bool hasChildren = item.children.size() > 0;
 	const float itemHeight = ImGui::GetFontSize();
 	const float textOffset = indentation * indentationOffset;
@@ -215,10 +225,10 @@ void RegistryWindow::renderItem(ImDrawList& drawList, HierarchyItem& item, uint3
 
 		auto select = [this](HierarchyItem& _item) -> void {
 			// Item already selected
-			if (selectedItems.find(_item.entity.id()) != selectedItems.end()) return;
+			if (selectedItems.find(_item.entity.handle()) != selectedItems.end()) return;
 
 			// Select item
-			selectedItems[_item.entity.id()] = &_item;
+			selectedItems[_item.entity.handle()] = &_item;
 			Runtime::sceneViewPipeline().setSelectedEntity(&_item.entity);
 
 			// Update insight panel
@@ -228,12 +238,12 @@ void RegistryWindow::renderItem(ImDrawList& drawList, HierarchyItem& item, uint3
 		// Just handle current items selection
 		if (io.KeyCtrl) {
 			// Item not selected yet, add to selected items
-			if (selectedItems.find(itemId) == selectedItems.end()) {
+			if (selectedItems.find(itemEntity) == selectedItems.end()) {
 				select(item);
 			}
 			// Item already selected, remove from selected items
 			else {
-				selectedItems.erase(itemId);
+				selectedItems.erase(itemEntity);
 			}
 		}
 		// Select all between latest selection and this item
@@ -242,23 +252,24 @@ void RegistryWindow::renderItem(ImDrawList& drawList, HierarchyItem& item, uint3
 			if (!lastSelected) 
 				lastSelected = &item;
 			
-			// Find multiselect start and end elements
-			auto start = std::find(currentHierarchy.begin(), currentHierarchy.end(), *lastSelected);
-			auto end = std::find(currentHierarchy.begin(), currentHierarchy.end(), item);
+			// Find multiselect start and end rows
+			const std::vector<HierarchyRow>& rows = hierarchy.rows();
+			auto start = std::find_if(rows.begin(), rows.end(), [&](const HierarchyRow& row) { return row.item == lastSelected; });
+			auto end = std::find_if(rows.begin(), rows.end(), [&](const HierarchyRow& row) { return row.item == &item; });
 
-			// Select all items between start and end
-			if (start != currentHierarchy.end() && end != currentHierarchy.end()) {
+			// Select all visible items between start and end
+			if (start != rows.end() && end != rows.end()) {
 				if (start <= end) {
 					for (auto i = start; i != end; ++i) {
-						select(*i);
+						select(*i->item);
 					}
-					select(*end);
+					select(*end->item);
 				}
 				else {
 					for (auto i = start; i != end; --i) {
-						select(*i);
+						select(*i->item);
 					}
-					select(*end);
+					select(*end->item);
 				}
 			}
 		}
@@ -266,7 +277,7 @@ void RegistryWindow::renderItem(ImDrawList& drawList, HierarchyItem& item, uint3
 		else {
 			// If theres multiple selected items, only select this item if it's not among the multiple selected ones
 			if (selectedItems.size() > 1) {
-				if (selectedItems.find(itemId) == selectedItems.end()) {
+				if (selectedItems.find(itemEntity) == selectedItems.end()) {
 					selectedItems.clear();
 					select(item);
 				}
@@ -326,7 +337,7 @@ void RegistryWindow::renderItem(ImDrawList& drawList, HierarchyItem& item, uint3
 		
 		// Check for circle click or mouse wheel click (-> expand)
 		if (circleClicked || wheelClicked) 
-			item.expanded = !item.expanded;
+			hierarchy.setExpanded(item, !item.expanded);
 		
 		// Evaluate color
 		ImU32 circleColor = circleHovered && dropType == NO_DROP ? (selected ? UIUtils::darken(color, 0.25f) : EditorColor::elementActive) : color;
@@ -395,16 +406,6 @@ void RegistryWindow::renderItem(ImDrawList& drawList, HierarchyItem& item, uint3
 			break;
 		}
 	}
-
-	//
-	// RENDER CHILDREN
-	//
-
-	if (hasChildren && item.expanded) {
-		for (auto& child : item.children) {
-			renderItem(drawList, child, indentation + 1);
-		}
-	}
 }
 
 void RegistryWindow::renderDraggedItem()
@@ -539,35 +540,27 @@ void RegistryWindow::updateCameraMovement()
 	}
 }
 
-void RegistryWindow::buildSceneHierarchy() {
-	// Clear the current hierarchy before rebuilding
-	currentHierarchy.clear();
-
-	// Get all transforms
-	auto transforms = ECS::main().view<TransformComponent>();
-	std::vector<std::pair<entt::entity, TransformComponent>> transformList;
-
-	// Fill transform list for reversed iteration
-	for (auto [entity, transform] : transforms.each()) {
-		transformList.push_back({ entity, transform });
+void RegistryWindow::pruneRemovedItems()
+{
+	// Drop selected items which were removed
+	for (auto it = selectedItems.begin(); it != selectedItems.end();) {
+		if (!hierarchy.find(it->first)) it = selectedItems.erase(it);
+		else ++it;
 	}
 
-	// Recursively build root entities in reverse
-	for (auto it = transformList.rbegin(); it != transformList.rend(); ++it) {
-		auto& [entity, transform] = *it;
-		if (Transform::hasParent(transform)) continue;
-		HierarchyItem item = HierarchyItem(EntityContainer(entity));
-		buildHierarchyChildren(item);
-		currentHierarchy.push_back(item);
-	}
-}
+	// Unselect entity in scene view if its item was removed
+	const std::vector<EntityContainer*>& selectedEntities = Runtime::sceneViewPipeline().getSelectedEntities();
+	if (!selectedEntities.empty() && selectedItems.find(selectedEntities[0]->handle()) == selectedItems.end())
+		Runtime::sceneViewPipeline().unselectEntities();
 
-void RegistryWindow::buildHierarchyChildren(HierarchyItem& parent) {
-	for (Entity childEntity : parent.entity.transform().children) {
-		HierarchyItem item = HierarchyItem(EntityContainer(childEntity));
-		buildHierarchyChildren(item);
-		parent.children.push_back(item);
-	}
+	// Removed items may have been cached
+	lastSelected = nullptr;
+	lastHovered = nullptr;
+
+	// Camera target may have been removed
+	cameraTarget = nullptr;
+	cameraMoving = false;
+	cameraMovementTime = 0.0f;
 }
 
 void RegistryWindow::setCameraTarget(TransformComponent* target)
@@ -6,29 +6,15 @@
 #include <unordered_map>
 
 #include "editor_window.h"
+#include "../ui/hierarchy/hierarchy_model.h"
 
 #include <ecs/ecs_collection.h>
 
-struct HierarchyItem {
-
-	explicit HierarchyItem(EntityContainer entity, std::vector<HierarchyItem> children = {}) : entity(entity), children(children), expanded(false)
-	{
-	};
-
-	EntityContainer entity;
-	std::vector<HierarchyItem> children;
-	bool expanded;
-
-	bool operator==(const HierarchyItem& other) {
-		return entity.id() == other.entity.id();
-	}
-
-};
-
 class RegistryWindow : public EditorWindow
 {
 public:
 	RegistryWindow();
+	~RegistryWindow();
 
 	void render() override;
 
@@ -39,7 +25,7 @@ private:
 	// Renders the current hierarchy as a whole
 	void renderHierarchy(ImDrawList& drawList);
 
-	// Renders a given item and all of its children
+	// Renders a single row of the hierarchy
 	void renderItem(ImDrawList& drawList, HierarchyItem& item, uint32_t indentation);
 
 	// Renders the indicator for the item currently dragged
@@ -51,11 +37,8 @@ private:
 	// Updates camera movement
 	void updateCameraMovement();
 
-	// Builds the opened scene into a hierarchy
-	void buildSceneHierarchy();
-
-	// Builds the children of a parent recursively
-	void buildHierarchyChildren(HierarchyItem& parent);
+	// Drops selections, hovers and camera targets of items removed from the hierarchy
+	void pruneRemovedItems();
 
 	// Sets a new target for the camera movement
 	void setCameraTarget(TransformComponent* target);
@@ -69,10 +52,10 @@ private:
 	bool contextMenuUsed;
 
 	// Current hierarchy
-	std::vector<HierarchyItem> currentHierarchy;
+	HierarchyModel hierarchy;
 
-	// Map of pointers to the currently selected items of the hierarchy sorted by their id
-	std::unordered_map<uint32_t, HierarchyItem*> selectedItems;
+	// Map of pointers to the currently selected items of the hierarchy sorted by their entity
+	std::unordered_map<Entity, HierarchyItem*> selectedItems;
 
 	HierarchyItem* lastSelected;
 	HierarchyItem* lastHovered;
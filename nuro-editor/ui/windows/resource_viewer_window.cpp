@@ -21,57 +21,62 @@ void ResourceViewerWindow::render()
 
 		IMComponents::headline("Resource Viewer", ICON_FA_DATABASE);
 
-		//
-		// TEMPORARY!
-		// Inefficient, just for debugging
-		//
-
-		const auto& resources = ApplicationContext::resourceManager().readResources();
+		ResourceManager& manager = ApplicationContext::resourceManager();
 
 		IMComponents::label("Resources allocated: ", EditorUI::getFonts().h4);
 		ImGui::SameLine();
-		IMComponents::label(std::to_string(resources.size()), EditorUI::getFonts().h4_bold);
+		IMComponents::label(std::to_string(manager.nResources()), EditorUI::getFonts().h4_bold);
+
+		IMComponents::label("Awaiting destruction: ", EditorUI::getFonts().h4);
+		ImGui::SameLine();
+		IMComponents::label(std::to_string(manager.nRetired()), EditorUI::getFonts().h4_bold);
 
 		ImGui::Dummy(ImVec2(0.0f, 5.0f));
 		
 		ImGui::BeginChild(EditorUI::generateId(), ImVec2(ImGui::GetContentRegionAvail()));
 		{
-			for (const auto& [id, resource] : resources) {
-				IMComponents::label("ID " + std::to_string(id) + ": ", EditorUI::getFonts().p_bold);
-				ImGui::SameLine();
+			// Resources are listed per type
+			for (const ResourcePool& pool : manager.readPools()) {
+				if (pool.resources.empty()) continue;
+				if (!IMComponents::header(pool.typeName + " (" + std::to_string(pool.resources.size()) + ")###" + pool.typeName)) continue;
 
-				IMComponents::label(resource->resourceName() + " - ");
-				ImGui::SameLine();
-
-				ImVec2 pos = ImGui::GetCursorScreenPos();
-				switch (resource->resourceState()) {
-				case ResourceState::EMPTY:
-					IMComponents::label("EMPTY", IM_COL32(255, 255, 0, 255));
-					ImGui::SameLine();
-					break;
-				case ResourceState::QUEUED:
-					IMComponents::label("QUEUED", IM_COL32(180, 180, 255, 255));
+				for (const ResourceRef<Resource>& resource : pool.resources) {
+					IMComponents::label("ID " + std::to_string(resource->resourceId()) + ": ", EditorUI::getFonts().p_bold);
 					ImGui::SameLine();
-					break;
-				case ResourceState::LOADING:
-					IMComponents::label("CREATING...", IM_COL32(100, 255, 145, 255));
-					ImGui::SetCursorScreenPos(pos);
-					IMComponents::loadingBuffer(drawList, pos + ImVec2(74.0f, 3.0f), 5.0f, 2.0f, IM_COL32(255, 255, 255, 200));
-					ImGui::SetCursorScreenPos(pos + ImVec2(83.0f, 0.0f));
-					break;
-				case ResourceState::READY:
-					IMComponents::label("READY", IM_COL32(0, 255, 0, 255));
+
+					IMComponents::label(resource->resourceName() + " - ");
 					ImGui::SameLine();
-					break;
-				case ResourceState::FAILED:
-					IMComponents::label("FAILED", IM_COL32(255, 50, 50, 255));
+
+					ImVec2 pos = ImGui::GetCursorScreenPos();
+					switch (resource->resourceState()) {
+					case ResourceState::EMPTY:
+						IMComponents::label("EMPTY", IM_COL32(255, 255, 0, 255));
+						ImGui::SameLine();
+						break;
+					case ResourceState::QUEUED:
+						IMComponents::label("QUEUED", IM_COL32(180, 180, 255, 255));
+						ImGui::SameLine();
+						break;
+					case ResourceState::LOADING:
+						IMComponents::label("CREATING...", IM_COL32(100, 255, 145, 255));
+						ImGui::SetCursorScreenPos(pos);
+						IMComponents::loadingBuffer(drawList, pos + ImVec2(74.0f, 3.0f), 5.0f, 2.0f, IM_COL32(255, 255, 255, 200));
+						ImGui::SetCursorScreenPos(pos + ImVec2(83.0f, 0.0f));
+						break;
+					case ResourceState::READY:
+						IMComponents::label("READY", IM_COL32(0, 255, 0, 255));
+						ImGui::SameLine();
+						break;
+					case ResourceState::FAILED:
+						IMComponents::label("FAILED", IM_COL32(255, 50, 50, 255));
+						ImGui::SameLine();
+						break;
+					}
+
+					IMComponents::label("- Used by: ");
 					ImGui::SameLine();
-					break;
+					IMComponents::label(std::to_string(resource.use_count() - 1));
 				}
-
-				IMComponents::label("- Used by: ");
-				ImGui::SameLine();
-				IMComponents::label(std::to_string(resource.use_count() - 1));
 			}
 		}
 		ImGui::EndChild();
@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <set>
+#include <memory>
+
+#include <diagnostics/gpu_profiler.h>
+
+namespace {
+
+	// Backend recording timestamps in host memory, results become available a given amount of frames after they were recorded
+	class MockBackend : public GPUTimerBackend
+	{
+	public:
+		uint32_t createQuery() override
+		{
+			liveQueries.insert(nextQuery);
+			nCreated++;
+			return nextQuery++;
+		}
+
+		void destroyQuery(uint32_t query) override
+		{
+			EXPECT_EQ(liveQueries.erase(query), 1u) << "destroyed unknown query " << query;
+		}
+
+		void timestamp(uint32_t query) override
+		{
+			EXPECT_TRUE(liveQueries.count(query)) << "timestamp into unknown query " << query;
+			clock += TICK;
+			recorded[query] = { clock, frame };
+		}
+
+		bool available(uint32_t query) override
+		{
+			return frame - recorded.at(query).frame >= latency;
+		}
+
+		uint64_t result(uint32_t query) override
+		{
+			EXPECT_TRUE(available(query)) << "read back unavailable query " << query << ", this would stall";
+			return recorded.at(query).time;
+		}
+
+		// Time between two timestamps in nanoseconds
+		static constexpr uint64_t TICK = 1'000'000;
+
+		struct Timestamp
+		{
+			uint64_t time;
+			uint64_t frame;
+		};
+
+		uint64_t clock = 0;
+		uint64_t frame = 0;
+		uint64_t latency = 0;
+		uint32_t nCreated = 0;
+		std::set<uint32_t> liveQueries;
+		std::map<uint32_t, Timestamp> recorded;
+
+	private:
+		uint32_t nextQuery = 1;
+	};
+
+	struct GPUProfilerTest : public ::testing::Test
+	{
+		GPUProfilerTest() : backend(new MockBackend()), profiler(std::unique_ptr<GPUTimerBackend>(backend))
+		{
+		}
+
+		// Advances the mock and the profiler to the next frame
+		void nextFrame()
+		{
+			backend->frame++;
+			profiler.beginFrame();
+		}
+
+		MockBackend* backend;
+		GPUProfiler profiler;
+	};
+
+}
+
+TEST_F(GPUProfilerTest, ReadsBackAfterAllFrameSlots)
+{
+	nextFrame();
+	profiler.start("zone");
+	profiler.stop("zone");
+
+	// Results of a frame are read back once its slot is reused
+	for (uint32_t i = 0; i < GPUProfiler::N_FRAMES - 1; i++) {
+		nextFrame();
+		EXPECT_EQ(profiler.getUs("zone"), 0.0);
+	}
+
+	nextFrame();
+	EXPECT_DOUBLE_EQ(profiler.getMs("zone"), 1.0);
+	EXPECT_DOUBLE_EQ(profiler.getUs("zone"), 1000.0);
+	EXPECT_EQ(profiler.nDropped(), 0u);
+}
+
+TEST_F(GPUProfilerTest, MeasuresNestedZones)
+{
+	nextFrame();
+	profiler.start("outer");
+	profiler.start("inner");
+	profiler.stop("inner");
+	profiler.stop("outer");
+
+	for (uint32_t i = 0; i < GPUProfiler::N_FRAMES; i++) nextFrame();
+
+	EXPECT_DOUBLE_EQ(profiler.getMs("outer"), 3.0);
+	EXPECT_DOUBLE_EQ(profiler.getMs("inner"), 1.0);
+}
+
+TEST_F(GPUProfilerTest, RecyclesQueries)
+{
+	for (uint32_t i = 0; i < 10 * GPUProfiler::N_FRAMES; i++) {
+		nextFrame();
+		profiler.start("a");
+		profiler.start("b");
+		profiler.stop("b");
+		profiler.stop("a");
+	}
+
+	// Two queries per zone and frame slot, reused once their slot was read back
+	EXPECT_EQ(profiler.nQueries(), 4 * GPUProfiler::N_FRAMES);
+	EXPECT_EQ(backend->nCreated, 4 * GPUProfiler::N_FRAMES);
+	EXPECT_EQ(profiler.nDropped(), 0u);
+}
+
+TEST_F(GPUProfilerTest, DropsUnavailableZonesWithoutBlocking)
+{
+	// Warm up with available results
+	for (uint32_t i = 0; i < 2 * GPUProfiler::N_FRAMES; i++) {
+		nextFrame();
+		profiler.start("zone");
+		profiler.stop("zone");
+	}
+	EXPECT_DOUBLE_EQ(profiler.getMs("zone"), 1.0);
+
+	// Gpu falls further behind than there are frame slots, previous time is kept
+	backend->latency = GPUProfiler::N_FRAMES + 1;
+	for (uint32_t i = 0; i < 2 * GPUProfiler::N_FRAMES; i++) {
+		nextFrame();
+		profiler.start("zone");
+		profiler.stop("zone");
+	}
+	EXPECT_EQ(profiler.nDropped(), 2 * GPUProfiler::N_FRAMES);
+	EXPECT_DOUBLE_EQ(profiler.getMs("zone"), 1.0);
+
+	// Queries of dropped zones are recycled too
+	EXPECT_EQ(profiler.nQueries(), 2 * GPUProfiler::N_FRAMES);
+}
+
+TEST_F(GPUProfilerTest, DropsUnstoppedZones)
+{
+	nextFrame();
+	profiler.start("zone");
+
+	for (uint32_t i = 0; i < GPUProfiler::N_FRAMES; i++) nextFrame();
+
+	EXPECT_EQ(profiler.nDropped(), 1u);
+	EXPECT_EQ(profiler.getUs("zone"), 0.0);
+
+	// Start query was recycled
+	profiler.start("zone");
+	profiler.stop("zone");
+	EXPECT_EQ(profiler.nQueries(), 2u);
+}
+
+TEST_F(GPUProfilerTest, DestroyReleasesAllQueries)
+{
+	for (uint32_t i = 0; i < GPUProfiler::N_FRAMES + 1; i++) {
+		nextFrame();
+		profiler.start("zone");
+		profiler.stop("zone");
+	}
+	ASSERT_FALSE(backend->liveQueries.empty());
+
+	profiler.destroy();
+	EXPECT_TRUE(backend->liveQueries.empty());
+	EXPECT_EQ(profiler.nQueries(), 0u);
+}
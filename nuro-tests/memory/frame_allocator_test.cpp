@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <set>
+#include <vector>
+#include <cstring>
+
+#include <memory/frame_allocator.h>
+
+namespace {
+
+	// Backend recording buffers and fences in host memory
+	class MockBackend : public FrameAllocatorBackend
+	{
+	public:
+		uint32_t createBuffer(uint32_t size, uint8_t*& mapping) override
+		{
+			uint32_t id = nextBuffer++;
+			buffers[id].resize(size);
+			mapping = buffers[id].data();
+			return id;
+		}
+
+		void destroyBuffer(uint32_t buffer) override
+		{
+			EXPECT_EQ(buffers.erase(buffer), 1u) << "destroyed unknown buffer " << buffer;
+		}
+
+		uint64_t insertFence() override
+		{
+			liveFences.insert(nextFence);
+			return nextFence++;
+		}
+
+		void waitFence(uint64_t fence) override
+		{
+			EXPECT_TRUE(liveFences.count(fence)) << "waited on released fence " << fence;
+			waitedFences.push_back(fence);
+		}
+
+		void releaseFence(uint64_t fence) override
+		{
+			EXPECT_EQ(liveFences.erase(fence), 1u) << "released unknown fence " << fence;
+		}
+
+		std::map<uint32_t, std::vector<uint8_t>> buffers;
+		std::set<uint64_t> liveFences;
+		std::vector<uint64_t> waitedFences;
+
+	private:
+		uint32_t nextBuffer = 1;
+		uint64_t nextFence = 1;
+	};
+
+	struct FrameAllocatorTest : public ::testing::Test
+	{
+		FrameAllocatorTest() : backend(new MockBackend()), allocator(std::unique_ptr<FrameAllocatorBackend>(backend))
+		{
+		}
+
+		// Owned by the allocator
+		MockBackend* backend;
+		FrameAllocator allocator;
+	};
+
+}
+
+TEST_F(FrameAllocatorTest, RotatesThroughRegions)
+{
+	allocator.create(256);
+
+	for (uint32_t i = 0; i < FrameAllocator::N_REGIONS * 2; i++) {
+		allocator.beginFrame();
+		EXPECT_EQ(allocator.currentRegion(), (i + 1) % FrameAllocator::N_REGIONS);
+
+		FrameAllocator::Allocation allocation = allocator.allocate(16, 4);
+		ASSERT_TRUE(allocation.valid());
+		EXPECT_EQ(allocation.offset, allocator.currentRegion() * 256);
+		EXPECT_EQ(allocation.data, backend->buffers[allocation.buffer].data() + allocation.offset);
+
+		allocator.endFrame();
+	}
+}
+
+TEST_F(FrameAllocatorTest, AlignsWithinRegion)
+{
+	allocator.create(256);
+	allocator.beginFrame();
+
+	FrameAllocator::Allocation a = allocator.allocate(10, 16);
+	FrameAllocator::Allocation b = allocator.allocate(10, 16);
+	FrameAllocator::Allocation c = allocator.allocate(1, 1);
+
+	EXPECT_EQ(b.offset, a.offset + 16);
+	EXPECT_EQ(c.offset, b.offset + 10);
+	EXPECT_EQ(allocator.used(), 27u);
+}
+
+TEST_F(FrameAllocatorTest, WaitsForFenceOfReusedRegionOnly)
+{
+	allocator.create(256);
+
+	// First N_REGIONS frames write fresh regions, nothing to wait for
+	for (uint32_t i = 0; i < FrameAllocator::N_REGIONS; i++) {
+		allocator.beginFrame();
+		allocator.allocate(8, 4);
+		allocator.endFrame();
+	}
+	EXPECT_TRUE(backend->waitedFences.empty());
+	EXPECT_EQ(backend->liveFences.size(), FrameAllocator::N_REGIONS);
+
+	// Returning to the first region waits for the fence inserted N_REGIONS frames ago
+	allocator.beginFrame();
+	ASSERT_EQ(backend->waitedFences.size(), 1u);
+	EXPECT_EQ(backend->waitedFences[0], 1u);
+	EXPECT_EQ(backend->liveFences.size(), FrameAllocator::N_REGIONS - 1);
+}
+
+TEST_F(FrameAllocatorTest, SkipsFenceOfEmptyFrame)
+{
+	allocator.create(256);
+	allocator.beginFrame();
+	allocator.endFrame();
+	EXPECT_TRUE(backend->liveFences.empty());
+}
+
+TEST_F(FrameAllocatorTest, WritesData)
+{
+	allocator.create(64);
+	allocator.beginFrame();
+
+	const uint32_t value = 0xDEADBEEF;
+	FrameAllocator::Allocation allocation = allocator.write(&value, sizeof(value), 4);
+	ASSERT_TRUE(allocation.valid());
+
+	uint32_t read = 0;
+	std::memcpy(&read, backend->buffers[allocation.buffer].data() + allocation.offset, sizeof(read));
+	EXPECT_EQ(read, value);
+}
+
+TEST_F(FrameAllocatorTest, RejectsEmptyAndUncreated)
+{
+	EXPECT_FALSE(allocator.allocate(16, 4).valid());
+
+	allocator.create(64);
+	allocator.beginFrame();
+	EXPECT_FALSE(allocator.allocate(0, 4).valid());
+}
+
+TEST_F(FrameAllocatorTest, GrowsAndRetiresOldBuffer)
+{
+	allocator.create(256);
+
+	allocator.beginFrame();
+	allocator.allocate(64, 4);
+	allocator.endFrame();
+
+	allocator.beginFrame();
+	FrameAllocator::Allocation a = allocator.allocate(200, 4);
+	uint32_t oldBuffer = a.buffer;
+
+	// Exhausting the region switches to a bigger buffer, the old one stays alive for this frame's allocations
+	FrameAllocator::Allocation b = allocator.allocate(200, 4);
+	ASSERT_TRUE(b.valid());
+	EXPECT_NE(b.buffer, oldBuffer);
+	EXPECT_EQ(allocator.regionSize(), 512u);
+	EXPECT_EQ(backend->buffers.size(), 2u);
+
+	// Fences of the old buffer are released instead of waited on
+	EXPECT_TRUE(backend->liveFences.empty());
+	allocator.endFrame();
+
+	// Old buffer is destroyed once no region can reference it anymore
+	for (uint32_t i = 0; i < FrameAllocator::N_REGIONS - 1; i++) {
+		allocator.beginFrame();
+		allocator.endFrame();
+		EXPECT_EQ(backend->buffers.count(oldBuffer), 1u);
+	}
+	allocator.beginFrame();
+	EXPECT_EQ(backend->buffers.count(oldBuffer), 0u);
+	EXPECT_EQ(backend->buffers.size(), 1u);
+}
+
+TEST_F(FrameAllocatorTest, GrowsToFitOversizedAllocation)
+{
+	allocator.create(64);
+	allocator.beginFrame();
+
+	FrameAllocator::Allocation allocation = allocator.allocate(1000, 16);
+	ASSERT_TRUE(allocation.valid());
+	EXPECT_GE(allocator.regionSize(), 1000u);
+	EXPECT_EQ(allocation.offset % 16, 0u);
+
+	// Regions of the grown buffer stay aligned, so do allocations made from them
+	EXPECT_EQ(allocator.regionSize() % FrameAllocator::REGION_ALIGNMENT, 0u);
+	allocator.endFrame();
+	allocator.beginFrame();
+	EXPECT_EQ(allocator.allocate(8, 16).offset % 16, 0u);
+}
+
+TEST_F(FrameAllocatorTest, RoundsRegionSize)
+{
+	allocator.create(100);
+	EXPECT_EQ(allocator.regionSize(), FrameAllocator::REGION_ALIGNMENT);
+}
+
+TEST_F(FrameAllocatorTest, DestroyReleasesEverything)
+{
+	allocator.create(64);
+	for (uint32_t i = 0; i < 2; i++) {
+		allocator.beginFrame();
+		allocator.allocate(100, 4);
+		allocator.endFrame();
+	}
+
+	allocator.destroy();
+	EXPECT_TRUE(backend->buffers.empty());
+	EXPECT_TRUE(backend->liveFences.empty());
+	EXPECT_EQ(allocator.backendId(), 0u);
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <memory/range_allocator.h>
+
+TEST(RangeAllocator, AllocatesFirstFit)
+{
+	RangeAllocator allocator(100);
+
+	EXPECT_EQ(allocator.allocate(10), 0u);
+	EXPECT_EQ(allocator.allocate(20), 10u);
+	EXPECT_EQ(allocator.allocate(30), 30u);
+
+	// Free a hole in front of a bigger free tail, the hole is taken first
+	allocator.free(10);
+	EXPECT_EQ(allocator.allocate(15), 10u);
+
+	// Remainder of the hole is too small, request falls through to the tail
+	EXPECT_EQ(allocator.allocate(10), 60u);
+
+	EXPECT_EQ(allocator.used(), 65u);
+	EXPECT_EQ(allocator.nAllocations(), 4u);
+}
+
+TEST(RangeAllocator, RejectsEmptyAllocations)
+{
+	RangeAllocator allocator(10);
+	EXPECT_EQ(allocator.allocate(0), RangeAllocator::INVALID_OFFSET);
+	EXPECT_EQ(allocator.nAllocations(), 0u);
+}
+
+TEST(RangeAllocator, MergesFreedRangeWithBothNeighbours)
+{
+	RangeAllocator allocator(30);
+	uint32_t a = allocator.allocate(10);
+	uint32_t b = allocator.allocate(10);
+	uint32_t c = allocator.allocate(10);
+
+	allocator.free(a);
+	allocator.free(c);
+	EXPECT_EQ(allocator.largestFreeRange(), 10u);
+
+	// Freeing the middle range joins all three into one
+	allocator.free(b);
+	EXPECT_EQ(allocator.largestFreeRange(), 30u);
+	EXPECT_EQ(allocator.used(), 0u);
+	EXPECT_EQ(allocator.allocate(30), 0u);
+}
+
+TEST(RangeAllocator, MergesFreedRangeWithPrecedingAndFollowing)
+{
+	RangeAllocator allocator(40);
+	uint32_t a = allocator.allocate(10);
+	uint32_t b = allocator.allocate(10);
+	uint32_t c = allocator.allocate(10);
+	allocator.allocate(10);
+
+	// Following neighbour only
+	allocator.free(b);
+	allocator.free(a);
+	EXPECT_EQ(allocator.largestFreeRange(), 20u);
+
+	// Preceding neighbour only
+	allocator.free(c);
+	EXPECT_EQ(allocator.largestFreeRange(), 30u);
+}
+
+TEST(RangeAllocator, FragmentationLimitsLargestRange)
+{
+	RangeAllocator allocator(100);
+
+	uint32_t offsets[10];
+	for (uint32_t i = 0; i < 10; i++) offsets[i] = allocator.allocate(10);
+
+	// Free every other range, half the space is free but scattered
+	for (uint32_t i = 0; i < 10; i += 2) allocator.free(offsets[i]);
+	EXPECT_EQ(allocator.capacity() - allocator.used(), 50u);
+	EXPECT_EQ(allocator.largestFreeRange(), 10u);
+	EXPECT_EQ(allocator.allocate(11), RangeAllocator::INVALID_OFFSET);
+
+	// Freeing the rest coalesces everything again
+	for (uint32_t i = 1; i < 10; i += 2) allocator.free(offsets[i]);
+	EXPECT_EQ(allocator.largestFreeRange(), 100u);
+}
+
+TEST(RangeAllocator, ExhaustionAndGrowth)
+{
+	RangeAllocator allocator(50);
+	EXPECT_EQ(allocator.allocate(50), 0u);
+	EXPECT_EQ(allocator.allocate(1), RangeAllocator::INVALID_OFFSET);
+
+	// Grown space is appended behind existing allocations
+	allocator.grow(80);
+	EXPECT_EQ(allocator.largestFreeRange(), 30u);
+	EXPECT_EQ(allocator.allocate(30), 50u);
+
+	// Capacity never shrinks
+	allocator.grow(10);
+	EXPECT_EQ(allocator.capacity(), 80u);
+}
+
+TEST(RangeAllocator, GrowMergesWithFreeTail)
+{
+	RangeAllocator allocator(50);
+	allocator.allocate(40);
+	allocator.grow(100);
+	EXPECT_EQ(allocator.largestFreeRange(), 60u);
+}
+
+TEST(RangeAllocator, IgnoresUnknownOffsets)
+{
+	RangeAllocator allocator(20);
+	allocator.allocate(10);
+	allocator.free(5);
+	allocator.free(RangeAllocator::INVALID_OFFSET);
+	EXPECT_EQ(allocator.used(), 10u);
+	EXPECT_EQ(allocator.nAllocations(), 1u);
+}
+
+TEST(RangeAllocator, ResetReleasesEverything)
+{
+	RangeAllocator allocator(20);
+	allocator.allocate(5);
+	allocator.allocate(5);
+	allocator.reset();
+	EXPECT_EQ(allocator.used(), 0u);
+	EXPECT_EQ(allocator.nAllocations(), 0u);
+	EXPECT_EQ(allocator.largestFreeRange(), 20u);
+}
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <glm/glm.hpp>
+
+#include <rendering/gizmos/gizmo_batch.h>
+
+namespace {
+
+	constexpr float EPSILON = 1e-5f;
+
+	const glm::vec3 CAMERA = glm::vec3(0.0f);
+
+}
+
+TEST(GizmoBatch, BoxIsTwelveLines)
+{
+	glm::mat4 model(1.0f);
+	model[0][0] = 2.0f;
+	model[3] = glm::vec4(10.0f, 0.0f, 0.0f, 1.0f);
+
+	GizmoBatch batch;
+	batch.addShape(GizmoBatch::Shape::BOX, model, glm::vec4(1.0f, 0.0f, 0.0f, 0.5f), false);
+
+	const auto& lines = batch.getLines();
+	ASSERT_EQ(lines.size(), 24u);
+	EXPECT_TRUE(batch.getForegroundLines().empty());
+
+	// Unit box spans -1 to 1, vertices are transformed to world space
+	for (const GizmoBatch::LineVertex& vertex : lines) {
+		EXPECT_NEAR(std::abs(vertex.position.x - 10.0f), 2.0f, EPSILON);
+		EXPECT_NEAR(std::abs(vertex.position.y), 1.0f, EPSILON);
+		EXPECT_NEAR(std::abs(vertex.position.z), 1.0f, EPSILON);
+		EXPECT_EQ(vertex.color, glm::vec4(1.0f, 0.0f, 0.0f, 0.5f));
+	}
+}
+
+TEST(GizmoBatch, PlaneIsFourLines)
+{
+	GizmoBatch batch;
+	batch.addShape(GizmoBatch::Shape::PLANE, glm::mat4(1.0f), glm::vec4(1.0f), false);
+	EXPECT_EQ(batch.getLines().size(), 8u);
+}
+
+TEST(GizmoBatch, SphereIsThreeCircles)
+{
+	GizmoBatch batch;
+	batch.addShape(GizmoBatch::Shape::SPHERE, glm::mat4(3.0f), glm::vec4(1.0f), false);
+
+	const auto& lines = batch.getLines();
+	ASSERT_EQ(lines.size(), 3 * GizmoBatch::SPHERE_SEGMENTS * 2);
+
+	// Unit sphere has a radius of 1, every vertex lies on the scaled sphere
+	for (const GizmoBatch::LineVertex& vertex : lines) {
+		EXPECT_NEAR(glm::length(glm::vec3(vertex.position)), 3.0f, 1e-4f);
+	}
+}
+
+TEST(GizmoBatch, SplitsForegroundShapes)
+{
+	GizmoBatch batch;
+	batch.addShape(GizmoBatch::Shape::BOX, glm::mat4(1.0f), glm::vec4(1.0f), false);
+	batch.addShape(GizmoBatch::Shape::SPHERE, glm::mat4(1.0f), glm::vec4(1.0f), true);
+	batch.addShape(GizmoBatch::Shape::PLANE, glm::mat4(1.0f), glm::vec4(1.0f), false);
+
+	EXPECT_EQ(batch.getLines().size(), 24u + 8u);
+	EXPECT_EQ(batch.getForegroundLines().size(), 3 * GizmoBatch::SPHERE_SEGMENTS * 2);
+}
+
+TEST(GizmoBatch, GroupsIconsByTexture)
+{
+	GizmoBatch batch;
+	batch.addIcon(7, glm::vec3(0.0f, 0.0f, 5.0f), 1.0f, CAMERA);
+	batch.addIcon(3, glm::vec3(0.0f, 0.0f, 60.0f), 1.0f, CAMERA);
+	batch.addIcon(3, glm::vec3(0.0f, 0.0f, 1.5f), 1.0f, CAMERA);
+	batch.addIcon(7, glm::vec3(5.0f, 0.0f, 0.0f), 2.0f, CAMERA);
+	batch.addIcon(3, glm::vec3(0.0f, 0.0f, 0.2f), 1.0f, CAMERA);
+	EXPECT_EQ(batch.nIcons(), 5u);
+
+	batch.buildIcons(glm::mat4(1.0f));
+
+	// Icon out of render radius is dropped, the rest is ordered by texture
+	ASSERT_EQ(batch.getIconInstances().size(), 4u);
+	const auto& groups = batch.getIconGroups();
+	ASSERT_EQ(groups.size(), 2u);
+	EXPECT_EQ(groups[0].texture, 3u);
+	EXPECT_EQ(groups[0].firstInstance, 0u);
+	EXPECT_EQ(groups[0].nInstances, 2u);
+	EXPECT_EQ(groups[1].texture, 7u);
+	EXPECT_EQ(groups[1].firstInstance, 2u);
+	EXPECT_EQ(groups[1].nInstances, 2u);
+}
+
+TEST(GizmoBatch, BuildsCameraFacingBillboards)
+{
+	GizmoBatch batch;
+	batch.addIcon(1, glm::vec3(0.0f, 0.0f, 5.0f), 1.0f, CAMERA);
+	batch.addIcon(2, glm::vec3(5.0f, 0.0f, 0.0f), 2.0f, CAMERA);
+	batch.buildIcons(glm::mat4(1.0f));
+
+	const auto& instances = batch.getIconInstances();
+	ASSERT_EQ(instances.size(), 2u);
+
+	// Icon in front of the camera faces it, its right axis points to -x
+	glm::vec4 right = instances[0].mvpMatrix * glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+	EXPECT_NEAR(right.x, -1.0f, EPSILON);
+	EXPECT_NEAR(right.z, 5.0f, EPSILON);
+
+	// Scale is applied to the billboard
+	glm::vec4 up = instances[1].mvpMatrix * glm::vec4(0.0f, 1.0f, 0.0f, 1.0f);
+	EXPECT_NEAR(up.x, 5.0f, EPSILON);
+	EXPECT_NEAR(up.y, 2.0f, EPSILON);
+}
+
+TEST(GizmoBatch, FadesIconsNearCamera)
+{
+	GizmoBatch batch;
+	batch.addIcon(1, glm::vec3(0.0f, 0.0f, 1.5f), 1.0f, CAMERA);
+	batch.addIcon(2, glm::vec3(0.0f, 0.0f, 0.2f), 1.0f, CAMERA);
+	batch.addIcon(3, glm::vec3(0.0f, 0.0f, 5.0f), 1.0f, CAMERA);
+	batch.buildIcons(glm::mat4(1.0f));
+
+	const auto& instances = batch.getIconInstances();
+	ASSERT_EQ(instances.size(), 3u);
+
+	// Halfway through the fade range
+	EXPECT_NEAR(instances[0].alpha.x, 0.5f, EPSILON);
+	EXPECT_NEAR(instances[0].alpha.y, GizmoBatch::ICON_FOREGROUND_ALPHA * 0.5f, EPSILON);
+
+	// Closer than the min distance
+	EXPECT_EQ(instances[1].alpha.x, 0.0f);
+	EXPECT_EQ(instances[1].alpha.y, 0.0f);
+
+	// Beyond the max distance
+	EXPECT_EQ(instances[2].alpha.x, 1.0f);
+	EXPECT_NEAR(instances[2].alpha.y, GizmoBatch::ICON_FOREGROUND_ALPHA, EPSILON);
+}
+
+TEST(GizmoBatch, IconAlphaClampsToFadeRange)
+{
+	EXPECT_EQ(GizmoBatch::iconAlpha(1.0f, 0.0f), 0.0f);
+	EXPECT_EQ(GizmoBatch::iconAlpha(1.0f, GizmoBatch::ICON_FADE_MIN_DISTANCE), 0.0f);
+	EXPECT_EQ(GizmoBatch::iconAlpha(0.8f, GizmoBatch::ICON_FADE_MAX_DISTANCE), 0.8f);
+	EXPECT_EQ(GizmoBatch::iconAlpha(0.8f, 100.0f), 0.8f);
+}
+
+TEST(GizmoBatch, ClearRemovesEverything)
+{
+	GizmoBatch batch;
+	batch.addShape(GizmoBatch::Shape::BOX, glm::mat4(1.0f), glm::vec4(1.0f), true);
+	batch.addIcon(1, glm::vec3(0.0f, 0.0f, 5.0f), 1.0f, CAMERA);
+	batch.buildIcons(glm::mat4(1.0f));
+
+	batch.clear();
+	batch.buildIcons(glm::mat4(1.0f));
+
+	EXPECT_TRUE(batch.getLines().empty());
+	EXPECT_TRUE(batch.getForegroundLines().empty());
+	EXPECT_TRUE(batch.getIconInstances().empty());
+	EXPECT_TRUE(batch.getIconGroups().empty());
+	EXPECT_EQ(batch.nIcons(), 0u);
+}
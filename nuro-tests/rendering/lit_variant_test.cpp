@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include <rendering/material/lit/lit_variant.h>
+
+using namespace LitVariant;
+
+namespace {
+
+	// All features in order of their bits
+	const std::vector<Feature> FEATURES = {
+		ALBEDO_MAP,
+		ROUGHNESS_MAP,
+		METALLIC_MAP,
+		NORMAL_MAP,
+		OCCLUSION_MAP,
+		EMISSION,
+		EMISSIVE_MAP,
+		HEIGHT_MAP,
+		SHADOWS,
+		CASCADED_SHADOWS,
+		SSAO,
+		LIGHT_CLUSTERS
+	};
+
+	// Every feature enabled
+	constexpr uint32_t ALL = (1u << N_FEATURES) - 1;
+
+}
+
+TEST(LitVariant, EmptySelectionIsBaseVariant)
+{
+	EXPECT_EQ(select(Selection()), 0u);
+	EXPECT_TRUE(defines(0).empty());
+}
+
+TEST(LitVariant, SelectsEachFieldAsItsFeature)
+{
+	auto expectSelects = [](bool Selection::* field, uint32_t features) {
+		Selection selection;
+		selection.*field = true;
+		EXPECT_EQ(select(selection), features);
+	};
+
+	expectSelects(&Selection::albedoMap, ALBEDO_MAP);
+	expectSelects(&Selection::roughnessMap, ROUGHNESS_MAP);
+	expectSelects(&Selection::metallicMap, METALLIC_MAP);
+	expectSelects(&Selection::normalMap, NORMAL_MAP);
+	expectSelects(&Selection::occlusionMap, OCCLUSION_MAP);
+	expectSelects(&Selection::emission, EMISSION);
+	expectSelects(&Selection::heightMap, HEIGHT_MAP);
+	expectSelects(&Selection::castShadows, SHADOWS);
+	expectSelects(&Selection::ssao, SSAO);
+	expectSelects(&Selection::lightClusters, LIGHT_CLUSTERS);
+
+	// Dependent features are dropped without the feature they depend on
+	expectSelects(&Selection::emissiveMap, 0);
+	expectSelects(&Selection::cascadedShadows, 0);
+}
+
+TEST(LitVariant, SelectsEveryFeature)
+{
+	Selection selection;
+	selection.albedoMap = true;
+	selection.roughnessMap = true;
+	selection.metallicMap = true;
+	selection.normalMap = true;
+	selection.occlusionMap = true;
+	selection.emission = true;
+	selection.emissiveMap = true;
+	selection.heightMap = true;
+	selection.castShadows = true;
+	selection.cascadedShadows = true;
+	selection.ssao = true;
+	selection.lightClusters = true;
+
+	EXPECT_EQ(select(selection), ALL);
+}
+
+TEST(LitVariant, NormalizeDropsDependentAndUnknownFeatures)
+{
+	EXPECT_EQ(normalize(EMISSIVE_MAP), 0u);
+	EXPECT_EQ(normalize(EMISSION | EMISSIVE_MAP), EMISSION | EMISSIVE_MAP);
+	EXPECT_EQ(normalize(CASCADED_SHADOWS | SSAO), SSAO);
+	EXPECT_EQ(normalize(SHADOWS | CASCADED_SHADOWS), SHADOWS | CASCADED_SHADOWS);
+	EXPECT_EQ(normalize(ALBEDO_MAP | (1u << N_FEATURES) | 0x80000000u), ALBEDO_MAP);
+
+	// Normalizing is idempotent
+	for (uint32_t features = 0; features <= ALL; features++) {
+		EXPECT_EQ(normalize(normalize(features)), normalize(features));
+	}
+}
+
+TEST(LitVariant, DefinesAreUniqueAndPrefixed)
+{
+	std::set<std::string> unique;
+	for (Feature feature : FEATURES) {
+		std::string define = LitVariant::define(feature);
+		EXPECT_EQ(define.rfind("LIT_", 0), 0u) << define;
+		unique.insert(define);
+	}
+	EXPECT_EQ(unique.size(), N_FEATURES);
+}
+
+TEST(LitVariant, DefinesAreOrderedByFeatureBit)
+{
+	std::vector<std::string> expected;
+	for (Feature feature : FEATURES) expected.push_back(LitVariant::define(feature));
+	EXPECT_EQ(defines(ALL), expected);
+
+	// Order doesn't depend on how the features were combined
+	EXPECT_EQ(defines(SSAO | ALBEDO_MAP), defines(ALBEDO_MAP | SSAO));
+	EXPECT_EQ(defines(SSAO | ALBEDO_MAP), (std::vector<std::string>{ "LIT_ALBEDO_MAP", "LIT_SSAO" }));
+
+	// Defines are taken from the normalized features
+	EXPECT_EQ(defines(CASCADED_SHADOWS | NORMAL_MAP), std::vector<std::string>{ "LIT_NORMAL_MAP" });
+}
+
+TEST(LitVariant, DistinctVariantsHaveDistinctKeysAndDefines)
+{
+	// Every normalized feature set is its own variant key with its own define list
+	std::set<uint32_t> keys;
+	std::set<std::vector<std::string>> defineSets;
+	for (uint32_t features = 0; features <= ALL; features++) {
+		uint32_t key = normalize(features);
+		if (!keys.insert(key).second) continue;
+		EXPECT_TRUE(defineSets.insert(defines(key)).second) << "variant " << key << " shares its defines";
+	}
+
+	// Emission and shadows pair with their dependent feature, each pair has three valid states
+	EXPECT_EQ(keys.size(), (1u << (N_FEATURES - 4)) * 3 * 3);
+}
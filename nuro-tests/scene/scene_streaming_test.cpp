@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <filesystem>
+
+#include <ecs/ecs.h>
+#include <scene/scene.h>
+#include <scene/scene_manager.h>
+#include <scene/scene_serializer.h>
+#include <context/application_context.h>
+
+namespace {
+
+	constexpr uint32_t N_SECTIONS = 100;
+
+	// Maximum amount of entities merged or destroyed per frame, shared by all sections
+	constexpr uint32_t FRAME_BUDGET = 97;
+
+	// Budget sections are given when streamed on their own
+	constexpr uint32_t SECTION_BUDGET = 7;
+
+	// Groups per section, each group is a transform only parent with a point light and two mesh renderers as children
+	constexpr uint32_t N_GROUPS = 8;
+	constexpr uint32_t ENTITIES_PER_SECTION = N_GROUPS * 4;
+
+	// Writes a section scene file
+	void writeSection(const FS::Path& path)
+	{
+		ECS ecs;
+		for (uint32_t i = 0; i < N_GROUPS; i++) {
+			auto [group, groupTransform] = ecs.createEntity("Group " + std::to_string(i));
+
+			auto [light, lightTransform] = ecs.createEntity("Light", group);
+			ecs.add<PointLightComponent>(light);
+
+			for (uint32_t j = 0; j < 2; j++) {
+				auto [mesh, meshTransform] = ecs.createEntity("Mesh", group);
+				ecs.add<MeshRendererComponent>(mesh);
+			}
+		}
+		ASSERT_TRUE(SceneSerializer::write(path, ecs, SceneAssetResolver()));
+	}
+
+	// Fails if any render queue entry doesn't reference the components of its entity
+	void expectRenderQueueValid(ECS& ecs)
+	{
+		const RenderQueue& queue = ecs.getRenderQueue();
+		ASSERT_EQ(queue.size(), ecs.view<MeshRendererComponent>().size());
+		for (const auto& [entity, transform, renderer] : queue) {
+			ASSERT_TRUE(ecs.verify(entity));
+			ASSERT_EQ(&transform, &ecs.get<TransformComponent>(entity));
+			ASSERT_EQ(&renderer, &ecs.get<MeshRendererComponent>(entity));
+		}
+	}
+
+	struct SceneStreamingTest : public ::testing::Test
+	{
+		void SetUp() override
+		{
+			// Scene manager streams into the main ecs
+			entt::locator<ECS>::emplace();
+
+			directory = std::filesystem::temp_directory_path() / "nuro_scene_streaming_test";
+			std::filesystem::create_directories(directory);
+
+			manager.setStreamingBudget(FRAME_BUDGET);
+			for (uint32_t i = 0; i < N_SECTIONS; i++) {
+				FS::Path file = directory / ("section_" + std::to_string(i) + ".nscn");
+				writeSection(file);
+				sections.push_back(manager.getScene(manager.createScene(file)));
+			}
+		}
+
+		void TearDown() override
+		{
+			sections.clear();
+			manager = SceneManager();
+			entt::locator<ECS>::reset();
+			std::filesystem::remove_all(directory);
+		}
+
+		ECS& ecs()
+		{
+			return ECS::main();
+		}
+
+		// Advances streaming of all sections by one frame through the scene manager, returns the amount of entities processed
+		uint32_t frame()
+		{
+			ApplicationContext::resourceManager().updateContext();
+
+			uint32_t processed = manager.update();
+			EXPECT_LE(processed, FRAME_BUDGET) << "sections overran the shared budget";
+			return processed;
+		}
+
+		// Advances streaming of every section on its own with a small budget, returns the amount of entities processed
+		uint32_t frameSeparately()
+		{
+			ApplicationContext::resourceManager().updateContext();
+
+			uint32_t processed = 0;
+			for (auto& section : sections) {
+				uint32_t sectionProcessed = section->stream(ecs(), SECTION_BUDGET);
+				EXPECT_LE(sectionProcessed, SECTION_BUDGET) << "section '" << section->name() << "' overran its budget";
+				processed += sectionProcessed;
+			}
+			return processed;
+		}
+
+		// Streams until the given condition holds, checks the render queue every frame and fails if streaming doesn't finish in time
+		template <typename Condition, typename Frame>
+		void streamUntil(Condition&& condition, Frame&& advance)
+		{
+			auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+			while (!condition()) {
+				ASSERT_LT(std::chrono::steady_clock::now(), timeout) << "streaming didn't finish";
+
+				// Give the resource processor time to decode while nothing can be merged
+				if (advance() == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+				expectRenderQueueValid(ecs());
+				if (HasFatalFailure()) return;
+			}
+		}
+
+		// Streams through the scene manager until all sections reached the given state
+		void streamUntil(SceneState state)
+		{
+			streamUntil([&]() { return allReached(state); }, [&]() { return frame(); });
+		}
+
+		bool allReached(SceneState state) const
+		{
+			for (auto& section : sections) {
+				if (section->state() != state) return false;
+			}
+			return true;
+		}
+
+		FS::Path directory;
+		SceneManager manager;
+		std::vector<SceneRef> sections;
+	};
+
+}
+
+TEST_F(SceneStreamingTest, LoadsAndUnloadsSectionsWithinBudget)
+{
+	for (auto& section : sections) manager.streamIn(section->name());
+	streamUntil(SceneState::LOADED);
+	ASSERT_FALSE(HasFatalFailure());
+
+	for (auto& section : sections) {
+		EXPECT_EQ(section->entities().size(), ENTITIES_PER_SECTION);
+	}
+	EXPECT_EQ(ecs().getRenderQueue().size(), N_SECTIONS * N_GROUPS * 2);
+
+	// Unload every other section, survivors must keep valid render queue entries
+	for (uint32_t i = 0; i < N_SECTIONS; i += 2) manager.streamOut(sections[i]->name());
+	auto unloaded = [&]() {
+		for (uint32_t i = 0; i < N_SECTIONS; i += 2) {
+			if (sections[i]->state() != SceneState::UNLOADED) return false;
+		}
+		return true;
+	};
+	streamUntil(unloaded, [&]() { return frame(); });
+	ASSERT_FALSE(HasFatalFailure());
+	EXPECT_EQ(ecs().getRenderQueue().size(), (N_SECTIONS / 2) * N_GROUPS * 2);
+
+	// Unload the rest
+	for (auto& section : sections) manager.streamOut(section->name());
+	streamUntil(SceneState::UNLOADED);
+	ASSERT_FALSE(HasFatalFailure());
+
+	EXPECT_TRUE(ecs().getRenderQueue().empty());
+	EXPECT_EQ(ecs().view<TransformComponent>().size(), 0u);
+}
+
+TEST_F(SceneStreamingTest, SectionsStayWithinTheirBudget)
+{
+	for (auto& section : sections) section->streamIn(SceneAssetResolver());
+	streamUntil([&]() { return allReached(SceneState::LOADED); }, [&]() { return frameSeparately(); });
+	ASSERT_FALSE(HasFatalFailure());
+	EXPECT_EQ(ecs().getRenderQueue().size(), N_SECTIONS * N_GROUPS * 2);
+
+	for (auto& section : sections) section->streamOut();
+	streamUntil([&]() { return allReached(SceneState::UNLOADED); }, [&]() { return frameSeparately(); });
+	ASSERT_FALSE(HasFatalFailure());
+	EXPECT_EQ(ecs().view<TransformComponent>().size(), 0u);
+}
+
+TEST_F(SceneStreamingTest, AbortsMergingSections)
+{
+	for (auto& section : sections) manager.streamIn(section->name());
+
+	// Stream out while sections are still decoding or merging
+	for (uint32_t i = 0; i < 20; i++) {
+		frame();
+		expectRenderQueueValid(ecs());
+		ASSERT_FALSE(HasFatalFailure());
+	}
+	for (auto& section : sections) manager.streamOut(section->name());
+
+	streamUntil(SceneState::UNLOADED);
+	ASSERT_FALSE(HasFatalFailure());
+
+	EXPECT_TRUE(ecs().getRenderQueue().empty());
+	EXPECT_EQ(ecs().view<TransformComponent>().size(), 0u);
+}